@@ -0,0 +1,59 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+/**
+ * @brief Counts calls to the global operator new and operator new[].
+ *
+ * Replaces the global allocation and deallocation functions in matching pairs, so include it from exactly one translation unit
+ * of a benchmark executable.
+ */
+namespace AllocationCounter {
+
+inline std::atomic<uint64_t> allocations{0}; ///< Number of calls to the global operator new
+
+/**
+ * @brief Returns the number of allocations so far.
+ */
+inline uint64_t count() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+} // namespace AllocationCounter
+
+// The replacements stay out of line: inlined into a caller, GCC pairs the inner malloc() and
+// free() with the operator new() and operator delete() the standard library calls and warns.
+
+__attribute__((noinline)) void* operator new(std::size_t size) {
+    AllocationCounter::allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+__attribute__((noinline)) void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+__attribute__((noinline)) void operator delete(void* memory, std::size_t) noexcept {
+    operator delete(memory);
+}
+
+__attribute__((noinline)) void operator delete[](void* memory) noexcept {
+    operator delete(memory);
+}
+
+__attribute__((noinline)) void operator delete[](void* memory, std::size_t) noexcept {
+    operator delete(memory);
+}
+
+#endif // ALLOCATION_COUNTER_H
@@ -0,0 +1,66 @@
+#ifndef BENCH_UTILS_H
+#define BENCH_UTILS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Minimal self-contained timing helpers shared by the benchmarks.
+ *
+ * The benchmarks also run on the target boards, so they avoid external benchmark frameworks.
+ */
+namespace BenchUtils {
+
+/**
+ * @brief Prevents the compiler from optimizing away a computed value.
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief Runs a body repeatedly and returns the median time per iteration.
+ *
+ * @param[in] body Callable executed once per iteration.
+ * @param[in] iterations Iterations per repetition.
+ * @param[in] repetitions Number of timed repetitions, the median is reported.
+ * @return Median nanoseconds per iteration.
+ */
+template <typename Body>
+double measureNs(Body&& body, size_t iterations, size_t repetitions = 5) {
+    for (size_t i = 0; i < iterations / 10 + 1; ++i) {
+        body();
+    }
+    std::vector<double> samples;
+    samples.reserve(repetitions);
+    for (size_t r = 0; r < repetitions; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            body();
+        }
+        samples.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                          static_cast<double>(iterations));
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+/**
+ * @brief Prints one result row.
+ *
+ * @param[in] name Benchmark name.
+ * @param[in] nsPerOp Nanoseconds per operation.
+ * @param[in] detail Additional column, for example the encoded size.
+ */
+inline void report(const std::string& name, double nsPerOp, const std::string& detail = "") {
+    std::printf("%-36s %10.1f ns/op  %s\n", name.c_str(), nsPerOp, detail.c_str());
+}
+
+} // namespace BenchUtils
+
+#endif // BENCH_UTILS_H
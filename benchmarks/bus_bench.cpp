@@ -0,0 +1,355 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+#include "ErrorHandler.h"
+#include "VirtualBus.h"
+#include "InverterCommand.h"
+#include "BatteryCommand.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Nanoseconds on the monotonic clock, the unit of every latency sample.
+ */
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief Struct representing the benchmark parameters.
+ */
+struct Config {
+    size_t producers = 1;            ///< Publishing threads
+    size_t subscribers = 1;          ///< Attached receiving tasks
+    std::string delivery = "queue";  ///< "queue" for receiveMessage(), "callback" for registerCallback()
+    std::string type = "inverter";   ///< "inverter", "battery" or "payload"
+    size_t payloadBytes = 64;        ///< Size of a "payload" message
+    size_t messages = 20000;         ///< Messages per producer
+    std::string output;              ///< JSON result file, stdout if empty
+};
+
+/**
+ * @brief Opaque byte payload of a configurable size.
+ */
+class PayloadCmd : public VirtualBusCmd {
+public:
+    explicit PayloadCmd(size_t size) : bytes_(size, '\x5a') {}
+
+    void print() const override { std::cout << "PayloadCmd: " << bytes_.size() << " bytes" << std::endl; }
+
+private:
+    std::string bytes_;  ///< Payload bytes
+};
+
+/**
+ * @brief Command carrying the time it was handed to the bus.
+ *
+ * @tparam Command Message type under test.
+ */
+template <typename Command>
+class StampedCmd : public Command {
+public:
+    using Command::Command;
+
+    std::atomic<uint64_t> publishedNs{0};  ///< Set right before sendMessage()
+};
+
+/**
+ * @brief Latency samples of one subscriber, written without locks by concurrent callbacks.
+ */
+struct SampleSink {
+    std::vector<uint64_t> samples;  ///< Publish to delivery latency in nanoseconds
+    std::atomic<size_t> count{0};   ///< Samples written
+
+    void record(uint64_t latencyNs) {
+        const size_t index = count.fetch_add(1, std::memory_order_relaxed);
+        if (index < samples.size()) {
+            samples[index] = latencyNs;
+        }
+    }
+};
+
+/**
+ * @brief Struct representing the measurements of one run.
+ */
+struct Outcome {
+    uint64_t published = 0;                ///< Messages handed to the bus
+    uint64_t delivered = 0;                ///< Messages seen by subscribers
+    double publishSeconds = 0.0;           ///< Start until the last producer returned
+    double deliverySeconds = 0.0;          ///< Start until the last delivery
+    std::vector<uint64_t> latenciesNs;     ///< All subscribers' samples, sorted
+    LatencyHistogram::Snapshot busDelay;   ///< The bus' own queue or callback delay histogram, all subscribers merged
+    bool complete = false;                 ///< False if deliveries timed out
+};
+
+void merge(LatencyHistogram::Snapshot& into, const LatencyHistogram::Snapshot& from) {
+    for (size_t i = 0; i < LatencyHistogram::kBucketCount; ++i) {
+        into.counts[i] += from.counts[i];
+    }
+    into.count += from.count;
+    into.sum += from.sum;
+    into.max = std::max(into.max, from.max);
+}
+
+template <typename Command>
+std::shared_ptr<StampedCmd<Command>> makeMessage(const Config&) {
+    return std::make_shared<StampedCmd<Command>>();
+}
+
+template <>
+std::shared_ptr<StampedCmd<PayloadCmd>> makeMessage<PayloadCmd>(const Config& config) {
+    return std::make_shared<StampedCmd<PayloadCmd>>(config.payloadBytes);
+}
+
+/**
+ * @brief Publishes from every producer and measures delivery to every subscriber.
+ *
+ * Messages are created before the clock starts, so the run measures the bus and not the
+ * command constructors. Each message is stamped immediately before sendMessage().
+ *
+ * @tparam Command Message type under test.
+ * @param[in] config Benchmark parameters.
+ * @return Measurements of the run.
+ */
+template <typename Command>
+Outcome run(const Config& config) {
+    const uint64_t expectedPerSubscriber = static_cast<uint64_t>(config.producers) * config.messages;
+    const uint64_t expected = expectedPerSubscriber * config.subscribers;
+    const bool callbacks = config.delivery == "callback";
+
+    std::vector<std::vector<std::shared_ptr<StampedCmd<Command>>>> prepared(config.producers);
+    for (auto& messages : prepared) {
+        messages.reserve(config.messages);
+        for (size_t i = 0; i < config.messages; ++i) {
+            messages.push_back(makeMessage<Command>(config));
+        }
+    }
+    std::vector<SampleSink> sinks(config.subscribers);
+    for (auto& sink : sinks) {
+        sink.samples.assign(expectedPerSubscriber, 0);
+    }
+
+    Outcome outcome;
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<uint64_t> lastDeliveryNs{0};
+    std::atomic<bool> go{false};
+    auto onDelivery = [&](SampleSink& sink, const std::shared_ptr<VirtualBusCmd>& message) {
+        const uint64_t now = nowNs();
+        sink.record(now - static_cast<StampedCmd<Command>*>(message.get())->publishedNs.load(std::memory_order_relaxed));
+        if (delivered.fetch_add(1, std::memory_order_acq_rel) + 1 == expected) {
+            lastDeliveryNs.store(now, std::memory_order_release);
+        }
+    };
+
+    uint64_t startNs = 0;
+    uint64_t publishEndNs = 0;
+    {
+        VirtualBus bus;
+        // Every producer thread publishes as task 1, subscribers take ids 2..S+1. The bus queues
+        // a message for every task but its sender, so separate producer tasks would collect
+        // each other's messages in queues nobody reads.
+        const int senderId = 1;
+        bus.attach(senderId, "Producers");
+        std::vector<std::thread> receivers;
+        for (size_t s = 0; s < config.subscribers; ++s) {
+            const int taskId = static_cast<int>(2 + s);
+            bus.attach(taskId, "Subscriber" + std::to_string(s));
+            SampleSink& sink = sinks[s];
+            if (callbacks) {
+                bus.registerCallback(taskId, [&onDelivery, &sink](std::shared_ptr<VirtualBusCmd> message) {
+                    onDelivery(sink, message);
+                });
+            } else {
+                receivers.emplace_back([&, taskId, expectedPerSubscriber] {
+                    std::shared_ptr<VirtualBusCmd> message;
+                    for (uint64_t i = 0; i < expectedPerSubscriber && bus.receiveMessage(taskId, message); ++i) {
+                        onDelivery(sink, message);
+                    }
+                });
+            }
+        }
+
+        std::atomic<size_t> producersDone{0};
+        std::vector<std::thread> producers;
+        for (size_t p = 0; p < config.producers; ++p) {
+            producers.emplace_back([&, p] {
+                while (!go.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                for (auto& message : prepared[p]) {
+                    message->publishedNs.store(nowNs(), std::memory_order_relaxed);
+                    bus.sendMessage(senderId, message);
+                }
+                if (producersDone.fetch_add(1) + 1 == config.producers) {
+                    publishEndNs = nowNs();
+                }
+            });
+        }
+
+        startNs = nowNs();
+        go.store(true, std::memory_order_release);
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        const auto deadline = Clock::now() + std::chrono::seconds(60);
+        while (delivered.load(std::memory_order_acquire) < expected && Clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        outcome.complete = delivered.load(std::memory_order_acquire) >= expected;
+        for (const auto& report : bus.getLatencyReports()) {
+            if (report.taskId != senderId) {
+                merge(outcome.busDelay, callbacks ? report.callbackDelay : report.queueDelay);
+            }
+        }
+        bus.shutdown();
+        for (auto& receiver : receivers) {
+            receiver.join();
+        }
+    }
+
+    outcome.published = expectedPerSubscriber;
+    outcome.delivered = delivered.load();
+    outcome.publishSeconds = static_cast<double>(publishEndNs - startNs) / 1e9;
+    const uint64_t endNs = outcome.complete ? lastDeliveryNs.load(std::memory_order_acquire) : nowNs();
+    outcome.deliverySeconds = static_cast<double>(endNs - startNs) / 1e9;
+    for (auto& sink : sinks) {
+        const size_t count = std::min(sink.count.load(), sink.samples.size());
+        outcome.latenciesNs.insert(outcome.latenciesNs.end(), sink.samples.begin(), sink.samples.begin() + static_cast<std::ptrdiff_t>(count));
+    }
+    std::sort(outcome.latenciesNs.begin(), outcome.latenciesNs.end());
+    return outcome;
+}
+
+uint64_t percentile(const std::vector<uint64_t>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    return sorted[static_cast<size_t>(p * static_cast<double>(sorted.size() - 1))];
+}
+
+nlohmann::json toJson(const Config& config, const Outcome& outcome) {
+    nlohmann::json result;
+    result["benchmark"] = "bus_bench";
+    result["config"] = {{"producers", config.producers}, {"subscribers", config.subscribers},
+                        {"delivery", config.delivery}, {"type", config.type},
+                        {"payload_bytes", config.type == "payload" ? config.payloadBytes : 0},
+                        {"messages_per_producer", config.messages},
+                        {"hardware_threads", std::thread::hardware_concurrency()}};
+
+    double sum = 0.0;
+    for (uint64_t sample : outcome.latenciesNs) {
+        sum += static_cast<double>(sample);
+    }
+    const auto& samples = outcome.latenciesNs;
+    result["latency_ns"] = {{"samples", samples.size()},
+                            {"min", samples.empty() ? 0 : samples.front()},
+                            {"mean", samples.empty() ? 0.0 : sum / static_cast<double>(samples.size())},
+                            {"p50", percentile(samples, 0.50)},
+                            {"p99", percentile(samples, 0.99)},
+                            {"p999", percentile(samples, 0.999)},
+                            {"max", samples.empty() ? 0 : samples.back()}};
+    const auto& bus = outcome.busDelay;
+    result["bus_histogram_ns"] = {{"samples", bus.count},
+                                  {"mean", bus.mean()},
+                                  {"p50", bus.percentile(0.50)},
+                                  {"p99", bus.percentile(0.99)},
+                                  {"p999", bus.percentile(0.999)},
+                                  {"max", bus.max}};
+    result["throughput"] = {
+        {"published", outcome.published},
+        {"delivered", outcome.delivered},
+        {"complete", outcome.complete},
+        {"publish_seconds", outcome.publishSeconds},
+        {"delivery_seconds", outcome.deliverySeconds},
+        {"published_per_second", outcome.publishSeconds > 0.0 ? static_cast<double>(outcome.published) / outcome.publishSeconds : 0.0},
+        {"delivered_per_second", outcome.deliverySeconds > 0.0 ? static_cast<double>(outcome.delivered) / outcome.deliverySeconds : 0.0}};
+    return result;
+}
+
+} // namespace
+
+/**
+ * @brief Measures VirtualBus publish throughput and publish-to-delivery latency.
+ *
+ * Usage: bus_bench [--producers N] [--subscribers N] [--delivery queue|callback]
+ *                  [--type inverter|battery|payload] [--payload BYTES] [--messages N] [--out FILE]
+ *
+ * Every producer publishes N messages (default 20000). Queue delivery drains each subscriber
+ * with receiveMessage() on its own thread; callback delivery registers a callback that runs
+ * on the bus thread pool. Latency runs from just before sendMessage() to the moment the
+ * subscriber sees the message. `--payload` sets the size of `payload` messages. The result
+ * is written as JSON to FILE or stdout so runs can be compared across changes.
+ *
+ * @return Exit code, 2 if not every message was delivered within 60 seconds.
+ */
+int main(int argc, char* argv[]) {
+    Config config;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string argument = argv[i];
+        if (argument == "--producers") {
+            config.producers = std::strtoul(argv[i + 1], nullptr, 0);
+        } else if (argument == "--subscribers") {
+            config.subscribers = std::strtoul(argv[i + 1], nullptr, 0);
+        } else if (argument == "--delivery") {
+            config.delivery = argv[i + 1];
+        } else if (argument == "--type") {
+            config.type = argv[i + 1];
+        } else if (argument == "--payload") {
+            config.payloadBytes = std::strtoul(argv[i + 1], nullptr, 0);
+        } else if (argument == "--messages") {
+            config.messages = std::strtoul(argv[i + 1], nullptr, 0);
+        } else if (argument == "--out") {
+            config.output = argv[i + 1];
+        } else {
+            std::cerr << "Unknown option " << argument << std::endl;
+            return 1;
+        }
+    }
+    if (config.producers == 0 || config.subscribers == 0 || config.messages == 0 ||
+        (config.delivery != "queue" && config.delivery != "callback")) {
+        std::cerr << "Usage: " << argv[0] << " [--producers N] [--subscribers N] [--delivery queue|callback]"
+                  << " [--type inverter|battery|payload] [--payload BYTES] [--messages N] [--out FILE]" << std::endl;
+        return 1;
+    }
+
+    // The bus reports its shutdown on stdout, keep stdout for the JSON result
+    std::streambuf* console = std::cout.rdbuf(std::cerr.rdbuf());
+    Outcome outcome;
+    if (config.type == "inverter") {
+        outcome = run<InverterCommand>(config);
+    } else if (config.type == "battery") {
+        outcome = run<BatteryStateCmd>(config);
+    } else if (config.type == "payload") {
+        outcome = run<PayloadCmd>(config);
+    } else {
+        std::cerr << "Unknown message type " << config.type << std::endl;
+        return 1;
+    }
+    ErrorHandler::flush();
+    std::cout.rdbuf(console);
+
+    const std::string text = toJson(config, outcome).dump(2);
+    if (config.output.empty()) {
+        std::cout << text << std::endl;
+    } else {
+        std::ofstream file(config.output, std::ios::trunc);
+        file << text << std::endl;
+        if (!file) {
+            std::cerr << "Cannot write " << config.output << std::endl;
+            return 1;
+        }
+    }
+    return outcome.complete ? 0 : 2;
+}
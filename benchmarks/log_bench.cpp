@@ -0,0 +1,182 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <time.h>
+
+#include "AsyncLogger.h"
+#include "BinaryLogger.h"
+#include "StdCoutLogger.h"
+#include "BenchUtils.h"
+
+using BenchUtils::report;
+
+namespace {
+
+constexpr size_t kMessagesPerThread = 200000;
+
+/**
+ * @brief CPU time of the calling thread, so time spent by the background thread is not counted
+ * on machines with fewer cores than threads.
+ */
+uint64_t threadCpuNs() {
+    timespec now{};
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+}
+
+/**
+ * @brief Logs from several threads at once and returns the mean CPU time per call.
+ *
+ * @param[in] logger Logger under test.
+ * @param[in] threads Number of logging threads.
+ * @return CPU nanoseconds per info() call, averaged over all threads.
+ */
+double measureCalls(ILogger& logger, size_t threads) {
+    // A typical bus message, longer than the small string buffer
+    const std::string message = "VirtualBus: Task Sender (ID: 0) is sending a message.";
+    std::vector<double> perThread(threads);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&logger, &message, &perThread, t] {
+            // The first call registers the thread, keep it out of the timing
+            logger.info(message);
+            const uint64_t start = threadCpuNs();
+            for (size_t i = 0; i < kMessagesPerThread; ++i) {
+                logger.info(message);
+            }
+            perThread[t] = static_cast<double>(threadCpuNs() - start) / static_cast<double>(kMessagesPerThread);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double total = 0.0;
+    for (double ns : perThread) {
+        total += ns;
+    }
+    return total / static_cast<double>(threads);
+}
+
+/**
+ * @brief Logs a formatted message through VBUS_LOG_INFO from several threads.
+ *
+ * @param[in] logger Logger under test, in binary mode if it has a binary sink.
+ * @param[in] threads Number of logging threads.
+ * @return CPU nanoseconds per call, averaged over all threads.
+ */
+double measureFormatted(const std::shared_ptr<ILogger>& logger, size_t threads) {
+    const std::string sender = "Sender";
+    std::vector<double> perThread(threads);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&logger, &sender, &perThread, t] {
+            VBUS_LOG_INFO(logger, "VirtualBus: Task {} (ID: {}) is sending message {} ({} V).", sender, t, size_t{0}, 48.5f);
+            const uint64_t start = threadCpuNs();
+            for (size_t i = 0; i < kMessagesPerThread; ++i) {
+                VBUS_LOG_INFO(logger, "VirtualBus: Task {} (ID: {}) is sending message {} ({} V).", sender, t, i, 48.5f);
+            }
+            perThread[t] = static_cast<double>(threadCpuNs() - start) / static_cast<double>(kMessagesPerThread);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double total = 0.0;
+    for (double ns : perThread) {
+        total += ns;
+    }
+    return total / static_cast<double>(threads);
+}
+
+} // namespace
+
+/**
+ * @brief Compares the caller-side cost of StdCoutLogger and AsyncLogger, output goes to /dev/null,
+ * then the cost and log size of formatted messages as text and in the binary format.
+ *
+ * Usage: log_bench [max_threads]
+ */
+int main(int argc, char* argv[]) {
+    const size_t maxThreads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4;
+
+    std::ofstream devNullStream("/dev/null");
+    std::FILE* devNull = std::fopen("/dev/null", "w");
+    if (!devNullStream || !devNull) {
+        std::fprintf(stderr, "Cannot open /dev/null.\n");
+        return 1;
+    }
+    std::streambuf* coutBuffer = std::cout.rdbuf(devNullStream.rdbuf());
+
+    std::vector<std::pair<std::string, double>> results;
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        StdCoutLogger console;
+        const double consoleNs = measureCalls(console, threads);
+
+        uint64_t dropped = 0;
+        double asyncNs = 0.0;
+        {
+            // Large rings so that the producers never wait for the background thread
+            AsyncLogger async(devNull, devNull, kMessagesPerThread);
+            asyncNs = measureCalls(async, threads);
+            async.flush();
+            dropped = async.dropped();
+        }
+
+        std::cout.rdbuf(coutBuffer);
+        char detail[64];
+        report("StdCoutLogger info, " + std::to_string(threads) + " threads", consoleNs);
+        std::snprintf(detail, sizeof(detail), "%6.1fx  %llu dropped", consoleNs / asyncNs, static_cast<unsigned long long>(dropped));
+        report("AsyncLogger info, " + std::to_string(threads) + " threads", asyncNs, detail);
+        std::cout.rdbuf(devNullStream.rdbuf());
+    }
+
+    // Formatted call sites: AsyncLogger text versus BinaryLogger records
+    const std::string binaryPath = "/tmp/log_bench.vblog";
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        const double messages = static_cast<double>(threads * (kMessagesPerThread + 1));
+
+        std::FILE* textFile = std::tmpfile();
+        double textNs = 0.0;
+        long textBytes = 0;
+        {
+            auto async = std::make_shared<AsyncLogger>(textFile, textFile, kMessagesPerThread);
+            textNs = measureFormatted(async, threads);
+            async->flush();
+            textBytes = std::ftell(textFile);
+        }
+        std::fclose(textFile);
+
+        double binaryNs = 0.0;
+        uint64_t binaryBytes = 0;
+        uint64_t dropped = 0;
+        {
+            // Enough blocks that the records of one run never wait for the disk
+            auto binary = std::make_shared<BinaryLogger>(binaryPath, 1024 * 1024, 8 * threads);
+            binaryNs = measureFormatted(binary, threads);
+            binary->flush();
+            binaryBytes = binary->bytesWritten();
+            dropped = binary->dropped();
+        }
+        std::remove(binaryPath.c_str());
+
+        std::cout.rdbuf(coutBuffer);
+        char detail[96];
+        std::snprintf(detail, sizeof(detail), "%6.1f B/msg", static_cast<double>(textBytes) / messages);
+        report("AsyncLogger formatted, " + std::to_string(threads) + " threads", textNs, detail);
+        std::snprintf(detail, sizeof(detail), "%6.1f B/msg  %4.1fx smaller  %llu dropped", static_cast<double>(binaryBytes) / messages,
+                      static_cast<double>(textBytes) / static_cast<double>(binaryBytes), static_cast<unsigned long long>(dropped));
+        report("BinaryLogger formatted, " + std::to_string(threads) + " threads", binaryNs, detail);
+        std::cout.rdbuf(devNullStream.rdbuf());
+    }
+
+    std::cout.rdbuf(coutBuffer);
+    std::fclose(devNull);
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+#include "InverterCommand.h"
+#include "BatteryCommand.h"
+#include "BenchUtils.h"
+#include "AllocationCounter.h"
+
+using BenchUtils::doNotOptimize;
+using BenchUtils::measureNs;
+using BenchUtils::report;
+
+namespace {
+
+constexpr size_t kPasses = 2000;
+
+/**
+ * @brief One line of the corpus together with the command type it targets.
+ */
+struct Payload {
+    std::string text;  ///< JSON text as received from MQTT
+    bool battery;      ///< True for battery state messages, false for inverter commands
+};
+
+/**
+ * @brief Derives a malformed corpus by truncating every payload, as a broken client would.
+ */
+std::vector<Payload> truncateCorpus(const std::vector<Payload>& corpus) {
+    std::vector<Payload> truncated;
+    for (const auto& payload : corpus) {
+        truncated.push_back({payload.text.substr(0, payload.text.size() * 2 / 3), payload.battery});
+    }
+    return truncated;
+}
+
+std::vector<Payload> loadCorpus(const std::string& path) {
+    std::vector<Payload> corpus;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty()) {
+            corpus.push_back({line, line.find("\"Cube_Num\"") != std::string::npos});
+        }
+    }
+    return corpus;
+}
+
+/**
+ * @brief DOM-based parse mirroring the former hand-written parsers, without their logging.
+ */
+bool parseDom(InverterCommand& command, const std::string& text) {
+    try {
+        nlohmann::json json = nlohmann::json::parse(text);
+        if (json.contains("current") && json["current"].is_number()) {
+            command.setCurrent(json["current"].get<double>());
+        }
+        if (json.contains("voltage") && json["voltage"].is_number()) {
+            command.setVoltage(json["voltage"].get<double>());
+        }
+        if (json.contains("command") && json["command"].is_string()) {
+            const std::string mode = json["command"].get<std::string>();
+            command.setMode(mode == "StartCharging" ? InverterCommand::Mode::Charging : InverterCommand::Mode::Discharging);
+        }
+        return true;
+    } catch (const nlohmann::json::exception&) {
+        return false;
+    }
+}
+
+/**
+ * @copydoc parseDom
+ */
+bool parseDom(BatteryStateCmd& command, const std::string& text) {
+    try {
+        nlohmann::json json = nlohmann::json::parse(text);
+        command.setNumberOfCubes(json["Cube_Num"].get<uint8_t>());
+        command.setNumberOfReadyCubes(json["Cube_OP"].get<uint8_t>());
+        command.setVoltageMinimum(json["Voltage"]["MIN"].get<uint16_t>());
+        command.setVoltageMaximum(json["Voltage"]["MAX"].get<uint16_t>());
+        command.setVoltageMean(json["Voltage"]["AVG"].get<int16_t>());
+        command.setSocMinimum(json["SOC"]["MIN"].get<uint16_t>());
+        command.setSocMaximum(json["SOC"]["MAX"].get<uint16_t>());
+        command.setSocMean(json["SOC"]["AVG"].get<uint32_t>());
+        command.setCurrentMean(json["Current"]["AVG"].get<int32_t>());
+        command.setCurrentMinimum(json["Current"]["MIN"].get<int32_t>());
+        command.setCurrentMaximum(json["Current"]["MAX"].get<int32_t>());
+        return true;
+    } catch (const nlohmann::json::exception&) {
+        return false;
+    }
+}
+
+/**
+ * @brief Parses the whole corpus once, returns the number of accepted payloads.
+ */
+template <typename Parse>
+size_t parseCorpus(const std::vector<Payload>& corpus, InverterCommand& inverter, BatteryStateCmd& battery, Parse&& parse) {
+    size_t accepted = 0;
+    for (const auto& payload : corpus) {
+        accepted += payload.battery ? parse(battery, payload.text) : parse(inverter, payload.text);
+    }
+    return accepted;
+}
+
+template <typename Parse>
+void run(const std::string& name, const std::vector<Payload>& corpus, Parse&& parse) {
+    InverterCommand inverter;
+    BatteryStateCmd battery;
+
+    const uint64_t before = AllocationCounter::count();
+    const size_t accepted = parseCorpus(corpus, inverter, battery, parse);
+    const double allocationsPerCommand =
+        static_cast<double>(AllocationCounter::count() - before) / static_cast<double>(corpus.size());
+
+    const double ns = measureNs([&] { doNotOptimize(parseCorpus(corpus, inverter, battery, parse)); }, kPasses);
+    char detail[64];
+    std::snprintf(detail, sizeof(detail), "%.1f allocs/cmd, %zu/%zu accepted", allocationsPerCommand, accepted, corpus.size());
+    report(name, ns / static_cast<double>(corpus.size()), detail);
+}
+
+} // namespace
+
+/**
+ * @brief Compares the DOM parse against the generated single-pass SAX parsers.
+ *
+ * Every line of the corpus is parsed into a reused command object, the reported time and
+ * allocation count are per command. The malformed runs truncate every payload, the DOM path
+ * then pays for an exception per command while the SAX path returns an error code.
+ *
+ * @param[in] argc Argument count.
+ * @param[in] argv Optional path to an NDJSON corpus, defaults to the bundled one.
+ * @return Exit code.
+ */
+int main(int argc, char* argv[]) {
+    const std::string path = argc > 1 ? argv[1] : PARSER_BENCH_CORPUS;
+    const auto corpus = loadCorpus(path);
+    if (corpus.empty()) {
+        std::fprintf(stderr, "No payloads in %s\n", path.c_str());
+        return 1;
+    }
+    std::printf("Corpus: %zu payloads from %s\n\n", corpus.size(), path.c_str());
+
+    InverterCommand::registerParser();
+    BatteryStateCmd::registerParser();
+
+    auto parseSax = [](auto& command, const std::string& text) {
+        ParseError error;
+        return command.tryParse(text, error) == ReturnType::OK;
+    };
+    auto parseDomAny = [](auto& command, const std::string& text) { return parseDom(command, text); };
+    const auto malformed = truncateCorpus(corpus);
+
+    run("parse/dom", corpus, parseDomAny);
+    run("parse/sax", corpus, parseSax);
+    run("parse/dom/malformed", malformed, parseDomAny);
+    run("parse/sax/malformed", malformed, parseSax);
+    return 0;
+}
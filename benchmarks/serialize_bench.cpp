@@ -0,0 +1,123 @@
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "nlohmann/json.hpp"
+#include "CommandWireFormat.h"
+#include "BenchUtils.h"
+#include "AllocationCounter.h"
+
+using BenchUtils::doNotOptimize;
+using BenchUtils::measureNs;
+using BenchUtils::report;
+
+namespace {
+
+constexpr size_t kIterations = 200000;
+
+/**
+ * @brief Struct representing one measured serializer.
+ */
+struct Sample {
+    double ns = 0.0;           ///< Nanoseconds per message
+    double allocations = 0.0;  ///< Allocations per message
+};
+
+template <typename Body>
+Sample measure(Body&& body) {
+    const uint64_t before = AllocationCounter::count();
+    for (size_t i = 0; i < 1000; ++i) {
+        body();
+    }
+    Sample sample;
+    sample.allocations = static_cast<double>(AllocationCounter::count() - before) / 1000.0;
+    sample.ns = measureNs(body, kIterations);
+    return sample;
+}
+
+void print(const std::string& name, const Sample& sample, const Sample& baseline) {
+    char detail[64];
+    std::snprintf(detail, sizeof(detail), "%5.1f allocs/msg  %6.1fx", sample.allocations, baseline.ns / sample.ns);
+    report(name, sample.ns, detail);
+}
+
+/**
+ * @brief DOM-based inverter serialization as done before the generated serializer.
+ */
+std::string inverterDom(const InverterCommand& command) {
+    nlohmann::json json;
+    json["command"] = command.getMode() == InverterCommand::Mode::Charging ? "StartCharging" : "StartDischarging";
+    json["voltage"] = command.getVoltage();
+    json["current"] = command.getCurrent();
+    return json.dump();
+}
+
+} // namespace
+
+/**
+ * @brief Compares the DOM serialization of the uplink messages against the direct serializers.
+ *
+ * The direct serializers append to a string that is cleared and reused for every message,
+ * as the uplink does. The last column is the speedup over the DOM path of the same command.
+ *
+ * @return Exit code, 1 if a direct serializer does not reproduce the DOM output.
+ */
+int main() {
+    BatteryStateCmd battery;
+    battery.setNumberOfCubes(12);
+    battery.setNumberOfReadyCubes(11);
+    battery.setVoltageMinimum(50200);
+    battery.setVoltageMaximum(51800);
+    battery.setVoltageMean(25600);
+    battery.setSocMinimum(4120);
+    battery.setSocMaximum(4480);
+    battery.setSocMean(4300);
+    battery.setCurrentMean(-35);
+    battery.setCurrentMinimum(-71);
+    battery.setCurrentMaximum(12);
+
+    InverterCommand inverter;
+    inverter.setMode(InverterCommand::Mode::Discharging);
+    inverter.setVoltage(402.75);
+    inverter.setCurrent(-31.5);
+
+    std::string out;
+    out.reserve(256);
+    battery.serializeJson(out);
+    if (out != battery.toJson().dump()) {
+        std::fprintf(stderr, "serializeJson differs from toJson().dump():\n%s\n%s\n", out.c_str(), battery.toJson().dump().c_str());
+        return 1;
+    }
+    out.clear();
+    inverter.serializeJson(out);
+    if (nlohmann::json::parse(out) != nlohmann::json::parse(inverterDom(inverter))) {
+        std::fprintf(stderr, "serializeJson differs from the DOM output: %s\n", out.c_str());
+        return 1;
+    }
+
+    uint8_t buffer[64];
+    const Sample batteryDom = measure([&] { doNotOptimize(battery.toJson().dump()); });
+    print("battery/toJson().dump()", batteryDom, batteryDom);
+    print("battery/serializeJson", measure([&] {
+        out.clear();
+        battery.serializeJson(out);
+        doNotOptimize(out.data());
+    }), batteryDom);
+    print("battery/binary", measure([&] {
+        doNotOptimize(CommandWire::encode(battery, buffer, sizeof(buffer)));
+        doNotOptimize(buffer);
+    }), batteryDom);
+
+    const Sample inverterBaseline = measure([&] { doNotOptimize(inverterDom(inverter)); });
+    print("inverter/dom-dump", inverterBaseline, inverterBaseline);
+    print("inverter/serializeJson", measure([&] {
+        out.clear();
+        inverter.serializeJson(out);
+        doNotOptimize(out.data());
+    }), inverterBaseline);
+    print("inverter/binary", measure([&] {
+        doNotOptimize(CommandWire::encode(inverter, buffer, sizeof(buffer)));
+        doNotOptimize(buffer);
+    }), inverterBaseline);
+    return 0;
+}
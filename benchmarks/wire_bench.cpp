@@ -0,0 +1,142 @@
+#include <cstdint>
+#include <string>
+
+#include "nlohmann/json.hpp"
+#include "CommandWireFormat.h"
+#include "LazyCommand.h"
+#include "BenchUtils.h"
+
+using BenchUtils::doNotOptimize;
+using BenchUtils::measureNs;
+using BenchUtils::report;
+
+namespace {
+
+constexpr size_t kIterations = 200000;
+
+std::shared_ptr<InverterCommand> makeInverter() {
+    auto command = std::make_shared<InverterCommand>();
+    command->setMode(InverterCommand::Mode::Discharging);
+    command->setVoltage(402.75);
+    command->setCurrent(-31.5);
+    return command;
+}
+
+std::shared_ptr<BatteryStateCmd> makeBattery() {
+    const uint8_t payload[BatteryStateView::kSize] = {
+        12, 11, 0x80, 0xbb, 0x68, 0xde, 0x30, 0xca, 0x20, 0x1c, 0x88, 0x1d, 0x10, 0x1d, 0, 0,
+        0x70, 0x17, 0, 0, 0x7d, 0x01, 0, 0, 0x50, 0x01, 0, 0, 0xb0, 0x01, 0, 0, 0x12, 0x00, 0x1e, 0x00};
+    return std::static_pointer_cast<BatteryStateCmd>(CommandWire::decodePayload(CommandType::Battery, payload, sizeof(payload)));
+}
+
+std::string inverterJson(const InverterCommand& command) {
+    nlohmann::json json;
+    json["command"] = command.getMode() == InverterCommand::Mode::Charging ? "StartCharging" : "StartDischarging";
+    json["voltage"] = command.getVoltage();
+    json["current"] = command.getCurrent();
+    return json.dump();
+}
+
+} // namespace
+
+/**
+ * @brief Compares the binary wire format against the nlohmann JSON path.
+ *
+ * JSON decoding is measured as parse plus field extraction, without the logging done by the
+ * hand-written parsers, so the numbers isolate the representation cost.
+ *
+ * @return Exit code.
+ */
+int main() {
+    auto inverter = makeInverter();
+    auto battery = makeBattery();
+    uint8_t buffer[64];
+
+    std::printf("Inverter: binary %zu bytes, JSON %zu bytes\n",
+                CommandWire::encode(*inverter, buffer, sizeof(buffer)), inverterJson(*inverter).size());
+    std::printf("Battery:  binary %zu bytes, JSON %zu bytes\n\n",
+                CommandWire::encode(*battery, buffer, sizeof(buffer)), battery->toJson().dump().size());
+
+    report("inverter/encode/binary", measureNs([&] {
+        doNotOptimize(CommandWire::encode(*inverter, buffer, sizeof(buffer)));
+        doNotOptimize(buffer);
+    }, kIterations));
+    report("inverter/encode/json", measureNs([&] {
+        doNotOptimize(inverterJson(*inverter));
+    }, kIterations));
+
+    const size_t inverterSize = CommandWire::encode(*inverter, buffer, sizeof(buffer));
+    const std::string inverterText = inverterJson(*inverter);
+    report("inverter/decode/binary-view", measureNs([&] {
+        WireFormat::WireHeader header;
+        InverterCommandView view;
+        WireFormat::readHeader(buffer, inverterSize, header);
+        InverterCommandView::from(buffer + WireFormat::kHeaderSize, header.payloadSize, view);
+        doNotOptimize(view.voltage() + view.current());
+    }, kIterations));
+    report("inverter/decode/binary-object", measureNs([&] {
+        doNotOptimize(CommandWire::decode(buffer, inverterSize));
+    }, kIterations));
+    report("inverter/decode/json-object", measureNs([&] {
+        auto json = nlohmann::json::parse(inverterText);
+        auto command = std::make_shared<InverterCommand>();
+        command->setMode(json["command"].get<std::string>() == "StartCharging" ? InverterCommand::Mode::Charging
+                                                                               : InverterCommand::Mode::Discharging);
+        command->setVoltage(json["voltage"].get<double>());
+        command->setCurrent(json["current"].get<double>());
+        doNotOptimize(command);
+    }, kIterations));
+
+    // Lazy commands: construction only (routed untouched), then with one field read
+    const uint8_t* inverterPayload = buffer + WireFormat::kHeaderSize;
+    const size_t inverterPayloadSize = inverterSize - WireFormat::kHeaderSize;
+    report("inverter/decode/binary-lazy-untouched", measureNs([&] {
+        doNotOptimize(LazyCommand<InverterCommand>::fromBinary(inverterPayload, inverterPayloadSize));
+    }, kIterations));
+    report("inverter/decode/binary-lazy-one-field", measureNs([&] {
+        doNotOptimize(LazyCommand<InverterCommand>::fromBinary(inverterPayload, inverterPayloadSize)->getMode());
+    }, kIterations));
+    report("inverter/decode/json-sax-object", measureNs([&] {
+        auto command = std::make_shared<InverterCommand>();
+        ParseError error;
+        doNotOptimize(command->parseJson(inverterText, error));
+    }, kIterations));
+    report("inverter/decode/json-lazy-untouched", measureNs([&] {
+        doNotOptimize(LazyCommand<InverterCommand>::fromJson(inverterText));
+    }, kIterations));
+    report("inverter/decode/json-lazy-one-field", measureNs([&] {
+        doNotOptimize(LazyCommand<InverterCommand>::fromJson(inverterText)->getMode());
+    }, kIterations));
+
+    report("battery/encode/binary", measureNs([&] {
+        doNotOptimize(CommandWire::encode(*battery, buffer, sizeof(buffer)));
+        doNotOptimize(buffer);
+    }, kIterations));
+    report("battery/encode/json", measureNs([&] {
+        doNotOptimize(battery->toJson().dump());
+    }, kIterations));
+
+    const size_t batterySize = CommandWire::encode(*battery, buffer, sizeof(buffer));
+    const std::string batteryText = battery->toJson().dump();
+    report("battery/decode/binary-view", measureNs([&] {
+        WireFormat::WireHeader header;
+        BatteryStateView view;
+        WireFormat::readHeader(buffer, batterySize, header);
+        BatteryStateView::from(buffer + WireFormat::kHeaderSize, header.payloadSize, view);
+        doNotOptimize(view.socMean() + view.voltageMinimum() + view.currentMean());
+    }, kIterations));
+    report("battery/decode/binary-object", measureNs([&] {
+        doNotOptimize(CommandWire::decode(buffer, batterySize));
+    }, kIterations));
+    report("battery/decode/json-object", measureNs([&] {
+        auto json = nlohmann::json::parse(batteryText);
+        auto command = std::make_shared<BatteryStateCmd>();
+        command->setNumberOfCubes(json["Cube_Num"].get<uint8_t>());
+        command->setNumberOfReadyCubes(json["Cube_OP"].get<uint8_t>());
+        command->setVoltageMinimum(json["Voltage"]["MIN"].get<uint16_t>());
+        command->setVoltageMaximum(json["Voltage"]["MAX"].get<uint16_t>());
+        command->setSocMean(json["SOC"]["AVG"].get<uint32_t>());
+        doNotOptimize(command);
+    }, kIterations));
+    return 0;
+}
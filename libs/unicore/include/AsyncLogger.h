@@ -0,0 +1,169 @@
+#ifndef ASYNC_LOGGER_H
+#define ASYNC_LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ILogger.h"
+
+/**
+ * @brief ILogger that moves formatting and output off the calling threads.
+ *
+ * Each producer thread owns a single-producer ring of fixed-size records, so logging is a
+ * CPU counter read, a copy into the ring and a release store: no lock, no allocation for messages
+ * up to kInlineText bytes, no system call. A background thread drains all rings in time
+ * order and writes each batch with one call per stream, or forwards the messages to a
+ * downstream ILogger such as SpdLogWrapper.
+ *
+ * When a ring is full, info and warning messages are dropped and counted; the count is
+ * logged as a warning once space frees up. Error and critical messages wait for space and
+ * wake the background thread, and critical() returns only once the message is written,
+ * since ErrorHandler terminates right after it.
+ */
+class AsyncLogger : public ILogger {
+public:
+    static constexpr size_t kInlineText = 232;  ///< Message bytes stored in the ring, longer ones are allocated
+
+    /**
+     * @brief Constructor writing to the console like StdCoutLogger, or to a downstream logger.
+     *
+     * @param[in] sink Downstream logger called from the background thread, nullptr for the console.
+     * @param[in] ringCapacity Records per producer thread, rounded up to a power of two.
+     * @param[in] flushInterval Longest time a message waits before it is written.
+     */
+    explicit AsyncLogger(std::shared_ptr<ILogger> sink = nullptr, size_t ringCapacity = 1024,
+                         std::chrono::milliseconds flushInterval = std::chrono::milliseconds(5));
+
+    /**
+     * @brief Constructor writing the "[LEVEL]: message" lines to two streams.
+     *
+     * @param[in] out Stream of the info and warning messages.
+     * @param[in] err Stream of the error and critical messages.
+     * @param[in] ringCapacity Records per producer thread, rounded up to a power of two.
+     * @param[in] flushInterval Longest time a message waits before it is written.
+     */
+    AsyncLogger(std::FILE* out, std::FILE* err, size_t ringCapacity = 1024,
+                std::chrono::milliseconds flushInterval = std::chrono::milliseconds(5));
+
+    /**
+     * @brief Destructor writing all pending messages and stopping the background thread.
+     */
+    ~AsyncLogger() override;
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    /**
+     * @brief Log a debug message.
+     *
+     * @param[in] message The message to log.
+     */
+    void debug(const std::string& message) override;
+
+    /**
+     * @brief Log an informational message.
+     *
+     * @param[in] message The message to log.
+     */
+    void info(const std::string& message) override;
+
+    /**
+     * @brief Log a warning message.
+     *
+     * @param[in] message The message to log.
+     */
+    void warn(const std::string& message) override;
+
+    /**
+     * @brief Log an error message.
+     *
+     * @param[in] message The message to log.
+     */
+    void error(const std::string& message) override;
+
+    /**
+     * @brief Log a critical error message and wait until it is written.
+     *
+     * @param[in] message The message to log.
+     */
+    void critical(const std::string& message) override;
+
+    /**
+     * @brief Sets the lowest level that is logged, here and in the downstream logger.
+     *
+     * @param[in] level The level, LogLevel::Off disables logging.
+     */
+    void setLevel(LogLevel level) override;
+
+    /**
+     * @brief Waits until every message logged before the call is written.
+     */
+    void flush();
+
+    /**
+     * @brief Getter for the number of dropped messages.
+     * @return Messages dropped because a ring was full, since construction.
+     */
+    uint64_t dropped() const { return droppedTotal_.load(std::memory_order_relaxed); }
+
+private:
+    struct Ring;
+
+    /**
+     * @brief Enumeration representing the severity of a record.
+     */
+    enum class Level : uint8_t { Debug, Info, Warn, Error, Critical };
+
+    /**
+     * @brief Stores a message in the calling thread's ring.
+     *
+     * @param[in] level Severity of the message.
+     * @param[in] message The message to log.
+     * @return True if stored, false if dropped.
+     */
+    bool push(Level level, const std::string& message);
+
+    /**
+     * @brief Getter for the calling thread's ring, registering it on first use.
+     * @return The ring of the calling thread.
+     */
+    Ring& localRing();
+
+    /**
+     * @brief Background loop.
+     */
+    void run();
+
+    /**
+     * @brief Writes every record currently in the rings.
+     */
+    void drain();
+
+    std::shared_ptr<ILogger> sink_;                    ///< Downstream logger, nullptr for the streams
+    std::FILE* out_;                                   ///< Info and warning stream
+    std::FILE* err_;                                   ///< Error and critical stream
+    size_t ringCapacity_;                              ///< Records per ring, a power of two
+    std::chrono::milliseconds flushInterval_;          ///< Background wake-up interval
+    uint64_t id_;                                      ///< Process-wide unique instance id
+    std::mutex mutex_;                                 ///< Guards the fields below and the waits
+    std::vector<std::shared_ptr<Ring>> rings_;         ///< Rings of all producer threads
+    std::condition_variable wake_;                     ///< Wakes the background thread
+    std::condition_variable flushed_;                  ///< Signals completed drains
+    uint64_t flushRequested_ = 0;                      ///< Last requested drain
+    uint64_t flushDone_ = 0;                           ///< Last completed drain
+    bool urgent_ = false;                              ///< An error is waiting to be written
+    bool stopping_ = false;                            ///< Set to stop the background thread
+    std::atomic<uint64_t> droppedTotal_{0};            ///< Dropped messages since construction
+    std::thread worker_;                               ///< Background thread
+};
+
+#endif // ASYNC_LOGGER_H
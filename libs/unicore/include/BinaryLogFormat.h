@@ -0,0 +1,253 @@
+#ifndef BINARY_LOG_FORMAT_H
+#define BINARY_LOG_FORMAT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <type_traits>
+
+/**
+ * @brief Binary log encoding shared by BinaryLogger and BinaryLogReader.
+ *
+ * Every VBUS_LOG_* call site owns a static Site. The first time it logs, the site receives a
+ * process-wide id and its level, file, line, format and argument signature are recorded once
+ * in the log. From then on a record only holds the site id, a time delta and the raw
+ * argument values; the text is rebuilt on the host.
+ *
+ * File layout, integers little endian:
+ * - header: magic "VBLG", version (u8), wall clock ns (u64) and steady clock ns (u64) at open;
+ * - chunks: type (u8), payload length (u32), payload.
+ *
+ * Chunk payloads:
+ * - Site: id, level, line (varints), then file, format and signature (varint length + bytes);
+ * - Records: steady clock ns of the block start (u64), then records of site id (varint),
+ *   ns since the previous record (varint) and the arguments;
+ * - Dropped: number of records lost because no block was free (varint).
+ *
+ * Argument encoding by signature character: 'i' zigzag varint, 'u' and 'p' varint, 'f' IEEE
+ * float (u32), 'd' IEEE double (u64), 'b' and 'c' one byte, 's' varint length + bytes.
+ */
+namespace BinaryLogFormat {
+
+constexpr char kMagic[4] = {'V', 'B', 'L', 'G'};  ///< File magic
+constexpr uint8_t kVersion = 1;                    ///< Format version
+constexpr size_t kHeaderSize = 4 + 1 + 8 + 8;      ///< File header size
+constexpr size_t kChunkHeaderSize = 1 + 4;         ///< Chunk type and length
+constexpr size_t kMaxVarint = 10;                  ///< Longest varint
+
+/**
+ * @brief Enumeration representing chunk types.
+ */
+enum class ChunkType : uint8_t {
+    Site = 1,
+    Records = 2,
+    Dropped = 3
+};
+
+/**
+ * @brief Struct representing a logging call site, one static instance per VBUS_LOG_* use.
+ */
+struct Site {
+    /**
+     * @brief Constructor, constant-initialized so a static Site costs no guard.
+     *
+     * @param[in] level LogLevel of the call site.
+     * @param[in] file Source file.
+     * @param[in] line Source line.
+     */
+    constexpr Site(int level, const char* file, int line) : level(level), file(file), line(line) {}
+
+    const int level;             ///< LogLevel of the call site
+    const char* const file;      ///< Source file
+    const int line;              ///< Source line
+    std::atomic<uint32_t> id{0}; ///< Process-wide id, 0 until the first record
+};
+
+/**
+ * @brief Assigns the id of a call site on its first record.
+ *
+ * @param[in,out] site The call site.
+ * @param[in] format Format of the call site, must stay valid for the process lifetime.
+ * @param[in] signature Argument signature, one character per argument.
+ * @return The id of the site.
+ */
+uint32_t registerSite(Site& site, const char* format, const char* signature);
+
+inline void putVarint(char*& out, uint64_t value) {
+    while (value >= 0x80) {
+        *out++ = static_cast<char>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<char>(value);
+}
+
+inline void putFixed64(char*& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        *out++ = static_cast<char>(value >> (8 * i));
+    }
+}
+
+inline void putBytes(char*& out, const char* data, size_t size) {
+    putVarint(out, size);
+    std::memcpy(out, data, size);
+    out += size;
+}
+
+/**
+ * @brief Encoding of one argument type, see the signature characters above.
+ */
+template <typename T, typename Enable = void>
+struct Arg;
+
+template <>
+struct Arg<bool> {
+    static constexpr char kTag = 'b';
+    static size_t maxSize(bool) { return 1; }
+    static void encode(char*& out, bool value) { *out++ = value ? 1 : 0; }
+};
+
+template <>
+struct Arg<char> {
+    static constexpr char kTag = 'c';
+    static size_t maxSize(char) { return 1; }
+    static void encode(char*& out, char value) { *out++ = value; }
+};
+
+template <typename T>
+struct Arg<T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value && !std::is_same<T, char>::value>::type> {
+    static constexpr char kTag = 'i';
+    static size_t maxSize(T) { return kMaxVarint; }
+    static void encode(char*& out, T value) {
+        const int64_t wide = value;
+        putVarint(out, (static_cast<uint64_t>(wide) << 1) ^ static_cast<uint64_t>(wide >> 63));
+    }
+};
+
+template <typename T>
+struct Arg<T, typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value && !std::is_same<T, bool>::value &&
+                                      !std::is_same<T, char>::value>::type> {
+    static constexpr char kTag = 'u';
+    static size_t maxSize(T) { return kMaxVarint; }
+    static void encode(char*& out, T value) { putVarint(out, value); }
+};
+
+template <>
+struct Arg<float> {
+    static constexpr char kTag = 'f';
+    static size_t maxSize(float) { return 4; }
+    static void encode(char*& out, float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int i = 0; i < 4; ++i) {
+            *out++ = static_cast<char>(bits >> (8 * i));
+        }
+    }
+};
+
+template <typename T>
+struct Arg<T, typename std::enable_if<std::is_floating_point<T>::value && !std::is_same<T, float>::value>::type> {
+    static constexpr char kTag = 'd';
+    static size_t maxSize(T) { return 8; }
+    static void encode(char*& out, T value) {
+        const double wide = static_cast<double>(value);
+        uint64_t bits;
+        std::memcpy(&bits, &wide, sizeof(bits));
+        putFixed64(out, bits);
+    }
+};
+
+template <typename T>
+struct Arg<T, typename std::enable_if<std::is_enum<T>::value>::type> {
+    using Underlying = typename std::underlying_type<T>::type;
+    static constexpr char kTag = Arg<Underlying>::kTag;
+    static size_t maxSize(T) { return kMaxVarint; }
+    static void encode(char*& out, T value) { Arg<Underlying>::encode(out, static_cast<Underlying>(value)); }
+};
+
+template <>
+struct Arg<std::string> {
+    static constexpr char kTag = 's';
+    static size_t maxSize(const std::string& value) { return kMaxVarint + value.size(); }
+    static void encode(char*& out, const std::string& value) { putBytes(out, value.data(), value.size()); }
+};
+
+template <>
+struct Arg<const char*> {
+    static constexpr char kTag = 's';
+    // A null string is written as "(null)", like LogFormat::appendArg()
+    static const char* text(const char* value) { return value ? value : "(null)"; }
+    static size_t maxSize(const char* value) { return kMaxVarint + std::strlen(text(value)); }
+    static void encode(char*& out, const char* value) { putBytes(out, text(value), std::strlen(text(value))); }
+};
+
+template <>
+struct Arg<char*> : Arg<const char*> {};
+
+template <typename T>
+struct Arg<T*, typename std::enable_if<!std::is_same<typename std::remove_cv<T>::type, char>::value>::type> {
+    static constexpr char kTag = 'p';
+    static size_t maxSize(const T*) { return kMaxVarint; }
+    static void encode(char*& out, const T* value) { putVarint(out, reinterpret_cast<uintptr_t>(value)); }
+};
+
+/**
+ * @brief Encoding of an argument as passed to the macros, arrays decay to pointers.
+ */
+template <typename T>
+using ArgOf = Arg<typename std::decay<T>::type>;
+
+/**
+ * @brief Destination of binary records.
+ */
+class Sink {
+public:
+    virtual ~Sink() = default;
+
+    /**
+     * @brief Writes one record.
+     *
+     * @param[in,out] site The call site, registered on its first record.
+     * @param[in] format Format of the call site, a string literal.
+     * @param[in] args Values of the placeholders.
+     */
+    template <typename... Args>
+    void write(Site& site, const char* format, const Args&... args) {
+        uint32_t id = site.id.load(std::memory_order_acquire);
+        if (id == 0) {
+            static constexpr char kSignature[] = {ArgOf<Args>::kTag..., '\0'};
+            id = registerSite(site, format, kSignature);
+        }
+        size_t maxSize = 2 * kMaxVarint;
+        (void)std::initializer_list<int>{(maxSize += ArgOf<Args>::maxSize(args), 0)...};
+        char* out = beginRecord(id, maxSize);
+        if (!out) {
+            return;
+        }
+        (void)std::initializer_list<int>{(ArgOf<Args>::encode(out, args), 0)...};
+        endRecord(out);
+    }
+
+protected:
+    /**
+     * @brief Starts a record, locking the sink on success.
+     *
+     * @param[in] siteId Id of the call site, written by the sink with the time delta.
+     * @param[in] maxSize Upper bound of the record size.
+     * @return Where to encode the arguments, nullptr if the record is dropped.
+     */
+    virtual char* beginRecord(uint32_t siteId, size_t maxSize) = 0;
+
+    /**
+     * @brief Completes the record started by beginRecord() and unlocks the sink.
+     *
+     * @param[in] end End of the encoded arguments.
+     */
+    virtual void endRecord(char* end) = 0;
+};
+
+} // namespace BinaryLogFormat
+
+#endif // BINARY_LOG_FORMAT_H
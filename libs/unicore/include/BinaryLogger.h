@@ -0,0 +1,248 @@
+#ifndef BINARY_LOGGER_H
+#define BINARY_LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BinaryLogFormat.h"
+#include "ILogger.h"
+#include "ReturnType.h"
+
+/**
+ * @brief ILogger writing the compact binary format of BinaryLogFormat to a file.
+ *
+ * VBUS_LOG_* call sites write their raw arguments into a preallocated block owned by the
+ * calling thread, so threads logging concurrently do not wait for each other; nothing is
+ * formatted and nothing is allocated on the device after the first record of a thread. Full
+ * blocks, and the partial blocks every flush interval, are written by a background thread
+ * together with the definitions of the call sites seen since the previous write. Messages
+ * passed as text through info() and the other members are stored as a string argument.
+ *
+ * When every block is waiting to be written or held by another thread, records are dropped
+ * and counted; the count is written as a Dropped chunk. critical() returns only once the record is on disk.
+ * Decode the file with BinaryLogReader or `blog_decode`.
+ */
+class BinaryLogger : public ILogger, public BinaryLogFormat::Sink {
+public:
+    /**
+     * @brief Constructor for BinaryLogger.
+     *
+     * @param[in] path Log file; it is created or overwritten.
+     * @param[in] blockSize Bytes per block, also the largest record.
+     * @param[in] blockCount Number of preallocated blocks, at least 2.
+     * @param[in] flushInterval Longest time a record waits before it is written.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     */
+    explicit BinaryLogger(const std::string& path, size_t blockSize = 64 * 1024, size_t blockCount = 4,
+                          std::chrono::milliseconds flushInterval = std::chrono::milliseconds(1000),
+                          std::shared_ptr<ILogger> logger = nullptr);
+
+    /**
+     * @brief Destructor writing all pending records and closing the file.
+     */
+    ~BinaryLogger() override;
+
+    BinaryLogger(const BinaryLogger&) = delete;
+    BinaryLogger& operator=(const BinaryLogger&) = delete;
+
+    /**
+     * @brief Checks whether the file could be opened.
+     * @return True if records are written.
+     */
+    bool isOpen() const { return file_ != nullptr; }
+
+    /**
+     * @brief Log a debug message.
+     *
+     * @param[in] message The message to log.
+     */
+    void debug(const std::string& message) override;
+
+    /**
+     * @brief Log an informational message.
+     *
+     * @param[in] message The message to log.
+     */
+    void info(const std::string& message) override;
+
+    /**
+     * @brief Log a warning message.
+     *
+     * @param[in] message The message to log.
+     */
+    void warn(const std::string& message) override;
+
+    /**
+     * @brief Log an error message.
+     *
+     * @param[in] message The message to log.
+     */
+    void error(const std::string& message) override;
+
+    /**
+     * @brief Log a critical error message and wait until it is written.
+     *
+     * @param[in] message The message to log.
+     */
+    void critical(const std::string& message) override;
+
+    /**
+     * @brief Getter for the binary sink used by the VBUS_LOG_* macros.
+     * @return This logger, nullptr if the file could not be opened.
+     */
+    BinaryLogFormat::Sink* binarySink() override { return file_ ? this : nullptr; }
+
+    /**
+     * @brief Waits until every record logged before the call is written.
+     */
+    void flush();
+
+    /**
+     * @brief Getter for the number of dropped records.
+     * @return Records dropped because no block was free, since construction.
+     */
+    uint64_t dropped() const { return droppedTotal_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Getter for the file size.
+     * @return Bytes written to the file so far.
+     */
+    uint64_t bytesWritten() const { return bytesWritten_.load(std::memory_order_relaxed); }
+
+protected:
+    char* beginRecord(uint32_t siteId, size_t maxSize) override;
+    void endRecord(char* end) override;
+
+private:
+    /**
+     * @brief Struct representing a block handed to the background thread.
+     */
+    struct Filled {
+        size_t block;   ///< Block index
+        size_t size;    ///< Used bytes
+    };
+
+    /**
+     * @brief Struct representing the block being filled by one thread.
+     */
+    struct Lane {
+        std::mutex mutex;            ///< Guards the fields below, only contended by the background thread
+        std::thread::id thread;      ///< Thread filling the block
+        size_t block = SIZE_MAX;     ///< Block being filled, SIZE_MAX if none
+        size_t used = 0;             ///< Used bytes of the block
+        uint64_t lastNs = 0;         ///< Steady clock of the previous record in the block
+    };
+
+    /**
+     * @brief Finds or creates the lane of the calling thread.
+     * @return The lane, valid until the logger is destroyed.
+     */
+    Lane* threadLane();
+
+    /**
+     * @brief Writes a text message through the built-in site of its level.
+     *
+     * @param[in] level Level of the message.
+     * @param[in] message The message to log.
+     */
+    void logText(LogLevel level, const std::string& message);
+
+    /**
+     * @brief Hands the block of a lane to the background thread. Requires lane.mutex and mutex_.
+     *
+     * @param[in,out] lane The lane.
+     */
+    void retireLane(Lane& lane);
+
+    /**
+     * @brief Hands the partial blocks of all lanes to the background thread.
+     *
+     * @param[in,out] lock Lock of mutex_, released while the lanes are locked.
+     * @param[out] lanes Scratch list of the lanes.
+     */
+    void retireLanes(std::unique_lock<std::mutex>& lock, std::vector<Lane*>& lanes);
+
+    /**
+     * @brief Background loop.
+     */
+    void run();
+
+    /**
+     * @brief Writes a chunk to the file. Called by the background thread only.
+     *
+     * @param[in] type Chunk type.
+     * @param[in] payload Chunk payload.
+     * @param[in] size Payload size.
+     */
+    void writeChunk(BinaryLogFormat::ChunkType type, const char* payload, size_t size);
+
+    /**
+     * @brief Writes the definitions of the sites registered since the last call.
+     */
+    void writeNewSites();
+
+    std::shared_ptr<ILogger> logger_;                  ///< Logger instance for logging messages
+    std::FILE* file_ = nullptr;                        ///< Log file
+    size_t blockSize_;                                 ///< Bytes per block
+    std::chrono::milliseconds flushInterval_;          ///< Background wake-up interval
+    std::vector<std::vector<char>> blocks_;            ///< Preallocated blocks
+    const uint64_t instance_;                          ///< Unique id of the logger, keys the lane cache of threads
+    std::mutex mutex_;                                 ///< Guards the fields below
+    std::vector<size_t> free_;                         ///< Blocks ready to be filled
+    std::vector<Filled> filled_;                       ///< Blocks waiting to be written, oldest first
+    std::vector<std::unique_ptr<Lane>> lanes_;         ///< One per thread that logged, never removed
+    uint64_t droppedPending_ = 0;                      ///< Dropped records not yet written
+    uint64_t flushRequested_ = 0;                      ///< Last requested flush
+    uint64_t flushDone_ = 0;                           ///< Last completed flush
+    bool stopping_ = false;                            ///< Set to stop the background thread
+    std::condition_variable wake_;                     ///< Wakes the background thread
+    std::condition_variable written_;                  ///< Signals written blocks
+    uint32_t sitesWritten_ = 0;                        ///< Sites already defined in the file
+    std::vector<char> scratch_;                        ///< Chunk encoding buffer of the background thread
+    std::atomic<uint64_t> droppedTotal_{0};            ///< Dropped records since construction
+    std::atomic<uint64_t> bytesWritten_{0};            ///< File size
+    std::thread worker_;                               ///< Background thread
+};
+
+/**
+ * @brief Class decoding a binary log file back to text.
+ */
+class BinaryLogReader {
+public:
+    /**
+     * @brief Struct representing a decoded record.
+     */
+    struct Entry {
+        uint64_t wallClockNs = 0;          ///< System clock time of the record
+        LogLevel level = LogLevel::Info;   ///< Level of the call site
+        std::string file;                  ///< Source file of the call site, empty for text messages
+        int line = 0;                      ///< Source line of the call site
+        std::string text;                  ///< Formatted message
+    };
+
+    /**
+     * @brief Loads and formats all records, sorted by time.
+     *
+     * Blocks of different threads are interleaved in the file, so the records are sorted by
+     * their time stamp; records of equal time keep their file order. A truncated last chunk,
+     * as left by a crash, ends the log without an error. Dropped records are reported as a
+     * warning entry.
+     *
+     * @param[in] path Binary log file.
+     * @param[out] entries Decoded records, oldest first.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     * @return OK, NOT_FOUND if the file cannot be opened, ERROR if it is not a binary log.
+     */
+    static ReturnType load(const std::string& path, std::vector<Entry>& entries, std::shared_ptr<ILogger> logger = nullptr);
+};
+
+#endif // BINARY_LOGGER_H
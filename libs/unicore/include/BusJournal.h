@@ -0,0 +1,206 @@
+#ifndef BUS_JOURNAL_H
+#define BUS_JOURNAL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "IBusObserver.h"
+#include "IBusMessageCodec.h"
+#include "ReturnType.h"
+#include "ILogger.h"
+
+/**
+ * @brief On-disk layout of the bus journal.
+ *
+ * A journal is a directory of segment files `journal-NNNNNN.vbj`. Every segment starts with a
+ * SegmentHeader followed by 8-byte aligned records. A record is a RecordHeader followed by
+ * the encoded payload; its `size` field is written last, so a zero `size` marks the end of
+ * the valid data even after a crash.
+ */
+namespace BusJournalFormat {
+
+constexpr char kMagic[4] = {'V', 'B', 'J', '1'};
+constexpr uint32_t kVersion = 1;
+
+/**
+ * @brief Header at the start of every segment file.
+ */
+struct SegmentHeader {
+    char magic[4];             ///< kMagic
+    uint32_t version;          ///< kVersion
+    uint32_t segmentIndex;     ///< Position of the segment in the journal
+    uint32_t headerSize;       ///< sizeof(SegmentHeader)
+    uint64_t wallClockNs;      ///< System clock when the journal was opened, for correlating with logs
+    uint64_t capacity;         ///< Size of the segment file in bytes
+    uint8_t reserved[32];      ///< Reserved, zero
+};
+
+/**
+ * @brief Header of every journal record.
+ */
+struct RecordHeader {
+    uint32_t size;             ///< Total record size including header and padding, 0 for end of data
+    uint32_t payloadSize;      ///< Bytes of encoded payload following the header
+    uint64_t timestampNs;      ///< Publish time in steady clock nanoseconds since the journal was opened
+    int32_t senderId;          ///< Sender task identifier
+    uint16_t type;             ///< CommandType of the message
+    uint16_t reserved;         ///< Reserved, zero
+};
+
+static_assert(sizeof(SegmentHeader) == 64, "SegmentHeader layout changed");
+static_assert(sizeof(RecordHeader) == 24, "RecordHeader layout changed");
+
+} // namespace BusJournalFormat
+
+/**
+ * @brief Class recording every message published on the virtual bus into memory-mapped segments.
+ *
+ * Attach it with VirtualBus::addObserver(). Each message is encoded straight into the mapped
+ * segment, so recording costs one encode and a few stores; the kernel writes the pages back
+ * in the background and the data survives a crash of the process. A background thread
+ * creates, maps and prefaults the next segment ahead of time and closes full ones, so a
+ * rollover inside onPublish() only swaps two mappings.
+ */
+class BusJournal : public IBusObserver {
+public:
+    /**
+     * @brief Constructor for BusJournal.
+     *
+     * Segment files left in the directory by an earlier run are replaced, so give every run
+     * its own directory when older journals must be kept.
+     *
+     * @param[in] directory Directory the segment files are written to; it is created if missing.
+     * @param[in] codec Codec used to encode message payloads.
+     * @param[in] segmentSize Size of each segment file in bytes.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     */
+    BusJournal(const std::string& directory, std::shared_ptr<IBusMessageCodec> codec,
+               size_t segmentSize = 64 * 1024 * 1024, std::shared_ptr<ILogger> logger = nullptr);
+
+    /**
+     * @brief Destructor that stops the background thread, trims and closes the current segment.
+     */
+    ~BusJournal() override;
+
+    BusJournal(const BusJournal&) = delete;
+    BusJournal& operator=(const BusJournal&) = delete;
+
+    /**
+     * @brief Checks whether the journal could be opened.
+     * @return True if records can be appended.
+     */
+    bool isOpen() const { return base_ != nullptr; }
+
+    /**
+     * @brief Appends a published message to the journal.
+     *
+     * @param[in] senderId The identifier of the sender.
+     * @param[in] message The published message.
+     */
+    void onPublish(int senderId, const std::shared_ptr<VirtualBusCmd>& message) override;
+
+    /**
+     * @brief Appends a message with an explicit timestamp.
+     *
+     * @param[in] senderId The identifier of the sender.
+     * @param[in] message The message to record.
+     * @param[in] timestampNs Steady clock nanoseconds since the journal was opened.
+     * @return OK, or ERROR if the journal is closed or a new segment cannot be created.
+     */
+    ReturnType append(int senderId, const VirtualBusCmd& message, uint64_t timestampNs);
+
+    /**
+     * @brief Getter for the number of recorded messages.
+     * @return Recorded message count.
+     */
+    uint64_t getRecordCount() const { return records_.load(std::memory_order_relaxed); }
+
+private:
+    /**
+     * @brief Struct representing one mapped segment file.
+     */
+    struct Segment {
+        int fd = -1;                  ///< Descriptor of the segment file
+        uint8_t* base = nullptr;      ///< Mapping of the segment
+        uint32_t index = 0;           ///< Index of the segment
+        size_t used = 0;              ///< Bytes written, the file is trimmed to this length on close
+    };
+
+    bool openSegment(uint32_t index, Segment& segment);
+    void closeSegment(Segment& segment);
+    bool rollover();
+    void prepare();
+
+    std::string directory_;                       ///< Journal directory
+    std::shared_ptr<IBusMessageCodec> codec_;     ///< Payload codec
+    size_t segmentSize_;                          ///< Size of each segment file
+    std::shared_ptr<ILogger> logger_;             ///< Logger instance for logging messages
+
+    std::mutex mutex_;                            ///< Serializes appends and segment rollover
+    int fd_ = -1;                                 ///< Descriptor of the current segment
+    uint8_t* base_ = nullptr;                     ///< Mapping of the current segment
+    size_t offset_ = 0;                           ///< Write position inside the current segment
+    uint32_t segmentIndex_ = 0;                   ///< Index of the current segment
+
+    std::mutex prepareMutex_;                     ///< Guards the members below, shared with the preparer thread
+    std::condition_variable prepareCondition_;    ///< Signalled when a segment is ready, retired or the journal stops
+    Segment spare_;                               ///< Next segment, mapped and prefaulted; base is null while pending
+    bool prepareFailed_ = false;                  ///< The next segment could not be created
+    std::vector<Segment> retired_;                ///< Full segments waiting to be trimmed and closed
+    bool stopping_ = false;                       ///< Set by the destructor to end the preparer thread
+    std::thread preparer_;                        ///< Creates the next segment and closes retired ones
+    uint64_t wallClockNs_ = 0;                    ///< System clock at open
+    std::chrono::steady_clock::time_point start_; ///< Steady clock at open, origin of record timestamps
+    std::atomic<uint64_t> records_{0};            ///< Number of recorded messages
+};
+
+/**
+ * @brief Class iterating over the records of a journal directory.
+ */
+class BusJournalReader {
+public:
+    /**
+     * @brief Callback receiving each record; return false to stop reading.
+     */
+    using RecordCallback = std::function<bool(const BusJournalFormat::RecordHeader& header, const uint8_t* payload)>;
+
+    /**
+     * @brief Constructor for BusJournalReader.
+     *
+     * @param[in] directory Journal directory.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     */
+    explicit BusJournalReader(const std::string& directory, std::shared_ptr<ILogger> logger = nullptr)
+        : directory_(directory), logger_(logger) {}
+
+    /**
+     * @brief Reads every record of every segment in order.
+     *
+     * @param[in] callback Callback receiving each record.
+     * @return OK, NOT_FOUND if the directory holds no segments, ERROR if a segment is corrupt.
+     */
+    ReturnType forEach(const RecordCallback& callback) const;
+
+    /**
+     * @brief Lists the segment files of a journal directory in order.
+     *
+     * @param[in] directory Journal directory.
+     * @return Paths of the segment files.
+     */
+    static std::vector<std::string> listSegments(const std::string& directory);
+
+private:
+    std::string directory_;              ///< Journal directory
+    std::shared_ptr<ILogger> logger_;    ///< Logger instance for logging messages
+};
+
+#endif // BUS_JOURNAL_H
@@ -0,0 +1,226 @@
+#ifndef BUS_METRICS_H
+#define BUS_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <sched.h>
+
+#include "VirtualBusCmd.h"
+
+/**
+ * @brief Monotonic counter split into per-CPU cells on separate cache lines.
+ *
+ * Threads add to the cell of the CPU they run on, so concurrent publishers on different
+ * cores do not bounce a shared cache line. Reading sums all cells and may miss additions
+ * that are in flight.
+ */
+class ShardedCounter {
+public:
+    static constexpr size_t kShards = 16;  ///< Number of cells, CPUs beyond that share cells
+
+    /**
+     * @brief Adds to the counter.
+     *
+     * @param[in] amount Value to add.
+     */
+    void add(uint64_t amount = 1) { add(amount, shardIndex()); }
+
+    /**
+     * @brief Adds to the counter using a cell index obtained once for several counters.
+     *
+     * @param[in] amount Value to add.
+     * @param[in] shard Cell index from shardIndex().
+     */
+    void add(uint64_t amount, size_t shard) { cells_[shard].value.fetch_add(amount, std::memory_order_relaxed); }
+
+    /**
+     * @brief Sums all cells.
+     * @return Current counter value.
+     */
+    uint64_t load() const {
+        uint64_t total = 0;
+        for (const auto& cell : cells_) {
+            total += cell.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    /**
+     * @brief Cell index of the calling thread, its current CPU or a thread hash.
+     * @return Index below kShards.
+     */
+    static size_t shardIndex() {
+        const int cpu = ::sched_getcpu();
+        if (cpu >= 0) {
+            return static_cast<size_t>(cpu) % kShards;
+        }
+        return std::hash<std::thread::id>()(std::this_thread::get_id()) % kShards;
+    }
+
+private:
+    /**
+     * @brief Struct representing one counter cell, alone on its cache line.
+     */
+    struct alignas(64) Cell {
+        std::atomic<uint64_t> value{0};  ///< Partial count
+    };
+
+    std::array<Cell, kShards> cells_{};  ///< Per-CPU partial counts
+};
+
+/**
+ * @brief Message counters of a VirtualBus, per task and per CommandType.
+ *
+ * The bus updates the counters on its publish and delivery paths. Collection only takes
+ * the metrics' own lock, which guards the task table, and never the bus lock, so scraping
+ * cannot stall publishers.
+ */
+class BusMetrics {
+public:
+    static constexpr size_t kTypeCount = static_cast<size_t>(CommandType::Diagnostic) + 1; ///< Number of command types
+
+    /**
+     * @brief Struct representing the counters of one attached task.
+     */
+    struct TaskCounters {
+        int taskId = 0;                           ///< The identifier of the task
+        std::string name;                         ///< The name of the task
+        ShardedCounter published;                 ///< Messages the task sent
+        ShardedCounter publishedBytes;            ///< Payload bytes the task sent
+        ShardedCounter delivered;                 ///< Messages handed to the task's queue reader or callback
+        ShardedCounter deliveredBytes;            ///< Payload bytes handed to the task
+        ShardedCounter dropped;                   ///< Messages discarded from the task's queue
+        std::atomic<uint64_t> queueDepth{0};      ///< Messages currently queued for the task
+        std::atomic<uint64_t> queueDepthMax{0};   ///< High-water mark of queueDepth
+
+        /**
+         * @brief Updates the queue depth gauge and its high-water mark.
+         *
+         * @param[in] depth Current queue size.
+         */
+        void setQueueDepth(size_t depth) {
+            // Only called under the bus lock, so plain stores suffice
+            queueDepth.store(depth, std::memory_order_relaxed);
+            if (depth > queueDepthMax.load(std::memory_order_relaxed)) {
+                queueDepthMax.store(depth, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    /**
+     * @brief Struct representing the counters of one command type.
+     */
+    struct TypeCounters {
+        ShardedCounter published;   ///< Messages published
+        ShardedCounter delivered;   ///< Deliveries to subscribers
+        ShardedCounter dropped;     ///< Messages discarded, including publishes from unknown senders
+        ShardedCounter bytes;       ///< Payload bytes published
+    };
+
+    /**
+     * @brief Creates the counters of a newly attached task.
+     *
+     * @param[in] taskId The identifier of the task.
+     * @param[in] name The name of the task.
+     * @return Counters the bus keeps with the task.
+     */
+    std::shared_ptr<TaskCounters> addTask(int taskId, const std::string& name);
+
+    /**
+     * @brief Stops exporting the counters of a detached task.
+     *
+     * @param[in] taskId The identifier of the task.
+     */
+    void removeTask(int taskId);
+
+    /**
+     * @brief Getter for the counters of a command type.
+     *
+     * @param[in] type The command type.
+     * @return Counters of the type.
+     */
+    TypeCounters& type(CommandType type) { return types_[typeIndex(type)]; }
+
+    /**
+     * @brief Counts a published message.
+     *
+     * @param[in] sender Counters of the sender.
+     * @param[in] message The published message.
+     */
+    void recordPublish(TaskCounters& sender, const VirtualBusCmd& message) {
+        const size_t shard = ShardedCounter::shardIndex();
+        const size_t bytes = message.payloadSize();
+        TypeCounters& counters = type(message.getType());
+        sender.published.add(1, shard);
+        counters.published.add(1, shard);
+        if (bytes != 0) {
+            sender.publishedBytes.add(bytes, shard);
+            counters.bytes.add(bytes, shard);
+        }
+    }
+
+    /**
+     * @brief Counts a message handed to a subscriber.
+     *
+     * @param[in] receiver Counters of the subscriber.
+     * @param[in] message The delivered message.
+     */
+    void recordDelivery(TaskCounters& receiver, const VirtualBusCmd& message) {
+        const size_t shard = ShardedCounter::shardIndex();
+        const size_t bytes = message.payloadSize();
+        receiver.delivered.add(1, shard);
+        type(message.getType()).delivered.add(1, shard);
+        if (bytes != 0) {
+            receiver.deliveredBytes.add(bytes, shard);
+        }
+    }
+
+    /**
+     * @brief Counts a discarded message.
+     *
+     * @param[in] owner Counters of the task whose queue held the message, nullptr if none.
+     * @param[in] message The discarded message.
+     */
+    void recordDrop(TaskCounters* owner, const VirtualBusCmd& message) {
+        if (owner) {
+            owner->dropped.add();
+        }
+        type(message.getType()).dropped.add();
+    }
+
+    /**
+     * @brief Renders all counters in the Prometheus text exposition format.
+     *
+     * @return The exposition text, version 0.0.4.
+     */
+    std::string toPrometheus() const;
+
+    /**
+     * @brief Getter for the name of a command type as used in the metric labels.
+     *
+     * @param[in] type The command type.
+     * @return The type name.
+     */
+    static const char* typeName(CommandType type);
+
+private:
+    static size_t typeIndex(CommandType type) {
+        const size_t index = static_cast<size_t>(type);
+        return index < kTypeCount ? index : static_cast<size_t>(CommandType::Json);
+    }
+
+    mutable std::mutex tasksMutex_;                         ///< Guards tasks_, never taken on the publish path
+    std::map<int, std::shared_ptr<TaskCounters>> tasks_;    ///< Counters of the attached tasks
+    std::array<TypeCounters, kTypeCount> types_;            ///< Counters per command type
+};
+
+#endif // BUS_METRICS_H
@@ -0,0 +1,44 @@
+#ifndef BUS_PROBES_H
+#define BUS_PROBES_H
+
+/**
+ * @brief USDT (SystemTap SDT) probes of the bus hot paths, provider "vbus".
+ *
+ * With <sys/sdt.h> available (systemtap-sdt-dev / systemtap-sdt-devel) each probe compiles
+ * to a single nop plus a note in the binary, which perf, bpftrace and SystemTap turn into a
+ * breakpoint only while attached. Without the header, or with VBUS_NO_PROBES defined, the
+ * probes compile to nothing. Arguments must be cheap, they are evaluated either way.
+ *
+ * | Probe          | Arguments                                              |
+ * |----------------|--------------------------------------------------------|
+ * | attach         | task id, task name                                     |
+ * | detach         | task id, messages discarded from its queue             |
+ * | publish        | sender id, CommandType, message address                |
+ * | enqueue        | task id, message address, queue depth                  |
+ * | dequeue        | task id, message address, publish time (steady ns)     |
+ * | callback_begin | task id, message address, delay since publish (ns)     |
+ * | callback_end   | task id, message address, callback duration (ns)       |
+ * | pool_task_start| worker index                                           |
+ * | pool_task_end  | worker index                                           |
+ *
+ * Example: `bpftrace -e 'usdt:./CPPProject:vbus:callback_end { @[arg0] = hist(arg2); }'`
+ */
+
+#if defined(__has_include) && !defined(VBUS_NO_PROBES)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define VBUS_PROBES_AVAILABLE 1
+#endif
+#endif
+
+#ifdef VBUS_PROBES_AVAILABLE
+#define VBUS_PROBE1(name, a) STAP_PROBE1(vbus, name, a)
+#define VBUS_PROBE2(name, a, b) STAP_PROBE2(vbus, name, a, b)
+#define VBUS_PROBE3(name, a, b, c) STAP_PROBE3(vbus, name, a, b, c)
+#else
+#define VBUS_PROBE1(name, a) ((void)0)
+#define VBUS_PROBE2(name, a, b) ((void)0)
+#define VBUS_PROBE3(name, a, b, c) ((void)0)
+#endif
+
+#endif // BUS_PROBES_H
@@ -0,0 +1,62 @@
+#ifndef BUS_REPLAYER_H
+#define BUS_REPLAYER_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "VirtualBus.h"
+#include "IBusMessageCodec.h"
+#include "ReturnType.h"
+#include "ILogger.h"
+
+/**
+ * @brief Class re-injecting a recorded bus journal into a VirtualBus.
+ *
+ * Records are decoded with the same codec that recorded them and published in journal order.
+ * With a speed factor the original inter-message gaps are reproduced (1.0 = real time,
+ * 10.0 = ten times faster); a speed of 0 publishes as fast as the bus accepts messages,
+ * which turns a field journal into a throughput benchmark driven by real traffic.
+ */
+class BusReplayer {
+public:
+    /**
+     * @brief Struct representing the outcome of a replay.
+     */
+    struct Result {
+        uint64_t replayed = 0;                    ///< Messages published on the bus
+        uint64_t skipped = 0;                     ///< Records the codec could not decode
+        std::chrono::nanoseconds elapsed{0};      ///< Wall-clock duration of the replay
+        double messagesPerSecond = 0.0;           ///< Replayed messages per second
+    };
+
+    /**
+     * @brief Constructor for BusReplayer.
+     *
+     * @param[in] bus The bus the records are published on.
+     * @param[in] codec Codec used to decode the payloads.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     */
+    BusReplayer(VirtualBus& bus, std::shared_ptr<IBusMessageCodec> codec, std::shared_ptr<ILogger> logger = nullptr)
+        : bus_(bus), codec_(std::move(codec)), logger_(logger) {}
+
+    /**
+     * @brief Replays a journal directory.
+     *
+     * @param[in] directory Journal directory written by BusJournal.
+     * @param[in] speed Replay speed relative to the recording, 0 for maximum speed.
+     * @param[in] senderId Sender identifier to publish with, or -1 to keep the recorded ones.
+     * @param[out] result Replay statistics.
+     * @return OK, NOT_FOUND if the directory holds no journal, ERROR on a corrupt journal,
+     *         INVALID_ARGUMENT for a negative speed.
+     */
+    ReturnType replay(const std::string& directory, double speed, int senderId, Result& result);
+
+private:
+    VirtualBus& bus_;                            ///< Target bus
+    std::shared_ptr<IBusMessageCodec> codec_;    ///< Payload codec
+    std::shared_ptr<ILogger> logger_;            ///< Logger instance for logging messages
+};
+
+#endif // BUS_REPLAYER_H
@@ -0,0 +1,264 @@
+#ifndef CAN_BUS_EMULATOR_H
+#define CAN_BUS_EMULATOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "candefenation.h"
+#include "ReturnType.h"
+#include "ILogger.h"
+
+/**
+ * @brief In-process CAN bus emulator with bit-accurate frame timing.
+ *
+ * Simulated ECUs (nodes) attach to the emulator and queue `can_frame`s for transmission.
+ * Whenever the bus is idle the pending frame with the highest priority (lowest arbitration
+ * field) across all nodes wins arbitration. The frame then occupies the bus for the number
+ * of bit times it would need on the wire at the configured baud rate, including CRC and
+ * bit stuffing, and is finally delivered to every other node.
+ *
+ * Error frames are modelled with the flags from `candefenation.h`: a corrupted frame is
+ * reported to the other nodes as an error frame with `can_id = CAN_ERR_PROT` and
+ * `data[0] = CAN_ERR_TX_FAIL`, the transmitter's error counter is raised and the frame is
+ * retransmitted. A node whose counter exceeds the bus-off limit is taken off the bus and
+ * receives an error frame with `can_id = CAN_ERR_CRTL` and `data[0] = CAN_ERR_BUSOFF`; it
+ * neither sends nor receives frames until recoverNode().
+ */
+class CanBusEmulator {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Callback invoked on the bus thread for every frame seen by a node.
+     *
+     * Error frames are passed with `CAN_ERR_CRTL` or `CAN_ERR_PROT` set in `can_id`.
+     */
+    using FrameCallback = std::function<void(const can_frame&, Clock::time_point)>;
+
+    /**
+     * @brief Time base used to pace frames on the bus.
+     */
+    enum class TimeMode {
+        RealTime,  ///< Frames occupy the bus for their wall-clock duration
+        Virtual    ///< Frames are delivered as fast as possible, only the simulated clock advances
+    };
+
+    /**
+     * @brief Per-node error state following the CAN fault confinement rules.
+     */
+    enum class NodeState {
+        ErrorActive,
+        ErrorPassive,
+        BusOff
+    };
+
+    /**
+     * @brief Snapshot of the bus statistics.
+     */
+    struct Statistics {
+        uint64_t framesDelivered = 0;      ///< Frames that completed transmission
+        uint64_t errorFrames = 0;          ///< Error frames signalled on the bus
+        uint64_t txRejected = 0;           ///< Frames rejected because a mailbox was full or the node was bus-off
+        uint64_t busBits = 0;              ///< Total bit times the bus was occupied
+        double busLoad = 0.0;              ///< Busy bus time divided by elapsed time (0.0 - 1.0)
+        double meanLatencyUs = 0.0;        ///< Mean time from transmit() to end of frame
+        double maxLatencyUs = 0.0;         ///< Worst time from transmit() to end of frame
+        std::chrono::nanoseconds elapsed{0};  ///< Simulated time since start()
+    };
+
+    /**
+     * @brief Constructor for CanBusEmulator.
+     *
+     * @param[in] baudRate Nominal bit rate, one of `CAN_BAUD_125K` through `CAN_BAUD_1M`.
+     * @param[in] mode Time base used to pace frames.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     */
+    explicit CanBusEmulator(uint32_t baudRate = CAN_BAUD_500K, TimeMode mode = TimeMode::RealTime,
+                            std::shared_ptr<ILogger> logger = nullptr);
+
+    /**
+     * @brief Destructor that stops the bus thread.
+     */
+    ~CanBusEmulator();
+
+    CanBusEmulator(const CanBusEmulator&) = delete;
+    CanBusEmulator& operator=(const CanBusEmulator&) = delete;
+
+    /**
+     * @brief Attaches a simulated ECU to the bus.
+     *
+     * @param[in] name Name of the node, used in log messages.
+     * @param[in] callback Receive callback, may be empty for transmit-only nodes.
+     * @param[in] mailboxDepth Maximum number of frames the node may have pending.
+     * @return Node identifier used for transmit().
+     */
+    int attachNode(const std::string& name, FrameCallback callback, size_t mailboxDepth = 64);
+
+    /**
+     * @brief Queues a frame for transmission by a node.
+     *
+     * @param[in] nodeId Identifier returned by attachNode().
+     * @param[in] frame The frame to send.
+     * @return OK if queued, BUSY if the mailbox is full, ERROR if the node is bus-off,
+     *         INVALID_ARGUMENT for unknown nodes or a DLC above 8.
+     */
+    ReturnType transmit(int nodeId, const can_frame& frame);
+
+    /**
+     * @brief Starts the bus thread.
+     */
+    void start();
+
+    /**
+     * @brief Stops the bus thread. Pending frames are discarded.
+     */
+    void stop();
+
+    /**
+     * @brief Blocks until every mailbox is empty and the last frame was delivered, or the timeout expires.
+     *
+     * @param[in] timeout Maximum time to wait.
+     * @return True if the bus drained.
+     */
+    bool waitIdle(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Sets the probability that a transmitted frame is corrupted on the wire.
+     *
+     * @param[in] probability Value between 0.0 and 1.0.
+     */
+    void setErrorRate(double probability);
+
+    /**
+     * @brief Brings a bus-off node back onto the bus with cleared error counters.
+     *
+     * @param[in] nodeId Identifier returned by attachNode().
+     */
+    void recoverNode(int nodeId);
+
+    /**
+     * @brief Getter for the error state of a node.
+     * @param[in] nodeId Identifier returned by attachNode().
+     * @return Error state of the node.
+     */
+    NodeState getNodeState(int nodeId) const;
+
+    /**
+     * @brief Returns a snapshot of the bus statistics.
+     * @return Current statistics.
+     */
+    Statistics getStatistics() const;
+
+    /**
+     * @brief Getter for the configured baud rate.
+     * @return Baud rate in bit/s.
+     */
+    uint32_t getBaudRate() const { return baudRate_; }
+
+    /**
+     * @brief Computes the number of bit times a frame occupies on the bus.
+     *
+     * Includes SOF, arbitration and control fields, data, CRC, the exact number of stuff
+     * bits for this frame, ACK, EOF and the interframe space.
+     *
+     * @param[in] frame The frame to measure.
+     * @return Number of bit times.
+     */
+    static uint32_t frameBitLength(const can_frame& frame);
+
+    /**
+     * @brief Computes the arbitration key of a CAN identifier, lower keys win arbitration.
+     *
+     * @param[in] canId Identifier including `CAN_EFF_FLAG` and `CAN_RTR_FLAG`.
+     * @return Key reproducing the bitwise arbitration order of standard and extended frames.
+     */
+    static uint32_t arbitrationKey(uint32_t canId);
+
+private:
+    /**
+     * @brief Struct representing a frame waiting in a node mailbox.
+     */
+    struct PendingFrame {
+        can_frame frame;                 ///< Frame to transmit
+        Clock::time_point enqueuedAt;    ///< Time transmit() was called, for latency statistics
+    };
+
+    /**
+     * @brief Struct representing a simulated ECU.
+     */
+    struct Node {
+        std::string name;                    ///< Name of the node
+        FrameCallback callback;              ///< Receive callback
+        std::deque<PendingFrame> mailbox;    ///< Frames waiting for arbitration
+        size_t mailboxDepth = 0;             ///< Capacity of the mailbox
+        uint32_t txErrorCounter = 0;         ///< Transmit error counter (TEC)
+        NodeState state = NodeState::ErrorActive;  ///< Fault confinement state
+    };
+
+    /**
+     * @brief Main loop of the bus thread.
+     */
+    void run();
+
+    /**
+     * @brief Selects the frame that wins arbitration. Must be called with mutex_ held.
+     * @param[out] position Index of the winning frame inside the node mailbox, may be null.
+     * @return Index of the winning node, or -1 if no frame is pending.
+     */
+    int arbitrate(size_t* position = nullptr) const;
+
+    /**
+     * @brief Advances the bus clock by a number of bit times, sleeping in real-time mode.
+     *
+     * @param[in] bits Number of bit times.
+     * @return Time at the end of the interval.
+     */
+    Clock::time_point occupyBus(uint32_t bits);
+
+    /**
+     * @brief Delivers a frame to every node except the sender and the bus-off nodes.
+     *
+     * @param[in] sender Index of the transmitting node, or -1 to deliver to all nodes.
+     * @param[in] frame The frame to deliver.
+     * @param[in] when Time the frame completed on the bus.
+     */
+    void deliver(int sender, const can_frame& frame, Clock::time_point when);
+
+    uint32_t baudRate_;                        ///< Nominal bit rate in bit/s
+    TimeMode mode_;                            ///< Time base
+    std::chrono::duration<double, std::nano> bitTime_;  ///< Duration of one bit
+    std::shared_ptr<ILogger> logger_;          ///< Logger instance for logging messages
+
+    std::vector<std::unique_ptr<Node>> nodes_; ///< Attached nodes, indexed by node identifier
+    std::vector<Node*> deliveryList_;          ///< Receivers of the current frame, used by the bus thread only
+    mutable std::mutex mutex_;                 ///< Protects nodes_ and the statistics
+    std::condition_variable txCondition_;      ///< Signalled when a frame is queued or the bus stops
+    std::condition_variable idleCondition_;    ///< Signalled when all mailboxes drained
+    std::atomic<bool> running_;                ///< Flag indicating whether the bus thread runs
+    bool frameInFlight_ = false;               ///< True while a frame occupies the bus or is being delivered
+    std::thread thread_;                       ///< Bus thread
+
+    Clock::time_point startTime_;              ///< Time start() was called
+    Clock::time_point busTime_;                ///< Simulated bus clock
+    double errorRate_ = 0.0;                   ///< Probability of corrupting a frame
+    std::mt19937 random_;                      ///< Random source for error injection
+
+    uint64_t framesDelivered_ = 0;             ///< Statistics: delivered frames
+    uint64_t errorFrames_ = 0;                 ///< Statistics: error frames
+    uint64_t txRejected_ = 0;                  ///< Statistics: rejected transmit requests
+    uint64_t busBits_ = 0;                     ///< Statistics: occupied bit times
+    double latencySumUs_ = 0.0;                ///< Statistics: sum of frame latencies
+    double latencyMaxUs_ = 0.0;                ///< Statistics: worst frame latency
+};
+
+#endif // CAN_BUS_EMULATOR_H
@@ -0,0 +1,57 @@
+#ifndef CAN_DUMP_READER_H
+#define CAN_DUMP_READER_H
+
+#include <string>
+#include <vector>
+
+#include "candefenation.h"
+#include "ReturnType.h"
+#include "ILogger.h"
+#include <memory>
+
+/**
+ * @brief Struct representing one frame of a recorded CAN log.
+ */
+struct CanDumpRecord {
+    double timestamp = 0.0;  ///< Reception time in seconds
+    can_frame frame{};       ///< Recorded frame
+};
+
+/**
+ * @brief Class reading CAN traffic recorded with `candump -L` for replay.
+ *
+ * Each line has the form `(1700000000.123456) can0 181#1122334455667788`. Identifiers with
+ * eight hex digits are extended frames, `R` after the `#` marks a remote frame.
+ */
+class CanDumpReader {
+public:
+    /**
+     * @brief Constructor for CanDumpReader.
+     *
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     */
+    explicit CanDumpReader(std::shared_ptr<ILogger> logger = nullptr) : logger_(logger) {}
+
+    /**
+     * @brief Parses a single log line.
+     *
+     * @param[in] line The line to parse.
+     * @param[out] record The parsed frame.
+     * @return OK, or INVALID_ARGUMENT if the line is not a frame record.
+     */
+    static ReturnType parseLine(const std::string& line, CanDumpRecord& record);
+
+    /**
+     * @brief Loads all frames of a log file. Lines that are not frames are skipped.
+     *
+     * @param[in] path Path of the log file.
+     * @param[out] records Parsed frames in file order.
+     * @return OK, or NOT_FOUND if the file cannot be opened.
+     */
+    ReturnType load(const std::string& path, std::vector<CanDumpRecord>& records) const;
+
+private:
+    std::shared_ptr<ILogger> logger_; ///< Logger instance for logging messages
+};
+
+#endif // CAN_DUMP_READER_H
@@ -0,0 +1,29 @@
+#ifndef CAN_FRAME_UTILS_H
+#define CAN_FRAME_UTILS_H
+
+#include <cstdint>
+#include "candefenation.h"
+
+/**
+ * @brief Computes the arbitration key of a CAN identifier, lower keys win arbitration.
+ *
+ * The key reproduces the bitwise arbitration order on the wire: base identifier, RTR/SRR,
+ * IDE, identifier extension and RTR of extended frames. A standard frame therefore wins
+ * against an extended frame with the same base identifier, and a data frame wins against
+ * a remote frame with the same identifier.
+ *
+ * @param[in] canId Identifier including `CAN_EFF_FLAG` and `CAN_RTR_FLAG`.
+ * @return Arbitration key.
+ */
+inline uint32_t canArbitrationKey(uint32_t canId) {
+    const uint32_t remote = (canId & CAN_RTR_FLAG) ? 1U : 0U;
+    if (canId & CAN_EFF_FLAG) {
+        uint32_t id = CAN_EFF_ID(canId);
+        // Base ID, recessive SRR, recessive IDE, extension, RTR
+        return ((id >> 18) << 21) | (1U << 20) | (1U << 19) | ((id & 0x3FFFF) << 1) | remote;
+    }
+    // Base ID, RTR, dominant IDE
+    return (CAN_SFF_ID(canId) << 21) | (remote << 20);
+}
+
+#endif // CAN_FRAME_UTILS_H
@@ -0,0 +1,158 @@
+#ifndef CAN_OPEN_PDO_MAPPER_H
+#define CAN_OPEN_PDO_MAPPER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "candefenation.h"
+#include "VirtualBus.h"
+#include "VirtualBusCmd.h"
+#include "ReturnType.h"
+#include "ILogger.h"
+
+/**
+ * @brief Encoding of an object dictionary entry inside a PDO.
+ */
+enum class CanOpenDataType {
+    Unsigned,  ///< UNSIGNED8 .. UNSIGNED32
+    Signed,    ///< INTEGER8 .. INTEGER32
+    Real32     ///< REAL32 (IEEE 754 single precision)
+};
+
+/**
+ * @brief Binding of one object dictionary entry to a field of a bus command.
+ *
+ * The physical value handed to `set` (and returned by `get`) is the raw PDO value
+ * multiplied by `scale`.
+ */
+struct CanOpenObjectBinding {
+    uint16_t index;                                   ///< Object dictionary index
+    uint8_t subIndex;                                 ///< Object dictionary sub-index
+    CanOpenDataType type;                             ///< Encoding of the raw value
+    double scale;                                     ///< Physical units per raw unit
+    void (*set)(VirtualBusCmd& command, double value);       ///< Writes the field of a command
+    double (*get)(const VirtualBusCmd& command);             ///< Reads the field of a command
+};
+
+/**
+ * @brief Class mapping CANopen process data objects to virtual bus commands.
+ *
+ * RPDOs received from the network are decoded into a new command and published on the bus;
+ * TPDOs are encoded from commands taken off the bus. PDO mappings use the CiA 301 mapping
+ * entry format (0xIIIISSLL: index, sub-index, bit length) and are resolved against the
+ * object dictionary once, when the PDO is added. Each mapped entry is compiled into a bit
+ * offset, a width and the field accessor, so decoding a frame is a table lookup by COB-ID
+ * followed by a fixed sequence of bit extractions, with no dictionary search at run time.
+ *
+ * The mapper itself does not depend on a CANopen stack; it consumes raw `can_frame`s from a
+ * socket, the CAN bus emulator or a candump replay.
+ */
+class CanOpenPdoMapper {
+public:
+    /**
+     * @brief Creates the command an RPDO decodes into.
+     */
+    using CommandFactory = std::shared_ptr<VirtualBusCmd> (*)();
+
+    /**
+     * @brief Constructor for CanOpenPdoMapper.
+     *
+     * @param[in] bus Virtual bus decoded commands are published on.
+     * @param[in] senderId Task identifier used as sender of published commands; it must be attached to the bus.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     */
+    CanOpenPdoMapper(VirtualBus& bus, int senderId, std::shared_ptr<ILogger> logger = nullptr);
+
+    /**
+     * @brief Sets the object dictionary entries PDO mappings may refer to.
+     *
+     * @param[in] bindings Object dictionary bindings.
+     */
+    void setObjectDictionary(std::vector<CanOpenObjectBinding> bindings);
+
+    /**
+     * @brief Adds a receive PDO that is decoded into a command and published on the bus.
+     *
+     * @param[in] cobId COB-ID of the PDO, `CAN_EFF_FLAG` marks a 29-bit identifier.
+     * @param[in] mapping Mapping entries in CiA 301 format (0xIIIISSLL).
+     * @param[in] factory Creates the command the PDO decodes into.
+     * @return OK, INVALID_ARGUMENT if an entry is not in the dictionary or the mapping exceeds 64 bits.
+     */
+    ReturnType addRpdo(uint32_t cobId, const std::vector<uint32_t>& mapping, CommandFactory factory);
+
+    /**
+     * @brief Adds a transmit PDO encoded from commands of a given type.
+     *
+     * @param[in] cobId COB-ID of the PDO.
+     * @param[in] mapping Mapping entries in CiA 301 format (0xIIIISSLL).
+     * @param[in] type Command type the PDO is encoded from.
+     * @return OK, INVALID_ARGUMENT if an entry is not in the dictionary or the mapping exceeds 64 bits.
+     */
+    ReturnType addTpdo(uint32_t cobId, const std::vector<uint32_t>& mapping, CommandType type);
+
+    /**
+     * @brief Decodes a received frame and publishes the resulting command.
+     *
+     * @param[in] frame The received frame.
+     * @return OK if a command was published, NOT_FOUND if the COB-ID is not a configured RPDO or the
+     *         frame is a remote request, INVALID_ARGUMENT if the frame is shorter than the mapping.
+     */
+    ReturnType onFrame(const can_frame& frame);
+
+    /**
+     * @brief Decodes a received frame without publishing it.
+     *
+     * @param[in] frame The received frame.
+     * @param[out] command The decoded command.
+     * @return Same as onFrame().
+     */
+    ReturnType decode(const can_frame& frame, std::shared_ptr<VirtualBusCmd>& command) const;
+
+    /**
+     * @brief Encodes a command into the TPDO configured for its type.
+     *
+     * @param[in] command The command to encode.
+     * @param[out] frame The encoded frame.
+     * @return OK, or NOT_FOUND if no TPDO is configured for the command type.
+     */
+    ReturnType encode(const VirtualBusCmd& command, can_frame& frame) const;
+
+private:
+    /**
+     * @brief Mapping entry resolved against the object dictionary.
+     */
+    struct CompiledField {
+        uint8_t bitOffset;         ///< Position of the least significant bit inside the PDO
+        uint8_t bitLength;         ///< Width of the value
+        CanOpenDataType type;      ///< Encoding of the raw value
+        double scale;              ///< Physical units per raw unit
+        void (*set)(VirtualBusCmd&, double);   ///< Field setter
+        double (*get)(const VirtualBusCmd&);   ///< Field getter
+    };
+
+    /**
+     * @brief PDO with its compiled mapping.
+     */
+    struct CompiledPdo {
+        uint32_t cobId;                     ///< COB-ID including flags
+        uint8_t length;                     ///< Payload bytes covered by the mapping
+        CommandFactory factory;             ///< RPDO: command factory
+        CommandType type;                   ///< TPDO: source command type
+        std::vector<CompiledField> fields;  ///< Mapped entries in PDO order
+    };
+
+    ReturnType compile(uint32_t cobId, const std::vector<uint32_t>& mapping, CompiledPdo& pdo) const;
+    const CompiledPdo* findRpdo(uint32_t cobId) const;
+
+    VirtualBus& bus_;                                  ///< Bus decoded commands are published on
+    int senderId_;                                     ///< Sender identifier on the bus
+    std::shared_ptr<ILogger> logger_;                  ///< Logger instance for logging messages
+    std::vector<CanOpenObjectBinding> dictionary_;     ///< Object dictionary bindings
+    std::vector<CompiledPdo> rpdos_;                   ///< Receive PDOs
+    std::vector<CompiledPdo> tpdos_;                   ///< Transmit PDOs
+    std::vector<int16_t> rpdoBySffId_;                 ///< Direct table from 11-bit COB-ID to rpdos_ index
+};
+
+#endif // CAN_OPEN_PDO_MAPPER_H
@@ -0,0 +1,138 @@
+#ifndef CAN_TX_QUEUE_H
+#define CAN_TX_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "candefenation.h"
+#include "ICanSink.h"
+#include "ReturnType.h"
+#include "ILogger.h"
+
+/**
+ * @brief Class representing a priority-ordered CAN transmit queue.
+ *
+ * Pending frames are kept ordered by their arbitration key, so the queue hands frames to
+ * the sink in the same order the bus would let them win arbitration. At most one frame per
+ * CAN identifier is pending: submitting a frame for an identifier that has not been sent
+ * yet replaces the older payload in place, so a newer setpoint never queues behind a stale
+ * one. A transmit thread drains the queue in batches of the highest priority frames and
+ * writes each batch to the sink in one call.
+ */
+class CanTxQueue {
+public:
+    /**
+     * @brief Snapshot of the queue statistics.
+     */
+    struct Statistics {
+        uint64_t submitted = 0;    ///< Frames accepted by submit()
+        uint64_t replaced = 0;     ///< Pending frames overwritten by a newer frame for the same identifier
+        uint64_t rejected = 0;     ///< Frames refused because the queue was full
+        uint64_t written = 0;      ///< Frames accepted by the sink
+        uint64_t batches = 0;      ///< Write calls issued to the sink
+        uint64_t sinkBusy = 0;     ///< Write calls that found the sink full
+        uint64_t sinkErrors = 0;   ///< Write calls that failed
+        size_t pending = 0;        ///< Frames currently waiting
+    };
+
+    /**
+     * @brief Constructor for CanTxQueue.
+     *
+     * @param[in] sink Destination of the frames.
+     * @param[in] maxBatch Maximum number of frames handed to the sink per write.
+     * @param[in] capacity Maximum number of frames pending or being written at once.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     */
+    CanTxQueue(std::shared_ptr<ICanSink> sink, size_t maxBatch = 16, size_t capacity = 256,
+               std::shared_ptr<ILogger> logger = nullptr);
+
+    /**
+     * @brief Destructor that stops the transmit thread.
+     */
+    ~CanTxQueue();
+
+    CanTxQueue(const CanTxQueue&) = delete;
+    CanTxQueue& operator=(const CanTxQueue&) = delete;
+
+    /**
+     * @brief Queues a frame, replacing an unsent frame with the same identifier.
+     *
+     * @param[in] frame The frame to send.
+     * @return OK if queued or replaced, BUSY if the queue is full, INVALID_ARGUMENT for a DLC above 8.
+     */
+    ReturnType submit(const can_frame& frame);
+
+    /**
+     * @brief Starts the transmit thread.
+     */
+    void start();
+
+    /**
+     * @brief Stops the transmit thread. Frames still pending are discarded.
+     */
+    void stop();
+
+    /**
+     * @brief Blocks until all pending frames were written or the timeout expires.
+     *
+     * @param[in] timeout Maximum time to wait.
+     * @return True if the queue drained.
+     */
+    bool flush(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Sets the delay before retrying a sink that reported BUSY.
+     *
+     * @param[in] interval Retry delay.
+     */
+    void setRetryInterval(std::chrono::microseconds interval) { retryInterval_ = interval; }
+
+    /**
+     * @brief Returns a snapshot of the queue statistics.
+     * @return Current statistics.
+     */
+    Statistics getStatistics() const;
+
+private:
+    /**
+     * @brief Main loop of the transmit thread.
+     */
+    void run();
+
+    /**
+     * @brief Puts frames the sink did not accept back into the queue.
+     *
+     * A frame is dropped if a newer frame for the same identifier arrived meanwhile. The
+     * capacity holds, since submit() counts the frames in flight. Must be called with mutex_ held.
+     *
+     * @param[in] first Index of the first unsent frame in batch_.
+     */
+    void requeue(size_t first);
+
+    std::shared_ptr<ICanSink> sink_;              ///< Destination of the frames
+    size_t maxBatch_;                             ///< Maximum frames per write
+    size_t capacity_;                             ///< Maximum pending and in-flight frames
+    std::shared_ptr<ILogger> logger_;             ///< Logger instance for logging messages
+    std::atomic<std::chrono::microseconds> retryInterval_{std::chrono::microseconds(500)};  ///< Delay after BUSY
+
+    std::map<uint32_t, can_frame> pending_;       ///< Pending frames keyed by arbitration key
+    std::vector<can_frame> batch_;                ///< Frames being written, used by the transmit thread only
+    mutable std::mutex mutex_;                    ///< Protects pending_ and the statistics
+    std::condition_variable txCondition_;         ///< Signalled when frames are queued or the queue stops
+    std::condition_variable drainedCondition_;    ///< Signalled when the queue drained
+    std::atomic<bool> running_;                   ///< Flag indicating whether the transmit thread runs
+    bool writing_ = false;                        ///< True while a batch is handed to the sink
+    size_t inFlight_ = 0;                         ///< Frames of the batch handed to the sink
+    std::thread thread_;                          ///< Transmit thread
+
+    Statistics stats_;                            ///< Counters, pending is filled in on read
+};
+
+#endif // CAN_TX_QUEUE_H
@@ -0,0 +1,53 @@
+#ifndef COMMAND_PARSER_REGISTRY_H
+#define COMMAND_PARSER_REGISTRY_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "JsonCmdParser.h"
+#include "ReturnType.h"
+#include "ILogger.h"
+
+/**
+ * @brief Process-wide table of stateless JSON parsers, indexed by CommandType.
+ *
+ * Parsers are registered once at startup and live until the process exits, so commands
+ * carry no parser of their own and VirtualBusCmd::parse() dispatches through a single
+ * array load instead of a per-object shared pointer.
+ */
+class CommandParserRegistry {
+public:
+    static constexpr size_t kTypeCount = static_cast<size_t>(CommandType::Diagnostic) + 1; ///< Number of command types
+
+    /**
+     * @brief Registers the parser for a command type.
+     *
+     * Intended to be called during startup. A parser can be registered only once per type,
+     * so lookups never observe a parser being replaced while in use.
+     *
+     * @param[in] type Command type the parser handles.
+     * @param[in] parser Parser instance, must be stateless apart from its logger.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     * @return OK, INVALID_ARGUMENT for a null parser or BUSY if the type already has one.
+     */
+    static ReturnType registerParser(CommandType type, std::unique_ptr<JsonCmdParser> parser,
+                                     std::shared_ptr<ILogger> logger = nullptr);
+
+    /**
+     * @brief Looks up the parser for a command type.
+     *
+     * @param[in] type Command type.
+     * @return The registered parser, or nullptr if none was registered.
+     */
+    static JsonCmdParser* find(CommandType type) {
+        const auto index = static_cast<size_t>(type);
+        return index < kTypeCount ? parsers_[index].load(std::memory_order_acquire) : nullptr;
+    }
+
+private:
+    static std::array<std::atomic<JsonCmdParser*>, kTypeCount> parsers_; ///< Registered parsers, owned for the process lifetime
+};
+
+#endif // COMMAND_PARSER_REGISTRY_H
@@ -3,8 +3,11 @@
 
 #include "IStorage.h"
 #include "ILogger.h"
+#include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 /**
  * @brief Singleton class representing a configuration handler that uses an abstract storage and logging system.
@@ -56,7 +59,17 @@ public:
             if (logger_) logger_->error("Storage backend is not set.");
             return false;
         }
-        return storage_->load(source);
+        if (!storage_->load(source)) {
+            return false;
+        }
+        // Keys missing from the source keep their current value
+        for (const auto& key : listenedKeys()) {
+            std::string value;
+            if (storage_->tryGetValue(key, value)) {
+                notify(key, value);
+            }
+        }
+        return true;
     }
 
     /**
@@ -96,18 +109,68 @@ public:
     void setConfig(const std::string& key, const std::string& value) {
         if (storage_) {
             storage_->setValue(key, value);
+            notify(key, value);
         } else {
             if (logger_) logger_->error("Storage backend is not set.");
         }
     }
 
+    /**
+     * @brief Registers a callback applying a value at runtime.
+     *
+     * The callback runs on every setConfig() of the key and after every successful load()
+     * that found the key, on the calling thread; it must not call addListener().
+     *
+     * @param[in] key The key to watch.
+     * @param[in] listener Callback receiving the new value.
+     */
+    void addListener(const std::string& key, std::function<void(const std::string&)> listener) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        listeners_[key].push_back(std::move(listener));
+    }
+
 private:
     // Private constructor to prevent instantiation from outside the class
     Configuration() = default;
 
+    /**
+     * @brief Getter for the keys with listeners.
+     * @return The watched keys.
+     */
+    std::vector<std::string> listenedKeys() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<std::string> keys;
+        for (const auto& entry : listeners_) {
+            keys.push_back(entry.first);
+        }
+        return keys;
+    }
+
+    /**
+     * @brief Calls the listeners of a key, outside the lock.
+     *
+     * @param[in] key The changed key.
+     * @param[in] value The new value.
+     */
+    void notify(const std::string& key, const std::string& value) {
+        std::vector<std::function<void(const std::string&)>> listeners;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = listeners_.find(key);
+            if (it == listeners_.end()) {
+                return;
+            }
+            listeners = it->second;
+        }
+        for (const auto& listener : listeners) {
+            listener(value);
+        }
+    }
+
     std::unique_ptr<IStorage> storage_; ///< Storage instance to manage configuration data
     std::shared_ptr<ILogger> logger_;    ///< Logger instance for logging messages
-    mutable std::mutex mutex_;          ///< Mutex to protect access to storage and logger
+    mutable std::mutex mutex_;          ///< Mutex to protect access to storage, logger and listeners
+    std::map<std::string, std::vector<std::function<void(const std::string&)>>> listeners_;  ///< Runtime listeners by key
 
 };
 
@@ -2,12 +2,22 @@
 #ifndef ERROR_HANDLER_H
 #define ERROR_HANDLER_H
 
+#include <atomic>
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <mutex>
 #include <memory>
+#include <vector>
 #include "ILogger.h"
+#include "LockProfiler.h"
 
+class FlightRecorder;
+
+// Reports are counted per module and severity and handed to a background reporter without
+// taking a lock. Identical reports are written once per summary interval, followed by a
+// summary with the number of repeats. CRITICAL reports are written synchronously, after
+// everything queued before them, and terminate the program.
 class ErrorHandler {
 public:
     enum class ErrorSeverity {
@@ -19,8 +29,22 @@ public:
 
     static void handleError(const std::string& module, const std::string& message, ErrorSeverity severity, std::shared_ptr<ILogger> logger = nullptr);
 
+    // Every reported error is also written to this recorder, so it survives std::terminate().
+    static void setFlightRecorder(std::shared_ptr<FlightRecorder> recorder);
+
+    // Writes every report queued so far and the pending repeat counts on the calling thread.
+    static void flush();
+
+    // Number of reports of a module and severity since start, 0 for unknown modules.
+    static uint64_t errorCount(const std::string& module, ErrorSeverity severity);
+
+    // Number of reports lost because the reporter queue was full.
+    static uint64_t dropped();
+
 private:
-    static std::mutex mutex_;  // Declare as static, but without initialization.
+    static ProfiledMutex mutex_;  // Guards recorders_, never taken by handleError()
+    static std::atomic<FlightRecorder*> recorder_;
+    static std::vector<std::shared_ptr<FlightRecorder>> recorders_;  // Keeps replaced recorders alive for concurrent writers
 };
 
 #endif // ERROR_HANDLER_H
@@ -0,0 +1,115 @@
+#ifndef FD_CAN_SINK_H
+#define FD_CAN_SINK_H
+
+#include "ICanSink.h"
+#include "ILogger.h"
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+/**
+ * @brief Class representing a CAN sink that writes raw `can_frame` records to a file descriptor.
+ *
+ * Used as a stand-in for a CAN socket in tests: the descriptor may be a regular file or a
+ * pipe. Every batch is written with a single `write` call when the descriptor accepts it.
+ */
+class FdCanSink : public ICanSink {
+public:
+    /**
+     * @brief Constructor for FdCanSink that takes ownership of an open descriptor.
+     *
+     * @param[in] fd Open file descriptor.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     */
+    explicit FdCanSink(int fd, std::shared_ptr<ILogger> logger = nullptr)
+        : fd_(fd), logger_(logger) {}
+
+    /**
+     * @brief Constructor for FdCanSink that opens a file or FIFO for writing.
+     *
+     * @param[in] path Path of the file or FIFO.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     */
+    explicit FdCanSink(const std::string& path, std::shared_ptr<ILogger> logger = nullptr)
+        : fd_(::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644)), logger_(logger) {
+        if (fd_ < 0 && logger_) {
+            logger_->error("FdCanSink: Failed to open " + path + ": " + std::strerror(errno));
+        }
+    }
+
+    /**
+     * @brief Destructor that closes the descriptor.
+     */
+    ~FdCanSink() override {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    FdCanSink(const FdCanSink&) = delete;
+    FdCanSink& operator=(const FdCanSink&) = delete;
+
+    /**
+     * @brief Writes a batch of frames to the descriptor.
+     *
+     * A frame is never split: if a non-blocking descriptor accepted part of a frame the
+     * remainder is written before returning.
+     *
+     * @param[in] frames Pointer to the first frame of the batch.
+     * @param[in] count Number of frames in the batch.
+     * @param[out] written Number of frames accepted.
+     * @return OK, BUSY or ERROR.
+     */
+    ReturnType writeFrames(const can_frame* frames, size_t count, size_t& written) override {
+        written = 0;
+        if (fd_ < 0) {
+            return ReturnType::ERROR;
+        }
+        const char* data = reinterpret_cast<const char*>(frames);
+        const size_t total = count * sizeof(can_frame);
+        size_t offset = 0;
+        while (offset < total) {
+            ssize_t result = ::write(fd_, data + offset, total - offset);
+            if (result > 0) {
+                offset += static_cast<size_t>(result);
+                continue;
+            }
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                if (offset % sizeof(can_frame) == 0) {
+                    written = offset / sizeof(can_frame);
+                    return ReturnType::BUSY;
+                }
+                // Finish the partially written frame so the stream stays aligned
+                pollfd pfd{fd_, POLLOUT, 0};
+                ::poll(&pfd, 1, -1);
+                continue;
+            }
+            if (logger_) {
+                logger_->error("FdCanSink: write failed: " + std::string(std::strerror(errno)));
+            }
+            written = offset / sizeof(can_frame);
+            return ReturnType::ERROR;
+        }
+        written = count;
+        return ReturnType::OK;
+    }
+
+    /**
+     * @brief Checks whether the descriptor is usable.
+     * @return True if the descriptor is open.
+     */
+    bool isOpen() const { return fd_ >= 0; }
+
+private:
+    int fd_;                            ///< Destination file descriptor
+    std::shared_ptr<ILogger> logger_;   ///< Logger instance for logging messages
+};
+
+#endif // FD_CAN_SINK_H
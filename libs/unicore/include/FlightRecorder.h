@@ -0,0 +1,194 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "IBusObserver.h"
+#include "IBusMessageCodec.h"
+#include "ReturnType.h"
+#include "ILogger.h"
+
+/**
+ * @brief On-disk layout of the flight recorder file.
+ *
+ * The file is a FileHeader followed by a power-of-two number of 64-byte slots used as a ring.
+ * A writer claims a global sequence number, clears the slot's `sequence`, fills the slot and
+ * finally stores `sequence + 1`. A reader therefore accepts a slot only if its `sequence`
+ * is non-zero and maps back to the slot position; torn slots are skipped.
+ */
+namespace FlightRecorderFormat {
+
+constexpr char kMagic[4] = {'V', 'B', 'F', 'R'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kPayloadCapacity = 36;  ///< Payload bytes available in a slot
+
+/**
+ * @brief Kind of a recorded entry.
+ */
+enum class EntryKind : uint16_t {
+    Message = 1,   ///< Bus message, payload encoded with the codec
+    State = 2,     ///< State transition, payload is text
+    Error = 3      ///< ErrorHandler report, payload is text, `type` holds the severity
+};
+
+/**
+ * @brief Header at the start of the file.
+ */
+struct FileHeader {
+    char magic[4];             ///< kMagic
+    uint32_t version;          ///< kVersion
+    uint32_t slotSize;         ///< sizeof(Slot)
+    uint32_t capacity;         ///< Number of slots, a power of two
+    uint64_t wallClockNs;      ///< System clock when the recorder was opened
+    uint64_t steadyClockNs;    ///< Steady clock when the recorder was opened, origin of slot timestamps
+    uint64_t head;             ///< Next sequence number, updated atomically by writers
+    uint8_t reserved[24];      ///< Reserved, zero
+};
+
+/**
+ * @brief Fixed-size ring slot.
+ */
+struct Slot {
+    uint64_t sequence;         ///< Sequence number + 1 once complete, 0 while empty or being written
+    uint64_t timestampNs;      ///< Steady clock nanoseconds since the recorder was opened
+    uint16_t kind;             ///< EntryKind
+    uint16_t type;             ///< CommandType for messages, ErrorSeverity for errors
+    int32_t senderId;          ///< Sender task identifier, -1 if not applicable
+    uint16_t payloadSize;      ///< Valid payload bytes
+    uint16_t reserved;         ///< Reserved, zero
+    uint8_t payload[kPayloadCapacity];  ///< Encoded message or truncated text
+};
+
+static_assert(sizeof(FileHeader) == 64, "FileHeader layout changed");
+static_assert(sizeof(Slot) == 64, "Slot layout changed");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Flight recorder needs lock-free 64-bit atomics");
+
+} // namespace FlightRecorderFormat
+
+/**
+ * @brief Class keeping the most recent bus messages and events in a memory-mapped ring.
+ *
+ * Every write is wait-free: one atomic increment to claim a slot and a handful of stores.
+ * The file is mapped shared, so its contents stay in the page cache and are readable with
+ * `flight_dump` after the process crashes or is terminated by a CRITICAL error.
+ */
+class FlightRecorder : public IBusObserver {
+public:
+    /**
+     * @brief Constructor for FlightRecorder.
+     *
+     * @param[in] path File backing the ring; it is created or overwritten.
+     * @param[in] capacity Number of entries kept, rounded up to a power of two.
+     * @param[in] codec Codec used to encode bus messages, may be null to record only headers.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     */
+    FlightRecorder(const std::string& path, size_t capacity = 16384,
+                   std::shared_ptr<IBusMessageCodec> codec = nullptr, std::shared_ptr<ILogger> logger = nullptr);
+
+    /**
+     * @brief Destructor that unmaps the file. The file is kept.
+     */
+    ~FlightRecorder() override;
+
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    /**
+     * @brief Checks whether the file could be mapped.
+     * @return True if entries are recorded.
+     */
+    bool isOpen() const { return header_ != nullptr; }
+
+    /**
+     * @brief Records a published bus message.
+     *
+     * @param[in] senderId The identifier of the sender.
+     * @param[in] message The published message.
+     */
+    void onPublish(int senderId, const std::shared_ptr<VirtualBusCmd>& message) override;
+
+    /**
+     * @brief Records a state transition.
+     *
+     * @param[in] text Description of the new state, truncated to the slot payload.
+     */
+    void recordState(const std::string& text);
+
+    /**
+     * @brief Records an error report.
+     *
+     * @param[in] severity Severity as the numeric ErrorHandler::ErrorSeverity value.
+     * @param[in] text Module and message, truncated to the slot payload.
+     */
+    void recordError(uint16_t severity, const std::string& text);
+
+    /**
+     * @brief Records an error report as "module: message" without building the string.
+     *
+     * @param[in] severity Severity as the numeric ErrorHandler::ErrorSeverity value.
+     * @param[in] module Reporting module.
+     * @param[in] message Error message, truncated to the slot payload.
+     */
+    void recordError(uint16_t severity, const std::string& module, const std::string& message);
+
+private:
+    /**
+     * @brief Claims the next slot and clears its sequence.
+     * @param[out] sequence Claimed sequence number.
+     * @return The claimed slot.
+     */
+    FlightRecorderFormat::Slot* claim(uint64_t& sequence);
+
+    /**
+     * @brief Publishes a filled slot.
+     */
+    static void commit(FlightRecorderFormat::Slot* slot, uint64_t sequence);
+
+    void recordText(FlightRecorderFormat::EntryKind kind, uint16_t type, const std::string& text,
+                    const std::string& separator = std::string(), const std::string& rest = std::string());
+    uint64_t now() const;
+
+    std::shared_ptr<IBusMessageCodec> codec_;     ///< Payload codec
+    std::shared_ptr<ILogger> logger_;             ///< Logger instance for logging messages
+    size_t mappingSize_ = 0;                      ///< Size of the mapping
+    FlightRecorderFormat::FileHeader* header_ = nullptr;  ///< Mapped file header
+    FlightRecorderFormat::Slot* slots_ = nullptr; ///< Mapped slot array
+    uint64_t mask_ = 0;                           ///< capacity - 1
+    std::chrono::steady_clock::time_point start_; ///< Origin of slot timestamps
+};
+
+/**
+ * @brief Class reading a flight recorder file, for example after a crash.
+ */
+class FlightRecorderReader {
+public:
+    /**
+     * @brief Struct representing a recovered entry.
+     */
+    struct Entry {
+        uint64_t sequence = 0;                 ///< Global sequence number
+        uint64_t wallClockNs = 0;              ///< System clock time of the entry
+        FlightRecorderFormat::EntryKind kind = FlightRecorderFormat::EntryKind::State;  ///< Entry kind
+        uint16_t type = 0;                     ///< CommandType or ErrorSeverity
+        int32_t senderId = -1;                 ///< Sender task identifier
+        std::vector<uint8_t> payload;          ///< Payload bytes
+    };
+
+    /**
+     * @brief Loads all complete entries ordered by sequence number.
+     *
+     * @param[in] path Flight recorder file.
+     * @param[out] entries Recovered entries, oldest first.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     * @return OK, NOT_FOUND if the file cannot be opened, ERROR if it is not a recorder file.
+     */
+    static ReturnType load(const std::string& path, std::vector<Entry>& entries, std::shared_ptr<ILogger> logger = nullptr);
+};
+
+#endif // FLIGHT_RECORDER_H
@@ -0,0 +1,40 @@
+#ifndef I_BUS_MESSAGE_CODEC_H
+#define I_BUS_MESSAGE_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "VirtualBusCmd.h"
+
+/**
+ * @brief Interface representing a binary encoding of bus commands.
+ *
+ * The core library only moves opaque payloads around (journals, recorders, transports);
+ * the application provides the codec that knows its concrete command classes.
+ */
+class IBusMessageCodec {
+public:
+    virtual ~IBusMessageCodec() = default;
+
+    /**
+     * @brief Encodes the payload of a command.
+     *
+     * @param[in] command The command to encode.
+     * @param[out] buffer Destination buffer.
+     * @param[in] capacity Size of the destination buffer.
+     * @return Number of bytes written, 0 if the command type is not supported or does not fit.
+     */
+    virtual size_t encode(const VirtualBusCmd& command, uint8_t* buffer, size_t capacity) const = 0;
+
+    /**
+     * @brief Decodes a payload produced by encode().
+     *
+     * @param[in] type Command type of the payload.
+     * @param[in] buffer Encoded payload.
+     * @param[in] size Size of the payload.
+     * @return The decoded command, or nullptr if the payload is invalid or the type is not supported.
+     */
+    virtual std::shared_ptr<VirtualBusCmd> decode(CommandType type, const uint8_t* buffer, size_t size) const = 0;
+};
+
+#endif // I_BUS_MESSAGE_CODEC_H
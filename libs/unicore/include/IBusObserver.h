@@ -0,0 +1,26 @@
+#ifndef I_BUS_OBSERVER_H
+#define I_BUS_OBSERVER_H
+
+#include <memory>
+#include "VirtualBusCmd.h"
+
+/**
+ * @brief Interface representing a passive observer of every message published on the virtual bus.
+ *
+ * Observers are called on the publishing thread while the bus is locked, so implementations
+ * must be short and must not call back into the bus.
+ */
+class IBusObserver {
+public:
+    virtual ~IBusObserver() = default;
+
+    /**
+     * @brief Called for every message accepted by VirtualBus::sendMessage.
+     *
+     * @param[in] senderId The identifier of the sender.
+     * @param[in] message The published message.
+     */
+    virtual void onPublish(int senderId, const std::shared_ptr<VirtualBusCmd>& message) = 0;
+};
+
+#endif // I_BUS_OBSERVER_H
@@ -0,0 +1,30 @@
+#ifndef I_CAN_SINK_H
+#define I_CAN_SINK_H
+
+#include <cstddef>
+#include "candefenation.h"
+#include "ReturnType.h"
+
+/**
+ * @brief Interface representing a destination for outgoing CAN frames.
+ */
+class ICanSink {
+public:
+    virtual ~ICanSink() = default;
+
+    /**
+     * @brief Writes a batch of frames in one operation.
+     *
+     * Frames are passed in transmission order. A sink that cannot accept the whole batch
+     * reports how many frames it took, the remaining ones are retried by the caller.
+     *
+     * @param[in] frames Pointer to the first frame of the batch.
+     * @param[in] count Number of frames in the batch.
+     * @param[out] written Number of frames accepted by the sink.
+     * @return OK if all frames were written, BUSY if the sink is temporarily full,
+     *         ERROR on a permanent failure.
+     */
+    virtual ReturnType writeFrames(const can_frame* frames, size_t count, size_t& written) = 0;
+};
+
+#endif // I_CAN_SINK_H
@@ -1,15 +1,45 @@
 #ifndef I_LOGGER_H
 #define I_LOGGER_H
 
+#include <atomic>
 #include <string>
 
+#include "LogFormat.h"
+
+/**
+ * @brief Enumeration representing log levels, in increasing severity.
+ */
+enum class LogLevel {
+    Debug = 0,
+    Info,
+    Warn,
+    Error,
+    Critical,
+    Off
+};
+
 /**
  * @brief Interface representing a generic logger.
+ *
+ * Implementations drop messages below the level set with setLevel(). Call sites that build
+ * their message should use the VBUS_LOG_* macros or the *f() members, which check the level
+ * before formatting.
  */
 class ILogger {
 public:
     virtual ~ILogger() = default;
 
+    /**
+     * @brief Log a debug message, forwarded to info() unless overridden.
+     *
+     * @param[in] message The message to log.
+     */
+    virtual void debug(const std::string& message) {
+        if (isEnabled(LogLevel::Debug)) {
+            info(message);
+        }
+    }
+
     /**
      * @brief Log an informational message.
      *
@@ -37,6 +67,132 @@ public:
      * @param[in] message The message to log.
      */
     virtual void critical(const std::string& message) = 0;
+
+    /**
+     * @brief Sets the lowest level that is logged.
+     *
+     * @param[in] level The level, LogLevel::Off disables logging.
+     */
+    virtual void setLevel(LogLevel level) {
+        level_.store(level, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Getter for the lowest level that is logged.
+     * @return The level, LogLevel::Info by default.
+     */
+    LogLevel getLevel() const {
+        return level_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Checks whether messages of a level are logged.
+     *
+     * Only the runtime level is checked; VBUS_LOG_MIN_LEVEL removes VBUS_LOG_* call sites at
+     * compile time but does not affect messages passed to the members directly.
+     *
+     * @param[in] level The level to check.
+     * @return True if a message of the level would be logged.
+     */
+    bool isEnabled(LogLevel level) const {
+        return level >= level_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Getter for the binary sink used by the VBUS_LOG_* macros.
+     * @return The sink, nullptr if the logger takes formatted text.
+     */
+    virtual BinaryLogFormat::Sink* binarySink() {
+        return nullptr;
+    }
+
+    /**
+     * @brief Parses a level name as used in the configuration.
+     *
+     * @param[in] name One of debug, info, warn, warning, error, critical, off.
+     * @param[out] level The parsed level, unchanged on failure.
+     * @return True if the name is known.
+     */
+    static bool parseLevel(const std::string& name, LogLevel& level) {
+        static const struct { const char* name; LogLevel level; } kNames[] = {
+            {"debug", LogLevel::Debug}, {"info", LogLevel::Info}, {"warn", LogLevel::Warn}, {"warning", LogLevel::Warn},
+            {"error", LogLevel::Error}, {"critical", LogLevel::Critical}, {"off", LogLevel::Off}};
+        for (const auto& entry : kNames) {
+            if (name == entry.name) {
+                level = entry.level;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Formats and logs a debug message if the level is enabled.
+     *
+     * @param[in] format Format with "{}" placeholders, see LogFormat.
+     * @param[in] args Values replacing the placeholders.
+     */
+    template <typename... Args>
+    void debugf(const char* format, const Args&... args) {
+        if (isEnabled(LogLevel::Debug)) {
+            debug(LogFormat::format(format, args...));
+        }
+    }
+
+    /**
+     * @brief Formats and logs an informational message if the level is enabled.
+     *
+     * @param[in] format Format with "{}" placeholders, see LogFormat.
+     * @param[in] args Values replacing the placeholders.
+     */
+    template <typename... Args>
+    void infof(const char* format, const Args&... args) {
+        if (isEnabled(LogLevel::Info)) {
+            info(LogFormat::format(format, args...));
+        }
+    }
+
+    /**
+     * @brief Formats and logs a warning message if the level is enabled.
+     *
+     * @param[in] format Format with "{}" placeholders, see LogFormat.
+     * @param[in] args Values replacing the placeholders.
+     */
+    template <typename... Args>
+    void warnf(const char* format, const Args&... args) {
+        if (isEnabled(LogLevel::Warn)) {
+            warn(LogFormat::format(format, args...));
+        }
+    }
+
+    /**
+     * @brief Formats and logs an error message if the level is enabled.
+     *
+     * @param[in] format Format with "{}" placeholders, see LogFormat.
+     * @param[in] args Values replacing the placeholders.
+     */
+    template <typename... Args>
+    void errorf(const char* format, const Args&... args) {
+        if (isEnabled(LogLevel::Error)) {
+            error(LogFormat::format(format, args...));
+        }
+    }
+
+    /**
+     * @brief Formats and logs a critical error message if the level is enabled.
+     *
+     * @param[in] format Format with "{}" placeholders, see LogFormat.
+     * @param[in] args Values replacing the placeholders.
+     */
+    template <typename... Args>
+    void criticalf(const char* format, const Args&... args) {
+        if (isEnabled(LogLevel::Critical)) {
+            critical(LogFormat::format(format, args...));
+        }
+    }
+
+private:
+    std::atomic<LogLevel> level_{LogLevel::Info};  ///< Lowest logged level
 };
 
 #endif // I_LOGGER_H
@@ -34,6 +34,15 @@ public:
      */
     virtual std::string getValue(const std::string& key) const = 0;
 
+    /**
+     * @brief Get a configuration value by key without reporting a missing key.
+     *
+     * @param[in] key The key for the value.
+     * @param[out] value The value, unchanged if the key is missing.
+     * @return True if the key exists.
+     */
+    virtual bool tryGetValue(const std::string& key, std::string& value) const = 0;
+
     /**
      * @brief Set a configuration value.
      *
@@ -0,0 +1,293 @@
+#ifndef ISO_TP_BUFFER_POOL_H
+#define ISO_TP_BUFFER_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+/**
+ * @brief Class representing a fixed pool of equally sized payload buffers.
+ *
+ * All storage is allocated once in the constructor. Buffers are handed out by index from a
+ * lock-free free list, so a buffer may be released on any thread, e.g. by the last
+ * subscriber dropping a command that carries it. Every buffer is preceded by a header of
+ * kHeaderSize bytes, where IsoTpSlotAllocator places the command that carries the buffer.
+ */
+class IsoTpBufferPool {
+public:
+    static constexpr uint32_t kInvalidIndex = UINT32_MAX;  ///< Returned by acquire() when the pool is empty
+    static constexpr size_t kHeaderSize = 256;             ///< Bytes in front of each buffer, see header()
+
+    /**
+     * @brief Constructor for IsoTpBufferPool.
+     *
+     * @param[in] bufferCount Number of buffers in the pool.
+     * @param[in] bufferSize Size of each buffer in bytes.
+     */
+    IsoTpBufferPool(size_t bufferCount, size_t bufferSize)
+        : bufferCount_(bufferCount), bufferSize_(bufferSize),
+          stride_(kHeaderSize + (bufferSize + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t)),
+          storage_(bufferCount * stride_),
+          next_(new std::atomic<uint32_t>[bufferCount]), available_(bufferCount) {
+        for (size_t i = 0; i < bufferCount_; ++i) {
+            next_[i].store(i + 1 < bufferCount_ ? static_cast<uint32_t>(i + 1) : kInvalidIndex, std::memory_order_relaxed);
+        }
+        head_.store(pack(bufferCount_ ? 0 : kInvalidIndex, 0), std::memory_order_release);
+    }
+
+    IsoTpBufferPool(const IsoTpBufferPool&) = delete;
+    IsoTpBufferPool& operator=(const IsoTpBufferPool&) = delete;
+
+    /**
+     * @brief Takes a buffer from the pool.
+     * @return Buffer index, or kInvalidIndex if the pool is exhausted.
+     */
+    uint32_t acquire() {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        while (true) {
+            uint32_t index = static_cast<uint32_t>(head);
+            if (index == kInvalidIndex) {
+                return kInvalidIndex;
+            }
+            // The tag in the upper half protects the compare-exchange against ABA
+            uint64_t next = pack(next_[index].load(std::memory_order_relaxed), tag(head) + 1);
+            if (head_.compare_exchange_weak(head, next, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                available_.fetch_sub(1, std::memory_order_relaxed);
+                return index;
+            }
+        }
+    }
+
+    /**
+     * @brief Returns a buffer to the pool.
+     * @param[in] index Buffer index obtained from acquire().
+     */
+    void release(uint32_t index) {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        while (true) {
+            next_[index].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            uint64_t updated = pack(index, tag(head) + 1);
+            if (head_.compare_exchange_weak(head, updated, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                available_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the storage of a buffer.
+     * @param[in] index Buffer index.
+     * @return Pointer to the first byte of the buffer.
+     */
+    uint8_t* data(uint32_t index) { return storage_.data() + static_cast<size_t>(index) * stride_ + kHeaderSize; }
+
+    /**
+     * @brief Returns the header in front of a buffer.
+     * @param[in] index Buffer index.
+     * @return Pointer to kHeaderSize bytes, aligned for any scalar type.
+     */
+    void* header(uint32_t index) { return storage_.data() + static_cast<size_t>(index) * stride_; }
+
+    /**
+     * @brief Getter for the size of each buffer.
+     * @return Buffer size in bytes.
+     */
+    size_t bufferSize() const { return bufferSize_; }
+
+    /**
+     * @brief Getter for the number of buffers in the pool.
+     * @return Buffer count.
+     */
+    size_t bufferCount() const { return bufferCount_; }
+
+    /**
+     * @brief Getter for the number of free buffers.
+     * @return Free buffer count.
+     */
+    size_t available() const { return available_.load(std::memory_order_relaxed); }
+
+private:
+    static uint64_t pack(uint32_t index, uint32_t tagValue) { return (static_cast<uint64_t>(tagValue) << 32) | index; }
+    static uint32_t tag(uint64_t value) { return static_cast<uint32_t>(value >> 32); }
+
+    size_t bufferCount_;                              ///< Number of buffers
+    size_t bufferSize_;                               ///< Size of each buffer
+    size_t stride_;                                   ///< Distance between two headers, header plus aligned buffer
+    std::vector<uint8_t> storage_;                    ///< Backing storage of all buffers
+    std::unique_ptr<std::atomic<uint32_t>[]> next_;   ///< Free list links
+    std::atomic<uint64_t> head_{0};                   ///< Free list head: index in the low half, ABA tag in the high half
+    std::atomic<size_t> available_;                   ///< Number of free buffers
+};
+
+/**
+ * @brief Move-only handle owning one buffer of an IsoTpBufferPool.
+ */
+class IsoTpBuffer {
+public:
+    IsoTpBuffer() = default;
+
+    /**
+     * @brief Constructor taking ownership of an acquired buffer.
+     *
+     * @param[in] pool Pool the buffer belongs to.
+     * @param[in] index Buffer index obtained from acquire().
+     */
+    IsoTpBuffer(std::shared_ptr<IsoTpBufferPool> pool, uint32_t index)
+        : pool_(std::move(pool)), index_(index) {}
+
+    ~IsoTpBuffer() { reset(); }
+
+    IsoTpBuffer(IsoTpBuffer&& other) noexcept
+        : pool_(std::move(other.pool_)), index_(other.index_), size_(other.size_) {
+        other.index_ = IsoTpBufferPool::kInvalidIndex;
+        other.size_ = 0;
+    }
+
+    IsoTpBuffer& operator=(IsoTpBuffer&& other) noexcept {
+        if (this != &other) {
+            reset();
+            pool_ = std::move(other.pool_);
+            index_ = other.index_;
+            size_ = other.size_;
+            other.index_ = IsoTpBufferPool::kInvalidIndex;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    IsoTpBuffer(const IsoTpBuffer&) = delete;
+    IsoTpBuffer& operator=(const IsoTpBuffer&) = delete;
+
+    /**
+     * @brief Returns the buffer to its pool.
+     */
+    void reset() {
+        if (pool_ && index_ != IsoTpBufferPool::kInvalidIndex) {
+            pool_->release(index_);
+        }
+        index_ = IsoTpBufferPool::kInvalidIndex;
+        size_ = 0;
+        pool_.reset();
+    }
+
+    /**
+     * @brief Gives up ownership without returning the buffer to its pool.
+     * @return Buffer index, the caller is responsible for releasing it.
+     */
+    uint32_t detach() {
+        const uint32_t index = index_;
+        index_ = IsoTpBufferPool::kInvalidIndex;
+        size_ = 0;
+        pool_.reset();
+        return index;
+    }
+
+    /**
+     * @brief Getter for the pool of the buffer.
+     * @return Owning pool, empty for an invalid handle.
+     */
+    const std::shared_ptr<IsoTpBufferPool>& pool() const { return pool_; }
+
+    /**
+     * @brief Checks whether the handle owns a buffer.
+     * @return True if a buffer is owned.
+     */
+    bool valid() const { return pool_ && index_ != IsoTpBufferPool::kInvalidIndex; }
+
+    /**
+     * @brief Returns the storage of the owned buffer.
+     * @return Pointer to the first payload byte.
+     */
+    uint8_t* data() { return pool_->data(index_); }
+
+    /**
+     * @brief Returns the storage of the owned buffer.
+     * @return Pointer to the first payload byte.
+     */
+    const uint8_t* data() const { return pool_->data(index_); }
+
+    /**
+     * @brief Getter for the number of valid payload bytes.
+     * @return Payload size.
+     */
+    size_t size() const { return size_; }
+
+    /**
+     * @brief Setter for the number of valid payload bytes.
+     * @param[in] size Payload size, at most the pool buffer size.
+     */
+    void setSize(size_t size) { size_ = size; }
+
+    /**
+     * @brief Getter for the capacity of the buffer.
+     * @return Buffer size of the pool.
+     */
+    size_t capacity() const { return pool_ ? pool_->bufferSize() : 0; }
+
+private:
+    std::shared_ptr<IsoTpBufferPool> pool_;             ///< Owning pool
+    uint32_t index_ = IsoTpBufferPool::kInvalidIndex;   ///< Buffer index
+    size_t size_ = 0;                                   ///< Valid payload bytes
+};
+
+/**
+ * @brief Allocator placing a single object in the header of a pool buffer.
+ *
+ * Used with std::allocate_shared, so a command and its shared_ptr control block live in
+ * front of the payload they carry and no heap memory is allocated per payload. The buffer
+ * returns to the pool when the control block is deallocated, i.e. after the last shared
+ * and weak reference is gone.
+ */
+template <typename T>
+class IsoTpSlotAllocator {
+public:
+    using value_type = T;
+
+    /**
+     * @brief Constructor taking ownership of an acquired buffer.
+     *
+     * @param[in] pool Pool the buffer belongs to.
+     * @param[in] index Buffer index obtained from acquire(), released by deallocate().
+     */
+    IsoTpSlotAllocator(std::shared_ptr<IsoTpBufferPool> pool, uint32_t index) : pool_(std::move(pool)), index_(index) {}
+
+    template <typename U>
+    IsoTpSlotAllocator(const IsoTpSlotAllocator<U>& other) : pool_(other.pool_), index_(other.index_) {}
+
+    /**
+     * @brief Returns the header of the buffer.
+     * @param[in] count Number of objects, only 1 is supported.
+     * @return Storage for the object.
+     */
+    T* allocate(size_t count) {
+        static_assert(sizeof(T) <= IsoTpBufferPool::kHeaderSize, "Object does not fit into the buffer header");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Object alignment exceeds the buffer header alignment");
+        if (count != 1) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(pool_->header(index_));
+    }
+
+    /**
+     * @brief Returns the buffer to the pool.
+     */
+    void deallocate(T*, size_t) { pool_->release(index_); }
+
+    template <typename U>
+    bool operator==(const IsoTpSlotAllocator<U>& other) const { return pool_ == other.pool_ && index_ == other.index_; }
+
+    template <typename U>
+    bool operator!=(const IsoTpSlotAllocator<U>& other) const { return !(*this == other); }
+
+private:
+    template <typename U>
+    friend class IsoTpSlotAllocator;
+
+    std::shared_ptr<IsoTpBufferPool> pool_;   ///< Owning pool, kept alive by the control block
+    uint32_t index_;                          ///< Buffer whose header holds the object
+};
+
+#endif // ISO_TP_BUFFER_POOL_H
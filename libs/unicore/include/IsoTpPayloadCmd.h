@@ -0,0 +1,99 @@
+#ifndef ISO_TP_PAYLOAD_CMD_H
+#define ISO_TP_PAYLOAD_CMD_H
+
+#include "VirtualBusCmd.h"
+#include "IsoTpBufferPool.h"
+#include "ILogger.h"
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+
+/**
+ * @brief Class representing a reassembled ISO-TP payload published on the virtual bus.
+ *
+ * The command lives in the header of the pool buffer the payload was reassembled into, see
+ * create(); subscribers read the bytes in place and the buffer returns to the pool when the
+ * last reference is dropped.
+ */
+class IsoTpPayloadCmd : public VirtualBusCmd {
+private:
+    std::shared_ptr<ILogger> logger_; ///< Logger instance for logging messages
+
+public:
+    /**
+     * @brief Creates a command in the header of the buffer holding its payload, without heap allocation.
+     *
+     * @param[in] canId CAN identifier the payload was received on.
+     * @param[in] buffer Buffer holding the payload, owned by the command afterwards.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     * @return The command, empty if the buffer is not valid.
+     */
+    static std::shared_ptr<IsoTpPayloadCmd> create(uint32_t canId, IsoTpBuffer&& buffer, std::shared_ptr<ILogger> logger = nullptr) {
+        if (!buffer.valid()) {
+            return nullptr;
+        }
+        std::shared_ptr<IsoTpBufferPool> pool = buffer.pool();
+        const size_t size = buffer.size();
+        const uint32_t index = buffer.detach();
+        return std::allocate_shared<IsoTpPayloadCmd>(IsoTpSlotAllocator<IsoTpPayloadCmd>(pool, index),
+                                                     canId, pool->data(index), size, std::move(logger));
+    }
+
+    /**
+     * @brief Constructor for IsoTpPayloadCmd, use create() to tie the command to a pool buffer.
+     *
+     * @param[in] canId CAN identifier the payload was received on.
+     * @param[in] data First payload byte, must outlive the command.
+     * @param[in] size Payload length in bytes.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     */
+    IsoTpPayloadCmd(uint32_t canId, const uint8_t* data, size_t size, std::shared_ptr<ILogger> logger = nullptr)
+        : VirtualBusCmd(), logger_(logger), canId_(canId), data_(data), size_(size) {
+        type_ = CommandType::Diagnostic;
+    }
+
+    /**
+     * @brief Getter for the CAN identifier.
+     * @return CAN identifier of the sender.
+     */
+    uint32_t getCanId() const { return canId_; }
+
+    /**
+     * @brief Getter for the payload bytes.
+     * @return Pointer to the first payload byte.
+     */
+    const uint8_t* data() const { return data_; }
+
+    /**
+     * @brief Getter for the payload length.
+     * @return Payload length in bytes.
+     */
+    size_t size() const { return size_; }
+
+    /**
+     * @brief Getter for the payload size, counted by the bus metrics.
+     * @return Payload length in bytes.
+     */
+    size_t payloadSize() const override { return size(); }
+
+    /**
+     * @brief Prints the CAN identifier and the payload in hex.
+     */
+    void print() const override {
+        std::cout << "IsoTpPayloadCmd: CAN ID 0x" << std::hex << canId_ << std::dec << ", " << size() << " bytes:";
+        char hex[4];
+        for (size_t i = 0; i < size(); ++i) {
+            std::snprintf(hex, sizeof(hex), " %02X", data()[i]);
+            std::cout << hex;
+        }
+        std::cout << std::endl;
+    }
+
+private:
+    uint32_t canId_;        ///< CAN identifier the payload was received on
+    const uint8_t* data_;   ///< Payload in the pool buffer behind the command
+    size_t size_;           ///< Payload length in bytes
+};
+
+#endif // ISO_TP_PAYLOAD_CMD_H
@@ -0,0 +1,170 @@
+#ifndef ISO_TP_REASSEMBLER_H
+#define ISO_TP_REASSEMBLER_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "candefenation.h"
+#include "IsoTpBufferPool.h"
+#include "IsoTpPayloadCmd.h"
+#include "ReturnType.h"
+#include "ILogger.h"
+
+/**
+ * @brief Class representing an ISO-TP (ISO 15765-2) receive engine for many concurrent senders.
+ *
+ * Single frames and first/consecutive frame sequences are reassembled per CAN identifier
+ * into buffers taken from a preallocated pool. Flow control frames are generated for every
+ * first frame and after each block, and stalled sessions are expired by a timing wheel.
+ * The session table, the buffer pool and the wheel are all sized in the constructor, so
+ * memory use does not depend on the number of sessions started or aborted.
+ *
+ * The reassembler is not thread-safe; feed it from a single receive thread.
+ */
+class IsoTpReassembler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Callback used to transmit flow control frames.
+     */
+    using FrameSender = std::function<void(const can_frame&)>;
+
+    /**
+     * @brief Callback receiving every completed payload, e.g. to publish it on the virtual bus.
+     */
+    using MessageHandler = std::function<void(const std::shared_ptr<IsoTpPayloadCmd>&)>;
+
+    /**
+     * @brief Maps the identifier of a sender to the identifier its flow control frames are sent on.
+     */
+    using FlowControlIdMapper = std::function<uint32_t(uint32_t)>;
+
+    /**
+     * @brief Reassembler configuration.
+     */
+    struct Config {
+        size_t maxSessions = 64;                      ///< Concurrent multi-frame sessions
+        size_t poolBuffers = 128;                     ///< Payload buffers, shared by sessions and delivered payloads still referenced
+        size_t maxPayload = 4095;                     ///< Largest accepted payload in bytes
+        uint8_t blockSize = 0;                        ///< Consecutive frames per block, 0 for unlimited
+        uint8_t separationTime = 0;                   ///< STmin requested from senders, raw ISO-TP encoding
+        std::chrono::milliseconds timeout{1000};      ///< N_Cr: maximum gap between consecutive frames
+        std::chrono::milliseconds tick{10};           ///< Resolution of the timeout wheel
+        uint8_t padding = 0xCC;                       ///< Fill byte of flow control frames
+    };
+
+    /**
+     * @brief Snapshot of the reassembler statistics.
+     */
+    struct Statistics {
+        uint64_t completed = 0;        ///< Payloads delivered
+        uint64_t flowControlSent = 0;  ///< Flow control frames transmitted
+        uint64_t timeouts = 0;         ///< Sessions expired by the wheel
+        uint64_t sequenceErrors = 0;   ///< Sessions aborted on a wrong sequence number
+        uint64_t overflows = 0;        ///< First frames refused: payload too large or no session/buffer free
+        uint64_t unexpected = 0;       ///< Frames ignored: consecutive frame without session, malformed PCI
+        size_t activeSessions = 0;     ///< Sessions currently in progress
+    };
+
+    /**
+     * @brief Constructor for IsoTpReassembler.
+     *
+     * @param[in] config Reassembler configuration.
+     * @param[in] sender Callback used to transmit flow control frames.
+     * @param[in] handler Callback receiving completed payloads.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     */
+    IsoTpReassembler(const Config& config, FrameSender sender, MessageHandler handler,
+                     std::shared_ptr<ILogger> logger = nullptr);
+
+    /**
+     * @brief Sets the mapping from sender identifier to flow control identifier.
+     *
+     * The default swaps target and source address of 29-bit normal fixed addressing
+     * (0x18DAttss) and otherwise follows the 11-bit diagnostic convention of a response
+     * identifier 8 above the request identifier (e.g. 0x7E8 is answered on 0x7E0).
+     *
+     * @param[in] mapper Mapping function.
+     */
+    void setFlowControlIdMapper(FlowControlIdMapper mapper) { flowControlIdMapper_ = std::move(mapper); }
+
+    /**
+     * @brief Processes one received CAN frame.
+     *
+     * @param[in] frame The received frame.
+     * @param[in] now Reception time, also used to advance the timeout wheel.
+     * @return OK if the frame was consumed, NOT_FOUND for a consecutive frame without session,
+     *         INVALID_ARGUMENT for malformed frames, BUSY if a first frame had to be refused.
+     */
+    ReturnType onFrame(const can_frame& frame, Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Advances the timeout wheel and expires stalled sessions.
+     *
+     * @param[in] now Current time.
+     */
+    void poll(Clock::time_point now = Clock::now());
+
+    /**
+     * @brief Returns a snapshot of the reassembler statistics.
+     * @return Current statistics.
+     */
+    Statistics getStatistics() const;
+
+private:
+    static constexpr int32_t kNone = -1;
+
+    /**
+     * @brief Struct representing one multi-frame reception in progress.
+     */
+    struct Session {
+        uint32_t canId = 0;            ///< Sender identifier
+        IsoTpBuffer buffer;            ///< Pool buffer receiving the payload
+        size_t expected = 0;           ///< Total payload length announced by the first frame
+        size_t received = 0;           ///< Bytes received so far
+        uint8_t nextSequence = 0;      ///< Expected consecutive frame sequence number
+        uint8_t framesInBlock = 0;     ///< Consecutive frames since the last flow control
+        uint64_t deadlineTick = 0;     ///< Wheel tick at which the session expires
+        int32_t wheelPrev = kNone;     ///< Previous session in the same wheel slot
+        int32_t wheelNext = kNone;     ///< Next session in the same wheel slot (also the free list link)
+        bool active = false;           ///< True while the session is in use
+    };
+
+    int32_t findSession(uint32_t canId) const;
+    int32_t openSession(uint32_t canId);
+    void closeSession(int32_t index);
+    void removeFromIndex(uint32_t canId);
+    size_t hashSlot(uint32_t canId) const;
+
+    void schedule(int32_t index);
+    void unschedule(int32_t index);
+    uint64_t tickOf(Clock::time_point now) const;
+
+    void sendFlowControl(uint32_t canId, uint8_t status);
+    void deliver(uint32_t canId, IsoTpBuffer&& buffer);
+
+    Config config_;                                 ///< Reassembler configuration
+    FrameSender sender_;                            ///< Flow control transmit callback
+    MessageHandler handler_;                        ///< Completed payload callback
+    FlowControlIdMapper flowControlIdMapper_;       ///< Sender to flow control identifier mapping
+    std::shared_ptr<ILogger> logger_;               ///< Logger instance for logging messages
+    std::shared_ptr<IsoTpBufferPool> pool_;         ///< Preallocated payload buffers
+
+    std::vector<Session> sessions_;                 ///< Session storage
+    int32_t freeSession_ = kNone;                   ///< Head of the free session list
+    std::vector<int32_t> index_;                    ///< Open addressing table from CAN identifier to session
+    size_t indexMask_ = 0;                          ///< index_.size() - 1
+
+    std::vector<int32_t> wheel_;                    ///< Timing wheel slots holding session list heads
+    Clock::time_point epoch_;                       ///< Time of wheel tick 0
+    uint64_t currentTick_ = 0;                      ///< Last processed wheel tick
+    uint64_t timeoutTicks_ = 1;                     ///< Session timeout in wheel ticks
+
+    Statistics stats_;                              ///< Counters, activeSessions is kept current
+};
+
+#endif // ISO_TP_REASSEMBLER_H
@@ -4,6 +4,7 @@
 
 #include <string>
 #include "VirtualBusCmd.h"
+#include "ReturnType.h"
 
 class VirtualBusCmd;
 /**
@@ -14,11 +15,15 @@ public:
     /**
      * @brief Pure virtual function to parse parameters and set them in the command.
      *
+     * Implementations report failures through the return value and must neither throw nor
+     * log, malformed input is expected on this path.
+     *
      * @param[in] command Reference to a command object that parameters will be set to.
      * @param[in] parameters JSON string representing command parameters.
-     * @return True if parsing is successful, otherwise false.
+     * @param[out] error Position or field of the failure.
+     * @return OK, ERROR for malformed JSON, INVALID_ARGUMENT for a rejected value or command type.
      */
-    virtual bool parseParameters(VirtualBusCmd& command, const std::string& parameters) = 0;
+    virtual ReturnType parseParameters(VirtualBusCmd& command, const std::string& parameters, ParseError& error) = 0;
 
     /**
      * @brief Virtual destructor.
@@ -0,0 +1,103 @@
+#ifndef JSON_FORMAT_H
+#define JSON_FORMAT_H
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+
+/**
+ * @brief Helpers appending JSON tokens to a string without building a DOM.
+ *
+ * Used by the generated command serializers. Strings passed to appendKey() and
+ * appendString() must not need escaping; the generated code only passes schema constants.
+ */
+namespace JsonFormat {
+
+/**
+ * @brief Appends an integer.
+ *
+ * @param[out] out Destination string.
+ * @param[in] value Value to append.
+ */
+template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+inline void appendNumber(std::string& out, T value) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+/**
+ * @brief Appends a floating point value with the shortest round-trip representation.
+ *
+ * Non-finite values have no JSON representation and are written as null.
+ *
+ * @param[out] out Destination string.
+ * @param[in] value Value to append.
+ */
+inline void appendNumber(std::string& out, double value) {
+    if (value != value || value - value != 0.0) {
+        out += "null";
+        return;
+    }
+    // Setpoints and measurements rarely have more than three decimals. Below 1e9 such a value
+    // is written exactly and shortest from its scaled integer, far cheaper than to_chars().
+    if (value != 0.0 && value > -1e9 && value < 1e9) {
+        long long fixed = std::llround(value * 1000.0);
+        if (static_cast<double>(fixed) / 1000.0 == value) {
+            if (fixed < 0) {
+                out += '-';
+                fixed = -fixed;
+            }
+            appendNumber(out, fixed / 1000);
+            int fraction = static_cast<int>(fixed % 1000);
+            if (fraction != 0) {
+                char digits[4] = {'.', static_cast<char>('0' + fraction / 100), static_cast<char>('0' + fraction / 10 % 10),
+                                  static_cast<char>('0' + fraction % 10)};
+                size_t length = 4;
+                while (digits[length - 1] == '0') {
+                    --length;
+                }
+                out.append(digits, length);
+            }
+            return;
+        }
+    }
+    char buffer[32];
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+#else
+    int length = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    out.append(buffer, static_cast<size_t>(length));
+#endif
+}
+
+/**
+ * @brief Appends a quoted string that needs no escaping.
+ *
+ * @param[out] out Destination string.
+ * @param[in] value String to append.
+ */
+inline void appendString(std::string& out, const char* value) {
+    out += '"';
+    out += value;
+    out += '"';
+}
+
+/**
+ * @brief Appends an object key followed by a colon.
+ *
+ * @param[out] out Destination string.
+ * @param[in] key Key to append.
+ */
+inline void appendKey(std::string& out, const char* key) {
+    appendString(out, key);
+    out += ':';
+}
+
+} // namespace JsonFormat
+
+#endif // JSON_FORMAT_H
@@ -0,0 +1,527 @@
+#ifndef JSON_SAX_READER_H
+#define JSON_SAX_READER_H
+
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+/**
+ * @brief Base of the single-pass SAX handlers that parse command parameters.
+ *
+ * parse() tokenizes the text itself and tracks the structure of a JSON object with at most
+ * one level of nested groups, handing each scalar to the derived class, identified by the
+ * field id the derived class returned for its key. Unknown keys and their subtrees are
+ * skipped. No DOM is built: keys and strings are views into the text, and only strings with
+ * escapes are decoded, into a per-thread buffer that keeps its capacity across calls. After
+ * the first call on a thread, parsing does not allocate.
+ *
+ * The derived class provides:
+ * - `int lookup(int group, std::string_view key)` returning a field id (>= 0),
+ *   `groupMarker(g)` for a nested group, or `kUnknown`; `group` is -1 at the top level;
+ * - `bool onInteger(int field, int64_t value)`, `bool onUnsigned(int field, uint64_t value)`,
+ *   `bool onFloat(int field, double value)`, `bool onString(int field, std::string_view value)`,
+ *   each returning false if the value is not acceptable for the field.
+ *
+ * After parse() returned false, syntaxError() tells whether the text was malformed,
+ * errorPosition() gives the 1-based byte where parsing stopped, and errorField() names the
+ * field or group marker whose value was rejected, kUnknown for input that is not an object.
+ * Errors are reported through these accessors only, never by throwing.
+ */
+template <typename Derived>
+class JsonSaxReader {
+public:
+    static constexpr int kUnknown = -1;
+    static constexpr int kMaxDepth = 64;  ///< Deeper nesting is reported as a syntax error
+
+    /**
+     * @brief Encodes a group index as a lookup result.
+     */
+    static constexpr int groupMarker(int group) { return -2 - group; }
+
+    /**
+     * @brief Parses a complete JSON text, see RFC 8259.
+     *
+     * @param[in] text The JSON text.
+     * @return True if the text is valid and every value was accepted.
+     */
+    bool parse(const std::string& text) {
+        const char* const begin = text.c_str();
+        const char* const end = begin + text.size();
+        const char* pos = begin;
+        uint64_t arrays = 0;  // Bit n set if the container at nesting n is an array
+        int nesting = 0;
+        enum class Expect { Value, Key, Next } expect = Expect::Value;
+
+        while (true) {
+            skipSpace(pos, end);
+            if (expect == Expect::Key) {
+                std::string_view name;
+                if (pos == end || *pos != '"' || !readString(pos, end, name)) {
+                    return syntax(begin, pos);
+                }
+                key(name);
+                skipSpace(pos, end);
+                if (pos == end || *pos != ':') {
+                    return syntax(begin, pos);
+                }
+                ++pos;
+                expect = Expect::Value;
+                continue;
+            }
+
+            if (expect == Expect::Next) {
+                if (nesting == 0) {
+                    return pos == end || syntax(begin, pos);
+                }
+                const bool inArray = (arrays >> (nesting - 1)) & 1;
+                if (pos != end && *pos == ',') {
+                    ++pos;
+                    expect = inArray ? Expect::Value : Expect::Key;
+                    continue;
+                }
+                if (pos == end || *pos != (inArray ? ']' : '}')) {
+                    return syntax(begin, pos);
+                }
+                ++pos;
+                --nesting;
+                if (!leave()) {
+                    return false;
+                }
+                continue;
+            }
+
+            if (pos == end) {
+                return syntax(begin, pos);
+            }
+            const char* const token = pos;
+            switch (*pos) {
+                case '{':
+                case '[': {
+                    const bool isArray = *pos == '[';
+                    if (nesting == kMaxDepth) {
+                        return syntax(begin, pos);
+                    }
+                    ++pos;
+                    arrays = isArray ? arrays | (uint64_t{1} << nesting) : arrays & ~(uint64_t{1} << nesting);
+                    ++nesting;
+                    if (!(isArray ? startArray() : startObject())) {
+                        return rejected(begin, token);
+                    }
+                    skipSpace(pos, end);
+                    if (pos != end && *pos == (isArray ? ']' : '}')) {
+                        ++pos;
+                        --nesting;
+                        if (!leave()) {
+                            return false;
+                        }
+                        expect = Expect::Next;
+                    } else {
+                        expect = isArray ? Expect::Value : Expect::Key;
+                    }
+                    continue;
+                }
+                case '"': {
+                    std::string_view value;
+                    if (!readString(pos, end, value)) {
+                        return syntax(begin, pos);
+                    }
+                    if (!(accept() ? (field_ == kUnknown || finish(derived().onString(field_, value))) : fallback())) {
+                        return rejected(begin, token);
+                    }
+                    break;
+                }
+                case 't':
+                case 'f':
+                case 'n':
+                    if (!readLiteral(pos, end)) {
+                        return syntax(begin, pos);
+                    }
+                    if (!onLiteral()) {
+                        return rejected(begin, token);
+                    }
+                    break;
+                default:
+                    if (!readNumber(pos, end)) {
+                        return syntaxError_ ? syntax(begin, pos) : rejected(begin, token);
+                    }
+                    break;
+            }
+            expect = Expect::Next;
+        }
+    }
+
+    bool syntaxError() const { return syntaxError_; }
+    std::size_t errorPosition() const { return errorPosition_; }
+    int errorField() const { return errorField_; }
+
+private:
+    Derived& derived() { return static_cast<Derived&>(*this); }
+
+    /**
+     * @brief Records a syntax error at the 1-based position of the offending byte.
+     */
+    bool syntax(const char* begin, const char* pos) {
+        syntaxError_ = true;
+        errorPosition_ = static_cast<std::size_t>(pos - begin) + 1;
+        return false;
+    }
+
+    /**
+     * @brief Records the 1-based position of a value the handler rejected, e.g. a top-level array.
+     */
+    bool rejected(const char* begin, const char* token) {
+        errorPosition_ = static_cast<std::size_t>(token - begin) + 1;
+        return false;
+    }
+
+    static void skipSpace(const char*& pos, const char* end) {
+        while (pos != end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t')) {
+            ++pos;
+        }
+    }
+
+    static bool isDigit(const char* pos, const char* end) { return pos != end && *pos >= '0' && *pos <= '9'; }
+
+    /**
+     * @brief Buffer of the decoded strings with escapes, reused by every parse on the thread.
+     */
+    static std::string& scratch() {
+        static thread_local std::string buffer;
+        return buffer;
+    }
+
+    /**
+     * @brief Reads a string token, pos on its opening quote.
+     *
+     * @param[in,out] pos Read position, left on the offending byte on failure.
+     * @param[in] end End of the text.
+     * @param[out] value The string, a view into the text or into scratch().
+     * @return False if the token is malformed.
+     */
+    static bool readString(const char*& pos, const char* end, std::string_view& value) {
+        const char* const start = ++pos;
+        const char* copied = start;  // First byte not yet appended to decoded
+        std::string* decoded = nullptr;
+        while (pos != end) {
+            const unsigned char c = static_cast<unsigned char>(*pos);
+            if (c == '"') {
+                if (decoded) {
+                    decoded->append(copied, pos);
+                    value = *decoded;
+                } else {
+                    value = std::string_view(start, static_cast<std::size_t>(pos - start));
+                }
+                ++pos;
+                return true;
+            }
+            if (c < 0x20) {
+                return false;
+            }
+            if (c == '\\') {
+                if (!decoded) {
+                    decoded = &scratch();
+                    decoded->clear();
+                }
+                decoded->append(copied, pos);
+                ++pos;
+                if (!readEscape(pos, end, *decoded)) {
+                    return false;
+                }
+                copied = pos;
+            } else if (c >= 0x80) {
+                if (!skipUtf8(pos, end)) {
+                    return false;
+                }
+            } else {
+                ++pos;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Decodes the escape sequence after a backslash.
+     */
+    static bool readEscape(const char*& pos, const char* end, std::string& out) {
+        if (pos == end) {
+            return false;
+        }
+        switch (*pos) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                ++pos;
+                uint32_t code = 0;
+                if (!readHex4(pos, end, code) || (code >= 0xDC00 && code <= 0xDFFF)) {
+                    return false;
+                }
+                if (code >= 0xD800 && code <= 0xDBFF) {
+                    // A high surrogate must be followed by an escaped low surrogate
+                    uint32_t low = 0;
+                    if (end - pos < 2 || pos[0] != '\\' || pos[1] != 'u') {
+                        return false;
+                    }
+                    pos += 2;
+                    if (!readHex4(pos, end, low) || low < 0xDC00 || low > 0xDFFF) {
+                        return false;
+                    }
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+                appendUtf8(out, code);
+                return true;
+            }
+            default:
+                return false;
+        }
+        ++pos;
+        return true;
+    }
+
+    static bool readHex4(const char*& pos, const char* end, uint32_t& code) {
+        for (int i = 0; i < 4; ++i, ++pos) {
+            if (pos == end) {
+                return false;
+            }
+            const char c = *pos;
+            const int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+            if (digit < 0) {
+                return false;
+            }
+            code = (code << 4) | static_cast<uint32_t>(digit);
+        }
+        return true;
+    }
+
+    static void appendUtf8(std::string& out, uint32_t code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    /**
+     * @brief Skips one well-formed UTF-8 sequence of two to four bytes, see RFC 3629.
+     */
+    static bool skipUtf8(const char*& pos, const char* end) {
+        const unsigned char lead = static_cast<unsigned char>(*pos);
+        int continuation = 0;
+        unsigned char low = 0x80;
+        unsigned char high = 0xBF;
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            continuation = 1;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            continuation = 2;
+            low = lead == 0xE0 ? 0xA0 : 0x80;   // Overlong
+            high = lead == 0xED ? 0x9F : 0xBF;  // Surrogates
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            continuation = 3;
+            low = lead == 0xF0 ? 0x90 : 0x80;
+            high = lead == 0xF4 ? 0x8F : 0xBF;  // Above U+10FFFF
+        } else {
+            return false;
+        }
+        ++pos;
+        for (int i = 0; i < continuation; ++i, ++pos) {
+            const unsigned char byte = pos != end ? static_cast<unsigned char>(*pos) : 0;
+            if (pos == end || byte < low || byte > high) {
+                return false;
+            }
+            low = 0x80;
+            high = 0xBF;
+        }
+        return true;
+    }
+
+    static bool readLiteral(const char*& pos, const char* end) {
+        const std::string_view rest(pos, static_cast<std::size_t>(end - pos));
+        for (std::string_view literal : {std::string_view("true"), std::string_view("false"), std::string_view("null")}) {
+            if (rest.compare(0, literal.size(), literal) == 0) {
+                pos += literal.size();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Reads a number token and hands it to the derived class.
+     *
+     * @return False on a syntax error, then with syntaxError_ set by the caller, or if the
+     *         value was rejected.
+     */
+    bool readNumber(const char*& pos, const char* end) {
+        const char* const start = pos;
+        const bool negative = *pos == '-';
+        if (negative) {
+            ++pos;
+        }
+        if (!isDigit(pos, end)) {
+            return syntaxAt();
+        }
+        if (*pos == '0') {
+            ++pos;
+        } else {
+            while (isDigit(pos, end)) ++pos;
+        }
+        bool integer = true;
+        if (pos != end && *pos == '.') {
+            integer = false;
+            ++pos;
+            if (!isDigit(pos, end)) {
+                return syntaxAt();
+            }
+            while (isDigit(pos, end)) ++pos;
+        }
+        if (pos != end && (*pos == 'e' || *pos == 'E')) {
+            integer = false;
+            ++pos;
+            if (pos != end && (*pos == '+' || *pos == '-')) {
+                ++pos;
+            }
+            if (!isDigit(pos, end)) {
+                return syntaxAt();
+            }
+            while (isDigit(pos, end)) ++pos;
+        }
+
+        // Integers that do not fit 64 bits are passed as floating point, like nlohmann::json does
+        if (integer && negative) {
+            int64_t value = 0;
+            if (std::from_chars(start, pos, value).ec == std::errc()) {
+                return accept() ? (field_ == kUnknown || finish(derived().onInteger(field_, value))) : fallback();
+            }
+        } else if (integer) {
+            uint64_t value = 0;
+            if (std::from_chars(start, pos, value).ec == std::errc()) {
+                return accept() ? (field_ == kUnknown || finish(derived().onUnsigned(field_, value))) : fallback();
+            }
+        }
+        double value = 0;
+        if (std::from_chars(start, pos, value).ec != std::errc()) {
+            // Out of range: strtod underflows to zero, the token ends where strtod stops
+            value = std::strtod(start, nullptr);
+            if (!std::isfinite(value)) {
+                return syntaxAt();  // Rejected as a number overflow by nlohmann::json as well
+            }
+        }
+        return accept() ? (field_ == kUnknown || finish(derived().onFloat(field_, value))) : fallback();
+    }
+
+    bool syntaxAt() {
+        syntaxError_ = true;
+        return false;
+    }
+
+    bool onLiteral() {
+        if (skipDepth_ > 0 || (depth_ > 0 && field_ == kUnknown)) {
+            return true;
+        }
+        return fail(field_);
+    }
+
+    bool startObject() {
+        if (skipDepth_ > 0 || depth_ == 0) {
+            ++depth_;
+            return true;
+        }
+        if (depth_ == 1 && field_ <= groupMarker(0)) {
+            group_ = groupMarker(field_);  // The marker encoding is its own inverse
+            field_ = kUnknown;
+            ++depth_;
+            return true;
+        }
+        return enterSkipped();
+    }
+
+    bool startArray() {
+        if (depth_ == 0) {
+            return fail(kUnknown);
+        }
+        if (skipDepth_ > 0) {
+            ++depth_;
+            return true;
+        }
+        return enterSkipped();
+    }
+
+    void key(std::string_view name) {
+        if (skipDepth_ == 0) {
+            field_ = derived().lookup(depth_ == 2 ? group_ : -1, name);
+        }
+    }
+
+    // A value is handed to the derived class only for a known scalar key inside the object
+    bool accept() const { return skipDepth_ == 0 && depth_ > 0 && (field_ >= 0 || field_ == kUnknown); }
+
+    bool fallback() {
+        if (skipDepth_ > 0) {
+            return true;
+        }
+        return fail(field_);  // Top-level scalar or a scalar where a group was expected
+    }
+
+    bool finish(bool accepted) {
+        if (!accepted) {
+            return fail(field_);
+        }
+        field_ = kUnknown;
+        return true;
+    }
+
+    bool enterSkipped() {
+        if (field_ != kUnknown) {
+            return fail(field_);  // Container where a scalar field or a deeper group was expected
+        }
+        ++depth_;
+        skipDepth_ = depth_;
+        return true;
+    }
+
+    bool leave() {
+        if (skipDepth_ == depth_) {
+            skipDepth_ = 0;
+        } else if (skipDepth_ == 0 && depth_ == 2) {
+            group_ = -1;
+        }
+        --depth_;
+        field_ = kUnknown;
+        return true;
+    }
+
+    bool fail(int field) {
+        errorField_ = field;
+        return false;
+    }
+
+    int depth_ = 0;             ///< Current nesting depth, 1 inside the top-level object
+    int skipDepth_ = 0;         ///< Depth of the container being skipped, 0 if none
+    int group_ = -1;            ///< Index of the open group, -1 at the top level
+    int field_ = kUnknown;      ///< Lookup result of the last key
+    int errorField_ = kUnknown; ///< Field or group marker that caused the failure
+    std::size_t errorPosition_ = 0; ///< Byte position of the failure, 1-based
+    bool syntaxError_ = false;  ///< True if the text is not valid JSON
+};
+
+#endif // JSON_SAX_READER_H
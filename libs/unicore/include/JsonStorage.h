@@ -87,14 +87,30 @@ public:
      * @return The value as a string.
      */
     std::string getValue(const std::string& key) const override {
-        auto it = storage_.find(key);
-        if (it != storage_.end()) {
-            return it->second;
+        std::string value;
+        if (tryGetValue(key, value)) {
+            return value;
         }
         if (logger_) logger_->warn("Key '" + key + "' not found in storage");
         return "";
     }
 
+    /**
+     * @brief Get a configuration value by key without reporting a missing key.
+     *
+     * @param[in] key The key for the value.
+     * @param[out] value The value, unchanged if the key is missing.
+     * @return True if the key exists.
+     */
+    bool tryGetValue(const std::string& key, std::string& value) const override {
+        auto it = storage_.find(key);
+        if (it == storage_.end()) {
+            return false;
+        }
+        value = it->second;
+        return true;
+    }
+
     /**
      * @brief Set a configuration value.
      *
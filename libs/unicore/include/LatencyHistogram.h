@@ -0,0 +1,163 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Lock-free log-linear latency histogram in the style of HdrHistogram.
+ *
+ * Values below 32 are counted exactly. Larger values fall into 16 linear sub-buckets per
+ * power of two, so every bucket is within 1/16 (6.25%) of its values over the full
+ * uint64_t range. record() is two relaxed fetch_adds on a fixed array plus a rarely taken
+ * compare-exchange for the maximum, so recording from many threads needs no lock and
+ * never allocates. The sample count is derived from the buckets when reading.
+ */
+class LatencyHistogram {
+public:
+    static constexpr size_t kSubBuckets = 16;                     ///< Linear sub-buckets per power of two
+    static constexpr size_t kBucketCount = 61 * kSubBuckets;      ///< Covers every uint64_t value
+
+    /**
+     * @brief Struct representing a consistent-enough copy of a histogram for reporting.
+     *
+     * Counters are read one by one while recording continues, so a snapshot may be off by
+     * the few samples recorded during the copy.
+     */
+    struct Snapshot {
+        std::array<uint64_t, kBucketCount> counts{};  ///< Samples per bucket
+        uint64_t count = 0;                           ///< Total samples
+        uint64_t sum = 0;                             ///< Sum of all samples
+        uint64_t max = 0;                             ///< Largest sample
+
+        /**
+         * @brief Value at or below which the given fraction of samples lie.
+         *
+         * @param[in] fraction Fraction between 0 and 1, e.g. 0.999 for p99.9.
+         * @return Upper bound of the bucket holding the percentile, capped at max.
+         */
+        uint64_t percentile(double fraction) const {
+            if (count == 0) {
+                return 0;
+            }
+            const double target = fraction * static_cast<double>(count);
+            uint64_t rank = target <= 1.0 ? 1 : static_cast<uint64_t>(target + 0.999999);
+            if (rank > count) {
+                rank = count;
+            }
+            uint64_t seen = 0;
+            for (size_t i = 0; i < kBucketCount; ++i) {
+                seen += counts[i];
+                if (seen >= rank) {
+                    const uint64_t upper = highestEquivalent(i);
+                    return upper < max ? upper : max;
+                }
+            }
+            return max;
+        }
+
+        /**
+         * @brief Getter for the mean.
+         * @return Mean of all samples, 0 without samples.
+         */
+        double mean() const { return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+    };
+
+    /**
+     * @brief Records one sample.
+     *
+     * @param[in] value Sample, typically nanoseconds.
+     */
+    void record(uint64_t value) {
+        counts_[indexOf(value)].fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+        uint64_t max = max_.load(std::memory_order_relaxed);
+        while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Records the time elapsed since a point on the monotonic clock.
+     *
+     * @param[in] sinceNs Start time as returned by nowNs().
+     */
+    void recordSince(uint64_t sinceNs) {
+        const uint64_t now = nowNs();
+        record(now > sinceNs ? now - sinceNs : 0);
+    }
+
+    /**
+     * @brief Copies the current counters.
+     *
+     * @param[out] snapshot Destination of the copy.
+     */
+    void snapshot(Snapshot& snapshot) const {
+        snapshot.count = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            snapshot.counts[i] = counts_[i].load(std::memory_order_relaxed);
+            snapshot.count += snapshot.counts[i];
+        }
+        snapshot.sum = sum_.load(std::memory_order_relaxed);
+        snapshot.max = max_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Clears all counters, samples recorded concurrently may survive.
+     */
+    void reset() {
+        for (auto& counter : counts_) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Reads the monotonic clock used for all latency samples.
+     * @return Nanoseconds since an arbitrary epoch.
+     */
+    static uint64_t nowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    /**
+     * @brief Maps a value to its bucket.
+     *
+     * @param[in] value Sample value.
+     * @return Bucket index below kBucketCount.
+     */
+    static size_t indexOf(uint64_t value) {
+        if (value < 2 * kSubBuckets) {
+            return static_cast<size_t>(value);
+        }
+        // Keep the five most significant bits: a shift of 'exponent' leaves 16..31
+        const unsigned exponent = static_cast<unsigned>(63 - __builtin_clzll(value)) - 4;
+        return exponent * kSubBuckets + static_cast<size_t>(value >> exponent);
+    }
+
+    /**
+     * @brief Largest value that maps to a bucket.
+     *
+     * @param[in] index Bucket index.
+     * @return Upper bound of the bucket.
+     */
+    static uint64_t highestEquivalent(size_t index) {
+        if (index < 2 * kSubBuckets) {
+            return index;
+        }
+        const unsigned exponent = static_cast<unsigned>(index / kSubBuckets) - 1;
+        const uint64_t mantissa = index % kSubBuckets + kSubBuckets;
+        return ((mantissa + 1) << exponent) - 1;
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> counts_{};  ///< Samples per bucket
+    std::atomic<uint64_t> sum_{0};                              ///< Sum of all samples, for the mean
+    std::atomic<uint64_t> max_{0};                              ///< Largest sample
+};
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,85 @@
+#ifndef LATENCY_SIGNAL_DUMP_H
+#define LATENCY_SIGNAL_DUMP_H
+
+#include <atomic>
+#include <condition_variable>
+#include <csignal>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "VirtualBus.h"
+#include "ILogger.h"
+
+/**
+ * @brief Prints the VirtualBus latency histograms whenever the process receives a signal.
+ *
+ * The signal handler only raises a flag; a helper thread polls it and formats the report,
+ * so nothing unsafe runs in signal context. The report goes to the logger, or to stdout
+ * without one. Only one instance can own the signal at a time.
+ *
+ * Usage: `kill -USR1 <pid>`.
+ */
+class LatencySignalDump {
+public:
+    /**
+     * @brief Constructor installing the signal handler and starting the helper thread.
+     *
+     * @param[in] bus The bus whose latency is reported, must outlive this object.
+     * @param[in] signalNumber Signal that triggers a report.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     */
+    LatencySignalDump(VirtualBus& bus, int signalNumber = SIGUSR1, std::shared_ptr<ILogger> logger = nullptr);
+
+    /**
+     * @brief Destructor restoring the previous signal handler and stopping the thread.
+     */
+    ~LatencySignalDump();
+
+    LatencySignalDump(const LatencySignalDump&) = delete;
+    LatencySignalDump& operator=(const LatencySignalDump&) = delete;
+
+    /**
+     * @brief Getter for the installation state.
+     * @return True if the signal handler is installed.
+     */
+    bool isInstalled() const { return installed_; }
+
+    /**
+     * @brief Formats latency reports as a table in microseconds.
+     *
+     * Tasks without samples are left out.
+     *
+     * @param[in] reports Reports as returned by VirtualBus::getLatencyReports().
+     * @return The table, one line per task and delivery path.
+     */
+    static std::string format(const std::vector<VirtualBus::LatencyReport>& reports);
+
+private:
+    /**
+     * @brief Signal handler raising the report flag.
+     */
+    static void onSignal(int);
+
+    /**
+     * @brief Helper thread loop printing a report for every raised flag.
+     */
+    void run();
+
+    static std::atomic<bool> requested_;   ///< Raised by the signal handler
+    static std::atomic<bool> owned_;       ///< True while an instance owns the signal
+
+    VirtualBus& bus_;                      ///< Reported bus
+    int signalNumber_;                     ///< Handled signal
+    struct sigaction previous_{};          ///< Handler restored on destruction
+    bool installed_ = false;               ///< True if the handler was installed
+    bool stopping_ = false;                ///< Set to stop the helper thread
+    std::mutex mutex_;                     ///< Protects stopping_
+    std::condition_variable wake_;         ///< Wakes the helper thread on destruction
+    std::thread worker_;                   ///< Helper thread
+    std::shared_ptr<ILogger> logger_;      ///< Logger instance for logging messages
+};
+
+#endif // LATENCY_SIGNAL_DUMP_H
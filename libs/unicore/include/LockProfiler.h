@@ -0,0 +1,177 @@
+#ifndef LOCK_PROFILER_H
+#define LOCK_PROFILER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief Wait and hold time profiling of the core mutexes.
+ *
+ * The bus, thread pool, error handler and console logger lock through ProfiledMutex and
+ * the guards below. A build with ENABLE_LOCK_PROFILING=ON (VBUS_LOCK_PROFILING) records,
+ * per named lock and per locking call site, the acquisitions, contended acquisitions,
+ * time spent waiting and time the lock was held. Holds above a threshold are printed to
+ * stderr as they happen. Without the option ProfiledMutex is a std::mutex that only
+ * accepts a name, the guards are the standard ones and nothing is recorded.
+ */
+class LockProfiler {
+public:
+    /**
+     * @brief Getter for the build mode.
+     * @return True if the mutexes are instrumented.
+     */
+    static bool enabled();
+
+    /**
+     * @brief Sets the hold time above which a hold is counted and printed as a stall.
+     *
+     * @param[in] threshold Hold time threshold, 10 ms by default.
+     */
+    static void setHoldThreshold(std::chrono::nanoseconds threshold);
+
+    /**
+     * @brief Formats the locks and call sites with the most waiting time.
+     *
+     * @param[in] top Number of locks and of call sites to list.
+     * @return The report, or a note that profiling is disabled.
+     */
+    static std::string report(size_t top = 10);
+
+    /**
+     * @brief Clears all recorded statistics.
+     */
+    static void reset();
+};
+
+#ifdef VBUS_LOCK_PROFILING
+
+struct LockStats;
+struct LockSite;
+
+/**
+ * @brief Mutex recording wait and hold times for LockProfiler.
+ *
+ * lock() and try_lock() take the call site as default arguments, so locking through
+ * ProfiledLockGuard or ProfiledUniqueLock attributes the time to the guard's location.
+ */
+class ProfiledMutex {
+public:
+    /**
+     * @brief Constructor for ProfiledMutex.
+     *
+     * @param[in] name Lock name, mutexes with the same name share statistics.
+     */
+    explicit ProfiledMutex(const char* name);
+
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+    /**
+     * @brief Locks the mutex, timing the wait if it is contended.
+     *
+     * @param[in] file Call site file, filled in by the compiler.
+     * @param[in] line Call site line, filled in by the compiler.
+     */
+    void lock(const char* file = __builtin_FILE(), int line = __builtin_LINE());
+
+    /**
+     * @brief Locks the mutex if it is free.
+     *
+     * @param[in] file Call site file, filled in by the compiler.
+     * @param[in] line Call site line, filled in by the compiler.
+     * @return True if the mutex was acquired.
+     */
+    bool try_lock(const char* file = __builtin_FILE(), int line = __builtin_LINE());
+
+    /**
+     * @brief Unlocks the mutex and records the hold time.
+     */
+    void unlock();
+
+private:
+    std::mutex mutex_;           ///< The actual lock
+    LockStats* stats_;           ///< Statistics of the lock name
+    LockSite* holder_ = nullptr; ///< Call site of the current holder, written by the holder only
+    uint64_t acquiredNs_ = 0;    ///< Acquisition time of the current holder
+};
+
+/**
+ * @brief Scoped lock attributing its time to the location it is declared at.
+ */
+class ProfiledLockGuard {
+public:
+    explicit ProfiledLockGuard(ProfiledMutex& mutex, const char* file = __builtin_FILE(), int line = __builtin_LINE())
+        : mutex_(mutex) {
+        mutex_.lock(file, line);
+    }
+    ~ProfiledLockGuard() { mutex_.unlock(); }
+
+    ProfiledLockGuard(const ProfiledLockGuard&) = delete;
+    ProfiledLockGuard& operator=(const ProfiledLockGuard&) = delete;
+
+private:
+    ProfiledMutex& mutex_;  ///< Held mutex
+};
+
+/**
+ * @brief Non-movable unique lock for ProfiledConditionVariable waits.
+ *
+ * Relocking after a condition variable wait is attributed to the original location.
+ */
+class ProfiledUniqueLock {
+public:
+    explicit ProfiledUniqueLock(ProfiledMutex& mutex, const char* file = __builtin_FILE(), int line = __builtin_LINE())
+        : mutex_(mutex), file_(file), line_(line) {
+        lock();
+    }
+    ~ProfiledUniqueLock() {
+        if (owns_) {
+            mutex_.unlock();
+        }
+    }
+
+    ProfiledUniqueLock(const ProfiledUniqueLock&) = delete;
+    ProfiledUniqueLock& operator=(const ProfiledUniqueLock&) = delete;
+
+    void lock() {
+        mutex_.lock(file_, line_);
+        owns_ = true;
+    }
+    void unlock() {
+        owns_ = false;
+        mutex_.unlock();
+    }
+    bool owns_lock() const { return owns_; }
+
+private:
+    ProfiledMutex& mutex_;  ///< Locked mutex
+    const char* file_;      ///< Call site file
+    int line_;              ///< Call site line
+    bool owns_ = false;     ///< True while locked
+};
+
+using ProfiledConditionVariable = std::condition_variable_any;
+
+#else
+
+/**
+ * @brief Plain std::mutex that accepts the name used by profiling builds.
+ */
+class ProfiledMutex : public std::mutex {
+public:
+    explicit constexpr ProfiledMutex(const char*) noexcept {}
+};
+
+static_assert(sizeof(ProfiledMutex) == sizeof(std::mutex), "ProfiledMutex must add nothing to std::mutex");
+
+using ProfiledLockGuard = std::lock_guard<std::mutex>;
+using ProfiledUniqueLock = std::unique_lock<std::mutex>;
+using ProfiledConditionVariable = std::condition_variable;
+
+#endif // VBUS_LOCK_PROFILING
+
+#endif // LOCK_PROFILER_H
@@ -0,0 +1,211 @@
+#ifndef LOG_FORMAT_H
+#define LOG_FORMAT_H
+
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include "BinaryLogFormat.h"
+#include "LogLimiter.h"
+
+/**
+ * @brief Lowest log level compiled into the VBUS_LOG_* call sites.
+ *
+ * 0 debug, 1 info, 2 warning, 3 error, 4 critical. Set by the build through LOG_MIN_LEVEL;
+ * Release builds default to 2, which removes the debug and info call sites entirely.
+ */
+#ifndef VBUS_LOG_MIN_LEVEL
+#define VBUS_LOG_MIN_LEVEL 0
+#endif
+
+/**
+ * @brief Minimal "{}" formatting for log messages.
+ *
+ * Each "{}" in the format is replaced by the next argument, "{{" and "}}" produce literal
+ * braces. Supported arguments are strings, characters, booleans, arithmetic types, enums
+ * (as their underlying value) and pointers. Surplus arguments are ignored, surplus
+ * placeholders are kept as they are.
+ */
+namespace LogFormat {
+
+inline void appendArg(std::string& out, const std::string& value) {
+    out += value;
+}
+
+inline void appendArg(std::string& out, const char* value) {
+    out += value ? value : "(null)";
+}
+
+inline void appendArg(std::string& out, char value) {
+    out += value;
+}
+
+inline void appendArg(std::string& out, bool value) {
+    out += value ? "true" : "false";
+}
+
+inline void appendArg(std::string& out, const void* value) {
+    char buffer[24];
+    std::snprintf(buffer, sizeof(buffer), "%p", value);
+    out += buffer;
+}
+
+template <typename T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>
+inline void appendArg(std::string& out, T value) {
+    // Shortest round-trip form for floating point
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+template <typename T, typename std::enable_if<std::is_enum<T>::value, int>::type = 0>
+inline void appendArg(std::string& out, T value) {
+    appendArg(out, static_cast<typename std::underlying_type<T>::type>(value));
+}
+
+/**
+ * @brief Copies format text up to the next placeholder.
+ *
+ * @param[out] out Destination string.
+ * @param[in,out] format Remaining format, advanced past the placeholder.
+ * @return True if a placeholder was found.
+ */
+inline bool appendUntilPlaceholder(std::string& out, const char*& format) {
+    while (*format) {
+        if (format[0] == '{' && format[1] == '}') {
+            format += 2;
+            return true;
+        }
+        if ((format[0] == '{' && format[1] == '{') || (format[0] == '}' && format[1] == '}')) {
+            ++format;
+        }
+        out += *format++;
+    }
+    return false;
+}
+
+inline void formatInto(std::string& out, const char* format) {
+    while (appendUntilPlaceholder(out, format)) {
+        out += "{}";
+    }
+}
+
+template <typename First, typename... Rest>
+inline void formatInto(std::string& out, const char* format, const First& first, const Rest&... rest) {
+    if (!appendUntilPlaceholder(out, format)) {
+        return;
+    }
+    appendArg(out, first);
+    formatInto(out, format, rest...);
+}
+
+/**
+ * @brief Formats a message.
+ *
+ * @param[in] format Format with "{}" placeholders.
+ * @param[in] args Values replacing the placeholders in order.
+ * @return The formatted message.
+ */
+template <typename... Args>
+inline std::string format(const char* format, const Args&... args) {
+    std::string out;
+    out.reserve(std::strlen(format) + 16 * sizeof...(Args));
+    formatInto(out, format, args...);
+    return out;
+}
+
+} // namespace LogFormat
+
+/**
+ * @brief Logs through an ILogger pointer, formatting only if the level is enabled.
+ *
+ * The logger may be null. Levels below VBUS_LOG_MIN_LEVEL compile to nothing, arguments
+ * included, so they must not have side effects the caller relies on. If the logger has a
+ * binary sink, the arguments are encoded raw against the call site and never formatted,
+ * so the format must be a string literal.
+ *
+ * Example: `VBUS_LOG_INFO(logger_, "VirtualBus: Task {} (ID: {}) attached.", name, id);`
+ *
+ * Sites that fire per message use the *_LIMITED variants, which take a LogLimiter key:
+ * `VBUS_LOG_INFO_LIMITED(logger_, "pool.enqueue", "ThreadPool: Task enqueued.");`
+ */
+#define VBUS_LOG_AT_(logger, level, method, ...)                                                  \
+    do {                                                                                          \
+        const auto& vbusLogger_ = (logger);                                                       \
+        if (vbusLogger_ && vbusLogger_->isEnabled(level)) {                                       \
+            VBUS_LOG_EMIT_(vbusLogger_, level, method, __VA_ARGS__);                              \
+        }                                                                                         \
+    } while (0)
+
+/**
+ * @brief Like VBUS_LOG_AT_, but throttled by the LogLimiter rule of `limitKey`.
+ *
+ * A logged message is preceded by the number of messages the site suppressed since its
+ * previous one; if the site goes quiet, LogLimiter::flushSuppressed() writes the count.
+ */
+#define VBUS_LOG_LIMITED_AT_(logger, level, method, limitKey, ...)                                \
+    do {                                                                                          \
+        const auto& vbusLogger_ = (logger);                                                       \
+        if (vbusLogger_ && vbusLogger_->isEnabled(level)) {                                       \
+            static LogLimiter vbusLimiter_(limitKey);                                             \
+            uint64_t vbusSuppressed_ = 0;                                                         \
+            if (vbusLimiter_.admit(vbusSuppressed_, &*vbusLogger_, static_cast<int>(level))) {   \
+                if (vbusSuppressed_ > 0) {                                                        \
+                    VBUS_LOG_EMIT_(vbusLogger_, level, method,                                    \
+                                   "LogLimiter: {} suppressed {} messages.",                      \
+                                   vbusLimiter_.key(), vbusSuppressed_);                          \
+                }                                                                                 \
+                VBUS_LOG_EMIT_(vbusLogger_, level, method, __VA_ARGS__);                          \
+            }                                                                                     \
+        }                                                                                         \
+    } while (0)
+
+/**
+ * @brief Writes one message of an enabled level, binary or formatted. Implementation detail.
+ */
+#define VBUS_LOG_EMIT_(loggerRef, level, method, ...)                                             \
+    do {                                                                                          \
+        static BinaryLogFormat::Site vbusSite_(static_cast<int>(level), __FILE__, __LINE__);      \
+        if (auto* vbusSink_ = (loggerRef)->binarySink()) {                                        \
+            vbusSink_->write(vbusSite_, __VA_ARGS__);                                             \
+        } else {                                                                                  \
+            (loggerRef)->method(LogFormat::format(__VA_ARGS__));                                  \
+        }                                                                                         \
+    } while (0)
+
+#if VBUS_LOG_MIN_LEVEL <= 0
+#define VBUS_LOG_DEBUG(logger, ...) VBUS_LOG_AT_(logger, LogLevel::Debug, debug, __VA_ARGS__)
+#define VBUS_LOG_DEBUG_LIMITED(logger, key, ...) VBUS_LOG_LIMITED_AT_(logger, LogLevel::Debug, debug, key, __VA_ARGS__)
+#else
+#define VBUS_LOG_DEBUG(logger, ...) ((void)0)
+#define VBUS_LOG_DEBUG_LIMITED(logger, key, ...) ((void)0)
+#endif
+
+#if VBUS_LOG_MIN_LEVEL <= 1
+#define VBUS_LOG_INFO(logger, ...) VBUS_LOG_AT_(logger, LogLevel::Info, info, __VA_ARGS__)
+#define VBUS_LOG_INFO_LIMITED(logger, key, ...) VBUS_LOG_LIMITED_AT_(logger, LogLevel::Info, info, key, __VA_ARGS__)
+#else
+#define VBUS_LOG_INFO(logger, ...) ((void)0)
+#define VBUS_LOG_INFO_LIMITED(logger, key, ...) ((void)0)
+#endif
+
+#if VBUS_LOG_MIN_LEVEL <= 2
+#define VBUS_LOG_WARN(logger, ...) VBUS_LOG_AT_(logger, LogLevel::Warn, warn, __VA_ARGS__)
+#define VBUS_LOG_WARN_LIMITED(logger, key, ...) VBUS_LOG_LIMITED_AT_(logger, LogLevel::Warn, warn, key, __VA_ARGS__)
+#else
+#define VBUS_LOG_WARN(logger, ...) ((void)0)
+#define VBUS_LOG_WARN_LIMITED(logger, key, ...) ((void)0)
+#endif
+
+#if VBUS_LOG_MIN_LEVEL <= 3
+#define VBUS_LOG_ERROR(logger, ...) VBUS_LOG_AT_(logger, LogLevel::Error, error, __VA_ARGS__)
+#else
+#define VBUS_LOG_ERROR(logger, ...) ((void)0)
+#endif
+
+#define VBUS_LOG_CRITICAL(logger, ...) VBUS_LOG_AT_(logger, LogLevel::Critical, critical, __VA_ARGS__)
+
+#endif // LOG_FORMAT_H
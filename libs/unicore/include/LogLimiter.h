@@ -0,0 +1,154 @@
+#ifndef LOG_LIMITER_H
+#define LOG_LIMITER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+class ILogger;
+
+/**
+ * @brief Class throttling one log call site, see the VBUS_LOG_*_LIMITED macros.
+ *
+ * Every limited call site owns a static LogLimiter with a key such as "pool.enqueue". The
+ * rule of a key keeps every N-th message, at most M messages per second, or both; keys
+ * without a rule fall back to the "*" rule, and log everything if there is none. Rules can
+ * be replaced at any time with configure(); call sites pick up the change on their next
+ * message. A message logged after suppressed ones is preceded by a summary with their count;
+ * counts of sites that went quiet are written by flushSuppressed().
+ */
+class LogLimiter {
+public:
+    /**
+     * @brief Struct representing the throttling rule of a key.
+     */
+    struct Rule {
+        uint32_t every = 0;       ///< Keep every N-th message, 0 or 1 keeps all
+        uint32_t perSecond = 0;   ///< Keep at most this many messages per second, 0 for no limit
+    };
+
+    static constexpr std::chrono::seconds kFlushInterval{1};  ///< Interval of the flushSuppressed() calls by the loggers
+
+    /**
+     * @brief Constructor, constant-initialized so a static LogLimiter costs no guard.
+     *
+     * @param[in] key Key of the call site, a string literal.
+     */
+    constexpr explicit LogLimiter(const char* key) : key_(key) {}
+
+    /**
+     * @brief Decides whether the current message is logged.
+     *
+     * @param[out] suppressed Messages suppressed since the last logged one, set if admitted.
+     * @param[in] owner Logger of the call site, receives the count if flushSuppressed() reports it.
+     *                  A limiter given an owner must live until the program ends, as in the macros.
+     * @param[in] level LogLevel of the call site as int, used for that report.
+     * @return True if the message is logged.
+     */
+    bool admit(uint64_t& suppressed, ILogger* owner = nullptr, int level = 1) {
+        const uint32_t generation = generation_.load(std::memory_order_acquire);
+        if (cachedGeneration_.load(std::memory_order_relaxed) != generation) {
+            refresh(generation);
+        }
+        const uint32_t every = every_.load(std::memory_order_relaxed);
+        const uint32_t perSecond = perSecond_.load(std::memory_order_relaxed);
+
+        bool admitted = true;
+        if (every > 1) {
+            admitted = calls_.fetch_add(1, std::memory_order_relaxed) % every == 0;
+        }
+        if (admitted && perSecond > 0) {
+            const uint64_t second = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+            uint64_t window = window_.load(std::memory_order_relaxed);
+            if (window != second && window_.compare_exchange_strong(window, second, std::memory_order_relaxed)) {
+                inWindow_.store(0, std::memory_order_relaxed);
+            }
+            admitted = inWindow_.fetch_add(1, std::memory_order_relaxed) < perSecond;
+        }
+        if (!admitted) {
+            if (owner != nullptr && !linked_.load(std::memory_order_relaxed)) {
+                link();
+            }
+            owner_.store(owner, std::memory_order_relaxed);
+            level_.store(level, std::memory_order_relaxed);
+            suppressed_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        suppressed = suppressed_.load(std::memory_order_relaxed) != 0 ? suppressed_.exchange(0, std::memory_order_relaxed) : 0;
+        return true;
+    }
+
+    /**
+     * @brief Getter for the key of the call site.
+     * @return The key.
+     */
+    const char* key() const { return key_; }
+
+    /**
+     * @brief Sets the rule of a key, "*" for the default rule.
+     *
+     * @param[in] key The key.
+     * @param[in] rule The rule, an all-zero rule removes it.
+     */
+    static void setRule(const std::string& key, const Rule& rule);
+
+    /**
+     * @brief Replaces all rules with a configuration value.
+     *
+     * The value is a list of `key=rule` entries separated by ';' or ','; a rule is `every N`,
+     * `N/s`, both separated by a space, or `off`. Example:
+     * `pool.enqueue=every 100; bus.send=every 10 50/s; *=200/s`.
+     *
+     * @param[in] spec The configuration value, empty to remove all rules.
+     * @return False if an entry cannot be parsed; the valid entries are applied.
+     */
+    static bool configure(const std::string& spec);
+
+    /**
+     * @brief Writes the suppressed counts of call sites that went quiet.
+     *
+     * A count is written once it did not change since the previous call, so sites that are
+     * still active keep reporting with their next logged message. Only sites that last
+     * suppressed a message of this logger are reported. AsyncLogger and BinaryLogger call it
+     * from their background thread once per second and when they stop; other loggers have to
+     * call it themselves.
+     *
+     * @param[in] logger Logger to write the counts to.
+     * @param[in] quietOnly False to write every pending count, e.g. when the logger stops.
+     */
+    static void flushSuppressed(ILogger& logger, bool quietOnly = true);
+
+private:
+    /**
+     * @brief Reloads the rule of the call site after the rules changed.
+     *
+     * @param[in] generation Generation of the rules being loaded.
+     */
+    void refresh(uint32_t generation);
+
+    /**
+     * @brief Adds the call site to the list walked by flushSuppressed(), once.
+     */
+    void link();
+
+    static std::atomic<uint32_t> generation_;         ///< Incremented whenever the rules change
+    static std::atomic<LogLimiter*> registered_;      ///< Head of the list of call sites that logged, see next_
+
+    const char* key_;                                  ///< Key of the call site
+    std::atomic<uint32_t> cachedGeneration_{0};        ///< Generation of the cached rule, 0 before the first message
+    std::atomic<uint32_t> every_{0};                   ///< Cached Rule::every
+    std::atomic<uint32_t> perSecond_{0};               ///< Cached Rule::perSecond
+    std::atomic<uint64_t> calls_{0};                   ///< Messages seen, for sampling
+    std::atomic<uint64_t> window_{0};                  ///< Steady clock second of the rate window
+    std::atomic<uint32_t> inWindow_{0};                ///< Messages seen in the rate window
+    std::atomic<uint64_t> suppressed_{0};              ///< Messages suppressed since the last logged one
+    std::atomic<ILogger*> owner_{nullptr};             ///< Logger of the last suppressed message, compared only
+    std::atomic<int> level_{0};                        ///< Level of the last suppressed message
+    std::atomic<uint64_t> flushSeen_{0};               ///< suppressed_ seen by the previous flushSuppressed()
+    std::atomic<bool> linked_{false};                  ///< Set once the call site is in the registered_ list
+    LogLimiter* next_ = nullptr;                       ///< Next registered call site, set once by link()
+};
+
+#endif // LOG_LIMITER_H
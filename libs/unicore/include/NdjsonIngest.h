@@ -0,0 +1,78 @@
+#ifndef NDJSON_INGEST_H
+#define NDJSON_INGEST_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "VirtualBus.h"
+#include "ThreadPool.h"
+#include "ReturnType.h"
+#include "ILogger.h"
+
+/**
+ * @brief Bulk loader publishing newline-delimited JSON commands onto a VirtualBus.
+ *
+ * The file is memory-mapped and split into chunks that end on a line boundary. Chunks are
+ * parsed concurrently on a ThreadPool, each into its own batch of commands, while the calling
+ * thread publishes the finished batches with VirtualBus::sendMessages() in file order. At
+ * most two chunks per worker are in flight, so the memory of the ingest itself is bounded for
+ * any file size; the published commands stay alive until every subscriber has consumed them.
+ */
+class NdjsonIngest {
+public:
+    /**
+     * @brief Builds a parsed command from one line, or returns nullptr to reject the line.
+     *
+     * Called concurrently from the pool workers, so it must be thread-safe.
+     */
+    using CommandFactory = std::function<std::shared_ptr<VirtualBusCmd>(const std::string& line)>;
+
+    /**
+     * @brief Struct representing the outcome of an ingest run.
+     */
+    struct Result {
+        uint64_t lines = 0;                       ///< Non-empty lines read
+        uint64_t published = 0;                   ///< Commands published on the bus
+        uint64_t rejected = 0;                    ///< Lines the factory rejected
+        std::chrono::nanoseconds elapsed{0};      ///< Wall-clock duration of the ingest
+        double commandsPerSecond = 0.0;           ///< Published commands per second
+    };
+
+    /**
+     * @brief Constructor for NdjsonIngest.
+     *
+     * @param[in] bus The bus the commands are published on.
+     * @param[in] pool Thread pool the chunks are parsed on.
+     * @param[in] workers Number of pool threads available to the ingest, bounds the chunks in flight.
+     * @param[in] factory Line parser producing the commands.
+     * @param[in] chunkSize Approximate number of bytes per chunk.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     */
+    NdjsonIngest(VirtualBus& bus, ThreadPool& pool, size_t workers, CommandFactory factory,
+                 size_t chunkSize = 1024 * 1024, std::shared_ptr<ILogger> logger = nullptr);
+
+    /**
+     * @brief Ingests one NDJSON file.
+     *
+     * @param[in] path File to read.
+     * @param[in] senderId Sender identifier to publish with, must be attached to the bus.
+     * @param[out] result Ingest statistics.
+     * @return OK, NOT_FOUND if the file cannot be opened, ERROR if it cannot be mapped or the
+     *         bus rejects a batch, INVALID_ARGUMENT without a factory.
+     */
+    ReturnType ingest(const std::string& path, int senderId, Result& result);
+
+private:
+    VirtualBus& bus_;                      ///< Target bus
+    ThreadPool& pool_;                     ///< Parser workers
+    size_t workers_;                       ///< Worker count used to bound the chunks in flight
+    CommandFactory factory_;               ///< Line parser
+    size_t chunkSize_;                     ///< Approximate chunk size in bytes
+    std::shared_ptr<ILogger> logger_;      ///< Logger instance for logging messages
+};
+
+#endif // NDJSON_INGEST_H
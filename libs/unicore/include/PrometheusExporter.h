@@ -0,0 +1,102 @@
+#ifndef PROMETHEUS_EXPORTER_H
+#define PROMETHEUS_EXPORTER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "BusMetrics.h"
+#include "ReturnType.h"
+#include "ILogger.h"
+
+/**
+ * @brief Publishes BusMetrics in the Prometheus text format.
+ *
+ * Two independent outputs are available:
+ * - a file rewritten periodically through a rename, for the node_exporter textfile collector;
+ * - a minimal HTTP endpoint on 127.0.0.1 that answers every request with the metrics.
+ *
+ * Each output runs on its own thread and only reads the counters.
+ */
+class PrometheusExporter {
+public:
+    /**
+     * @brief Constructor for PrometheusExporter.
+     *
+     * @param[in] metrics Counters to export, must outlive the exporter.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     */
+    PrometheusExporter(const BusMetrics& metrics, std::shared_ptr<ILogger> logger = nullptr);
+
+    /**
+     * @brief Destructor stopping all outputs.
+     */
+    ~PrometheusExporter();
+
+    PrometheusExporter(const PrometheusExporter&) = delete;
+    PrometheusExporter& operator=(const PrometheusExporter&) = delete;
+
+    /**
+     * @brief Starts rewriting a file with the current metrics.
+     *
+     * @param[in] path Target file, written as path + ".tmp" and renamed.
+     * @param[in] interval Time between two writes.
+     * @return OK, BUSY if the file output already runs, ERROR if the file cannot be written.
+     */
+    ReturnType startFile(const std::string& path, std::chrono::milliseconds interval = std::chrono::seconds(5));
+
+    /**
+     * @brief Starts serving the metrics over HTTP on the loopback interface.
+     *
+     * @param[in] port TCP port, 0 picks a free one.
+     * @return OK, BUSY if the endpoint already runs, ERROR if the socket cannot be bound.
+     */
+    ReturnType startHttp(uint16_t port);
+
+    /**
+     * @brief Getter for the bound HTTP port.
+     * @return The port, 0 if the endpoint is not running.
+     */
+    uint16_t httpPort() const { return httpPort_; }
+
+    /**
+     * @brief Stops all outputs and writes the file a last time.
+     */
+    void stop();
+
+private:
+    /**
+     * @brief Writes the current metrics to the file output.
+     * @return True on success.
+     */
+    bool writeFile();
+
+    /**
+     * @brief File output loop.
+     */
+    void runFile();
+
+    /**
+     * @brief HTTP accept loop.
+     */
+    void runHttp();
+
+    const BusMetrics& metrics_;                  ///< Exported counters
+    std::string filePath_;                       ///< File output target
+    std::chrono::milliseconds fileInterval_{0};  ///< Time between two file writes
+    std::thread fileThread_;                     ///< File output thread
+    int listenFd_ = -1;                          ///< HTTP listening socket
+    uint16_t httpPort_ = 0;                      ///< Bound HTTP port
+    std::thread httpThread_;                     ///< HTTP accept thread
+    std::atomic<bool> stopping_{false};          ///< Set to stop both threads
+    std::mutex mutex_;                           ///< Protects the wait of the file thread
+    std::condition_variable wake_;               ///< Wakes the file thread on stop
+    std::shared_ptr<ILogger> logger_;            ///< Logger instance for logging messages
+};
+
+#endif // PROMETHEUS_EXPORTER_H
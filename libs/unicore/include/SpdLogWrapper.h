@@ -19,13 +19,26 @@ public:
         logger_->set_level(spdlog::level::info);  // Default log level
     }
 
+    /**
+     * @brief Log a debug message.
+     *
+     * @param[in] message The message to log.
+     */
+    void debug(const std::string& message) override {
+        if (isEnabled(LogLevel::Debug)) {
+            logger_->debug(message);
+        }
+    }
+
     /**
      * @brief Log an informational message.
      *
      * @param[in] message The message to log.
      */
     void info(const std::string& message) override {
-        logger_->info(message);
+        if (isEnabled(LogLevel::Info)) {
+            logger_->info(message);
+        }
     }
 
     /**
@@ -34,7 +47,9 @@ public:
      * @param[in] message The message to log.
      */
     void warn(const std::string& message) override {
-        logger_->warn(message);
+        if (isEnabled(LogLevel::Warn)) {
+            logger_->warn(message);
+        }
     }
 
     /**
@@ -43,7 +58,9 @@ public:
      * @param[in] message The message to log.
      */
     void error(const std::string& message) override {
-        logger_->error(message);
+        if (isEnabled(LogLevel::Error)) {
+            logger_->error(message);
+        }
     }
 
     /**
@@ -52,7 +69,21 @@ public:
      * @param[in] message The message to log.
      */
     void critical(const std::string& message) override {
-        logger_->critical(message);
+        if (isEnabled(LogLevel::Critical)) {
+            logger_->critical(message);
+        }
+    }
+
+    /**
+     * @brief Sets the lowest level that is logged, in this wrapper and in spdlog.
+     *
+     * @param[in] level The level, LogLevel::Off disables logging.
+     */
+    void setLevel(LogLevel level) override {
+        ILogger::setLevel(level);
+        static const spdlog::level::level_enum kLevels[] = {spdlog::level::debug, spdlog::level::info, spdlog::level::warn,
+                                                            spdlog::level::err, spdlog::level::critical, spdlog::level::off};
+        logger_->set_level(kLevels[static_cast<int>(level)]);
     }
 
 private:
@@ -2,6 +2,7 @@
 #define STD_COUT_LOGGER_H
 
 #include "ILogger.h"
+#include "LockProfiler.h"
 #include <iostream>
 #include <mutex>
 #include <string>
@@ -11,13 +12,29 @@
  */
 class StdCoutLogger : public ILogger {
 public:
+    /**
+     * @brief Log a debug message.
+     *
+     * @param[in] message The message to log.
+     */
+    void debug(const std::string& message) override {
+        if (!isEnabled(LogLevel::Debug)) {
+            return;
+        }
+        ProfiledLockGuard lock(mutex_);
+        std::cout << "[DEBUG]: " << message << std::endl;
+    }
+
     /**
      * @brief Log an informational message.
      *
      * @param[in] message The message to log.
      */
     void info(const std::string& message) override {
-        std::lock_guard<std::mutex> lock(mutex_);
+        if (!isEnabled(LogLevel::Info)) {
+            return;
+        }
+        ProfiledLockGuard lock(mutex_);
         std::cout << "[INFO]: " << message << std::endl;
     }
 
@@ -27,7 +44,10 @@ public:
      * @param[in] message The message to log.
      */
     void warn(const std::string& message) override {
-        std::lock_guard<std::mutex> lock(mutex_);
+        if (!isEnabled(LogLevel::Warn)) {
+            return;
+        }
+        ProfiledLockGuard lock(mutex_);
         std::cout << "[WARNING]: " << message << std::endl;
     }
 
@@ -37,7 +57,10 @@ public:
      * @param[in] message The message to log.
      */
     void error(const std::string& message) override {
-        std::lock_guard<std::mutex> lock(mutex_);
+        if (!isEnabled(LogLevel::Error)) {
+            return;
+        }
+        ProfiledLockGuard lock(mutex_);
         std::cerr << "[ERROR]: " << message << std::endl;
     }
 
@@ -47,12 +70,15 @@ public:
      * @param[in] message The message to log.
      */
     void critical(const std::string& message) override {
-        std::lock_guard<std::mutex> lock(mutex_);
+        if (!isEnabled(LogLevel::Critical)) {
+            return;
+        }
+        ProfiledLockGuard lock(mutex_);
         std::cerr << "[CRITICAL]: " << message << std::endl;
     }
 
 private:
-    std::mutex mutex_; ///< Mutex to ensure thread-safe logging
+    ProfiledMutex mutex_{"StdCoutLogger::mutex_"}; ///< Mutex to ensure thread-safe logging
 };
 
 #endif // STD_COUT_LOGGER_H
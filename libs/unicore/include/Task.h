@@ -6,6 +6,7 @@
 #include <thread>
 #include <atomic>
 #include "VirtualBus.h"
+#include "ThreadName.h"
 #include "ILogger.h"
 #include "ErrorHandler.h"
 #include <memory>
@@ -46,9 +47,7 @@ public:
     Task(const std::string& name, VirtualBus& bus, std::shared_ptr<ILogger> logger = nullptr)
         : name_(name), bus_(bus), running_(false), logger_(logger) {
             id_ = TaskID::getID();
-            if (logger_) {
-                logger_->info("Task: Initialized task " + name_ + " with ID " + std::to_string(id_));
-            }
+            VBUS_LOG_INFO(logger_, "Task: Initialized task {} with ID {}", name_, id_);
         }
 
     /**
@@ -56,9 +55,7 @@ public:
      */
     virtual ~Task() {
         stop();
-        if (logger_) {
-            logger_->info("Task: Destroyed task " + name_);
-        }
+        VBUS_LOG_INFO(logger_, "Task: Destroyed task {}", name_);
     }
 
     /**
@@ -67,10 +64,11 @@ public:
     virtual void start() {
         if (!running_) {
             running_ = true;
-            thread_ = std::thread(&Task::run, this);
-            if (logger_) {
-                logger_->info("Task: Started task " + name_);
-            }
+            thread_ = std::thread([this] {
+                ThreadName::set("task-" + name_);
+                run();
+            });
+            VBUS_LOG_INFO(logger_, "Task: Started task {}", name_);
         }
     }
 
@@ -80,9 +78,7 @@ public:
     virtual void join() {
         if (thread_.joinable()) {
             thread_.join();
-            if (logger_) {
-                logger_->info("Task: Joined task " + name_);
-            }
+            VBUS_LOG_INFO(logger_, "Task: Joined task {}", name_);
         }
     }
 
@@ -96,9 +92,7 @@ public:
             if (thread_.joinable()) {
                 thread_.join();
             }
-            if (logger_) {
-                logger_->info("Task: Stopped task " + name_);
-            }
+            VBUS_LOG_INFO(logger_, "Task: Stopped task {}", name_);
         }
     }
 
@@ -0,0 +1,31 @@
+#ifndef THREAD_NAME_H
+#define THREAD_NAME_H
+
+#include <string>
+
+#include <pthread.h>
+
+#include "Tracer.h"
+
+/**
+ * @brief Names the calling thread for the OS and the Tracer.
+ *
+ * The OS name is what top -H, perf, gdb and /proc/<pid>/task/<tid>/comm show. Linux keeps
+ * at most 15 characters, longer names are cut.
+ */
+class ThreadName {
+public:
+    /**
+     * @brief Sets the name of the calling thread.
+     *
+     * @param[in] name Thread name, for example "vbus-pool-3" or "task-Sender".
+     */
+    static void set(const std::string& name) {
+        ::pthread_setname_np(::pthread_self(), name.substr(0, kMaxLength).c_str());
+        Tracer::setThreadName(name);
+    }
+
+    static constexpr size_t kMaxLength = 15;  ///< Longest name the kernel keeps
+};
+
+#endif // THREAD_NAME_H
@@ -12,6 +12,7 @@
 #include <atomic>
 #include "ILogger.h"
 #include "ErrorHandler.h"
+#include "LockProfiler.h"
 #include <memory>
 
 /**
@@ -52,8 +53,8 @@ private:
     std::vector<std::thread> workers_;  ///< Vector containing worker threads
     std::queue<std::function<void()>> tasks_;  ///< Queue of tasks to be executed
 
-    std::mutex queueMutex_;  ///< Mutex for synchronizing access to the task queue
-    std::condition_variable condition_;  ///< Condition variable to notify worker threads
+    ProfiledMutex queueMutex_{"ThreadPool::queueMutex_"};  ///< Mutex for synchronizing access to the task queue
+    ProfiledConditionVariable condition_;  ///< Condition variable to notify worker threads
     std::atomic<bool> stop_;  ///< Atomic flag to indicate if the pool should stop
 };
 
@@ -71,22 +72,18 @@ auto ThreadPool::enqueue(F&& f, Args&&... args)
 
         std::future<ReturnType> result = task->get_future();
         {
-            std::unique_lock<std::mutex> lock(queueMutex_);
+            ProfiledUniqueLock lock(queueMutex_);
 
             // Don't allow enqueueing after stopping the pool
             if (stop_) {
-                if (logger_) {
-                    logger_->error("ThreadPool: Attempted to enqueue on stopped ThreadPool.");
-                }
+                VBUS_LOG_ERROR(logger_, "ThreadPool: Attempted to enqueue on stopped ThreadPool.");
                 throw std::runtime_error("enqueue on stopped ThreadPool");
             }
 
             tasks_.emplace([task]() { (*task)(); });
         }
         condition_.notify_one();
-        if (logger_) {
-            logger_->info("ThreadPool: Task enqueued.");
-        }
+        VBUS_LOG_INFO_LIMITED(logger_, "pool.enqueue", "ThreadPool: Task enqueued.");
         return result;
 }
 
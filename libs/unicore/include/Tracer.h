@@ -0,0 +1,177 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "ReturnType.h"
+#include "ILogger.h"
+
+/**
+ * @brief Records the lifecycle of bus messages as Chrome trace events.
+ *
+ * Every thread appends to its own buffer, so recording never contends with other threads.
+ * While stopped, each instrumentation point costs one relaxed atomic load. The bus tags
+ * every published message with a trace id and emits:
+ * - a sendMessage slice on the sender thread with one flow arrow per subscriber;
+ * - a "queued" async span per subscriber, from publish until pickup;
+ * - the thread pool task, callback and consumer slices, ending the flow arrows.
+ *
+ * writeChromeJson() produces the JSON object format understood by chrome://tracing and the
+ * Perfetto UI (ui.perfetto.dev). Event names must be string literals.
+ */
+class Tracer {
+public:
+    static constexpr uint64_t kNoMessage = 0;  ///< Message id of events not tied to a message
+    static constexpr int kNoTask = -1;         ///< Task id of events not tied to a task
+
+    /**
+     * @brief Clears all buffers and starts recording.
+     *
+     * @param[in] maxEventsPerThread Events kept per thread, later events are counted as dropped.
+     */
+    static void start(size_t maxEventsPerThread = 1u << 20);
+
+    /**
+     * @brief Stops recording, the buffers are kept until the next start().
+     */
+    static void stop();
+
+    /**
+     * @brief Getter for the recording state.
+     * @return True between start() and stop().
+     */
+    static bool active() { return active_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Writes the recorded events in the Chrome trace event format.
+     *
+     * Safe to call while recording; events recorded meanwhile may be left out.
+     *
+     * @param[in] path Target file.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     * @return OK, or ERROR if the file cannot be written.
+     */
+    static ReturnType writeChromeJson(const std::string& path, std::shared_ptr<ILogger> logger = nullptr);
+
+    /**
+     * @brief Names the calling thread in the trace.
+     *
+     * @param[in] name Thread name shown on the timeline.
+     */
+    static void setThreadName(const std::string& name);
+
+    /**
+     * @brief Allocates the trace ids of published messages.
+     *
+     * @param[in] count Number of consecutive ids.
+     * @return The first of count process-wide unique ids, never kNoMessage.
+     */
+    static uint64_t nextMessageId(size_t count = 1) { return nextMessageId_.fetch_add(count, std::memory_order_relaxed); }
+
+    /**
+     * @brief Getter for the message the calling thread is handling.
+     * @return The id set by the innermost TraceScope with a message, or kNoMessage.
+     */
+    static uint64_t currentMessage();
+
+    /**
+     * @brief Monotonic clock used for the timestamps.
+     * @return Nanoseconds since an arbitrary epoch.
+     */
+    static uint64_t nowNs();
+
+    /**
+     * @brief Records a slice on the calling thread.
+     *
+     * @param[in] name Event name.
+     * @param[in] startNs Start time from nowNs().
+     * @param[in] endNs End time from nowNs().
+     * @param[in] messageId Message the slice handled, or kNoMessage.
+     * @param[in] taskId Task the slice ran for, or kNoTask.
+     */
+    static void complete(const char* name, uint64_t startNs, uint64_t endNs, uint64_t messageId, int taskId);
+
+    /**
+     * @brief Starts the "queued" span and the flow arrow of a message towards a subscriber.
+     *
+     * Called inside the publish slice.
+     *
+     * @param[in] messageId The published message.
+     * @param[in] taskId The subscriber.
+     */
+    static void enqueued(uint64_t messageId, int taskId);
+
+    /**
+     * @brief Ends the "queued" span and the flow arrow of a message at its subscriber.
+     *
+     * Called inside the slice that picked the message up.
+     *
+     * @param[in] messageId The delivered message.
+     * @param[in] taskId The subscriber.
+     */
+    static void dequeued(uint64_t messageId, int taskId);
+
+private:
+    friend class TraceScope;
+
+    /**
+     * @brief Replaces the message of the calling thread.
+     *
+     * @param[in] messageId New message id.
+     * @return The previous message id.
+     */
+    static uint64_t exchangeCurrentMessage(uint64_t messageId);
+
+    static std::atomic<bool> active_;              ///< Recording state
+    static std::atomic<uint64_t> nextMessageId_;   ///< Next message trace id
+};
+
+/**
+ * @brief Records a slice covering its own lifetime.
+ *
+ * While alive it is the calling thread's current message, so nested scopes that do not name
+ * a message are tagged with it.
+ */
+class TraceScope {
+public:
+    /**
+     * @brief Constructor starting the slice if the tracer is recording.
+     *
+     * @param[in] name Event name, a string literal.
+     * @param[in] taskId Task the slice runs for, or Tracer::kNoTask.
+     * @param[in] messageId Message the slice handles, the enclosing scope's by default.
+     */
+    explicit TraceScope(const char* name, int taskId = Tracer::kNoTask, uint64_t messageId = Tracer::currentMessage())
+        : name_(name), taskId_(taskId), messageId_(messageId) {
+        if (Tracer::active()) {
+            startNs_ = Tracer::nowNs();
+            previousMessage_ = Tracer::exchangeCurrentMessage(messageId_);
+        }
+    }
+
+    /**
+     * @brief Destructor recording the slice.
+     */
+    ~TraceScope() {
+        if (startNs_ != 0) {
+            Tracer::exchangeCurrentMessage(previousMessage_);
+            Tracer::complete(name_, startNs_, Tracer::nowNs(), messageId_, taskId_);
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;                             ///< Event name
+    int taskId_;                                   ///< Task of the slice
+    uint64_t messageId_;                           ///< Message of the slice
+    uint64_t previousMessage_ = Tracer::kNoMessage; ///< Message of the enclosing scope
+    uint64_t startNs_ = 0;                         ///< Start time, 0 if not recording
+};
+
+#endif // TRACER_H
@@ -11,9 +11,16 @@
 #include <functional>
 #include <string>
 #include <atomic>
+#include <chrono>
+#include <vector>
 
 #include "ThreadPool.h"
+#include "LockProfiler.h"
+#include "LatencyHistogram.h"
+#include "Tracer.h"
+#include "BusMetrics.h"
 #include "VirtualBusCmd.h"
+#include "IBusObserver.h"
 #include "ReturnType.h"
 #include "ILogger.h"
 
@@ -27,6 +34,20 @@ private:
 public:
     using CallbackFunction = std::function<void(std::shared_ptr<VirtualBusCmd>)>;
 
+    /**
+     * @brief Struct representing the delivery latency of one attached task.
+     *
+     * All values are nanoseconds on the monotonic clock, measured from entry into
+     * sendMessage() or sendMessages().
+     */
+    struct LatencyReport {
+        int taskId = 0;                                    ///< The identifier of the task
+        std::string name;                                  ///< The name of the task
+        LatencyHistogram::Snapshot queueDelay;             ///< Publish until receiveMessage() returns the message
+        LatencyHistogram::Snapshot callbackDelay;          ///< Publish until the callback starts
+        LatencyHistogram::Snapshot callbackDuration;       ///< Time spent inside the callback
+    };
+
     /**
      * @brief Constructor for VirtualBus.
      *
@@ -66,10 +87,22 @@ public:
      * @brief Sends a message from a sender to the virtual bus.
      *
      * @param[in] senderId The identifier of the sender.
-     * @param[in] message The message to be sent.
+     * @param[in] message The message to be sent, an empty pointer is rejected.
      */
     void sendMessage(int senderId, const std::shared_ptr<VirtualBusCmd>& message);
 
+    /**
+     * @brief Sends a batch of messages from a sender in order.
+     *
+     * The bus lock is taken once for the whole batch and each subscriber callback is
+     * scheduled as a single thread pool task that walks the batch in order.
+     *
+     * @param[in] senderId The identifier of the sender.
+     * @param[in] messages The messages to be sent, null entries are skipped. Pass an rvalue to avoid a copy.
+     * @return OK, or NOT_FOUND if the sender is not attached.
+     */
+    ReturnType sendMessages(int senderId, std::vector<std::shared_ptr<VirtualBusCmd>> messages);
+
     /**
      * @brief Receives a message for a specific task from the virtual bus.
      *
@@ -80,24 +113,133 @@ public:
     bool receiveMessage(int taskId, std::shared_ptr<VirtualBusCmd>& message);
 
     /**
-     * @brief Shuts down the virtual bus.
+     * @brief Receives a message for a specific task, waiting at most the given time.
+     *
+     * Returns early only for a message or a shutdown; a task that is not attached waits the
+     * whole timeout, so a polling loop does not spin.
+     *
+     * @param[in] taskId The identifier of the task.
+     * @param[out] message The message received by the task.
+     * @param[in] timeout Maximum time to wait for a message.
+     * @return True if a message is received, otherwise false.
+     */
+    bool receiveMessage(int taskId, std::shared_ptr<VirtualBusCmd>& message, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Shuts down the virtual bus, later calls do nothing.
      */
     void shutdown();
 
+    /**
+     * @brief Adds an observer that sees every published message.
+     *
+     * @param[in] observer The observer to add.
+     */
+    void addObserver(std::shared_ptr<IBusObserver> observer);
+
+    /**
+     * @brief Removes a previously added observer.
+     *
+     * @param[in] observer The observer to remove.
+     */
+    void removeObserver(const std::shared_ptr<IBusObserver>& observer);
+
+    /**
+     * @brief Copies the delivery latency histograms of one task.
+     *
+     * Recording continues while the histograms are copied and never takes the bus lock.
+     *
+     * @param[in] taskId The identifier of the task.
+     * @param[out] report Latency of the task.
+     * @return OK, or NOT_FOUND if the task is not attached.
+     */
+    ReturnType getLatency(int taskId, LatencyReport& report);
+
+    /**
+     * @brief Copies the delivery latency histograms of all attached tasks.
+     *
+     * @return One report per task, ordered by task identifier.
+     */
+    std::vector<LatencyReport> getLatencyReports();
+
+    /**
+     * @brief Clears the latency histograms of all attached tasks.
+     */
+    void resetLatency();
+
+    /**
+     * @brief Getter for the message counters, readable without the bus lock.
+     * @return Counters per task and command type.
+     */
+    BusMetrics& getMetrics() { return metrics_; }
+
+    /**
+     * @brief Getter for the running state of the bus.
+     * @return True until shutdown() is called.
+     */
+    bool isRunning() const { return running_; }
+
 private:
+    /**
+     * @brief Struct representing the latency histograms of a task.
+     *
+     * Shared with the callback tasks in flight, so a detach does not invalidate them.
+     */
+    struct TaskLatency {
+        LatencyHistogram queueDelay;        ///< Publish until dequeue
+        LatencyHistogram callbackDelay;     ///< Publish until callback start
+        LatencyHistogram callbackDuration;  ///< Callback run time
+    };
+
+    /**
+     * @brief Struct representing a queued message and its publish time.
+     */
+    struct QueuedMessage {
+        std::shared_ptr<VirtualBusCmd> message;  ///< The queued message
+        uint64_t publishedNs;                    ///< Monotonic publish time in nanoseconds
+        uint64_t traceId;                        ///< Tracer message id, kNoMessage if published while not tracing
+    };
+
     /**
      * @brief Struct representing information about a task.
      */
     struct TaskInfo {
         std::string name;  ///< The name of the task
-        std::queue<std::shared_ptr<VirtualBusCmd>> messageQueue;  ///< Queue of messages for the task
+        std::queue<QueuedMessage> messageQueue;  ///< Queue of messages for the task
         CallbackFunction callback;  ///< Callback function for the task
+        std::shared_ptr<TaskLatency> latency;  ///< Delivery latency of the task
+        std::shared_ptr<BusMetrics::TaskCounters> metrics;  ///< Message counters of the task
     };
 
+    /**
+     * @brief Wraps a callback so that it records its start delay, duration and the delivery.
+     *
+     * @param[in] callback The callback function of the subscriber.
+     * @param[in] latency Histograms of the subscriber.
+     * @param[in] counters Message counters of the subscriber.
+     * @param[in] publishedNs Monotonic publish time in nanoseconds.
+     * @param[in] traceId Tracer message id of the message.
+     * @param[in] message The message to deliver.
+     */
+    void invokeTimed(const CallbackFunction& callback, TaskLatency& latency, BusMetrics::TaskCounters& counters,
+                     uint64_t publishedNs, uint64_t traceId, const std::shared_ptr<VirtualBusCmd>& message);
+
+    /**
+     * @brief Takes the oldest message from the queue of a task. Must be called with busMutex_ held.
+     *
+     * @param[in] taskId The identifier of the task.
+     * @param[in] taskInfo The task, its queue must not be empty.
+     * @param[out] message The message received by the task.
+     * @param[in] enteredNs Tracer time the receive call started, 0 if not tracing.
+     */
+    void popMessage(int taskId, TaskInfo& taskInfo, std::shared_ptr<VirtualBusCmd>& message, uint64_t enteredNs);
+
     std::unordered_map<int, TaskInfo> tasks_;  ///< Map of tasks registered with the virtual bus
-    std::mutex busMutex_;  ///< Mutex for synchronizing access to the bus
-    std::condition_variable busConditionVariable_;  ///< Condition variable for message synchronization
+    std::vector<std::shared_ptr<IBusObserver>> observers_;  ///< Observers notified on every publish
+    ProfiledMutex busMutex_{"VirtualBus::busMutex_"};  ///< Mutex for synchronizing access to the bus
+    ProfiledConditionVariable busConditionVariable_;  ///< Condition variable for message synchronization
     std::atomic<bool> running_;  ///< Atomic flag indicating whether the bus is running
+    BusMetrics metrics_;  ///< Message counters, outlive the thread pool below
 
     ThreadPool threadPool_;  ///< Thread pool for handling tasks
 };
@@ -2,13 +2,14 @@
 #ifndef VIRTUAL_BUS_COMMAND_H
 #define VIRTUAL_BUS_COMMAND_H
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <chrono>
 #include <iostream>
+#include "ReturnType.h"
 #include "ILogger.h"
 
-class JsonCmdParser;
 /**
  * @brief Enumeration representing command types.
  */
@@ -16,7 +17,16 @@ enum class CommandType {
     Inverter = 0,
     Battery,
     Gateway,
-    Json
+    Json,
+    Diagnostic
+};
+
+/**
+ * @brief Details of a rejected command payload, filled by VirtualBusCmd::tryParse().
+ */
+struct ParseError {
+    size_t position = 0;     ///< 1-based byte position of a syntax error or non-object input, 0 for rejected values
+    const char* field = "";  ///< JSON key of the rejected value, empty for syntax errors
 };
 
 /**
@@ -35,9 +45,7 @@ public:
     VirtualBusCmd(std::shared_ptr<ILogger> logger = nullptr)
         : commandString_(""), timestamp_(0), type_(CommandType::Json), logger_(logger) {
         updateTimestamp();
-        if (logger_) {
-            logger_->info("VirtualBusCmd: Command created with default type Json.");
-        }
+        VBUS_LOG_INFO_LIMITED(logger_, "cmd.create", "VirtualBusCmd: Command created with default type Json.");
     }
 
     /**
@@ -48,43 +56,48 @@ public:
         auto tse = now.time_since_epoch();
         auto millisecondsTime = std::chrono::duration_cast<std::chrono::milliseconds>(tse);
         timestamp_ = uint64_t(millisecondsTime.count());
-        if (logger_) {
-            logger_->info("VirtualBusCmd: Timestamp updated to " + std::to_string(timestamp_));
-        }
+        VBUS_LOG_INFO_LIMITED(logger_, "cmd.timestamp", "VirtualBusCmd: Timestamp updated to {}", timestamp_);
     }
 
     /**
-     * @brief Setter for the command parser.
+     * @brief Parses the given parameters using the parser registered for the command type.
+     *
+     * Logs the reason of a failure, see tryParse() for the silent variant.
      *
-     * @param[in] parser Shared pointer to a JSON command parser.
+     * @param[in] parameters JSON string representing command parameters.
+     * @return True if parsing is successful, otherwise false.
      */
-    void setParser(std::shared_ptr<JsonCmdParser> parser) {
-        parser_ = parser;
-        if (logger_) {
-            logger_->info("VirtualBusCmd: Parser set.");
-        }
-    }
+    bool parse(const std::string& parameters) ;
 
     /**
-     * @brief Parses the given parameters using the injected parser.
+     * @brief Parses the given parameters without throwing or logging.
+     *
+     * Malformed input is reported through the return value, so a burst of bad payloads costs
+     * about as much as valid ones.
      *
      * @param[in] parameters JSON string representing command parameters.
-     * @return True if parsing is successful, otherwise false.
+     * @param[out] error Position or field of the failure, untouched on success.
+     * @return OK, ERROR for malformed JSON, INVALID_ARGUMENT for a rejected value or a parser
+     *         of the wrong type, NOT_FOUND if no parser is registered for the command type.
      */
-    bool parse(const std::string& parameters) ;
+    ReturnType tryParse(const std::string& parameters, ParseError& error);
 
     /**
      * @brief Pure virtual function to print the command details.
      */
     virtual void print() const = 0;
 
+    /**
+     * @brief Getter for the payload size, counted by the bus metrics.
+     * @return Size of the encoded payload in bytes, 0 if the command type has no fixed encoding.
+     */
+    virtual size_t payloadSize() const { return 0; }
+
     /**
      * @brief Virtual destructor for VirtualBusCmd.
      */
     virtual ~VirtualBusCmd() {
-        if (logger_) {
-            logger_->info("VirtualBusCmd: Command destroyed.");
-        }
+        VBUS_LOG_INFO_LIMITED(logger_, "cmd.destroy", "VirtualBusCmd: Command destroyed.");
     }
 
     /**
@@ -106,17 +119,12 @@ protected:
     void printBase() const {
         std::cout << "VirtualBusCmd: " << commandString_ << std::endl;
         std::cout << "Timestamp: " << timestamp_ << std::endl;
-        if (logger_) {
-            logger_->info("VirtualBusCmd: Printed base command details.");
-        }
+        VBUS_LOG_INFO_LIMITED(logger_, "cmd.print", "VirtualBusCmd: Printed base command details.");
     }
 
     std::string commandString_;  ///< Command string representing the command details
     uint64_t timestamp_ = 0;  ///< Timestamp of the command
     CommandType type_;  ///< Type of the command
-
-private:
-    std::shared_ptr<JsonCmdParser> parser_;  ///< Parser for JSON command parsing
 };
 
 #endif // VIRTUAL_BUS_COMMAND_H
@@ -0,0 +1,107 @@
+#ifndef WIRE_FORMAT_H
+#define WIRE_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "ReturnType.h"
+
+/**
+ * @brief Primitives of the compact binary wire format for bus commands.
+ *
+ * A frame is a 4-byte WireHeader followed by a fixed-layout payload. All fields are
+ * little-endian and unaligned; readers load them with memcpy so payloads can be viewed
+ * in place inside any receive buffer, journal segment or shared memory region.
+ */
+namespace WireFormat {
+
+constexpr uint8_t kVersion = 1;
+constexpr size_t kHeaderSize = 4;
+
+/**
+ * @brief Decoded frame header.
+ */
+struct WireHeader {
+    uint8_t version = kVersion;    ///< Format version of the payload layout
+    uint8_t type = 0;              ///< CommandType of the payload
+    uint16_t payloadSize = 0;      ///< Payload bytes following the header
+};
+
+/**
+ * @brief Stores a scalar in little-endian byte order.
+ *
+ * @param[out] buffer Destination, need not be aligned.
+ * @param[in] value Value to store.
+ */
+template <typename T>
+inline void store(uint8_t* buffer, T value) {
+    static_assert(std::is_arithmetic<T>::value, "Only scalars are stored on the wire");
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        buffer[i] = bytes[sizeof(T) - 1 - i];
+    }
+#else
+    std::memcpy(buffer, &value, sizeof(T));
+#endif
+}
+
+/**
+ * @brief Loads a little-endian scalar.
+ *
+ * @param[in] buffer Source, need not be aligned.
+ * @return Loaded value.
+ */
+template <typename T>
+inline T load(const uint8_t* buffer) {
+    static_assert(std::is_arithmetic<T>::value, "Only scalars are loaded from the wire");
+    T value;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    uint8_t bytes[sizeof(T)];
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        bytes[i] = buffer[sizeof(T) - 1 - i];
+    }
+    std::memcpy(&value, bytes, sizeof(T));
+#else
+    std::memcpy(&value, buffer, sizeof(T));
+#endif
+    return value;
+}
+
+/**
+ * @brief Writes a frame header.
+ *
+ * @param[out] buffer Destination of at least kHeaderSize bytes.
+ * @param[in] type CommandType of the payload.
+ * @param[in] payloadSize Payload bytes following the header.
+ */
+inline void writeHeader(uint8_t* buffer, uint8_t type, uint16_t payloadSize) {
+    buffer[0] = kVersion;
+    buffer[1] = type;
+    store<uint16_t>(buffer + 2, payloadSize);
+}
+
+/**
+ * @brief Reads and validates a frame header.
+ *
+ * @param[in] buffer Frame start.
+ * @param[in] size Bytes available in the buffer.
+ * @param[out] header Decoded header.
+ * @return OK, INVALID_ARGUMENT if the frame is truncated or has an unknown version.
+ */
+inline ReturnType readHeader(const uint8_t* buffer, size_t size, WireHeader& header) {
+    if (size < kHeaderSize || buffer[0] != kVersion) {
+        return ReturnType::INVALID_ARGUMENT;
+    }
+    header.version = buffer[0];
+    header.type = buffer[1];
+    header.payloadSize = load<uint16_t>(buffer + 2);
+    return (kHeaderSize + header.payloadSize <= size) ? ReturnType::OK : ReturnType::INVALID_ARGUMENT;
+}
+
+} // namespace WireFormat
+
+#endif // WIRE_FORMAT_H
@@ -0,0 +1,411 @@
+#include "AsyncLogger.h"
+#include "ThreadName.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * @brief Struct representing one ring record.
+ */
+struct AsyncLogRecord {
+    uint64_t stamp;             ///< orderStamp() of the call
+    std::string* overflow;      ///< Messages longer than kInlineText, owned by the record
+    uint16_t length;            ///< Inline message length
+    uint8_t level;              ///< AsyncLogger::Level
+    char text[AsyncLogger::kInlineText];  ///< Inline message bytes
+};
+
+/**
+ * @brief Single-producer single-consumer ring of one producer thread.
+ *
+ * The producer owns head and cachedTail, the background thread owns tail; each sits on its
+ * own cache line.
+ */
+struct AsyncLogger::Ring {
+    explicit Ring(size_t capacity) : records(capacity), mask(capacity - 1) {}
+
+    ~Ring() {
+        // Records the background thread did not consume, possible after the logger is gone
+        for (uint64_t i = tail.load(); i != head.load(); ++i) {
+            delete records[i & mask].overflow;
+        }
+    }
+
+    std::vector<AsyncLogRecord> records;        ///< Record storage
+    const size_t mask;                          ///< Capacity - 1
+    alignas(64) std::atomic<uint64_t> head{0};  ///< Next record to write, published by the producer
+    uint64_t cachedTail = 0;                    ///< Producer's copy of tail
+    std::atomic<uint64_t> dropped{0};           ///< Messages dropped while full
+    alignas(64) std::atomic<uint64_t> tail{0};  ///< Next record to read, published by the consumer
+    std::atomic<bool> closed{false};            ///< Set when the logger is destroyed
+    std::atomic<bool> exited{false};            ///< Set when the producer thread exits
+};
+
+namespace {
+
+std::atomic<uint64_t> nextLoggerId{1};
+
+/**
+ * @brief Stamp ordering the records of different threads.
+ *
+ * Only compared, never shown, so the invariant CPU counter is enough where available; it
+ * costs a fraction of a steady_clock read.
+ */
+uint64_t orderStamp() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+size_t roundUpPowerOfTwo(size_t value) {
+    size_t capacity = 2;
+    while (capacity < value) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+/**
+ * @brief Struct representing a record taken out of a ring.
+ */
+struct Pending {
+    uint64_t stamp;       ///< orderStamp() of the call
+    uint8_t level;        ///< AsyncLogger::Level
+    std::string text;     ///< The message
+};
+
+const char* const kPrefixes[] = {"[DEBUG]: ", "[INFO]: ", "[WARNING]: ", "[ERROR]: ", "[CRITICAL]: "};
+
+} // namespace
+
+/**
+ * @brief Constructor writing to the console like StdCoutLogger, or to a downstream logger.
+ *
+ * @param[in] sink Downstream logger called from the background thread, nullptr for the console.
+ * @param[in] ringCapacity Records per producer thread, rounded up to a power of two.
+ * @param[in] flushInterval Longest time a message waits before it is written.
+ */
+AsyncLogger::AsyncLogger(std::shared_ptr<ILogger> sink, size_t ringCapacity, std::chrono::milliseconds flushInterval)
+    : sink_(std::move(sink)), out_(stdout), err_(stderr), ringCapacity_(roundUpPowerOfTwo(ringCapacity)),
+      flushInterval_(flushInterval), id_(nextLoggerId.fetch_add(1)) {
+    worker_ = std::thread(&AsyncLogger::run, this);
+}
+
+/**
+ * @brief Constructor writing the "[LEVEL]: message" lines to two streams.
+ *
+ * @param[in] out Stream of the info and warning messages.
+ * @param[in] err Stream of the error and critical messages.
+ * @param[in] ringCapacity Records per producer thread, rounded up to a power of two.
+ * @param[in] flushInterval Longest time a message waits before it is written.
+ */
+AsyncLogger::AsyncLogger(std::FILE* out, std::FILE* err, size_t ringCapacity, std::chrono::milliseconds flushInterval)
+    : out_(out), err_(err), ringCapacity_(roundUpPowerOfTwo(ringCapacity)), flushInterval_(flushInterval),
+      id_(nextLoggerId.fetch_add(1)) {
+    worker_ = std::thread(&AsyncLogger::run, this);
+}
+
+/**
+ * @brief Destructor writing all pending messages and stopping the background thread.
+ */
+AsyncLogger::~AsyncLogger() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    worker_.join();
+    for (const auto& ring : rings_) {
+        ring->closed.store(true);
+    }
+}
+
+/**
+ * @brief Log a debug message.
+ *
+ * @param[in] message The message to log.
+ */
+void AsyncLogger::debug(const std::string& message) {
+    if (isEnabled(LogLevel::Debug)) {
+        push(Level::Debug, message);
+    }
+}
+
+/**
+ * @brief Log an informational message.
+ *
+ * @param[in] message The message to log.
+ */
+void AsyncLogger::info(const std::string& message) {
+    if (isEnabled(LogLevel::Info)) {
+        push(Level::Info, message);
+    }
+}
+
+/**
+ * @brief Log a warning message.
+ *
+ * @param[in] message The message to log.
+ */
+void AsyncLogger::warn(const std::string& message) {
+    if (isEnabled(LogLevel::Warn)) {
+        push(Level::Warn, message);
+    }
+}
+
+/**
+ * @brief Log an error message and wake the background thread.
+ *
+ * @param[in] message The message to log.
+ */
+void AsyncLogger::error(const std::string& message) {
+    if (!isEnabled(LogLevel::Error)) {
+        return;
+    }
+    push(Level::Error, message);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        urgent_ = true;
+    }
+    wake_.notify_one();
+}
+
+/**
+ * @brief Log a critical error message and wait until it is written.
+ *
+ * @param[in] message The message to log.
+ */
+void AsyncLogger::critical(const std::string& message) {
+    if (!isEnabled(LogLevel::Critical)) {
+        return;
+    }
+    push(Level::Critical, message);
+    flush();
+}
+
+/**
+ * @brief Sets the lowest level that is logged, here and in the downstream logger.
+ *
+ * @param[in] level The level, LogLevel::Off disables logging.
+ */
+void AsyncLogger::setLevel(LogLevel level) {
+    ILogger::setLevel(level);
+    if (sink_) {
+        sink_->setLevel(level);
+    }
+}
+
+/**
+ * @brief Waits until every message logged before the call is written.
+ */
+void AsyncLogger::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stopping_) {
+        return;
+    }
+    const uint64_t target = ++flushRequested_;
+    wake_.notify_one();
+    flushed_.wait(lock, [this, target] { return flushDone_ >= target || stopping_; });
+}
+
+/**
+ * @brief Stores a message in the calling thread's ring.
+ *
+ * @param[in] level Severity of the message.
+ * @param[in] message The message to log.
+ * @return True if stored, false if dropped.
+ */
+bool AsyncLogger::push(Level level, const std::string& message) {
+    Ring& ring = localRing();
+    const uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.cachedTail > ring.mask) {
+        ring.cachedTail = ring.tail.load(std::memory_order_acquire);
+        while (head - ring.cachedTail > ring.mask) {
+            if (level < Level::Error) {
+                ring.dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            // Errors are never dropped, wait for the background thread
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                urgent_ = true;
+            }
+            wake_.notify_one();
+            std::this_thread::yield();
+            ring.cachedTail = ring.tail.load(std::memory_order_acquire);
+        }
+    }
+
+    AsyncLogRecord& record = ring.records[head & ring.mask];
+    record.stamp = orderStamp();
+    record.level = static_cast<uint8_t>(level);
+    if (message.size() <= kInlineText) {
+        std::memcpy(record.text, message.data(), message.size());
+        record.length = static_cast<uint16_t>(message.size());
+        record.overflow = nullptr;
+    } else {
+        record.length = 0;
+        record.overflow = new std::string(message);
+    }
+    ring.head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Getter for the calling thread's ring, registering it on first use.
+ * @return The ring of the calling thread.
+ */
+AsyncLogger::Ring& AsyncLogger::localRing() {
+    // Marks the rings of the thread when it exits, so drain() forgets them once empty
+    struct ThreadRings {
+        ~ThreadRings() {
+            for (const auto& entry : entries) {
+                entry.second->exited.store(true, std::memory_order_release);
+            }
+        }
+        // Keyed by instance id rather than address, a new logger may reuse a freed address
+        std::vector<std::pair<uint64_t, std::shared_ptr<Ring>>> entries;
+    };
+    thread_local ThreadRings threadRings;
+    std::vector<std::pair<uint64_t, std::shared_ptr<Ring>>>& rings = threadRings.entries;
+    thread_local uint64_t lastId = 0;
+    thread_local Ring* last = nullptr;
+    if (lastId == id_) {
+        return *last;
+    }
+
+    rings.erase(std::remove_if(rings.begin(), rings.end(), [](const auto& entry) { return entry.second->closed.load(); }),
+                rings.end());
+    auto it = std::find_if(rings.begin(), rings.end(), [this](const auto& entry) { return entry.first == id_; });
+    if (it == rings.end()) {
+        auto ring = std::make_shared<Ring>(ringCapacity_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            rings_.push_back(ring);
+        }
+        rings.emplace_back(id_, std::move(ring));
+        it = std::prev(rings.end());
+    }
+    lastId = id_;
+    last = it->second.get();
+    return *last;
+}
+
+/**
+ * @brief Background loop.
+ */
+void AsyncLogger::run() {
+    ThreadName::set("vbus-log");
+    auto limiterFlush = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait_for(lock, flushInterval_, [this] { return stopping_ || urgent_ || flushRequested_ != flushDone_; });
+        const uint64_t requested = flushRequested_;
+        const bool stopping = stopping_;
+        urgent_ = false;
+        lock.unlock();
+        // Counts of limited call sites that went quiet go into this thread's ring, drained below
+        const auto now = std::chrono::steady_clock::now();
+        if (stopping || now - limiterFlush >= LogLimiter::kFlushInterval) {
+            LogLimiter::flushSuppressed(*this, !stopping);
+            limiterFlush = now;
+        }
+        drain();
+        lock.lock();
+        flushDone_ = requested;
+        flushed_.notify_all();
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Writes every record currently in the rings.
+ */
+void AsyncLogger::drain() {
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rings = rings_;
+    }
+
+    std::vector<Pending> batch;
+    uint64_t dropped = 0;
+    for (const auto& ring : rings) {
+        const uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        const uint64_t head = ring->head.load(std::memory_order_acquire);
+        for (uint64_t i = tail; i != head; ++i) {
+            AsyncLogRecord& record = ring->records[i & ring->mask];
+            if (record.overflow) {
+                batch.push_back(Pending{record.stamp, record.level, std::move(*record.overflow)});
+                delete record.overflow;
+            } else {
+                batch.push_back(Pending{record.stamp, record.level, std::string(record.text, record.length)});
+            }
+        }
+        ring->tail.store(head, std::memory_order_release);
+        dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+    }
+
+    {
+        // Forget the rings of exited threads once they are empty
+        std::lock_guard<std::mutex> lock(mutex_);
+        rings_.erase(std::remove_if(rings_.begin(), rings_.end(), [](const std::shared_ptr<Ring>& ring) {
+                         // The head is final once the exit is seen
+                         return ring->exited.load(std::memory_order_acquire) && ring->tail.load() == ring->head.load();
+                     }),
+                     rings_.end());
+    }
+
+    if (dropped != 0) {
+        droppedTotal_.fetch_add(dropped, std::memory_order_relaxed);
+        batch.push_back(Pending{orderStamp(), static_cast<uint8_t>(Level::Warn),
+                                "AsyncLogger: Dropped " + std::to_string(dropped) + " messages, log ring full."});
+    }
+    if (batch.empty()) {
+        return;
+    }
+    // Each ring is in order already, this interleaves the threads
+    std::stable_sort(batch.begin(), batch.end(), [](const Pending& a, const Pending& b) { return a.stamp < b.stamp; });
+
+    if (sink_) {
+        for (const auto& pending : batch) {
+            switch (static_cast<Level>(pending.level)) {
+            case Level::Debug: sink_->debug(pending.text); break;
+            case Level::Info: sink_->info(pending.text); break;
+            case Level::Warn: sink_->warn(pending.text); break;
+            case Level::Error: sink_->error(pending.text); break;
+            case Level::Critical: sink_->critical(pending.text); break;
+            }
+        }
+        return;
+    }
+
+    std::string out;
+    std::string err;
+    for (const auto& pending : batch) {
+        std::string& target = pending.level < static_cast<uint8_t>(Level::Error) ? out : err;
+        target += kPrefixes[pending.level];
+        target += pending.text;
+        target += '\n';
+    }
+    if (!out.empty()) {
+        std::fwrite(out.data(), 1, out.size(), out_);
+        std::fflush(out_);
+    }
+    if (!err.empty()) {
+        std::fwrite(err.data(), 1, err.size(), err_);
+        std::fflush(err_);
+    }
+}
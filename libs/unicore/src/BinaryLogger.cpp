@@ -0,0 +1,666 @@
+#include "BinaryLogger.h"
+#include "ErrorHandler.h"
+#include "ThreadName.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using namespace BinaryLogFormat;
+
+namespace {
+
+/**
+ * @brief Struct representing a registered call site.
+ */
+struct SiteDefinition {
+    int level;                ///< LogLevel of the call site
+    const char* file;         ///< Source file
+    int line;                 ///< Source line
+    const char* format;       ///< Format string literal
+    const char* signature;    ///< Argument signature
+};
+
+/**
+ * @brief Process-wide table of call sites, indexed by id - 1.
+ */
+struct SiteRegistry {
+    std::mutex mutex;                     ///< Guards sites
+    std::vector<SiteDefinition> sites;    ///< Registered sites
+};
+
+SiteRegistry& siteRegistry() {
+    static SiteRegistry registry;
+    return registry;
+}
+
+// Sites of the messages passed as text, one per LogLevel
+Site textSites[] = {{static_cast<int>(LogLevel::Debug), "", 0}, {static_cast<int>(LogLevel::Info), "", 0},
+                    {static_cast<int>(LogLevel::Warn), "", 0},  {static_cast<int>(LogLevel::Error), "", 0},
+                    {static_cast<int>(LogLevel::Critical), "", 0}};
+
+// Ids of the BinaryLogger instances, 0 marks an empty lane cache
+std::atomic<uint64_t> nextInstance{1};
+
+uint64_t steadyNs() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+/**
+ * @brief Assigns the id of a call site on its first record.
+ *
+ * @param[in,out] site The call site.
+ * @param[in] format Format of the call site, must stay valid for the process lifetime.
+ * @param[in] signature Argument signature, one character per argument.
+ * @return The id of the site.
+ */
+uint32_t BinaryLogFormat::registerSite(Site& site, const char* format, const char* signature) {
+    SiteRegistry& registry = siteRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    // Another thread may have registered the site meanwhile
+    uint32_t id = site.id.load(std::memory_order_relaxed);
+    if (id == 0) {
+        registry.sites.push_back({site.level, site.file, site.line, format, signature});
+        id = static_cast<uint32_t>(registry.sites.size());
+        site.id.store(id, std::memory_order_release);
+    }
+    return id;
+}
+
+/**
+ * @brief Constructor for BinaryLogger.
+ *
+ * @param[in] path Log file; it is created or overwritten.
+ * @param[in] blockSize Bytes per block, also the largest record.
+ * @param[in] blockCount Number of preallocated blocks, at least 2.
+ * @param[in] flushInterval Longest time a record waits before it is written.
+ * @param[in] logger A shared pointer to a logger instance for logging messages.
+ */
+BinaryLogger::BinaryLogger(const std::string& path, size_t blockSize, size_t blockCount, std::chrono::milliseconds flushInterval,
+                           std::shared_ptr<ILogger> logger)
+    : logger_(std::move(logger)), blockSize_(std::max<size_t>(blockSize, 256)), flushInterval_(flushInterval),
+      instance_(nextInstance.fetch_add(1, std::memory_order_relaxed)) {
+    blockCount = std::max<size_t>(blockCount, 2);
+    blocks_.assign(blockCount, std::vector<char>(blockSize_));
+    free_.reserve(blockCount);
+    filled_.reserve(blockCount);
+    for (size_t i = 0; i < blockCount; ++i) {
+        free_.push_back(i);
+    }
+
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        ErrorHandler::handleError("BinaryLogger", "Cannot create " + path + ": " + std::strerror(errno), ErrorHandler::ErrorSeverity::ERROR, logger_);
+        return;
+    }
+    char header[kHeaderSize];
+    char* out = header;
+    std::memcpy(out, kMagic, sizeof(kMagic));
+    out += sizeof(kMagic);
+    *out++ = static_cast<char>(kVersion);
+    putFixed64(out, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                              std::chrono::system_clock::now().time_since_epoch()).count()));
+    putFixed64(out, steadyNs());
+    std::fwrite(header, 1, sizeof(header), file_);
+    std::fflush(file_);
+    bytesWritten_.store(sizeof(header), std::memory_order_relaxed);
+    worker_ = std::thread(&BinaryLogger::run, this);
+}
+
+/**
+ * @brief Destructor writing all pending records and closing the file.
+ */
+BinaryLogger::~BinaryLogger() {
+    if (worker_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        worker_.join();
+    }
+    if (file_) {
+        std::fclose(file_);
+    }
+}
+
+/**
+ * @brief Log a debug message.
+ *
+ * @param[in] message The message to log.
+ */
+void BinaryLogger::debug(const std::string& message) {
+    logText(LogLevel::Debug, message);
+}
+
+/**
+ * @brief Log an informational message.
+ *
+ * @param[in] message The message to log.
+ */
+void BinaryLogger::info(const std::string& message) {
+    logText(LogLevel::Info, message);
+}
+
+/**
+ * @brief Log a warning message.
+ *
+ * @param[in] message The message to log.
+ */
+void BinaryLogger::warn(const std::string& message) {
+    logText(LogLevel::Warn, message);
+}
+
+/**
+ * @brief Log an error message.
+ *
+ * @param[in] message The message to log.
+ */
+void BinaryLogger::error(const std::string& message) {
+    logText(LogLevel::Error, message);
+}
+
+/**
+ * @brief Log a critical error message and wait until it is written.
+ *
+ * @param[in] message The message to log.
+ */
+void BinaryLogger::critical(const std::string& message) {
+    logText(LogLevel::Critical, message);
+    flush();
+}
+
+/**
+ * @brief Waits until every record logged before the call is written.
+ */
+void BinaryLogger::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stopping_ || !worker_.joinable()) {
+        return;
+    }
+    const uint64_t target = ++flushRequested_;
+    wake_.notify_one();
+    written_.wait(lock, [this, target] { return flushDone_ >= target || stopping_; });
+}
+
+/**
+ * @brief Starts a record in the block of the calling thread, locking its lane on success.
+ *
+ * @param[in] siteId Id of the call site.
+ * @param[in] maxSize Upper bound of the record size.
+ * @return Where to encode the arguments, nullptr if the record is dropped.
+ */
+char* BinaryLogger::beginRecord(uint32_t siteId, size_t maxSize) {
+    Lane* lane = threadLane();
+    lane->mutex.lock();
+    if (lane->block == SIZE_MAX || lane->used + maxSize > blockSize_) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (8 + maxSize <= blockSize_ && lane->block != SIZE_MAX) {
+            retireLane(*lane);
+            wake_.notify_one();
+        }
+        if (free_.empty() || 8 + maxSize > blockSize_) {
+            ++droppedPending_;
+            droppedTotal_.fetch_add(1, std::memory_order_relaxed);
+            lane->mutex.unlock();
+            return nullptr;
+        }
+        lane->block = free_.back();
+        free_.pop_back();
+        lane->lastNs = steadyNs();
+        char* base = blocks_[lane->block].data();
+        putFixed64(base, lane->lastNs);
+        lane->used = 8;
+    }
+
+    // Only this thread writes to the block, so its deltas never go backwards
+    const uint64_t now = steadyNs();
+    char* out = blocks_[lane->block].data() + lane->used;
+    putVarint(out, siteId);
+    putVarint(out, now - lane->lastNs);
+    lane->lastNs = now;
+    return out;
+}
+
+/**
+ * @brief Completes the record started by beginRecord() and unlocks the lane.
+ *
+ * @param[in] end End of the encoded arguments.
+ */
+void BinaryLogger::endRecord(char* end) {
+    Lane* lane = threadLane();
+    lane->used = static_cast<size_t>(end - blocks_[lane->block].data());
+    lane->mutex.unlock();
+}
+
+/**
+ * @brief Finds or creates the lane of the calling thread.
+ * @return The lane, valid until the logger is destroyed.
+ */
+BinaryLogger::Lane* BinaryLogger::threadLane() {
+    // Logger ids are never reused, so a stale entry cannot match a new logger
+    thread_local uint64_t cachedInstance = 0;
+    thread_local Lane* cachedLane = nullptr;
+    if (cachedInstance == instance_) {
+        return cachedLane;
+    }
+    const std::thread::id self = std::this_thread::get_id();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find_if(lanes_.begin(), lanes_.end(), [self](const std::unique_ptr<Lane>& lane) { return lane->thread == self; });
+    if (it == lanes_.end()) {
+        lanes_.push_back(std::make_unique<Lane>());
+        lanes_.back()->thread = self;
+        it = lanes_.end() - 1;
+    }
+    cachedInstance = instance_;
+    cachedLane = it->get();
+    return cachedLane;
+}
+
+/**
+ * @brief Writes a text message through the built-in site of its level.
+ *
+ * @param[in] level Level of the message.
+ * @param[in] message The message to log.
+ */
+void BinaryLogger::logText(LogLevel level, const std::string& message) {
+    if (file_ && isEnabled(level)) {
+        write(textSites[static_cast<int>(level)], "{}", message);
+    }
+}
+
+/**
+ * @brief Hands the block of a lane to the background thread. Requires lane.mutex and mutex_.
+ *
+ * @param[in,out] lane The lane.
+ */
+void BinaryLogger::retireLane(Lane& lane) {
+    if (lane.block == SIZE_MAX) {
+        return;
+    }
+    if (lane.used > 8) {
+        filled_.push_back({lane.block, lane.used});
+    } else {
+        free_.push_back(lane.block);
+    }
+    lane.block = SIZE_MAX;
+}
+
+/**
+ * @brief Hands the partial blocks of all lanes to the background thread.
+ *
+ * @param[in,out] lock Lock of mutex_, released while the lanes are locked.
+ * @param[out] lanes Scratch list of the lanes.
+ */
+void BinaryLogger::retireLanes(std::unique_lock<std::mutex>& lock, std::vector<Lane*>& lanes) {
+    lanes.clear();
+    for (const auto& lane : lanes_) {
+        lanes.push_back(lane.get());
+    }
+    // Writers lock their lane before mutex_, so mutex_ is dropped first
+    lock.unlock();
+    for (Lane* lane : lanes) {
+        std::lock_guard<std::mutex> laneLock(lane->mutex);
+        std::lock_guard<std::mutex> relock(mutex_);
+        retireLane(*lane);
+    }
+    lock.lock();
+}
+
+/**
+ * @brief Background loop.
+ */
+void BinaryLogger::run() {
+    ThreadName::set("vbus-blog");
+    std::vector<Filled> writing;
+    writing.reserve(blocks_.size());
+    std::vector<Lane*> lanes;
+    auto limiterFlush = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait_for(lock, flushInterval_, [this] { return stopping_ || !filled_.empty() || flushRequested_ != flushDone_; });
+        const auto now = std::chrono::steady_clock::now();
+        if (stopping_ || now - limiterFlush >= LogLimiter::kFlushInterval) {
+            // Counts of limited call sites that went quiet, recorded before the blocks are retired
+            const bool quietOnly = !stopping_;
+            lock.unlock();
+            LogLimiter::flushSuppressed(*this, quietOnly);
+            lock.lock();
+            limiterFlush = now;
+        }
+        const uint64_t requested = flushRequested_;
+        const bool stopping = stopping_;
+        // Partial blocks are written on timeout, flush and stop, not when another block filled up
+        if (stopping || requested != flushDone_ || filled_.empty()) {
+            retireLanes(lock, lanes);
+        }
+        writing.swap(filled_);
+        const uint64_t dropped = droppedPending_;
+        droppedPending_ = 0;
+        lock.unlock();
+
+        for (const auto& block : writing) {
+            writeNewSites();
+            writeChunk(ChunkType::Records, blocks_[block.block].data(), block.size);
+        }
+        if (dropped > 0) {
+            char payload[kMaxVarint];
+            char* out = payload;
+            putVarint(out, dropped);
+            writeChunk(ChunkType::Dropped, payload, static_cast<size_t>(out - payload));
+        }
+        if (!writing.empty() || dropped > 0) {
+            std::fflush(file_);
+        }
+
+        lock.lock();
+        for (const auto& block : writing) {
+            free_.push_back(block.block);
+        }
+        writing.clear();
+        flushDone_ = requested;
+        written_.notify_all();
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Writes a chunk to the file. Called by the background thread only.
+ *
+ * @param[in] type Chunk type.
+ * @param[in] payload Chunk payload.
+ * @param[in] size Payload size.
+ */
+void BinaryLogger::writeChunk(ChunkType type, const char* payload, size_t size) {
+    char header[kChunkHeaderSize];
+    header[0] = static_cast<char>(type);
+    for (int i = 0; i < 4; ++i) {
+        header[1 + i] = static_cast<char>(static_cast<uint32_t>(size) >> (8 * i));
+    }
+    if (std::fwrite(header, 1, sizeof(header), file_) != sizeof(header) || std::fwrite(payload, 1, size, file_) != size) {
+        ErrorHandler::handleError("BinaryLogger", std::string("Write failed: ") + std::strerror(errno), ErrorHandler::ErrorSeverity::ERROR, logger_);
+        return;
+    }
+    bytesWritten_.fetch_add(sizeof(header) + size, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Writes the definitions of the sites registered since the last call.
+ */
+void BinaryLogger::writeNewSites() {
+    std::vector<SiteDefinition> added;
+    {
+        SiteRegistry& registry = siteRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        added.assign(registry.sites.begin() + sitesWritten_, registry.sites.end());
+    }
+    for (const auto& site : added) {
+        const size_t fileSize = std::strlen(site.file);
+        const size_t formatSize = std::strlen(site.format);
+        const size_t signatureSize = std::strlen(site.signature);
+        scratch_.resize(6 * kMaxVarint + fileSize + formatSize + signatureSize);
+        char* out = scratch_.data();
+        putVarint(out, ++sitesWritten_);
+        putVarint(out, static_cast<uint64_t>(site.level));
+        putVarint(out, static_cast<uint64_t>(site.line));
+        putBytes(out, site.file, fileSize);
+        putBytes(out, site.format, formatSize);
+        putBytes(out, site.signature, signatureSize);
+        writeChunk(ChunkType::Site, scratch_.data(), static_cast<size_t>(out - scratch_.data()));
+    }
+}
+
+namespace {
+
+/**
+ * @brief Bounds-checked cursor over a chunk payload.
+ */
+struct Cursor {
+    const uint8_t* pos;   ///< Next byte
+    const uint8_t* end;   ///< End of the payload
+
+    bool varint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && pos < end; shift += 7) {
+            const uint8_t byte = *pos++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool fixed(uint64_t& value, int bytes) {
+        if (end - pos < bytes) {
+            return false;
+        }
+        value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(*pos++) << (8 * i);
+        }
+        return true;
+    }
+
+    bool bytes(std::string& value) {
+        uint64_t size;
+        if (!varint(size) || static_cast<uint64_t>(end - pos) < size) {
+            return false;
+        }
+        value.assign(reinterpret_cast<const char*>(pos), static_cast<size_t>(size));
+        pos += size;
+        return true;
+    }
+};
+
+/**
+ * @brief Struct representing a site definition read back from the file.
+ */
+struct DecodedSite {
+    bool defined = false;   ///< Set once the Site chunk was read
+    LogLevel level = LogLevel::Info;
+    int line = 0;
+    std::string file;
+    std::string format;
+    std::string signature;
+};
+
+/**
+ * @brief Decodes one argument and appends its text like LogFormat::appendArg().
+ *
+ * @param[in,out] cursor Payload cursor.
+ * @param[in] tag Signature character of the argument.
+ * @param[out] out Destination string.
+ * @return False if the payload is malformed.
+ */
+bool appendDecodedArg(Cursor& cursor, char tag, std::string& out) {
+    uint64_t raw = 0;
+    switch (tag) {
+        case 'i':
+            if (!cursor.varint(raw)) return false;
+            LogFormat::appendArg(out, static_cast<int64_t>((raw >> 1) ^ (~(raw & 1) + 1)));
+            return true;
+        case 'u':
+            if (!cursor.varint(raw)) return false;
+            LogFormat::appendArg(out, raw);
+            return true;
+        case 'p':
+            if (!cursor.varint(raw)) return false;
+            LogFormat::appendArg(out, reinterpret_cast<const void*>(static_cast<uintptr_t>(raw)));
+            return true;
+        case 'f': {
+            if (!cursor.fixed(raw, 4)) return false;
+            const uint32_t bits = static_cast<uint32_t>(raw);
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            LogFormat::appendArg(out, value);
+            return true;
+        }
+        case 'd': {
+            if (!cursor.fixed(raw, 8)) return false;
+            double value;
+            std::memcpy(&value, &raw, sizeof(value));
+            LogFormat::appendArg(out, value);
+            return true;
+        }
+        case 'b':
+            if (!cursor.fixed(raw, 1)) return false;
+            LogFormat::appendArg(out, raw != 0);
+            return true;
+        case 'c':
+            if (!cursor.fixed(raw, 1)) return false;
+            LogFormat::appendArg(out, static_cast<char>(raw));
+            return true;
+        case 's': {
+            std::string value;
+            if (!cursor.bytes(value)) return false;
+            out += value;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Loads and formats all records, sorted by time.
+ *
+ * @param[in] path Binary log file.
+ * @param[out] entries Decoded records, oldest first.
+ * @param[in] logger A shared pointer to a logger instance for logging messages.
+ * @return OK, NOT_FOUND if the file cannot be opened, ERROR if it is not a binary log.
+ */
+ReturnType BinaryLogReader::load(const std::string& path, std::vector<Entry>& entries, std::shared_ptr<ILogger> logger) {
+    entries.clear();
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        if (logger) logger->error("BinaryLogReader: Cannot open " + path);
+        return ReturnType::NOT_FOUND;
+    }
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+    Cursor file{data.data(), data.data() + data.size()};
+    uint64_t version = 0;
+    uint64_t wallClockNs = 0;
+    uint64_t steadyClockNs = 0;
+    if (data.size() < kHeaderSize || std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0) {
+        if (logger) logger->error("BinaryLogReader: " + path + " is not a binary log.");
+        return ReturnType::ERROR;
+    }
+    file.pos += sizeof(kMagic);
+    file.fixed(version, 1);
+    file.fixed(wallClockNs, 8);
+    file.fixed(steadyClockNs, 8);
+    if (version != kVersion) {
+        if (logger) logger->error("BinaryLogReader: " + path + " has unsupported version " + std::to_string(version));
+        return ReturnType::ERROR;
+    }
+
+    std::vector<DecodedSite> sites;
+    uint64_t lastWallClockNs = wallClockNs;
+    while (static_cast<size_t>(file.end - file.pos) >= kChunkHeaderSize) {
+        uint64_t type = 0;
+        uint64_t size = 0;
+        file.fixed(type, 1);
+        file.fixed(size, 4);
+        if (static_cast<uint64_t>(file.end - file.pos) < size) {
+            break;  // Truncated by a crash
+        }
+        Cursor chunk{file.pos, file.pos + size};
+        file.pos += size;
+
+        switch (static_cast<ChunkType>(type)) {
+            case ChunkType::Site: {
+                uint64_t id = 0;
+                uint64_t level = 0;
+                uint64_t line = 0;
+                DecodedSite site;
+                if (!chunk.varint(id) || !chunk.varint(level) || !chunk.varint(line) || !chunk.bytes(site.file) ||
+                    !chunk.bytes(site.format) || !chunk.bytes(site.signature) || id == 0 || id > (1u << 24)) {
+                    if (logger) logger->warn("BinaryLogReader: Skipping a malformed site definition.");
+                    break;
+                }
+                site.defined = true;
+                site.level = static_cast<LogLevel>(level);
+                site.line = static_cast<int>(line);
+                if (sites.size() < id) {
+                    sites.resize(id);
+                }
+                sites[id - 1] = std::move(site);
+                break;
+            }
+            case ChunkType::Records: {
+                uint64_t ns = 0;
+                if (!chunk.fixed(ns, 8)) {
+                    break;
+                }
+                while (chunk.pos < chunk.end) {
+                    uint64_t id = 0;
+                    uint64_t delta = 0;
+                    if (!chunk.varint(id) || !chunk.varint(delta) || id == 0 || id > sites.size() || !sites[id - 1].defined) {
+                        if (logger) logger->warn("BinaryLogReader: Skipping the rest of a malformed block.");
+                        break;
+                    }
+                    ns += delta;
+                    const DecodedSite& site = sites[id - 1];
+                    Entry entry;
+                    entry.wallClockNs = wallClockNs + (ns - steadyClockNs);
+                    entry.level = site.level;
+                    entry.file = site.file;
+                    entry.line = site.line;
+                    // Same substitution as LogFormat::formatInto()
+                    const char* format = site.format.c_str();
+                    bool valid = true;
+                    bool placeholders = true;
+                    for (char tag : site.signature) {
+                        if (placeholders && !LogFormat::appendUntilPlaceholder(entry.text, format)) {
+                            placeholders = false;
+                        }
+                        std::string arg;
+                        if (!appendDecodedArg(chunk, tag, arg)) {
+                            valid = false;
+                            break;
+                        }
+                        if (placeholders) {
+                            entry.text += arg;
+                        }
+                    }
+                    if (!valid) {
+                        if (logger) logger->warn("BinaryLogReader: Skipping the rest of a malformed block.");
+                        break;
+                    }
+                    if (placeholders) {
+                        LogFormat::formatInto(entry.text, format);
+                    }
+                    lastWallClockNs = entry.wallClockNs;
+                    entries.push_back(std::move(entry));
+                }
+                break;
+            }
+            case ChunkType::Dropped: {
+                uint64_t count = 0;
+                if (chunk.varint(count)) {
+                    Entry entry;
+                    entry.wallClockNs = lastWallClockNs;
+                    entry.level = LogLevel::Warn;
+                    entry.text = "BinaryLogger: " + std::to_string(count) + " records dropped.";
+                    entries.push_back(std::move(entry));
+                }
+                break;
+            }
+            default:
+                break;  // Unknown chunks are skipped
+        }
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.wallClockNs < b.wallClockNs; });
+    return ReturnType::OK;
+}
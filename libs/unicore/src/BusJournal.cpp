@@ -0,0 +1,361 @@
+#include "BusJournal.h"
+#include "ErrorHandler.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace BusJournalFormat;
+
+namespace {
+
+constexpr size_t kAlignment = 8;
+constexpr size_t kMaxPayload = 64 * 1024;  // Largest payload a single record may carry
+
+size_t alignUp(size_t value) {
+    return (value + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+std::string segmentPath(const std::string& directory, uint32_t index) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "journal-%06u.vbj", index);
+    return (std::filesystem::path(directory) / name).string();
+}
+
+} // namespace
+
+/**
+ * @brief Constructor for BusJournal that opens the first segment and starts the preparer thread.
+ *
+ * @param[in] directory Directory of the segment files.
+ * @param[in] codec Codec used to encode message payloads.
+ * @param[in] segmentSize Size of each segment file.
+ * @param[in] logger A shared pointer to a logger instance for logging messages.
+ */
+BusJournal::BusJournal(const std::string& directory, std::shared_ptr<IBusMessageCodec> codec,
+                       size_t segmentSize, std::shared_ptr<ILogger> logger)
+    : directory_(directory), codec_(std::move(codec)),
+      segmentSize_(std::max(alignUp(segmentSize), sizeof(SegmentHeader) + sizeof(RecordHeader) + kMaxPayload)),
+      logger_(logger) {
+    std::error_code error;
+    std::filesystem::create_directories(directory_, error);
+
+    auto stale = BusJournalReader::listSegments(directory_);
+    if (!stale.empty()) {
+        ErrorHandler::handleError("BusJournal", "Replacing " + std::to_string(stale.size()) + " segments in " + directory_ + ".", ErrorHandler::ErrorSeverity::WARNING, logger_);
+        for (const auto& path : stale) {
+            std::filesystem::remove(path, error);
+        }
+    }
+
+    wallClockNs_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    start_ = std::chrono::steady_clock::now();
+    Segment first;
+    if (openSegment(0, first)) {
+        fd_ = first.fd;
+        base_ = first.base;
+        segmentIndex_ = 0;
+        offset_ = sizeof(SegmentHeader);
+        spare_.index = 1;
+        preparer_ = std::thread(&BusJournal::prepare, this);
+        if (logger_) {
+            logger_->info("BusJournal: Recording to " + directory_);
+        }
+    }
+}
+
+/**
+ * @brief Destructor that stops the background thread, trims and closes the current segment.
+ */
+BusJournal::~BusJournal() {
+    {
+        std::lock_guard<std::mutex> prepareLock(prepareMutex_);
+        stopping_ = true;
+    }
+    prepareCondition_.notify_all();
+    if (preparer_.joinable()) {
+        preparer_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Segment current{fd_, base_, segmentIndex_, offset_};
+    closeSegment(current);
+    base_ = nullptr;
+    fd_ = -1;
+    for (auto& segment : retired_) {
+        closeSegment(segment);
+    }
+    if (spare_.base) {
+        // Never written to, so it is not left behind as an empty segment
+        closeSegment(spare_);
+        std::error_code error;
+        std::filesystem::remove(segmentPath(directory_, spare_.index), error);
+    }
+}
+
+/**
+ * @brief Creates, sizes, maps and prefaults a segment file and writes its header.
+ *
+ * @param[in] index Segment index.
+ * @param[out] segment The mapped segment.
+ * @return True on success.
+ */
+bool BusJournal::openSegment(uint32_t index, Segment& segment) {
+    const std::string path = segmentPath(directory_, index);
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0 || ::ftruncate(fd, static_cast<off_t>(segmentSize_)) != 0) {
+        ErrorHandler::handleError("BusJournal", "Cannot create " + path + ": " + std::strerror(errno), ErrorHandler::ErrorSeverity::ERROR, logger_);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return false;
+    }
+    void* mapping = ::mmap(nullptr, segmentSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        ErrorHandler::handleError("BusJournal", "Cannot map " + path + ": " + std::strerror(errno), ErrorHandler::ErrorSeverity::ERROR, logger_);
+        ::close(fd);
+        return false;
+    }
+    uint8_t* base = static_cast<uint8_t*>(mapping);
+
+    // Write every page once, so appends do not take the first-write page faults
+    const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    for (size_t offset = 0; offset < segmentSize_; offset += pageSize) {
+        reinterpret_cast<volatile uint8_t*>(base)[offset] = 0;
+    }
+
+    SegmentHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(header.magic));
+    header.version = kVersion;
+    header.segmentIndex = index;
+    header.headerSize = sizeof(SegmentHeader);
+    header.wallClockNs = wallClockNs_;
+    header.capacity = segmentSize_;
+    std::memcpy(base, &header, sizeof(header));
+
+    segment.fd = fd;
+    segment.base = base;
+    segment.index = index;
+    segment.used = sizeof(SegmentHeader);
+    return true;
+}
+
+/**
+ * @brief Unmaps a segment and trims the file to the written length.
+ *
+ * @param[in,out] segment The segment, reset to closed.
+ */
+void BusJournal::closeSegment(Segment& segment) {
+    if (segment.base) {
+        ::munmap(segment.base, segmentSize_);
+        segment.base = nullptr;
+    }
+    if (segment.fd >= 0) {
+        if (::ftruncate(segment.fd, static_cast<off_t>(segment.used)) != 0 && logger_) {
+            logger_->warn("BusJournal: Failed to trim segment " + std::to_string(segment.index));
+        }
+        ::close(segment.fd);
+        segment.fd = -1;
+    }
+}
+
+/**
+ * @brief Switches to the prepared segment and hands the full one to the preparer thread.
+ *
+ * Must be called with mutex_ held. Waits only if records are written faster than the
+ * preparer creates segments.
+ *
+ * @return False if the next segment cannot be created; the journal is closed then.
+ */
+bool BusJournal::rollover() {
+    Segment next;
+    {
+        std::unique_lock<std::mutex> prepareLock(prepareMutex_);
+        prepareCondition_.wait(prepareLock, [this] { return spare_.base != nullptr || prepareFailed_ || stopping_; });
+        retired_.push_back(Segment{fd_, base_, segmentIndex_, offset_});
+        next = spare_;
+        spare_ = Segment{};
+        spare_.index = next.index + 1;
+    }
+    prepareCondition_.notify_all();
+
+    fd_ = next.fd;
+    base_ = next.base;
+    segmentIndex_ = next.index;
+    offset_ = sizeof(SegmentHeader);
+    return base_ != nullptr;
+}
+
+/**
+ * @brief Main loop of the preparer thread.
+ */
+void BusJournal::prepare() {
+    std::unique_lock<std::mutex> prepareLock(prepareMutex_);
+    while (true) {
+        prepareCondition_.wait(prepareLock, [this] {
+            return stopping_ || !retired_.empty() || (spare_.base == nullptr && !prepareFailed_);
+        });
+
+        std::vector<Segment> retired;
+        retired.swap(retired_);
+        const bool create = spare_.base == nullptr && !prepareFailed_ && !stopping_;
+        const uint32_t index = spare_.index;
+        prepareLock.unlock();
+
+        for (auto& segment : retired) {
+            closeSegment(segment);
+        }
+        Segment segment;
+        const bool created = create && openSegment(index, segment);
+
+        prepareLock.lock();
+        if (create) {
+            if (created) {
+                spare_ = segment;
+            } else {
+                prepareFailed_ = true;
+            }
+            prepareCondition_.notify_all();
+        }
+        if (stopping_ && retired_.empty()) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Appends a published message to the journal.
+ *
+ * @param[in] senderId The identifier of the sender.
+ * @param[in] message The published message.
+ */
+void BusJournal::onPublish(int senderId, const std::shared_ptr<VirtualBusCmd>& message) {
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+    append(senderId, *message, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+}
+
+/**
+ * @brief Appends a message with an explicit timestamp.
+ *
+ * @param[in] senderId The identifier of the sender.
+ * @param[in] message The message to record.
+ * @param[in] timestampNs Nanoseconds since the journal was opened.
+ * @return OK or ERROR.
+ */
+ReturnType BusJournal::append(int senderId, const VirtualBusCmd& message, uint64_t timestampNs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!base_) {
+        return ReturnType::ERROR;
+    }
+
+    // The payload is encoded in place; roll over when the rest of the segment might be too small
+    if (segmentSize_ - offset_ < sizeof(RecordHeader) + kMaxPayload && !rollover()) {
+        return ReturnType::ERROR;
+    }
+
+    uint8_t* record = base_ + offset_;
+    size_t payloadSize = codec_ ? codec_->encode(message, record + sizeof(RecordHeader), kMaxPayload) : 0;
+
+    RecordHeader header{};
+    header.payloadSize = static_cast<uint32_t>(payloadSize);
+    header.timestampNs = timestampNs;
+    header.senderId = senderId;
+    header.type = static_cast<uint16_t>(message.getType());
+    const uint32_t size = static_cast<uint32_t>(alignUp(sizeof(RecordHeader) + payloadSize));
+
+    // Publish the size last so a torn record reads as end of data
+    std::memcpy(record + sizeof(header.size), reinterpret_cast<const uint8_t*>(&header) + sizeof(header.size),
+                sizeof(RecordHeader) - sizeof(header.size));
+    reinterpret_cast<std::atomic<uint32_t>*>(record)->store(size, std::memory_order_release);
+
+    offset_ += size;
+    records_.fetch_add(1, std::memory_order_relaxed);
+    return ReturnType::OK;
+}
+
+/**
+ * @brief Lists the segment files of a journal directory in order.
+ *
+ * @param[in] directory Journal directory.
+ * @return Paths of the segment files.
+ */
+std::vector<std::string> BusJournalReader::listSegments(const std::string& directory) {
+    std::vector<std::string> segments;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        const std::string name = entry.path().filename().string();
+        if (name.rfind("journal-", 0) == 0 && entry.path().extension() == ".vbj") {
+            segments.push_back(entry.path().string());
+        }
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+/**
+ * @brief Reads every record of every segment in order.
+ *
+ * @param[in] callback Callback receiving each record.
+ * @return OK, NOT_FOUND or ERROR.
+ */
+ReturnType BusJournalReader::forEach(const RecordCallback& callback) const {
+    const auto segments = listSegments(directory_);
+    if (segments.empty()) {
+        return ReturnType::NOT_FOUND;
+    }
+    for (const auto& path : segments) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat info{};
+        if (fd < 0 || ::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SegmentHeader)) {
+            if (fd >= 0) ::close(fd);
+            if (logger_) logger_->error("BusJournalReader: Cannot read " + path);
+            return ReturnType::ERROR;
+        }
+        const size_t fileSize = static_cast<size_t>(info.st_size);
+        void* mapping = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            if (logger_) logger_->error("BusJournalReader: Cannot map " + path);
+            return ReturnType::ERROR;
+        }
+        const uint8_t* base = static_cast<const uint8_t*>(mapping);
+
+        SegmentHeader segment;
+        std::memcpy(&segment, base, sizeof(segment));
+        if (std::memcmp(segment.magic, kMagic, sizeof(kMagic)) != 0 || segment.version != kVersion) {
+            ::munmap(mapping, fileSize);
+            if (logger_) logger_->error("BusJournalReader: " + path + " is not a journal segment.");
+            return ReturnType::ERROR;
+        }
+
+        size_t offset = segment.headerSize;
+        bool keepGoing = true;
+        while (keepGoing && offset + sizeof(RecordHeader) <= fileSize) {
+            RecordHeader header;
+            std::memcpy(&header, base + offset, sizeof(header));
+            if (header.size == 0) {
+                break;
+            }
+            if (header.size < sizeof(RecordHeader) || offset + header.size > fileSize ||
+                sizeof(RecordHeader) + header.payloadSize > header.size) {
+                ::munmap(mapping, fileSize);
+                if (logger_) logger_->error("BusJournalReader: Corrupt record in " + path);
+                return ReturnType::ERROR;
+            }
+            keepGoing = callback(header, base + offset + sizeof(RecordHeader));
+            offset += header.size;
+        }
+        ::munmap(mapping, fileSize);
+        if (!keepGoing) {
+            break;
+        }
+    }
+    return ReturnType::OK;
+}
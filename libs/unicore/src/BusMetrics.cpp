@@ -0,0 +1,152 @@
+#include "BusMetrics.h"
+
+#include <utility>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Escapes a label value for the Prometheus text format.
+ */
+std::string escapeLabel(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+/**
+ * @brief Appends the HELP and TYPE lines of a metric family.
+ */
+void appendFamily(std::string& out, const char* name, const char* type, const char* help) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+/**
+ * @brief Appends one sample line.
+ */
+void appendSample(std::string& out, const char* name, const std::string& labels, uint64_t value) {
+    out += name;
+    out += '{';
+    out += labels;
+    out += "} ";
+    out += std::to_string(value);
+    out += '\n';
+}
+
+} // namespace
+
+/**
+ * @brief Creates the counters of a newly attached task.
+ *
+ * @param[in] taskId The identifier of the task.
+ * @param[in] name The name of the task.
+ * @return Counters the bus keeps with the task.
+ */
+std::shared_ptr<BusMetrics::TaskCounters> BusMetrics::addTask(int taskId, const std::string& name) {
+    auto counters = std::make_shared<TaskCounters>();
+    counters->taskId = taskId;
+    counters->name = name;
+    std::lock_guard<std::mutex> lock(tasksMutex_);
+    tasks_[taskId] = counters;
+    return counters;
+}
+
+/**
+ * @brief Stops exporting the counters of a detached task.
+ *
+ * @param[in] taskId The identifier of the task.
+ */
+void BusMetrics::removeTask(int taskId) {
+    std::lock_guard<std::mutex> lock(tasksMutex_);
+    tasks_.erase(taskId);
+}
+
+/**
+ * @brief Getter for the name of a command type as used in the metric labels.
+ *
+ * @param[in] type The command type.
+ * @return The type name.
+ */
+const char* BusMetrics::typeName(CommandType type) {
+    switch (type) {
+        case CommandType::Inverter: return "Inverter";
+        case CommandType::Battery: return "Battery";
+        case CommandType::Gateway: return "Gateway";
+        case CommandType::Json: return "Json";
+        case CommandType::Diagnostic: return "Diagnostic";
+    }
+    return "Unknown";
+}
+
+/**
+ * @brief Renders all counters in the Prometheus text exposition format.
+ *
+ * @return The exposition text, version 0.0.4.
+ */
+std::string BusMetrics::toPrometheus() const {
+    std::vector<std::pair<std::string, std::shared_ptr<TaskCounters>>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex_);
+        for (const auto& [taskId, counters] : tasks_) {
+            tasks.emplace_back("task=\"" + escapeLabel(counters->name) + "\",task_id=\"" + std::to_string(taskId) + "\"", counters);
+        }
+    }
+
+    // Each family lists all its samples together, as the format requires
+    std::string out;
+    out.reserve(512 + tasks.size() * 1024);
+    auto taskFamily = [&](const char* name, const char* type, const char* help, auto value) {
+        appendFamily(out, name, type, help);
+        for (const auto& [labels, counters] : tasks) {
+            appendSample(out, name, labels, value(*counters));
+        }
+    };
+    taskFamily("vbus_task_published_total", "counter", "Messages sent by the task.",
+               [](const TaskCounters& c) { return c.published.load(); });
+    taskFamily("vbus_task_published_bytes_total", "counter", "Payload bytes sent by the task.",
+               [](const TaskCounters& c) { return c.publishedBytes.load(); });
+    taskFamily("vbus_task_delivered_total", "counter", "Messages handed to the task's queue reader or callback.",
+               [](const TaskCounters& c) { return c.delivered.load(); });
+    taskFamily("vbus_task_delivered_bytes_total", "counter", "Payload bytes handed to the task.",
+               [](const TaskCounters& c) { return c.deliveredBytes.load(); });
+    taskFamily("vbus_task_dropped_total", "counter", "Messages discarded from the task's queue.",
+               [](const TaskCounters& c) { return c.dropped.load(); });
+    taskFamily("vbus_task_queue_depth", "gauge", "Messages currently queued for the task.",
+               [](const TaskCounters& c) { return c.queueDepth.load(std::memory_order_relaxed); });
+    taskFamily("vbus_task_queue_depth_max", "gauge", "Largest queue depth seen for the task.",
+               [](const TaskCounters& c) { return c.queueDepthMax.load(std::memory_order_relaxed); });
+
+    auto typeFamily = [&](const char* name, const char* help, auto value) {
+        appendFamily(out, name, "counter", help);
+        for (size_t i = 0; i < kTypeCount; ++i) {
+            appendSample(out, name, std::string("type=\"") + typeName(static_cast<CommandType>(i)) + "\"", value(types_[i]));
+        }
+    };
+    typeFamily("vbus_type_published_total", "Messages published per command type.",
+               [](const TypeCounters& c) { return c.published.load(); });
+    typeFamily("vbus_type_published_bytes_total", "Payload bytes published per command type.",
+               [](const TypeCounters& c) { return c.bytes.load(); });
+    typeFamily("vbus_type_delivered_total", "Deliveries to subscribers per command type.",
+               [](const TypeCounters& c) { return c.delivered.load(); });
+    typeFamily("vbus_type_dropped_total", "Messages discarded per command type.",
+               [](const TypeCounters& c) { return c.dropped.load(); });
+    return out;
+}
@@ -0,0 +1,58 @@
+#include "BusReplayer.h"
+#include "BusJournal.h"
+
+#include <thread>
+
+/**
+ * @brief Replays a journal directory.
+ *
+ * @param[in] directory Journal directory written by BusJournal.
+ * @param[in] speed Replay speed relative to the recording, 0 for maximum speed.
+ * @param[in] senderId Sender identifier to publish with, or -1 to keep the recorded ones.
+ * @param[out] result Replay statistics.
+ * @return OK, NOT_FOUND, ERROR or INVALID_ARGUMENT.
+ */
+ReturnType BusReplayer::replay(const std::string& directory, double speed, int senderId, Result& result) {
+    result = Result{};
+    if (speed < 0.0 || !codec_) {
+        return ReturnType::INVALID_ARGUMENT;
+    }
+
+    BusJournalReader reader(directory, logger_);
+    const auto start = std::chrono::steady_clock::now();
+    bool first = true;
+    uint64_t firstTimestampNs = 0;
+
+    ReturnType status = reader.forEach([&](const BusJournalFormat::RecordHeader& header, const uint8_t* payload) {
+        if (!bus_.isRunning()) {
+            return false;
+        }
+        auto message = codec_->decode(static_cast<CommandType>(header.type), payload, header.payloadSize);
+        if (!message) {
+            ++result.skipped;
+            return true;
+        }
+        if (speed > 0.0) {
+            if (first) {
+                firstTimestampNs = header.timestampNs;
+                first = false;
+            }
+            // Deadlines are taken from the journal start so pacing errors do not accumulate
+            auto offset = std::chrono::nanoseconds(static_cast<int64_t>((header.timestampNs - firstTimestampNs) / speed));
+            std::this_thread::sleep_until(start + offset);
+        }
+        bus_.sendMessage(senderId < 0 ? header.senderId : senderId, message);
+        ++result.replayed;
+        return true;
+    });
+
+    result.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    if (result.elapsed.count() > 0) {
+        result.messagesPerSecond = static_cast<double>(result.replayed) * 1e9 / static_cast<double>(result.elapsed.count());
+    }
+    if (logger_) {
+        logger_->info("BusReplayer: Replayed " + std::to_string(result.replayed) + " messages from " + directory +
+                      ", skipped " + std::to_string(result.skipped) + ".");
+    }
+    return status;
+}
@@ -0,0 +1,466 @@
+#include "CanBusEmulator.h"
+#include "ThreadName.h"
+#include "CanFrameUtils.h"
+#include "ErrorHandler.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr uint32_t kFrameTailBits = 1 + 1 + 1 + 7 + 3;  // CRC delimiter, ACK slot, ACK delimiter, EOF, IFS
+constexpr uint32_t kEofAndIfsBits = 7 + 3;               // Bits not sent when an error interrupts a frame
+constexpr uint32_t kErrorFrameBits = 6 + 8 + 3;          // Error flag, error delimiter, IFS
+constexpr uint32_t kErrorPassiveLimit = 128;
+constexpr uint32_t kBusOffLimit = 256;
+
+/**
+ * @brief Appends the `count` least significant bits of `value` to a bit stream, MSB first.
+ */
+void appendBits(uint8_t* bits, uint32_t& length, uint32_t value, uint32_t count) {
+    for (uint32_t i = count; i-- > 0;) {
+        bits[length++] = static_cast<uint8_t>((value >> i) & 1U);
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Constructor for CanBusEmulator.
+ *
+ * @param[in] baudRate Nominal bit rate in bit/s.
+ * @param[in] mode Time base used to pace frames.
+ * @param[in] logger A shared pointer to a logger instance for logging messages.
+ */
+CanBusEmulator::CanBusEmulator(uint32_t baudRate, TimeMode mode, std::shared_ptr<ILogger> logger)
+    : baudRate_(baudRate), mode_(mode), logger_(logger), running_(false), random_(std::random_device{}()) {
+    if (baudRate_ == 0) {
+        ErrorHandler::handleError("CanBusEmulator", "Baud rate of 0 requested, using 500 kbit/s.", ErrorHandler::ErrorSeverity::WARNING, logger_);
+        baudRate_ = CAN_BAUD_500K;
+    }
+    bitTime_ = std::chrono::duration<double, std::nano>(1e9 / static_cast<double>(baudRate_));
+    if (logger_) {
+        logger_->info("CanBusEmulator: Initialized at " + std::to_string(baudRate_) + " bit/s.");
+    }
+}
+
+/**
+ * @brief Destructor that stops the bus thread.
+ */
+CanBusEmulator::~CanBusEmulator() {
+    stop();
+}
+
+/**
+ * @brief Attaches a simulated ECU to the bus.
+ *
+ * @param[in] name Name of the node.
+ * @param[in] callback Receive callback.
+ * @param[in] mailboxDepth Maximum number of pending frames.
+ * @return Node identifier.
+ */
+int CanBusEmulator::attachNode(const std::string& name, FrameCallback callback, size_t mailboxDepth) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto node = std::make_unique<Node>();
+    node->name = name;
+    node->callback = std::move(callback);
+    node->mailboxDepth = std::max<size_t>(mailboxDepth, 1);
+    nodes_.push_back(std::move(node));
+    int nodeId = static_cast<int>(nodes_.size() - 1);
+    if (logger_) {
+        logger_->info("CanBusEmulator: Node " + name + " (ID: " + std::to_string(nodeId) + ") attached.");
+    }
+    return nodeId;
+}
+
+/**
+ * @brief Queues a frame for transmission by a node.
+ *
+ * @param[in] nodeId Identifier returned by attachNode().
+ * @param[in] frame The frame to send.
+ * @return Result of the request.
+ */
+ReturnType CanBusEmulator::transmit(int nodeId, const can_frame& frame) {
+    if (frame.can_dlc > 8) {
+        return ReturnType::INVALID_ARGUMENT;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (nodeId < 0 || nodeId >= static_cast<int>(nodes_.size())) {
+            return ReturnType::INVALID_ARGUMENT;
+        }
+        Node& node = *nodes_[nodeId];
+        if (node.state == NodeState::BusOff) {
+            ++txRejected_;
+            return ReturnType::ERROR;
+        }
+        if (node.mailbox.size() >= node.mailboxDepth) {
+            ++txRejected_;
+            return ReturnType::BUSY;
+        }
+        node.mailbox.push_back(PendingFrame{frame, Clock::now()});
+    }
+    txCondition_.notify_one();
+    return ReturnType::OK;
+}
+
+/**
+ * @brief Starts the bus thread.
+ */
+void CanBusEmulator::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        startTime_ = Clock::now();
+        busTime_ = startTime_;
+    }
+    thread_ = std::thread(&CanBusEmulator::run, this);
+    if (logger_) {
+        logger_->info("CanBusEmulator: Started.");
+    }
+}
+
+/**
+ * @brief Stops the bus thread and discards pending frames.
+ */
+void CanBusEmulator::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    {
+        // Taking the lock orders the flag change against the wait predicate of the bus thread
+        std::lock_guard<std::mutex> lock(mutex_);
+    }
+    txCondition_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& node : nodes_) {
+            node->mailbox.clear();
+        }
+    }
+    idleCondition_.notify_all();
+    if (logger_) {
+        logger_->info("CanBusEmulator: Stopped.");
+    }
+}
+
+/**
+ * @brief Blocks until every mailbox is empty and the last frame was delivered, or the timeout expires.
+ *
+ * @param[in] timeout Maximum time to wait.
+ * @return True if the bus drained.
+ */
+bool CanBusEmulator::waitIdle(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return idleCondition_.wait_for(lock, timeout, [this] {
+        return !frameInFlight_ && arbitrate() < 0;
+    });
+}
+
+/**
+ * @brief Sets the probability that a transmitted frame is corrupted.
+ *
+ * @param[in] probability Value between 0.0 and 1.0.
+ */
+void CanBusEmulator::setErrorRate(double probability) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    errorRate_ = std::clamp(probability, 0.0, 1.0);
+}
+
+/**
+ * @brief Brings a bus-off node back onto the bus.
+ *
+ * @param[in] nodeId Identifier returned by attachNode().
+ */
+void CanBusEmulator::recoverNode(int nodeId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (nodeId < 0 || nodeId >= static_cast<int>(nodes_.size())) {
+        return;
+    }
+    nodes_[nodeId]->txErrorCounter = 0;
+    nodes_[nodeId]->state = NodeState::ErrorActive;
+    if (logger_) {
+        logger_->info("CanBusEmulator: Node " + nodes_[nodeId]->name + " recovered from bus-off.");
+    }
+}
+
+/**
+ * @brief Getter for the error state of a node.
+ *
+ * @param[in] nodeId Identifier returned by attachNode().
+ * @return Error state of the node.
+ */
+CanBusEmulator::NodeState CanBusEmulator::getNodeState(int nodeId) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (nodeId < 0 || nodeId >= static_cast<int>(nodes_.size())) {
+        return NodeState::BusOff;
+    }
+    return nodes_[nodeId]->state;
+}
+
+/**
+ * @brief Returns a snapshot of the bus statistics.
+ *
+ * @return Current statistics.
+ */
+CanBusEmulator::Statistics CanBusEmulator::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Statistics stats;
+    stats.framesDelivered = framesDelivered_;
+    stats.errorFrames = errorFrames_;
+    stats.txRejected = txRejected_;
+    stats.busBits = busBits_;
+    stats.meanLatencyUs = framesDelivered_ ? latencySumUs_ / static_cast<double>(framesDelivered_) : 0.0;
+    stats.maxLatencyUs = latencyMaxUs_;
+
+    if (startTime_ != Clock::time_point{}) {
+        // In virtual mode the simulated bus clock may run ahead of the wall clock
+        Clock::time_point end = std::max(Clock::now(), busTime_);
+        stats.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - startTime_);
+    }
+    if (stats.elapsed.count() > 0) {
+        double busyNs = static_cast<double>(busBits_) * bitTime_.count();
+        stats.busLoad = std::min(1.0, busyNs / static_cast<double>(stats.elapsed.count()));
+    }
+    return stats;
+}
+
+/**
+ * @brief Computes the number of bit times a frame occupies on the bus.
+ *
+ * @param[in] frame The frame to measure.
+ * @return Number of bit times.
+ */
+uint32_t CanBusEmulator::frameBitLength(const can_frame& frame) {
+    // SOF through CRC is at most 1 + 32 + 6 + 64 + 15 bits for an extended data frame
+    uint8_t bits[128];
+    uint32_t length = 0;
+    const bool extended = (frame.can_id & CAN_EFF_FLAG) != 0;
+    const bool remote = (frame.can_id & CAN_RTR_FLAG) != 0;
+    const uint8_t dlc = std::min<uint8_t>(frame.can_dlc, 8);
+
+    appendBits(bits, length, 0, 1);  // SOF
+    if (extended) {
+        uint32_t id = CAN_EFF_ID(frame.can_id);
+        appendBits(bits, length, id >> 18, 11);   // Base identifier
+        appendBits(bits, length, 1, 1);           // SRR
+        appendBits(bits, length, 1, 1);           // IDE
+        appendBits(bits, length, id & 0x3FFFF, 18);  // Identifier extension
+        appendBits(bits, length, remote ? 1 : 0, 1);  // RTR
+        appendBits(bits, length, 0, 2);           // r1, r0
+    } else {
+        appendBits(bits, length, CAN_SFF_ID(frame.can_id), 11);
+        appendBits(bits, length, remote ? 1 : 0, 1);  // RTR
+        appendBits(bits, length, 0, 2);           // IDE, r0
+    }
+    appendBits(bits, length, dlc, 4);
+    if (!remote) {
+        for (uint8_t i = 0; i < dlc; ++i) {
+            appendBits(bits, length, frame.data[i], 8);
+        }
+    }
+
+    uint32_t crc = 0;
+    for (uint32_t i = 0; i < length; ++i) {
+        uint32_t next = bits[i] ^ ((crc >> 14) & 1U);
+        crc = (crc << 1) & 0x7FFFU;
+        if (next) {
+            crc ^= 0x4599U;
+        }
+    }
+    appendBits(bits, length, crc, 15);
+
+    // A stuff bit of opposite polarity follows every five consecutive identical bits
+    uint32_t stuffBits = 0;
+    uint8_t previous = bits[0];
+    uint32_t run = 1;
+    for (uint32_t i = 1; i < length; ++i) {
+        if (bits[i] == previous) {
+            ++run;
+        } else {
+            previous = bits[i];
+            run = 1;
+        }
+        if (run == 5) {
+            ++stuffBits;
+            previous = static_cast<uint8_t>(!previous);
+            run = 1;
+        }
+    }
+
+    return length + stuffBits + kFrameTailBits;
+}
+
+/**
+ * @brief Computes the arbitration key of a CAN identifier.
+ *
+ * @param[in] canId Identifier including flags.
+ * @return Arbitration key, lower keys win.
+ */
+uint32_t CanBusEmulator::arbitrationKey(uint32_t canId) {
+    return canArbitrationKey(canId);
+}
+
+/**
+ * @brief Selects the frame that wins arbitration. Must be called with mutex_ held.
+ *
+ * Every node is modelled as a controller with priority-ordered mailboxes, so the lowest
+ * identifier wins both inside a node and across nodes. Frames with the same identifier
+ * keep their submission order.
+ *
+ * @param[out] position Index of the winning frame inside the node mailbox.
+ * @return Index of the winning node, or -1 if no frame is pending.
+ */
+int CanBusEmulator::arbitrate(size_t* position) const {
+    int winner = -1;
+    uint32_t winnerKey = 0;
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        const Node& node = *nodes_[i];
+        if (node.state == NodeState::BusOff) {
+            continue;
+        }
+        for (size_t j = 0; j < node.mailbox.size(); ++j) {
+            uint32_t key = arbitrationKey(node.mailbox[j].frame.can_id);
+            if (winner < 0 || key < winnerKey) {
+                winner = static_cast<int>(i);
+                winnerKey = key;
+                if (position) {
+                    *position = j;
+                }
+            }
+        }
+    }
+    return winner;
+}
+
+/**
+ * @brief Advances the bus clock by a number of bit times.
+ *
+ * @param[in] bits Number of bit times.
+ * @return Time at the end of the interval.
+ */
+CanBusEmulator::Clock::time_point CanBusEmulator::occupyBus(uint32_t bits) {
+    auto duration = std::chrono::duration_cast<Clock::duration>(bitTime_ * bits);
+    Clock::time_point begin = std::max(busTime_, Clock::now());
+    Clock::time_point end = begin + duration;
+    if (mode_ == TimeMode::RealTime) {
+        std::this_thread::sleep_until(end);
+    }
+    return end;
+}
+
+/**
+ * @brief Delivers a frame to every node except the sender and the bus-off nodes.
+ *
+ * @param[in] sender Index of the transmitting node, or -1 for all nodes.
+ * @param[in] frame The frame to deliver.
+ * @param[in] when Time the frame completed on the bus.
+ */
+void CanBusEmulator::deliver(int sender, const can_frame& frame, Clock::time_point when) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        deliveryList_.clear();
+        for (size_t i = 0; i < nodes_.size(); ++i) {
+            // A bus-off node is disconnected from the bus and sees no traffic
+            const bool receives = static_cast<int>(i) != sender && nodes_[i]->state != NodeState::BusOff;
+            deliveryList_.push_back(receives ? nodes_[i].get() : nullptr);
+        }
+    }
+    // Nodes are never removed and their callbacks are immutable, so no lock is held while calling out
+    for (Node* node : deliveryList_) {
+        if (node && node->callback) {
+            node->callback(frame, when);
+        }
+    }
+}
+
+/**
+ * @brief Main loop of the bus thread.
+ */
+void CanBusEmulator::run() {
+    ThreadName::set("vbus-canemu");
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        txCondition_.wait(lock, [this] { return !running_ || arbitrate() >= 0; });
+        if (!running_) {
+            break;
+        }
+
+        size_t position = 0;
+        const int winner = arbitrate(&position);
+        const PendingFrame pending = nodes_[winner]->mailbox[position];
+        const uint32_t bits = frameBitLength(pending.frame);
+        const bool corrupted = errorRate_ > 0.0 && distribution(random_) < errorRate_;
+        const uint32_t occupied = corrupted ? bits - kEofAndIfsBits + kErrorFrameBits : bits;
+        frameInFlight_ = true;
+
+        lock.unlock();
+        Clock::time_point end = occupyBus(occupied);
+        lock.lock();
+
+        busTime_ = end;
+        busBits_ += occupied;
+        Node& node = *nodes_[winner];
+
+        if (!corrupted) {
+            node.mailbox.erase(node.mailbox.begin() + static_cast<std::ptrdiff_t>(position));
+            if (node.txErrorCounter > 0) {
+                --node.txErrorCounter;
+            }
+            if (node.state == NodeState::ErrorPassive && node.txErrorCounter < kErrorPassiveLimit) {
+                node.state = NodeState::ErrorActive;
+            }
+            double latencyUs = std::chrono::duration<double, std::micro>(end - pending.enqueuedAt).count();
+            latencySumUs_ += latencyUs;
+            latencyMaxUs_ = std::max(latencyMaxUs_, latencyUs);
+            ++framesDelivered_;
+
+            lock.unlock();
+            deliver(winner, pending.frame, end);
+            lock.lock();
+        } else {
+            ++errorFrames_;
+            node.txErrorCounter += 8;
+            can_frame errorFrame{};
+            errorFrame.can_id = CAN_ERR_PROT;
+            errorFrame.can_dlc = 8;
+            errorFrame.data[0] = CAN_ERR_TX_FAIL;
+
+            bool busOff = false;
+            if (node.txErrorCounter >= kBusOffLimit) {
+                node.state = NodeState::BusOff;
+                txRejected_ += node.mailbox.size();
+                node.mailbox.clear();
+                busOff = true;
+            } else if (node.txErrorCounter >= kErrorPassiveLimit) {
+                node.state = NodeState::ErrorPassive;
+            }
+            std::string nodeName = node.name;
+
+            lock.unlock();
+            deliver(winner, errorFrame, end);
+            if (busOff) {
+                can_frame busOffFrame{};
+                busOffFrame.can_id = CAN_ERR_CRTL;
+                busOffFrame.can_dlc = 8;
+                busOffFrame.data[0] = CAN_ERR_BUSOFF;
+                if (node.callback) {
+                    node.callback(busOffFrame, end);
+                }
+                ErrorHandler::handleError("CanBusEmulator", "Node " + nodeName + " entered bus-off.", ErrorHandler::ErrorSeverity::WARNING, logger_);
+            }
+            lock.lock();
+        }
+
+        // Only cleared once the callbacks returned, so waitIdle() also waits for the delivery
+        frameInFlight_ = false;
+        if (arbitrate() < 0) {
+            idleCondition_.notify_all();
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#include "CanDumpReader.h"
+
+#include <cstdlib>
+#include <fstream>
+
+namespace {
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+} // namespace
+
+/**
+ * @brief Parses a single log line.
+ *
+ * @param[in] line The line to parse.
+ * @param[out] record The parsed frame.
+ * @return OK or INVALID_ARGUMENT.
+ */
+ReturnType CanDumpReader::parseLine(const std::string& line, CanDumpRecord& record) {
+    size_t open = line.find('(');
+    size_t close = line.find(')', open);
+    if (open == std::string::npos || close == std::string::npos) {
+        return ReturnType::INVALID_ARGUMENT;
+    }
+    record.timestamp = std::strtod(line.c_str() + open + 1, nullptr);
+
+    // Skip the interface name
+    size_t interfaceStart = line.find_first_not_of(' ', close + 1);
+    size_t frameStart = (interfaceStart == std::string::npos) ? std::string::npos : line.find(' ', interfaceStart);
+    frameStart = (frameStart == std::string::npos) ? std::string::npos : line.find_first_not_of(' ', frameStart);
+    if (frameStart == std::string::npos) {
+        return ReturnType::INVALID_ARGUMENT;
+    }
+    size_t hash = line.find('#', frameStart);
+    if (hash == std::string::npos || hash == frameStart || hash - frameStart > 8) {
+        return ReturnType::INVALID_ARGUMENT;
+    }
+
+    uint32_t id = 0;
+    for (size_t i = frameStart; i < hash; ++i) {
+        int digit = hexValue(line[i]);
+        if (digit < 0) {
+            return ReturnType::INVALID_ARGUMENT;
+        }
+        id = (id << 4) | static_cast<uint32_t>(digit);
+    }
+    record.frame = can_frame{};
+    record.frame.can_id = (hash - frameStart == 8) ? ((id & CAN_EFF_MASK) | CAN_EFF_FLAG) : (id & CAN_SFF_MASK);
+
+    size_t position = hash + 1;
+    if (position < line.size() && (line[position] == 'R' || line[position] == 'r')) {
+        record.frame.can_id |= CAN_RTR_FLAG;
+        if (position + 1 < line.size() && hexValue(line[position + 1]) >= 0) {
+            record.frame.can_dlc = static_cast<uint8_t>(hexValue(line[position + 1]) & 0x0F);
+        }
+        return record.frame.can_dlc <= 8 ? ReturnType::OK : ReturnType::INVALID_ARGUMENT;
+    }
+
+    uint8_t length = 0;
+    while (position + 1 < line.size() && length < 8) {
+        if (line[position] == '.') {
+            ++position;
+            continue;
+        }
+        int high = hexValue(line[position]);
+        int low = hexValue(line[position + 1]);
+        if (high < 0 || low < 0) {
+            break;
+        }
+        record.frame.data[length++] = static_cast<uint8_t>((high << 4) | low);
+        position += 2;
+    }
+    record.frame.can_dlc = length;
+    return ReturnType::OK;
+}
+
+/**
+ * @brief Loads all frames of a log file.
+ *
+ * @param[in] path Path of the log file.
+ * @param[out] records Parsed frames.
+ * @return OK or NOT_FOUND.
+ */
+ReturnType CanDumpReader::load(const std::string& path, std::vector<CanDumpRecord>& records) const {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        if (logger_) logger_->error("CanDumpReader: Failed to open " + path);
+        return ReturnType::NOT_FOUND;
+    }
+    std::string line;
+    size_t skipped = 0;
+    CanDumpRecord record;
+    while (std::getline(file, line)) {
+        if (parseLine(line, record) == ReturnType::OK) {
+            records.push_back(record);
+        } else if (!line.empty()) {
+            ++skipped;
+        }
+    }
+    if (logger_) {
+        logger_->info("CanDumpReader: Loaded " + std::to_string(records.size()) + " frames from " + path +
+                      ", skipped " + std::to_string(skipped) + " lines.");
+    }
+    return ReturnType::OK;
+}
@@ -0,0 +1,259 @@
+#include "CanOpenPdoMapper.h"
+#include "ErrorHandler.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief Reads the PDO payload as a little endian 64-bit word.
+ */
+uint64_t loadPayload(const can_frame& frame) {
+    uint64_t word = 0;
+    for (uint8_t i = 0; i < frame.can_dlc && i < 8; ++i) {
+        word |= static_cast<uint64_t>(frame.data[i]) << (8 * i);
+    }
+    return word;
+}
+
+/**
+ * @brief Converts a physical value into the raw encoding of a field.
+ */
+uint64_t toRaw(double value, CanOpenDataType type, uint8_t bitLength) {
+    const uint64_t mask = (bitLength >= 64) ? ~0ULL : ((1ULL << bitLength) - 1);
+    if (type == CanOpenDataType::Real32) {
+        float real = static_cast<float>(value);
+        uint32_t bits;
+        std::memcpy(&bits, &real, sizeof(bits));
+        return bits & mask;
+    }
+    double rounded = std::isnan(value) ? 0.0 : std::round(value);
+    if (type == CanOpenDataType::Signed) {
+        const double limit = std::ldexp(1.0, bitLength - 1);
+        rounded = std::fmin(std::fmax(rounded, -limit), limit - 1);
+        return static_cast<uint64_t>(static_cast<int64_t>(rounded)) & mask;
+    }
+    rounded = std::fmin(std::fmax(rounded, 0.0), static_cast<double>(mask));
+    return static_cast<uint64_t>(rounded) & mask;
+}
+
+} // namespace
+
+/**
+ * @brief Constructor for CanOpenPdoMapper.
+ *
+ * @param[in] bus Virtual bus decoded commands are published on.
+ * @param[in] senderId Sender identifier of published commands.
+ * @param[in] logger A shared pointer to a logger instance for logging messages.
+ */
+CanOpenPdoMapper::CanOpenPdoMapper(VirtualBus& bus, int senderId, std::shared_ptr<ILogger> logger)
+    : bus_(bus), senderId_(senderId), logger_(logger), rpdoBySffId_(CAN_SFF_MASK + 1, -1) {}
+
+/**
+ * @brief Sets the object dictionary entries PDO mappings may refer to.
+ *
+ * @param[in] bindings Object dictionary bindings.
+ */
+void CanOpenPdoMapper::setObjectDictionary(std::vector<CanOpenObjectBinding> bindings) {
+    dictionary_ = std::move(bindings);
+}
+
+/**
+ * @brief Resolves mapping entries against the object dictionary.
+ *
+ * @param[in] cobId COB-ID of the PDO.
+ * @param[in] mapping Mapping entries in CiA 301 format.
+ * @param[out] pdo Compiled PDO.
+ * @return OK or INVALID_ARGUMENT.
+ */
+ReturnType CanOpenPdoMapper::compile(uint32_t cobId, const std::vector<uint32_t>& mapping, CompiledPdo& pdo) const {
+    pdo.cobId = cobId;
+    pdo.fields.clear();
+    uint32_t bitOffset = 0;
+    for (uint32_t entry : mapping) {
+        const uint16_t index = static_cast<uint16_t>(entry >> 16);
+        const uint8_t subIndex = static_cast<uint8_t>(entry >> 8);
+        const uint8_t bitLength = static_cast<uint8_t>(entry);
+
+        const CanOpenObjectBinding* binding = nullptr;
+        for (const auto& candidate : dictionary_) {
+            if (candidate.index == index && candidate.subIndex == subIndex) {
+                binding = &candidate;
+                break;
+            }
+        }
+        if (!binding || bitLength == 0 || bitLength > 32 || bitOffset + bitLength > 64 ||
+            (binding->type == CanOpenDataType::Real32 && bitLength != 32)) {
+            char text[16];
+            std::snprintf(text, sizeof(text), "%04X:%02X/%u", index, subIndex, bitLength);
+            ErrorHandler::handleError("CanOpenPdoMapper", "Invalid mapping entry " + std::string(text) + ".", ErrorHandler::ErrorSeverity::ERROR, logger_);
+            return ReturnType::INVALID_ARGUMENT;
+        }
+        pdo.fields.push_back(CompiledField{static_cast<uint8_t>(bitOffset), bitLength, binding->type,
+                                           binding->scale, binding->set, binding->get});
+        bitOffset += bitLength;
+    }
+    pdo.length = static_cast<uint8_t>((bitOffset + 7) / 8);
+    return ReturnType::OK;
+}
+
+/**
+ * @brief Adds a receive PDO.
+ *
+ * @param[in] cobId COB-ID of the PDO.
+ * @param[in] mapping Mapping entries.
+ * @param[in] factory Command factory.
+ * @return Result of the request.
+ */
+ReturnType CanOpenPdoMapper::addRpdo(uint32_t cobId, const std::vector<uint32_t>& mapping, CommandFactory factory) {
+    if (!factory || findRpdo(cobId)) {
+        return ReturnType::INVALID_ARGUMENT;
+    }
+    CompiledPdo pdo{};
+    ReturnType result = compile(cobId, mapping, pdo);
+    if (result != ReturnType::OK) {
+        return result;
+    }
+    pdo.factory = factory;
+    rpdos_.push_back(std::move(pdo));
+    if (!(cobId & CAN_EFF_FLAG)) {
+        rpdoBySffId_[CAN_SFF_ID(cobId)] = static_cast<int16_t>(rpdos_.size() - 1);
+    }
+    if (logger_) {
+        char id[16];
+        std::snprintf(id, sizeof(id), "0x%X", cobId);
+        logger_->info("CanOpenPdoMapper: RPDO " + std::string(id) + " mapped with " + std::to_string(mapping.size()) + " entries.");
+    }
+    return ReturnType::OK;
+}
+
+/**
+ * @brief Adds a transmit PDO.
+ *
+ * @param[in] cobId COB-ID of the PDO.
+ * @param[in] mapping Mapping entries.
+ * @param[in] type Source command type.
+ * @return Result of the request.
+ */
+ReturnType CanOpenPdoMapper::addTpdo(uint32_t cobId, const std::vector<uint32_t>& mapping, CommandType type) {
+    CompiledPdo pdo{};
+    ReturnType result = compile(cobId, mapping, pdo);
+    if (result != ReturnType::OK) {
+        return result;
+    }
+    for (const auto& field : pdo.fields) {
+        if (!field.get) {
+            return ReturnType::INVALID_ARGUMENT;
+        }
+    }
+    pdo.type = type;
+    tpdos_.push_back(std::move(pdo));
+    return ReturnType::OK;
+}
+
+/**
+ * @brief Finds the receive PDO of a COB-ID.
+ *
+ * @param[in] cobId COB-ID of the frame.
+ * @return Compiled PDO or nullptr.
+ */
+const CanOpenPdoMapper::CompiledPdo* CanOpenPdoMapper::findRpdo(uint32_t cobId) const {
+    if (!(cobId & CAN_EFF_FLAG)) {
+        int16_t index = rpdoBySffId_[CAN_SFF_ID(cobId)];
+        return index >= 0 ? &rpdos_[index] : nullptr;
+    }
+    for (const auto& pdo : rpdos_) {
+        if (pdo.cobId == cobId) {
+            return &pdo;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Decodes a received frame without publishing it.
+ *
+ * @param[in] frame The received frame.
+ * @param[out] command The decoded command.
+ * @return Result of decoding.
+ */
+ReturnType CanOpenPdoMapper::decode(const can_frame& frame, std::shared_ptr<VirtualBusCmd>& command) const {
+    // A remote request carries no payload, it asks the producer to send the PDO
+    if (frame.can_id & CAN_RTR_FLAG) {
+        return ReturnType::NOT_FOUND;
+    }
+    const CompiledPdo* pdo = findRpdo(frame.can_id);
+    if (!pdo) {
+        return ReturnType::NOT_FOUND;
+    }
+    if (frame.can_dlc < pdo->length) {
+        return ReturnType::INVALID_ARGUMENT;
+    }
+
+    const uint64_t payload = loadPayload(frame);
+    command = pdo->factory();
+    for (const CompiledField& field : pdo->fields) {
+        uint64_t raw = (payload >> field.bitOffset) & ((1ULL << field.bitLength) - 1);
+        double value;
+        if (field.type == CanOpenDataType::Real32) {
+            uint32_t bits = static_cast<uint32_t>(raw);
+            float real;
+            std::memcpy(&real, &bits, sizeof(real));
+            value = real;
+        } else if (field.type == CanOpenDataType::Signed) {
+            const uint64_t signBit = 1ULL << (field.bitLength - 1);
+            value = static_cast<double>(static_cast<int64_t>((raw ^ signBit) - signBit));
+        } else {
+            value = static_cast<double>(raw);
+        }
+        if (field.set) {
+            field.set(*command, value * field.scale);
+        }
+    }
+    return ReturnType::OK;
+}
+
+/**
+ * @brief Decodes a received frame and publishes the resulting command.
+ *
+ * @param[in] frame The received frame.
+ * @return Result of decoding.
+ */
+ReturnType CanOpenPdoMapper::onFrame(const can_frame& frame) {
+    std::shared_ptr<VirtualBusCmd> command;
+    ReturnType result = decode(frame, command);
+    if (result == ReturnType::OK) {
+        bus_.sendMessage(senderId_, command);
+    }
+    return result;
+}
+
+/**
+ * @brief Encodes a command into the TPDO configured for its type.
+ *
+ * @param[in] command The command to encode.
+ * @param[out] frame The encoded frame.
+ * @return Result of encoding.
+ */
+ReturnType CanOpenPdoMapper::encode(const VirtualBusCmd& command, can_frame& frame) const {
+    for (const CompiledPdo& pdo : tpdos_) {
+        if (pdo.type != command.getType()) {
+            continue;
+        }
+        uint64_t payload = 0;
+        for (const CompiledField& field : pdo.fields) {
+            double value = field.get(command) / field.scale;
+            payload |= toRaw(value, field.type, field.bitLength) << field.bitOffset;
+        }
+        frame = can_frame{};
+        frame.can_id = pdo.cobId;
+        frame.can_dlc = pdo.length;
+        for (uint8_t i = 0; i < pdo.length; ++i) {
+            frame.data[i] = static_cast<uint8_t>(payload >> (8 * i));
+        }
+        return ReturnType::OK;
+    }
+    return ReturnType::NOT_FOUND;
+}
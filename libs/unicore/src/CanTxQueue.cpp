@@ -0,0 +1,189 @@
+#include "CanTxQueue.h"
+#include "ThreadName.h"
+#include "CanFrameUtils.h"
+#include "ErrorHandler.h"
+
+#include <algorithm>
+
+/**
+ * @brief Constructor for CanTxQueue.
+ *
+ * @param[in] sink Destination of the frames.
+ * @param[in] maxBatch Maximum number of frames per write.
+ * @param[in] capacity Maximum number of pending and in-flight frames.
+ * @param[in] logger A shared pointer to a logger instance for logging messages.
+ */
+CanTxQueue::CanTxQueue(std::shared_ptr<ICanSink> sink, size_t maxBatch, size_t capacity,
+                       std::shared_ptr<ILogger> logger)
+    : sink_(std::move(sink)), maxBatch_(std::max<size_t>(maxBatch, 1)), capacity_(std::max<size_t>(capacity, 1)),
+      logger_(logger), running_(false) {
+    batch_.reserve(maxBatch_);
+    if (!sink_) {
+        ErrorHandler::handleError("CanTxQueue", "No sink provided, frames will be discarded.", ErrorHandler::ErrorSeverity::WARNING, logger_);
+    }
+}
+
+/**
+ * @brief Destructor that stops the transmit thread.
+ */
+CanTxQueue::~CanTxQueue() {
+    stop();
+}
+
+/**
+ * @brief Queues a frame, replacing an unsent frame with the same identifier.
+ *
+ * @param[in] frame The frame to send.
+ * @return Result of the request.
+ */
+ReturnType CanTxQueue::submit(const can_frame& frame) {
+    if (frame.can_dlc > 8) {
+        return ReturnType::INVALID_ARGUMENT;
+    }
+    const uint32_t key = canArbitrationKey(frame.can_id);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = pending_.find(key);
+        if (it != pending_.end()) {
+            it->second = frame;
+            ++stats_.replaced;
+        } else {
+            // Frames of the batch in flight count too, so requeue() never exceeds the capacity
+            if (pending_.size() + inFlight_ >= capacity_) {
+                ++stats_.rejected;
+                return ReturnType::BUSY;
+            }
+            pending_.emplace(key, frame);
+        }
+        ++stats_.submitted;
+    }
+    txCondition_.notify_one();
+    return ReturnType::OK;
+}
+
+/**
+ * @brief Starts the transmit thread.
+ */
+void CanTxQueue::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    thread_ = std::thread(&CanTxQueue::run, this);
+    if (logger_) {
+        logger_->info("CanTxQueue: Started with batch size " + std::to_string(maxBatch_) + ".");
+    }
+}
+
+/**
+ * @brief Stops the transmit thread and discards pending frames.
+ */
+void CanTxQueue::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    {
+        // Taking the lock orders the flag change against the wait predicate of the transmit thread
+        std::lock_guard<std::mutex> lock(mutex_);
+    }
+    txCondition_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.clear();
+    }
+    drainedCondition_.notify_all();
+    if (logger_) {
+        logger_->info("CanTxQueue: Stopped.");
+    }
+}
+
+/**
+ * @brief Blocks until all pending frames were written or the timeout expires.
+ *
+ * @param[in] timeout Maximum time to wait.
+ * @return True if the queue drained.
+ */
+bool CanTxQueue::flush(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return drainedCondition_.wait_for(lock, timeout, [this] {
+        return pending_.empty() && !writing_;
+    });
+}
+
+/**
+ * @brief Returns a snapshot of the queue statistics.
+ *
+ * @return Current statistics.
+ */
+CanTxQueue::Statistics CanTxQueue::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Statistics stats = stats_;
+    stats.pending = pending_.size();
+    return stats;
+}
+
+/**
+ * @brief Puts frames the sink did not accept back into the queue.
+ *
+ * @param[in] first Index of the first unsent frame in batch_.
+ */
+void CanTxQueue::requeue(size_t first) {
+    for (size_t i = first; i < batch_.size(); ++i) {
+        // emplace keeps a newer frame submitted while the batch was in flight
+        pending_.emplace(canArbitrationKey(batch_[i].can_id), batch_[i]);
+    }
+}
+
+/**
+ * @brief Main loop of the transmit thread.
+ */
+void CanTxQueue::run() {
+    ThreadName::set("vbus-cantx");
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        txCondition_.wait(lock, [this] { return !running_ || !pending_.empty(); });
+        if (!running_) {
+            break;
+        }
+
+        // Take the highest priority frames; anything submitted later competes again on the next batch
+        batch_.clear();
+        auto it = pending_.begin();
+        while (it != pending_.end() && batch_.size() < maxBatch_) {
+            batch_.push_back(it->second);
+            it = pending_.erase(it);
+        }
+        inFlight_ = batch_.size();
+        writing_ = true;
+
+        lock.unlock();
+        size_t written = 0;
+        ReturnType result = ReturnType::ERROR;
+        if (sink_) {
+            result = sink_->writeFrames(batch_.data(), batch_.size(), written);
+        }
+        lock.lock();
+
+        writing_ = false;
+        inFlight_ = 0;
+        ++stats_.batches;
+        stats_.written += written;
+        if (result == ReturnType::BUSY) {
+            ++stats_.sinkBusy;
+            requeue(written);
+            auto interval = retryInterval_.load();
+            txCondition_.wait_for(lock, interval, [this] { return !running_; });
+        } else if (result != ReturnType::OK) {
+            ++stats_.sinkErrors;
+            if (logger_) {
+                logger_->error("CanTxQueue: Sink failed, dropped " + std::to_string(batch_.size() - written) + " frames.");
+            }
+        }
+
+        if (pending_.empty()) {
+            drainedCondition_.notify_all();
+        }
+    }
+}
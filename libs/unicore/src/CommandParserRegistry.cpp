@@ -0,0 +1,27 @@
+#include "CommandParserRegistry.h"
+#include "ErrorHandler.h"
+
+std::array<std::atomic<JsonCmdParser*>, CommandParserRegistry::kTypeCount> CommandParserRegistry::parsers_{};
+
+ReturnType CommandParserRegistry::registerParser(CommandType type, std::unique_ptr<JsonCmdParser> parser,
+                                                 std::shared_ptr<ILogger> logger) {
+    const auto index = static_cast<size_t>(type);
+    if (!parser || index >= kTypeCount) {
+        ErrorHandler::handleError("CommandParserRegistry", "Invalid parser registration.", ErrorHandler::ErrorSeverity::ERROR, logger);
+        return ReturnType::INVALID_ARGUMENT;
+    }
+
+    JsonCmdParser* expected = nullptr;
+    if (!parsers_[index].compare_exchange_strong(expected, parser.get(), std::memory_order_acq_rel)) {
+        ErrorHandler::handleError("CommandParserRegistry", "Parser for command type " + std::to_string(index) + " already registered.",
+                                  ErrorHandler::ErrorSeverity::WARNING, logger);
+        return ReturnType::BUSY;
+    }
+    // Registered parsers are never removed, commands may use them until exit
+    parser.release();
+
+    if (logger) {
+        logger->info("CommandParserRegistry: Registered parser for command type " + std::to_string(index) + ".");
+    }
+    return ReturnType::OK;
+}
@@ -1,42 +1,407 @@
 // ErrorHandler.cpp
 #include "ErrorHandler.h"
+#include "FlightRecorder.h"
+#include "ThreadName.h"
 
-std::mutex ErrorHandler::mutex_;  // Define the static mutex variable here.
+#include <chrono>
+#include <condition_variable>
+#include <thread>
 
-void ErrorHandler::handleError(const std::string& module, const std::string& message, ErrorSeverity severity, std::shared_ptr<ILogger> logger) {
-    std::lock_guard<std::mutex> lock(mutex_);
+ProfiledMutex ErrorHandler::mutex_{"ErrorHandler::mutex_"};
+std::atomic<FlightRecorder*> ErrorHandler::recorder_{nullptr};
+std::vector<std::shared_ptr<FlightRecorder>> ErrorHandler::recorders_;
+
+namespace {
+
+using Severity = ErrorHandler::ErrorSeverity;
+
+constexpr size_t kSeverities = 4;
+constexpr size_t kModuleSlots = 64;        // Power of two
+constexpr size_t kDedupSlots = 1024;       // Power of two
+constexpr size_t kMaxProbes = 16;
+constexpr size_t kQueueCapacity = 1024;    // Power of two
+constexpr int kIdleIntervalsBeforeEviction = 2;
+constexpr std::chrono::milliseconds kSummaryInterval{1000};
+constexpr uint64_t kTombstone = ~0ull;     // Key of an evicted slot, keeps the rest of its probe sequence reachable
+
+uint64_t fnv1a(uint64_t hash, const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ static_cast<uint8_t>(data[i])) * 1099511628211ull;
+    }
+    return hash;
+}
+
+uint64_t moduleKey(const std::string& module) {
+    const uint64_t hash = fnv1a(14695981039346656037ull, module.data(), module.size());
+    return hash != 0 && hash != kTombstone ? hash : 1;
+}
+
+uint64_t reportKey(uint64_t moduleKey, Severity severity, const std::string& message) {
+    const char severityByte = static_cast<char>(severity);
+    uint64_t hash = fnv1a(moduleKey, &severityByte, 1);
+    hash = fnv1a(hash, message.data(), message.size());
+    return hash != 0 && hash != kTombstone ? hash : 1;
+}
+
+// Per-module counters, claimed by the first report of a module
+struct ModuleSlot {
+    std::atomic<uint64_t> key{0};
+    std::atomic<uint64_t> counts[kSeverities]{};
+};
+
+// Occurrences of one distinct report in the current summary interval
+struct DedupSlot {
+    std::atomic<uint64_t> key{0};
+    std::atomic<uint64_t> count{0};
+};
+
+ModuleSlot moduleSlots[kModuleSlots];
+ModuleSlot overflowModules;  // Modules that found no free slot
+DedupSlot dedupSlots[kDedupSlots];
+
+/**
+ * @brief Finds the slot of a key by linear probing, claiming a free one if asked to.
+ *
+ * The whole probe sequence up to the first empty slot is searched before a free slot is
+ * claimed, the first tombstone if there is one, so a key is not claimed twice.
+ *
+ * @param[out] claimed Set if a free slot was claimed, may be null.
+ * @return The slot, nullptr if the key is absent or the probe sequence is full.
+ */
+template <typename Slot, size_t Count>
+Slot* findSlot(Slot (&slots)[Count], uint64_t key, bool claim, bool* claimed = nullptr) {
+    while (true) {
+        Slot* free = nullptr;
+        uint64_t freeKey = 0;
+        for (size_t probe = 0; probe < kMaxProbes; ++probe) {
+            Slot& slot = slots[(key + probe) & (Count - 1)];
+            const uint64_t current = slot.key.load(std::memory_order_acquire);
+            if (current == key) {
+                return &slot;
+            }
+            if ((current == 0 || current == kTombstone) && !free) {
+                free = &slot;
+                freeKey = current;
+            }
+            if (current == 0) {
+                break;
+            }
+        }
+        if (!claim || !free) {
+            return nullptr;
+        }
+        if (free->key.compare_exchange_strong(freeKey, key, std::memory_order_acq_rel)) {
+            if (claimed) {
+                *claimed = true;
+            }
+            return free;
+        }
+        // Another producer took the slot, possibly for the same key: search again
+    }
+}
+
+/**
+ * @brief Writes one report, formatted as before the reporter existed.
+ */
+void writeReport(Severity severity, const std::string& module, const std::string& message, const std::shared_ptr<ILogger>& logger) {
     if (logger) {
         switch (severity) {
-            case ErrorSeverity::INFO:
+            case Severity::INFO:
                 logger->info("[INFO] [" + module + "] " + message);
                 break;
-            case ErrorSeverity::WARNING:
+            case Severity::WARNING:
                 logger->warn("[WARNING] [" + module + "] " + message);
                 break;
-            case ErrorSeverity::ERROR:
+            case Severity::ERROR:
                 logger->error("[ERROR] [" + module + "] " + message);
                 break;
-            case ErrorSeverity::CRITICAL:
+            case Severity::CRITICAL:
                 logger->critical("[CRITICAL] [" + module + "] " + message);
-                std::terminate(); // Optionally terminate the program for safety-critical systems
                 break;
         }
     } else {
         switch (severity) {
-            case ErrorSeverity::INFO:
+            case Severity::INFO:
                 std::cout << "[INFO] [" << module << "] " << message << std::endl;
                 break;
-            case ErrorSeverity::WARNING:
+            case Severity::WARNING:
                 std::cerr << "[WARNING] [" << module << "] " << message << std::endl;
                 break;
-            case ErrorSeverity::ERROR:
+            case Severity::ERROR:
                 std::cerr << "[ERROR] [" << module << "] " << message << std::endl;
                 break;
-            case ErrorSeverity::CRITICAL:
+            case Severity::CRITICAL:
                 std::cerr << "[CRITICAL] [" << module << "] " << message << std::endl;
-                // For critical errors, additional actions might be taken
-                std::terminate(); // Optionally terminate the program for safety-critical systems
                 break;
         }
     }
 }
+
+/**
+ * @brief Background thread writing the queued reports and the repeat summaries.
+ *
+ * Producers use a bounded multi-producer queue with a sequence number per slot; the
+ * consumer side is guarded by consumerMutex_, so flush() can drain from another thread.
+ */
+class Reporter {
+public:
+    Reporter() : slots_(new Slot[kQueueCapacity]), origins_(new Origin[kDedupSlots]) {
+        for (size_t i = 0; i < kQueueCapacity; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        thread_ = std::thread(&Reporter::run, this);
+    }
+
+    ~Reporter() {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    /**
+     * @brief Queues a report, without locking.
+     *
+     * @return False if the queue is full.
+     */
+    bool push(Severity severity, uint64_t key, size_t index, const std::string& module, const std::string& message,
+              const std::shared_ptr<ILogger>& logger) {
+        size_t position = enqueuePosition_.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots_[position & (kQueueCapacity - 1)];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                position = enqueuePosition_.load(std::memory_order_relaxed);
+            }
+        }
+        slot->severity = severity;
+        slot->key = key;
+        slot->index = index;
+        slot->module = module;
+        slot->message = message;
+        slot->logger = logger;
+        slot->sequence.store(position + 1, std::memory_order_release);
+        // Pairs with the fence in run(): either the reporter sees the report or we see it sleeping
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping_.load(std::memory_order_relaxed)) {
+            // Only taken while the reporter is idle, so never contended during a storm
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+            wake_.notify_one();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Writes every queued report and the pending repeat counts on the calling thread.
+     */
+    void flush() {
+        ProfiledLockGuard lock(consumerMutex_);
+        drain();
+        summarize(false);
+    }
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        Severity severity = Severity::INFO;
+        uint64_t key = 0;
+        size_t index = 0;
+        std::string module;
+        std::string message;
+        std::shared_ptr<ILogger> logger;
+    };
+
+    // First occurrence of a deduplicated report, for its summaries
+    struct Origin {
+        Severity severity = Severity::INFO;
+        std::string module;
+        std::string message;
+        std::shared_ptr<ILogger> logger;
+        uint64_t key = 0;  // Report key, 0 if the dedup slot holds no origin
+    };
+
+    /**
+     * @brief Writes the queued reports. Requires consumerMutex_.
+     */
+    void drain() {
+        while (true) {
+            const size_t position = dequeuePosition_.load(std::memory_order_relaxed);
+            Slot& slot = slots_[position & (kQueueCapacity - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+                break;
+            }
+            Origin origin{slot.severity, std::move(slot.module), std::move(slot.message), std::move(slot.logger), slot.key};
+            const size_t index = slot.index;
+            slot.module.clear();
+            slot.message.clear();
+            slot.sequence.store(position + kQueueCapacity, std::memory_order_release);
+            dequeuePosition_.store(position + 1, std::memory_order_relaxed);
+
+            writeReport(origin.severity, origin.module, origin.message, origin.logger);
+            if (origin.key != 0) {
+                origins_[index] = std::move(origin);
+            }
+        }
+        const uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped != droppedReported_) {
+            std::cerr << "[WARNING] [ErrorHandler] " << dropped - droppedReported_ << " reports dropped, queue full" << std::endl;
+            droppedReported_ = dropped;
+        }
+    }
+
+    /**
+     * @brief Writes the pending repeat counts. Requires consumerMutex_.
+     *
+     * @param intervalEnded True at the end of a summary interval, which also frees idle dedup
+     *        slots; false for a flush, whose counts cover only part of an interval.
+     */
+    void summarize(bool intervalEnded) {
+        for (size_t i = 0; i < kDedupSlots; ++i) {
+            DedupSlot& slot = dedupSlots[i];
+            const uint64_t key = slot.key.load(std::memory_order_acquire);
+            if (key == 0 || key == kTombstone) {
+                continue;
+            }
+            const uint64_t count = slot.count.exchange(0, std::memory_order_acq_rel);
+            if (count == 0) {
+                if (intervalEnded && ++idleIntervals_[i] >= kIdleIntervalsBeforeEviction) {
+                    // A tombstone rather than 0, so keys further along the probe sequence stay
+                    // reachable. A producer racing with the eviction at worst miscounts one summary
+                    slot.key.store(kTombstone, std::memory_order_release);
+                    origins_[i] = Origin{};
+                    idleIntervals_[i] = 0;
+                }
+                continue;
+            }
+            idleIntervals_[i] = 0;
+            if (count > 1 && origins_[i].key == key) {
+                const Origin& origin = origins_[i];
+                std::string summary = origin.message + " (repeated " + std::to_string(count - 1) + " more times";
+                if (intervalEnded) {
+                    summary += " in the last " + std::to_string(kSummaryInterval.count()) + " ms";
+                }
+                writeReport(origin.severity, origin.module, summary + ")", origin.logger);
+            }
+        }
+    }
+
+    void run() {
+        ThreadName::set("vbus-errors");
+        auto nextSummary = std::chrono::steady_clock::now() + kSummaryInterval;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex_);
+                sleeping_.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (!stopping_ && !pending()) {
+                    wake_.wait_until(lock, nextSummary);
+                }
+                sleeping_.store(false, std::memory_order_relaxed);
+            }
+            ProfiledLockGuard lock(consumerMutex_);
+            drain();
+            if (stopping()) {
+                summarize(false);
+                return;
+            }
+            if (std::chrono::steady_clock::now() >= nextSummary) {
+                summarize(true);
+                nextSummary = std::chrono::steady_clock::now() + kSummaryInterval;
+            }
+        }
+    }
+
+    bool pending() const {
+        const size_t position = dequeuePosition_.load(std::memory_order_relaxed);
+        return slots_[position & (kQueueCapacity - 1)].sequence.load(std::memory_order_acquire) == position + 1;
+    }
+
+    bool stopping() {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        return stopping_;
+    }
+
+    std::unique_ptr<Slot[]> slots_;                    // Queue slots
+    std::atomic<size_t> enqueuePosition_{0};           // Next position claimed by a producer
+    std::atomic<size_t> dequeuePosition_{0};           // Next position read, advanced under consumerMutex_
+    ProfiledMutex consumerMutex_{"ErrorHandler::reporter"};
+    std::unique_ptr<Origin[]> origins_;                // First occurrences by dedup slot, guarded by consumerMutex_
+    int idleIntervals_[kDedupSlots] = {};              // Intervals without occurrences, guarded by consumerMutex_
+    std::atomic<uint64_t> dropped_{0};                 // Reports lost to a full queue
+    uint64_t droppedReported_ = 0;                     // Drops already written
+    std::mutex wakeMutex_;                             // Guards stopping_ and the waits
+    std::condition_variable wake_;                     // Wakes the reporter thread
+    std::atomic<bool> sleeping_{false};                // Set while the reporter may be waiting
+    bool stopping_ = false;                            // Set to stop the reporter thread
+    std::thread thread_;                               // Reporter thread
+};
+
+Reporter& reporter() {
+    static Reporter instance;
+    return instance;
+}
+
+} // namespace
+
+void ErrorHandler::setFlightRecorder(std::shared_ptr<FlightRecorder> recorder) {
+    ProfiledLockGuard lock(mutex_);
+    recorder_.store(recorder.get(), std::memory_order_release);
+    if (recorder) {
+        recorders_.push_back(std::move(recorder));
+    }
+}
+
+void ErrorHandler::handleError(const std::string& module, const std::string& message, ErrorSeverity severity, std::shared_ptr<ILogger> logger) {
+    const uint64_t key = moduleKey(module);
+    ModuleSlot* counters = findSlot(moduleSlots, key, true);
+    (counters ? counters : &overflowModules)->counts[static_cast<size_t>(severity)].fetch_add(1, std::memory_order_relaxed);
+
+    if (FlightRecorder* recorder = recorder_.load(std::memory_order_acquire)) {
+        recorder->recordError(static_cast<uint16_t>(severity), module, message);
+    }
+
+    if (severity == ErrorSeverity::CRITICAL) {
+        // Everything reported before goes out first, then the critical report itself
+        reporter().flush();
+        writeReport(severity, module, message, logger);
+        std::terminate(); // Optionally terminate the program for safety-critical systems
+    }
+
+    // Only the first occurrence per summary interval is queued, repeats are counted
+    const uint64_t dedupKey = reportKey(key, severity, message);
+    bool claimed = false;
+    DedupSlot* dedup = findSlot(dedupSlots, dedupKey, true, &claimed);
+    if (claimed) {
+        // Overwrites a stray increment left by a producer racing with the eviction
+        dedup->count.store(1, std::memory_order_release);
+    } else if (dedup && dedup->count.fetch_add(1, std::memory_order_acq_rel) != 0) {
+        return;
+    }
+    reporter().push(severity, dedup ? dedupKey : 0, dedup ? static_cast<size_t>(dedup - dedupSlots) : 0, module, message, logger);
+}
+
+void ErrorHandler::flush() {
+    reporter().flush();
+}
+
+uint64_t ErrorHandler::errorCount(const std::string& module, ErrorSeverity severity) {
+    const ModuleSlot* counters = findSlot(moduleSlots, moduleKey(module), false);
+    return counters ? counters->counts[static_cast<size_t>(severity)].load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t ErrorHandler::dropped() {
+    return reporter().dropped();
+}
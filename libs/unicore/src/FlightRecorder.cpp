@@ -0,0 +1,251 @@
+#include "FlightRecorder.h"
+#include "ErrorHandler.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace FlightRecorderFormat;
+
+namespace {
+
+std::atomic<uint64_t>& atomicRef(uint64_t& value) {
+    return *reinterpret_cast<std::atomic<uint64_t>*>(&value);
+}
+
+} // namespace
+
+/**
+ * @brief Constructor for FlightRecorder that creates and maps the ring file.
+ *
+ * @param[in] path File backing the ring.
+ * @param[in] capacity Number of entries kept.
+ * @param[in] codec Codec used to encode bus messages.
+ * @param[in] logger A shared pointer to a logger instance for logging messages.
+ */
+FlightRecorder::FlightRecorder(const std::string& path, size_t capacity,
+                               std::shared_ptr<IBusMessageCodec> codec, std::shared_ptr<ILogger> logger)
+    : codec_(std::move(codec)), logger_(logger) {
+    size_t slots = 1;
+    while (slots < std::max<size_t>(capacity, 2)) {
+        slots <<= 1;
+    }
+    mappingSize_ = sizeof(FileHeader) + slots * sizeof(Slot);
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0 || ::ftruncate(fd, static_cast<off_t>(mappingSize_)) != 0) {
+        ErrorHandler::handleError("FlightRecorder", "Cannot create " + path + ": " + std::strerror(errno), ErrorHandler::ErrorSeverity::ERROR, logger_);
+        if (fd >= 0) ::close(fd);
+        return;
+    }
+    void* mapping = ::mmap(nullptr, mappingSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        ErrorHandler::handleError("FlightRecorder", "Cannot map " + path + ": " + std::strerror(errno), ErrorHandler::ErrorSeverity::ERROR, logger_);
+        return;
+    }
+
+    start_ = std::chrono::steady_clock::now();
+    header_ = static_cast<FileHeader*>(mapping);
+    slots_ = reinterpret_cast<Slot*>(static_cast<uint8_t*>(mapping) + sizeof(FileHeader));
+    mask_ = slots - 1;
+
+    // The file is freshly truncated, so all slots already read as empty
+    std::memcpy(header_->magic, kMagic, sizeof(header_->magic));
+    header_->version = kVersion;
+    header_->slotSize = sizeof(Slot);
+    header_->capacity = static_cast<uint32_t>(slots);
+    header_->wallClockNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    header_->steadyClockNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        start_.time_since_epoch()).count());
+    atomicRef(header_->head).store(0, std::memory_order_release);
+
+    if (logger_) {
+        logger_->info("FlightRecorder: Recording last " + std::to_string(slots) + " entries to " + path);
+    }
+}
+
+/**
+ * @brief Destructor that unmaps the file.
+ */
+FlightRecorder::~FlightRecorder() {
+    if (header_) {
+        ::munmap(header_, mappingSize_);
+    }
+}
+
+/**
+ * @brief Returns the steady clock nanoseconds since the recorder was opened.
+ */
+uint64_t FlightRecorder::now() const {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start_).count());
+}
+
+/**
+ * @brief Claims the next slot and clears its sequence.
+ *
+ * @param[out] sequence Claimed sequence number.
+ * @return The claimed slot.
+ */
+Slot* FlightRecorder::claim(uint64_t& sequence) {
+    sequence = atomicRef(header_->head).fetch_add(1, std::memory_order_relaxed);
+    Slot* slot = &slots_[sequence & mask_];
+    atomicRef(slot->sequence).store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return slot;
+}
+
+/**
+ * @brief Publishes a filled slot.
+ *
+ * @param[in] slot The slot to publish.
+ * @param[in] sequence Sequence number of the slot.
+ */
+void FlightRecorder::commit(Slot* slot, uint64_t sequence) {
+    atomicRef(slot->sequence).store(sequence + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Records a published bus message.
+ *
+ * @param[in] senderId The identifier of the sender.
+ * @param[in] message The published message.
+ */
+void FlightRecorder::onPublish(int senderId, const std::shared_ptr<VirtualBusCmd>& message) {
+    if (!header_) {
+        return;
+    }
+    uint64_t sequence;
+    Slot* slot = claim(sequence);
+    slot->timestampNs = now();
+    slot->kind = static_cast<uint16_t>(EntryKind::Message);
+    slot->type = static_cast<uint16_t>(message->getType());
+    slot->senderId = senderId;
+    slot->payloadSize = static_cast<uint16_t>(codec_ ? codec_->encode(*message, slot->payload, kPayloadCapacity) : 0);
+    commit(slot, sequence);
+}
+
+/**
+ * @brief Records a state transition.
+ *
+ * @param[in] text Description of the new state.
+ */
+void FlightRecorder::recordState(const std::string& text) {
+    recordText(EntryKind::State, 0, text);
+}
+
+/**
+ * @brief Records an error report.
+ *
+ * @param[in] severity Numeric ErrorHandler::ErrorSeverity value.
+ * @param[in] text Module and message.
+ */
+void FlightRecorder::recordError(uint16_t severity, const std::string& text) {
+    recordText(EntryKind::Error, severity, text);
+}
+
+/**
+ * @brief Records an error report as "module: message" without building the string.
+ *
+ * @param[in] severity Numeric ErrorHandler::ErrorSeverity value.
+ * @param[in] module Reporting module.
+ * @param[in] message Error message.
+ */
+void FlightRecorder::recordError(uint16_t severity, const std::string& module, const std::string& message) {
+    static const std::string separator = ": ";
+    recordText(EntryKind::Error, severity, module, separator, message);
+}
+
+/**
+ * @brief Records the concatenation of up to three texts, truncated to the slot payload.
+ */
+void FlightRecorder::recordText(EntryKind kind, uint16_t type, const std::string& text, const std::string& separator,
+                                const std::string& rest) {
+    if (!header_) {
+        return;
+    }
+    uint64_t sequence;
+    Slot* slot = claim(sequence);
+    size_t size = 0;
+    for (const std::string* part : {&text, &separator, &rest}) {
+        const size_t length = std::min(part->size(), kPayloadCapacity - size);
+        std::memcpy(slot->payload + size, part->data(), length);
+        size += length;
+    }
+    slot->timestampNs = now();
+    slot->kind = static_cast<uint16_t>(kind);
+    slot->type = type;
+    slot->senderId = -1;
+    slot->payloadSize = static_cast<uint16_t>(size);
+    commit(slot, sequence);
+}
+
+/**
+ * @brief Loads all complete entries ordered by sequence number.
+ *
+ * @param[in] path Flight recorder file.
+ * @param[out] entries Recovered entries, oldest first.
+ * @param[in] logger A shared pointer to a logger instance for logging messages.
+ * @return OK, NOT_FOUND or ERROR.
+ */
+ReturnType FlightRecorderReader::load(const std::string& path, std::vector<Entry>& entries, std::shared_ptr<ILogger> logger) {
+    entries.clear();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (logger) logger->error("FlightRecorderReader: Cannot open " + path);
+        return ReturnType::NOT_FOUND;
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        if (logger) logger->error("FlightRecorderReader: " + path + " is truncated.");
+        return ReturnType::ERROR;
+    }
+    const size_t fileSize = static_cast<size_t>(info.st_size);
+    void* mapping = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        if (logger) logger->error("FlightRecorderReader: Cannot map " + path);
+        return ReturnType::ERROR;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    const uint64_t capacity = header.capacity;
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.slotSize != sizeof(Slot) || capacity == 0 || (capacity & (capacity - 1)) != 0 ||
+        sizeof(FileHeader) + capacity * sizeof(Slot) > fileSize) {
+        ::munmap(mapping, fileSize);
+        if (logger) logger->error("FlightRecorderReader: " + path + " is not a flight recorder file.");
+        return ReturnType::ERROR;
+    }
+
+    const auto* slots = reinterpret_cast<const Slot*>(static_cast<const uint8_t*>(mapping) + sizeof(FileHeader));
+    entries.reserve(static_cast<size_t>(std::min<uint64_t>(header.head, capacity)));
+    for (uint64_t i = 0; i < capacity; ++i) {
+        Slot slot;
+        std::memcpy(&slot, &slots[i], sizeof(slot));
+        // Skip empty slots, slots torn by a crash and stale slots a lapping writer did not finish
+        if (slot.sequence == 0 || ((slot.sequence - 1) & (capacity - 1)) != i || slot.payloadSize > kPayloadCapacity) {
+            continue;
+        }
+        Entry entry;
+        entry.sequence = slot.sequence - 1;
+        entry.wallClockNs = header.wallClockNs + slot.timestampNs;
+        entry.kind = static_cast<EntryKind>(slot.kind);
+        entry.type = slot.type;
+        entry.senderId = slot.senderId;
+        entry.payload.assign(slot.payload, slot.payload + slot.payloadSize);
+        entries.push_back(std::move(entry));
+    }
+    ::munmap(mapping, fileSize);
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.sequence < b.sequence; });
+    return ReturnType::OK;
+}
@@ -0,0 +1,427 @@
+#include "IsoTpReassembler.h"
+#include "ErrorHandler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+constexpr uint8_t kSingleFrame = 0x0;
+constexpr uint8_t kFirstFrame = 0x1;
+constexpr uint8_t kConsecutiveFrame = 0x2;
+constexpr uint8_t kFlowControl = 0x3;
+
+constexpr uint8_t kFlowContinue = 0x0;
+constexpr uint8_t kFlowOverflow = 0x2;
+
+/**
+ * @brief Default flow control identifier mapping, see IsoTpReassembler::setFlowControlIdMapper().
+ */
+uint32_t defaultFlowControlId(uint32_t canId) {
+    if ((canId & CAN_EFF_FLAG) && ((canId >> 16) & 0xFF) == 0xDA) {
+        return (canId & 0xFFFF0000U) | ((canId & 0xFFU) << 8) | ((canId >> 8) & 0xFFU);
+    }
+    return canId - 8;
+}
+
+} // namespace
+
+/**
+ * @brief Constructor for IsoTpReassembler that preallocates sessions, buffers and the wheel.
+ *
+ * @param[in] config Reassembler configuration.
+ * @param[in] sender Callback used to transmit flow control frames.
+ * @param[in] handler Callback receiving completed payloads.
+ * @param[in] logger A shared pointer to a logger instance for logging messages.
+ */
+IsoTpReassembler::IsoTpReassembler(const Config& config, FrameSender sender, MessageHandler handler,
+                                   std::shared_ptr<ILogger> logger)
+    : config_(config), sender_(std::move(sender)), handler_(std::move(handler)),
+      flowControlIdMapper_(defaultFlowControlId), logger_(logger) {
+    config_.maxSessions = std::max<size_t>(config_.maxSessions, 1);
+    config_.poolBuffers = std::max(config_.poolBuffers, config_.maxSessions);
+    config_.maxPayload = std::clamp<size_t>(config_.maxPayload, 8, 4095);
+    if (config_.tick.count() <= 0) {
+        config_.tick = std::chrono::milliseconds(1);
+    }
+
+    pool_ = std::make_shared<IsoTpBufferPool>(config_.poolBuffers, config_.maxPayload);
+
+    sessions_.resize(config_.maxSessions);
+    for (size_t i = 0; i < sessions_.size(); ++i) {
+        sessions_[i].wheelNext = (i + 1 < sessions_.size()) ? static_cast<int32_t>(i + 1) : kNone;
+    }
+    freeSession_ = 0;
+
+    size_t indexSize = 1;
+    while (indexSize < config_.maxSessions * 2) {
+        indexSize <<= 1;
+    }
+    index_.assign(indexSize, kNone);
+    indexMask_ = indexSize - 1;
+
+    timeoutTicks_ = std::max<uint64_t>(1, (config_.timeout.count() + config_.tick.count() - 1) / config_.tick.count());
+    wheel_.assign(timeoutTicks_ + 2, kNone);
+    epoch_ = Clock::now();
+
+    if (logger_) {
+        logger_->info("IsoTpReassembler: Initialized with " + std::to_string(config_.maxSessions) + " sessions and " +
+                      std::to_string(config_.poolBuffers) + " buffers of " + std::to_string(config_.maxPayload) + " bytes.");
+    }
+}
+
+/**
+ * @brief Processes one received CAN frame.
+ *
+ * @param[in] frame The received frame.
+ * @param[in] now Reception time.
+ * @return Result of processing the frame.
+ */
+ReturnType IsoTpReassembler::onFrame(const can_frame& frame, Clock::time_point now) {
+    poll(now);
+
+    if (frame.can_dlc < 1 || frame.can_dlc > 8) {
+        ++stats_.unexpected;
+        return ReturnType::INVALID_ARGUMENT;
+    }
+    const uint32_t canId = frame.can_id;
+    const uint8_t pci = frame.data[0] >> 4;
+
+    switch (pci) {
+        case kSingleFrame: {
+            const size_t length = frame.data[0] & 0x0F;
+            if (length == 0 || length > static_cast<size_t>(frame.can_dlc - 1)) {
+                ++stats_.unexpected;
+                return ReturnType::INVALID_ARGUMENT;
+            }
+            // A single frame terminates a reception in progress from the same sender
+            int32_t existing = findSession(canId);
+            if (existing != kNone) {
+                closeSession(existing);
+            }
+            uint32_t bufferIndex = pool_->acquire();
+            if (bufferIndex == IsoTpBufferPool::kInvalidIndex) {
+                ++stats_.overflows;
+                return ReturnType::BUSY;
+            }
+            IsoTpBuffer buffer(pool_, bufferIndex);
+            std::memcpy(buffer.data(), &frame.data[1], length);
+            buffer.setSize(length);
+            deliver(canId, std::move(buffer));
+            return ReturnType::OK;
+        }
+
+        case kFirstFrame: {
+            if (frame.can_dlc < 8) {
+                ++stats_.unexpected;
+                return ReturnType::INVALID_ARGUMENT;
+            }
+            const size_t length = (static_cast<size_t>(frame.data[0] & 0x0F) << 8) | frame.data[1];
+            if (length < 8) {
+                ++stats_.unexpected;
+                return ReturnType::INVALID_ARGUMENT;
+            }
+            int32_t existing = findSession(canId);
+            if (existing != kNone) {
+                closeSession(existing);
+            }
+            if (length > config_.maxPayload) {
+                ++stats_.overflows;
+                sendFlowControl(canId, kFlowOverflow);
+                return ReturnType::BUSY;
+            }
+            int32_t index = openSession(canId);
+            if (index == kNone) {
+                ++stats_.overflows;
+                sendFlowControl(canId, kFlowOverflow);
+                return ReturnType::BUSY;
+            }
+            uint32_t bufferIndex = pool_->acquire();
+            if (bufferIndex == IsoTpBufferPool::kInvalidIndex) {
+                closeSession(index);
+                ++stats_.overflows;
+                sendFlowControl(canId, kFlowOverflow);
+                return ReturnType::BUSY;
+            }
+            Session& session = sessions_[index];
+            session.buffer = IsoTpBuffer(pool_, bufferIndex);
+            session.expected = length;
+            std::memcpy(session.buffer.data(), &frame.data[2], 6);
+            session.received = 6;
+            session.nextSequence = 1;
+            session.framesInBlock = 0;
+            schedule(index);
+            sendFlowControl(canId, kFlowContinue);
+            return ReturnType::OK;
+        }
+
+        case kConsecutiveFrame: {
+            int32_t index = findSession(canId);
+            if (index == kNone) {
+                ++stats_.unexpected;
+                return ReturnType::NOT_FOUND;
+            }
+            Session& session = sessions_[index];
+            if ((frame.data[0] & 0x0F) != session.nextSequence) {
+                ++stats_.sequenceErrors;
+                closeSession(index);
+                return ReturnType::INVALID_ARGUMENT;
+            }
+            const size_t chunk = std::min<size_t>(7, session.expected - session.received);
+            if (static_cast<size_t>(frame.can_dlc - 1) < chunk) {
+                ++stats_.unexpected;
+                closeSession(index);
+                return ReturnType::INVALID_ARGUMENT;
+            }
+            std::memcpy(session.buffer.data() + session.received, &frame.data[1], chunk);
+            session.received += chunk;
+            session.nextSequence = static_cast<uint8_t>((session.nextSequence + 1) & 0x0F);
+
+            if (session.received == session.expected) {
+                session.buffer.setSize(session.expected);
+                IsoTpBuffer buffer = std::move(session.buffer);
+                closeSession(index);
+                deliver(canId, std::move(buffer));
+                return ReturnType::OK;
+            }
+
+            unschedule(index);
+            schedule(index);
+            if (config_.blockSize != 0 && ++session.framesInBlock == config_.blockSize) {
+                session.framesInBlock = 0;
+                sendFlowControl(canId, kFlowContinue);
+            }
+            return ReturnType::OK;
+        }
+
+        case kFlowControl:
+            // Flow control is addressed to a transmitter, not to the receive engine
+            return ReturnType::OK;
+
+        default:
+            ++stats_.unexpected;
+            return ReturnType::INVALID_ARGUMENT;
+    }
+}
+
+/**
+ * @brief Advances the timeout wheel and expires stalled sessions.
+ *
+ * @param[in] now Current time.
+ */
+void IsoTpReassembler::poll(Clock::time_point now) {
+    const uint64_t target = tickOf(now);
+    if (target <= currentTick_) {
+        return;
+    }
+    // Every slot is visited at most once per call; deadlines are absolute, so skipping whole turns is safe
+    if (target - currentTick_ > wheel_.size()) {
+        currentTick_ = target - wheel_.size();
+    }
+    while (currentTick_ < target) {
+        ++currentTick_;
+        int32_t index = wheel_[currentTick_ % wheel_.size()];
+        while (index != kNone) {
+            int32_t next = sessions_[index].wheelNext;
+            if (sessions_[index].deadlineTick <= currentTick_) {
+                ++stats_.timeouts;
+                if (logger_) {
+                    const uint32_t canId = sessions_[index].canId;
+                    char id[16];
+                    if (canId & CAN_EFF_FLAG) {
+                        std::snprintf(id, sizeof(id), "0x%08X", canId & CAN_EFF_MASK);
+                    } else {
+                        std::snprintf(id, sizeof(id), "0x%03X", canId & CAN_SFF_MASK);
+                    }
+                    logger_->warn(std::string("IsoTpReassembler: Session for CAN ID ") + id + " timed out.");
+                }
+                closeSession(index);
+            }
+            index = next;
+        }
+    }
+}
+
+/**
+ * @brief Returns a snapshot of the reassembler statistics.
+ *
+ * @return Current statistics.
+ */
+IsoTpReassembler::Statistics IsoTpReassembler::getStatistics() const {
+    return stats_;
+}
+
+/**
+ * @brief Computes the hash table slot of a CAN identifier.
+ */
+size_t IsoTpReassembler::hashSlot(uint32_t canId) const {
+    return static_cast<size_t>((canId * 2654435761U) >> 8) & indexMask_;
+}
+
+/**
+ * @brief Looks up the session of a sender.
+ *
+ * @return Session index, or kNone.
+ */
+int32_t IsoTpReassembler::findSession(uint32_t canId) const {
+    size_t slot = hashSlot(canId);
+    while (index_[slot] != kNone) {
+        if (sessions_[index_[slot]].canId == canId) {
+            return index_[slot];
+        }
+        slot = (slot + 1) & indexMask_;
+    }
+    return kNone;
+}
+
+/**
+ * @brief Takes a session from the free list and indexes it by CAN identifier.
+ *
+ * @return Session index, or kNone if all sessions are in use.
+ */
+int32_t IsoTpReassembler::openSession(uint32_t canId) {
+    if (freeSession_ == kNone) {
+        return kNone;
+    }
+    int32_t index = freeSession_;
+    Session& session = sessions_[index];
+    freeSession_ = session.wheelNext;
+    session.canId = canId;
+    session.active = true;
+    session.wheelPrev = kNone;
+    session.wheelNext = kNone;
+
+    size_t slot = hashSlot(canId);
+    while (index_[slot] != kNone) {
+        slot = (slot + 1) & indexMask_;
+    }
+    index_[slot] = index;
+    ++stats_.activeSessions;
+    return index;
+}
+
+/**
+ * @brief Releases a session and its buffer.
+ */
+void IsoTpReassembler::closeSession(int32_t index) {
+    Session& session = sessions_[index];
+    if (!session.active) {
+        return;
+    }
+    unschedule(index);
+    removeFromIndex(session.canId);
+    session.buffer.reset();
+    session.active = false;
+    session.expected = 0;
+    session.received = 0;
+    session.wheelNext = freeSession_;
+    freeSession_ = index;
+    --stats_.activeSessions;
+}
+
+/**
+ * @brief Removes a CAN identifier from the open addressing table using backward shift deletion.
+ */
+void IsoTpReassembler::removeFromIndex(uint32_t canId) {
+    size_t hole = hashSlot(canId);
+    while (index_[hole] != kNone && sessions_[index_[hole]].canId != canId) {
+        hole = (hole + 1) & indexMask_;
+    }
+    if (index_[hole] == kNone) {
+        return;
+    }
+    index_[hole] = kNone;
+    size_t slot = hole;
+    while (true) {
+        slot = (slot + 1) & indexMask_;
+        if (index_[slot] == kNone) {
+            return;
+        }
+        size_t home = hashSlot(sessions_[index_[slot]].canId);
+        // Move the entry into the hole unless its home slot lies cyclically in (hole, slot]
+        bool stays = (hole <= slot) ? (home > hole && home <= slot) : (home > hole || home <= slot);
+        if (!stays) {
+            index_[hole] = index_[slot];
+            index_[slot] = kNone;
+            hole = slot;
+        }
+    }
+}
+
+/**
+ * @brief Converts a time point to a wheel tick.
+ */
+uint64_t IsoTpReassembler::tickOf(Clock::time_point now) const {
+    if (now <= epoch_) {
+        return 0;
+    }
+    return static_cast<uint64_t>((now - epoch_) / config_.tick);
+}
+
+/**
+ * @brief Links a session into the wheel slot of its new deadline.
+ */
+void IsoTpReassembler::schedule(int32_t index) {
+    Session& session = sessions_[index];
+    session.deadlineTick = currentTick_ + timeoutTicks_;
+    size_t slot = session.deadlineTick % wheel_.size();
+    session.wheelPrev = kNone;
+    session.wheelNext = wheel_[slot];
+    if (session.wheelNext != kNone) {
+        sessions_[session.wheelNext].wheelPrev = index;
+    }
+    wheel_[slot] = index;
+}
+
+/**
+ * @brief Unlinks a session from its wheel slot.
+ */
+void IsoTpReassembler::unschedule(int32_t index) {
+    Session& session = sessions_[index];
+    if (session.deadlineTick == 0 && session.wheelPrev == kNone && session.wheelNext == kNone) {
+        return;
+    }
+    size_t slot = session.deadlineTick % wheel_.size();
+    if (session.wheelPrev != kNone) {
+        sessions_[session.wheelPrev].wheelNext = session.wheelNext;
+    } else if (wheel_[slot] == index) {
+        wheel_[slot] = session.wheelNext;
+    }
+    if (session.wheelNext != kNone) {
+        sessions_[session.wheelNext].wheelPrev = session.wheelPrev;
+    }
+    session.wheelPrev = kNone;
+    session.wheelNext = kNone;
+    session.deadlineTick = 0;
+}
+
+/**
+ * @brief Transmits a flow control frame to a sender.
+ */
+void IsoTpReassembler::sendFlowControl(uint32_t canId, uint8_t status) {
+    if (!sender_) {
+        return;
+    }
+    can_frame frame{};
+    frame.can_id = flowControlIdMapper_ ? flowControlIdMapper_(canId) : defaultFlowControlId(canId);
+    frame.can_dlc = 8;
+    std::memset(frame.data, config_.padding, sizeof(frame.data));
+    frame.data[0] = static_cast<uint8_t>((kFlowControl << 4) | status);
+    frame.data[1] = config_.blockSize;
+    frame.data[2] = config_.separationTime;
+    sender_(frame);
+    ++stats_.flowControlSent;
+}
+
+/**
+ * @brief Wraps a completed payload into a command and passes it to the handler.
+ */
+void IsoTpReassembler::deliver(uint32_t canId, IsoTpBuffer&& buffer) {
+    ++stats_.completed;
+    if (!handler_) {
+        return;
+    }
+    // The command is placed in the buffer header, delivering a payload allocates nothing
+    handler_(IsoTpPayloadCmd::create(canId, std::move(buffer), logger_));
+}
@@ -0,0 +1,114 @@
+#include "LatencySignalDump.h"
+#include "ThreadName.h"
+#include "ErrorHandler.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+std::atomic<bool> LatencySignalDump::requested_{false};
+std::atomic<bool> LatencySignalDump::owned_{false};
+
+static_assert(std::atomic<bool>::is_always_lock_free, "The signal handler needs a lock-free flag");
+
+/**
+ * @brief Constructor installing the signal handler and starting the helper thread.
+ *
+ * @param[in] bus The bus whose latency is reported, must outlive this object.
+ * @param[in] signalNumber Signal that triggers a report.
+ * @param[in] logger A shared pointer to a logger instance for logging messages.
+ */
+LatencySignalDump::LatencySignalDump(VirtualBus& bus, int signalNumber, std::shared_ptr<ILogger> logger)
+    : bus_(bus), signalNumber_(signalNumber), logger_(logger) {
+    if (owned_.exchange(true)) {
+        ErrorHandler::handleError("LatencySignalDump", "Another instance already handles the latency signal.",
+                                  ErrorHandler::ErrorSeverity::WARNING, logger_);
+        return;
+    }
+    struct sigaction action{};
+    action.sa_handler = &LatencySignalDump::onSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    if (::sigaction(signalNumber_, &action, &previous_) != 0) {
+        owned_.store(false);
+        ErrorHandler::handleError("LatencySignalDump", "Cannot install handler for signal " + std::to_string(signalNumber_) + ".",
+                                  ErrorHandler::ErrorSeverity::WARNING, logger_);
+        return;
+    }
+    installed_ = true;
+    requested_.store(false);
+    worker_ = std::thread(&LatencySignalDump::run, this);
+}
+
+/**
+ * @brief Destructor restoring the previous signal handler and stopping the thread.
+ */
+LatencySignalDump::~LatencySignalDump() {
+    if (!installed_) {
+        return;
+    }
+    ::sigaction(signalNumber_, &previous_, nullptr);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    worker_.join();
+    owned_.store(false);
+}
+
+/**
+ * @brief Formats latency reports as a table in microseconds.
+ *
+ * @param[in] reports Reports as returned by VirtualBus::getLatencyReports().
+ * @return The table, one line per task and delivery path.
+ */
+std::string LatencySignalDump::format(const std::vector<VirtualBus::LatencyReport>& reports) {
+    std::string text = "VirtualBus latency (us)              count       p50       p99     p99.9       max\n";
+    char line[160];
+    auto addRow = [&](const std::string& task, const char* path, const LatencyHistogram::Snapshot& histogram) {
+        if (histogram.count == 0) {
+            return;
+        }
+        std::snprintf(line, sizeof(line), "  %-16.16s %-12s %10llu %9.1f %9.1f %9.1f %9.1f\n", task.c_str(), path,
+                      static_cast<unsigned long long>(histogram.count), histogram.percentile(0.50) / 1e3,
+                      histogram.percentile(0.99) / 1e3, histogram.percentile(0.999) / 1e3, histogram.max / 1e3);
+        text += line;
+    };
+    for (const auto& report : reports) {
+        addRow(report.name, "queue", report.queueDelay);
+        addRow(report.name, "cb-delay", report.callbackDelay);
+        addRow(report.name, "cb-duration", report.callbackDuration);
+    }
+    return text;
+}
+
+/**
+ * @brief Signal handler raising the report flag.
+ */
+void LatencySignalDump::onSignal(int) {
+    requested_.store(true, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Helper thread loop printing a report for every raised flag.
+ */
+void LatencySignalDump::run() {
+    ThreadName::set("vbus-latdump");
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        // A condition variable cannot be signalled from the handler, so the flag is polled
+        wake_.wait_for(lock, std::chrono::milliseconds(200), [this] { return stopping_; });
+        if (!requested_.exchange(false, std::memory_order_relaxed)) {
+            continue;
+        }
+        lock.unlock();
+        const std::string report = format(bus_.getLatencyReports());
+        if (logger_) {
+            logger_->info(report);
+        } else {
+            std::cout << report << std::flush;
+        }
+        lock.lock();
+    }
+}
@@ -0,0 +1,304 @@
+#include "LockProfiler.h"
+
+#ifdef VBUS_LOCK_PROFILING
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+/**
+ * @brief Struct representing the statistics shared by all mutexes of one name.
+ */
+struct LockStats {
+    const char* name = "";                     ///< Lock name
+    std::atomic<uint64_t> acquisitions{0};     ///< Successful lock() and try_lock() calls
+    std::atomic<uint64_t> contended{0};        ///< Acquisitions that had to wait
+    std::atomic<uint64_t> waitNs{0};           ///< Total waiting time
+    std::atomic<uint64_t> maxWaitNs{0};        ///< Longest wait
+    std::atomic<uint64_t> holdNs{0};           ///< Total hold time
+    std::atomic<uint64_t> maxHoldNs{0};        ///< Longest hold
+    std::atomic<uint64_t> longHolds{0};        ///< Holds above the threshold
+};
+
+/**
+ * @brief Struct representing the statistics of one lock at one call site.
+ */
+struct LockSite {
+    std::atomic<uint64_t> key{0};              ///< Hash of lock, file and line, 0 while free
+    std::atomic<bool> ready{false};            ///< Set once the fields below are written
+    const LockStats* lock = nullptr;           ///< Lock taken at the site
+    const char* file = nullptr;                ///< Source file
+    int line = 0;                              ///< Source line
+    std::atomic<uint64_t> acquisitions{0};     ///< Acquisitions at the site
+    std::atomic<uint64_t> contended{0};        ///< Acquisitions that had to wait
+    std::atomic<uint64_t> waitNs{0};           ///< Total waiting time
+    std::atomic<uint64_t> holdNs{0};           ///< Total hold time
+    std::atomic<uint64_t> maxHoldNs{0};        ///< Longest hold
+    std::atomic<uint64_t> longHolds{0};        ///< Holds above the threshold
+};
+
+namespace {
+
+constexpr size_t kSiteCount = 4096;  ///< Capacity of the call site table
+
+std::atomic<uint64_t> holdThresholdNs{10'000'000};
+
+/**
+ * @brief Lock names, registered once per name and never freed.
+ */
+struct Registry {
+    std::mutex mutex;             ///< Guards locks, deliberately not profiled
+    std::deque<LockStats> locks;  ///< Stable storage of the statistics
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+/**
+ * @brief Lock-free open addressing table of call sites, the last slot collects overflow.
+ */
+LockSite* sites() {
+    static LockSite table[kSiteCount];
+    return table;
+}
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void updateMax(std::atomic<uint64_t>& max, uint64_t value) {
+    uint64_t current = max.load(std::memory_order_relaxed);
+    while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+/**
+ * @brief Finds or inserts the entry of a lock at a call site.
+ */
+LockSite* findSite(const LockStats* lock, const char* file, int line) {
+    uint64_t key = reinterpret_cast<uintptr_t>(lock) * 0x9E3779B97F4A7C15ull;
+    key ^= reinterpret_cast<uintptr_t>(file) + 0x7F4A7C159E3779B9ull + (key << 6) + (key >> 2);
+    key ^= static_cast<uint64_t>(line) * 0xC2B2AE3D27D4EB4Full;
+    key |= 1;  // 0 marks a free slot
+
+    LockSite* table = sites();
+    for (size_t probe = 0; probe < kSiteCount - 1; ++probe) {
+        LockSite& site = table[(key + probe) % (kSiteCount - 1)];
+        uint64_t existing = site.key.load(std::memory_order_acquire);
+        if (existing == 0 && site.key.compare_exchange_strong(existing, key, std::memory_order_acq_rel)) {
+            site.lock = lock;
+            site.file = file;
+            site.line = line;
+            site.ready.store(true, std::memory_order_release);
+            return &site;
+        }
+        if (existing == key) {
+            return &site;
+        }
+    }
+    return &table[kSiteCount - 1];
+}
+
+const char* baseName(const char* path) {
+    const char* slash = std::strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+} // namespace
+
+/**
+ * @brief Constructor for ProfiledMutex.
+ *
+ * @param[in] name Lock name, mutexes with the same name share statistics.
+ */
+ProfiledMutex::ProfiledMutex(const char* name) {
+    Registry& instance = registry();
+    std::lock_guard<std::mutex> lock(instance.mutex);
+    auto it = std::find_if(instance.locks.begin(), instance.locks.end(),
+                           [name](const LockStats& stats) { return std::strcmp(stats.name, name) == 0; });
+    if (it == instance.locks.end()) {
+        instance.locks.emplace_back();
+        instance.locks.back().name = name;
+        stats_ = &instance.locks.back();
+    } else {
+        stats_ = &*it;
+    }
+}
+
+/**
+ * @brief Locks the mutex, timing the wait if it is contended.
+ *
+ * @param[in] file Call site file.
+ * @param[in] line Call site line.
+ */
+void ProfiledMutex::lock(const char* file, int line) {
+    LockSite* site = findSite(stats_, file, line);
+    if (!mutex_.try_lock()) {
+        const uint64_t start = nowNs();
+        mutex_.lock();
+        const uint64_t waited = nowNs() - start;
+        stats_->contended.fetch_add(1, std::memory_order_relaxed);
+        stats_->waitNs.fetch_add(waited, std::memory_order_relaxed);
+        updateMax(stats_->maxWaitNs, waited);
+        site->contended.fetch_add(1, std::memory_order_relaxed);
+        site->waitNs.fetch_add(waited, std::memory_order_relaxed);
+    }
+    stats_->acquisitions.fetch_add(1, std::memory_order_relaxed);
+    site->acquisitions.fetch_add(1, std::memory_order_relaxed);
+    holder_ = site;
+    acquiredNs_ = nowNs();
+}
+
+/**
+ * @brief Locks the mutex if it is free.
+ *
+ * @param[in] file Call site file.
+ * @param[in] line Call site line.
+ * @return True if the mutex was acquired.
+ */
+bool ProfiledMutex::try_lock(const char* file, int line) {
+    if (!mutex_.try_lock()) {
+        return false;
+    }
+    LockSite* site = findSite(stats_, file, line);
+    stats_->acquisitions.fetch_add(1, std::memory_order_relaxed);
+    site->acquisitions.fetch_add(1, std::memory_order_relaxed);
+    holder_ = site;
+    acquiredNs_ = nowNs();
+    return true;
+}
+
+/**
+ * @brief Unlocks the mutex and records the hold time.
+ */
+void ProfiledMutex::unlock() {
+    // Read the holder's fields before another thread can take the lock
+    const uint64_t held = nowNs() - acquiredNs_;
+    LockSite* site = holder_;
+    mutex_.unlock();
+
+    stats_->holdNs.fetch_add(held, std::memory_order_relaxed);
+    updateMax(stats_->maxHoldNs, held);
+    site->holdNs.fetch_add(held, std::memory_order_relaxed);
+    updateMax(site->maxHoldNs, held);
+    if (held > holdThresholdNs.load(std::memory_order_relaxed)) {
+        stats_->longHolds.fetch_add(1, std::memory_order_relaxed);
+        site->longHolds.fetch_add(1, std::memory_order_relaxed);
+        // stdio has its own lock, so this cannot recurse into a profiled mutex
+        std::fprintf(stderr, "[LockProfiler] %s held for %.3f ms at %s:%d\n", stats_->name, static_cast<double>(held) / 1e6,
+                     site->file ? baseName(site->file) : "?", site->line);
+    }
+}
+
+/**
+ * @brief Getter for the build mode.
+ * @return True, the mutexes are instrumented.
+ */
+bool LockProfiler::enabled() {
+    return true;
+}
+
+/**
+ * @brief Sets the hold time above which a hold is counted and printed as a stall.
+ *
+ * @param[in] threshold Hold time threshold.
+ */
+void LockProfiler::setHoldThreshold(std::chrono::nanoseconds threshold) {
+    holdThresholdNs.store(static_cast<uint64_t>(threshold.count()), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Formats the locks and call sites with the most waiting time.
+ *
+ * @param[in] top Number of locks and of call sites to list.
+ * @return The report.
+ */
+std::string LockProfiler::report(size_t top) {
+    std::vector<const LockStats*> locks;
+    {
+        Registry& instance = registry();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        for (const auto& stats : instance.locks) {
+            locks.push_back(&stats);
+        }
+    }
+    std::sort(locks.begin(), locks.end(), [](const LockStats* a, const LockStats* b) { return a->waitNs.load() > b->waitNs.load(); });
+
+    std::string text = "Lock                          acquired  contended   wait ms  max wait us   hold ms  max hold us  stalls\n";
+    char line[256];
+    for (size_t i = 0; i < locks.size() && i < top; ++i) {
+        const LockStats& stats = *locks[i];
+        std::snprintf(line, sizeof(line), "%-28.28s %10llu %10llu %9.3f %12.1f %9.3f %12.1f %7llu\n", stats.name,
+                      static_cast<unsigned long long>(stats.acquisitions.load()), static_cast<unsigned long long>(stats.contended.load()),
+                      stats.waitNs.load() / 1e6, stats.maxWaitNs.load() / 1e3, stats.holdNs.load() / 1e6, stats.maxHoldNs.load() / 1e3,
+                      static_cast<unsigned long long>(stats.longHolds.load()));
+        text += line;
+    }
+
+    std::vector<const LockSite*> busiest;
+    LockSite* table = sites();
+    for (size_t i = 0; i < kSiteCount; ++i) {
+        if (table[i].acquisitions.load(std::memory_order_relaxed) != 0) {
+            busiest.push_back(&table[i]);
+        }
+    }
+    std::sort(busiest.begin(), busiest.end(), [](const LockSite* a, const LockSite* b) { return a->waitNs.load() > b->waitNs.load(); });
+
+    text += "\nCall site                                 lock                          acquired  contended   wait ms   hold ms  stalls\n";
+    for (size_t i = 0; i < busiest.size() && i < top; ++i) {
+        const LockSite& site = *busiest[i];
+        const bool named = site.ready.load(std::memory_order_acquire);
+        std::string where = named ? std::string(baseName(site.file)) + ":" + std::to_string(site.line) : "(other sites)";
+        std::snprintf(line, sizeof(line), "%-41.41s %-28.28s %10llu %10llu %9.3f %9.3f %7llu\n", where.c_str(),
+                      named ? site.lock->name : "", static_cast<unsigned long long>(site.acquisitions.load()),
+                      static_cast<unsigned long long>(site.contended.load()), site.waitNs.load() / 1e6, site.holdNs.load() / 1e6,
+                      static_cast<unsigned long long>(site.longHolds.load()));
+        text += line;
+    }
+    return text;
+}
+
+/**
+ * @brief Clears all recorded statistics, call sites stay registered.
+ */
+void LockProfiler::reset() {
+    {
+        Registry& instance = registry();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        for (auto& stats : instance.locks) {
+            for (auto* counter : {&stats.acquisitions, &stats.contended, &stats.waitNs, &stats.maxWaitNs,
+                                  &stats.holdNs, &stats.maxHoldNs, &stats.longHolds}) {
+                counter->store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+    LockSite* table = sites();
+    for (size_t i = 0; i < kSiteCount; ++i) {
+        for (auto* counter : {&table[i].acquisitions, &table[i].contended, &table[i].waitNs, &table[i].holdNs,
+                              &table[i].maxHoldNs, &table[i].longHolds}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+#else
+
+bool LockProfiler::enabled() {
+    return false;
+}
+
+void LockProfiler::setHoldThreshold(std::chrono::nanoseconds) {}
+
+std::string LockProfiler::report(size_t) {
+    return "Lock profiling is disabled, configure with -DENABLE_LOCK_PROFILING=ON.\n";
+}
+
+void LockProfiler::reset() {}
+
+#endif // VBUS_LOCK_PROFILING
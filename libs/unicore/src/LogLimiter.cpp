@@ -0,0 +1,213 @@
+#include "LogLimiter.h"
+#include "ILogger.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+
+namespace {
+
+/**
+ * @brief Rules of all keys.
+ */
+struct RuleTable {
+    std::mutex mutex;                                 ///< Guards rules
+    std::map<std::string, LogLimiter::Rule> rules;    ///< Rules by key
+};
+
+RuleTable& ruleTable() {
+    static RuleTable table;
+    return table;
+}
+
+std::string trim(const std::string& text) {
+    const size_t first = text.find_first_not_of(" \t");
+    if (first == std::string::npos) {
+        return "";
+    }
+    return text.substr(first, text.find_last_not_of(" \t") - first + 1);
+}
+
+/**
+ * @brief Parses a positive count.
+ *
+ * @param[in] text The count.
+ * @param[out] value The parsed count.
+ * @return True if the text is a positive number.
+ */
+bool parseCount(const std::string& text, uint32_t& value) {
+    char* end = nullptr;
+    const unsigned long parsed = std::strtoul(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || parsed == 0 || parsed > UINT32_MAX) {
+        return false;
+    }
+    value = static_cast<uint32_t>(parsed);
+    return true;
+}
+
+/**
+ * @brief Parses a rule such as "every 10 50/s".
+ *
+ * @param[in] text The rule.
+ * @param[out] rule The parsed rule.
+ * @return True if the rule is valid.
+ */
+bool parseRule(const std::string& text, LogLimiter::Rule& rule) {
+    rule = LogLimiter::Rule{};
+    if (text == "off") {
+        // Explicit, so the key is not throttled by the "*" rule either
+        rule.every = 1;
+        return true;
+    }
+    size_t pos = 0;
+    bool any = false;
+    while (pos < text.size()) {
+        const size_t end = std::min(text.find(' ', pos), text.size());
+        const std::string word = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (word.empty()) {
+            continue;
+        }
+        if (word == "every") {
+            if (pos >= text.size()) {
+                return false;
+            }
+            const size_t next = std::min(text.find(' ', pos), text.size());
+            if (!parseCount(text.substr(pos, next - pos), rule.every)) {
+                return false;
+            }
+            pos = next + 1;
+        } else if (word.size() > 2 && word.compare(word.size() - 2, 2, "/s") == 0) {
+            if (!parseCount(word.substr(0, word.size() - 2), rule.perSecond)) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+        any = true;
+    }
+    return any;
+}
+
+} // namespace
+
+std::atomic<uint32_t> LogLimiter::generation_{1};
+std::atomic<LogLimiter*> LogLimiter::registered_{nullptr};
+
+/**
+ * @brief Sets the rule of a key, "*" for the default rule.
+ *
+ * @param[in] key The key.
+ * @param[in] rule The rule, an all-zero rule removes it.
+ */
+void LogLimiter::setRule(const std::string& key, const Rule& rule) {
+    RuleTable& table = ruleTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    if (rule.every == 0 && rule.perSecond == 0) {
+        table.rules.erase(key);
+    } else {
+        table.rules[key] = rule;
+    }
+    generation_.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * @brief Replaces all rules with a configuration value.
+ *
+ * @param[in] spec The configuration value, empty to remove all rules.
+ * @return False if an entry cannot be parsed; the valid entries are applied.
+ */
+bool LogLimiter::configure(const std::string& spec) {
+    std::map<std::string, Rule> rules;
+    bool valid = true;
+    size_t pos = 0;
+    while (pos <= spec.size()) {
+        const size_t end = std::min(spec.find_first_of(";,", pos), spec.size());
+        const std::string entry = trim(spec.substr(pos, end - pos));
+        pos = end + 1;
+        if (entry.empty()) {
+            continue;
+        }
+        const size_t equals = entry.find('=');
+        Rule rule;
+        if (equals == std::string::npos || trim(entry.substr(0, equals)).empty() || !parseRule(trim(entry.substr(equals + 1)), rule)) {
+            valid = false;
+            continue;
+        }
+        if (rule.every != 0 || rule.perSecond != 0) {
+            rules[trim(entry.substr(0, equals))] = rule;
+        }
+    }
+
+    RuleTable& table = ruleTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    table.rules = std::move(rules);
+    generation_.fetch_add(1, std::memory_order_release);
+    return valid;
+}
+
+/**
+ * @brief Reloads the rule of the call site after the rules changed.
+ *
+ * @param[in] generation Generation of the rules being loaded.
+ */
+void LogLimiter::refresh(uint32_t generation) {
+    Rule rule;
+    {
+        RuleTable& table = ruleTable();
+        std::lock_guard<std::mutex> lock(table.mutex);
+        auto it = table.rules.find(key_);
+        if (it == table.rules.end()) {
+            it = table.rules.find("*");
+        }
+        if (it != table.rules.end()) {
+            rule = it->second;
+        }
+    }
+    every_.store(rule.every, std::memory_order_relaxed);
+    perSecond_.store(rule.perSecond, std::memory_order_relaxed);
+    cachedGeneration_.store(generation, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Adds the call site to the list walked by flushSuppressed(), once.
+ */
+void LogLimiter::link() {
+    if (linked_.exchange(true, std::memory_order_relaxed)) {
+        return;
+    }
+    next_ = registered_.load(std::memory_order_relaxed);
+    while (!registered_.compare_exchange_weak(next_, this, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+/**
+ * @brief Writes the suppressed counts of call sites that went quiet.
+ *
+ * @param[in] logger Logger to write the counts to.
+ * @param[in] quietOnly False to write every pending count, e.g. when the logger stops.
+ */
+void LogLimiter::flushSuppressed(ILogger& logger, bool quietOnly) {
+    for (LogLimiter* site = registered_.load(std::memory_order_acquire); site != nullptr; site = site->next_) {
+        const uint64_t pending = site->suppressed_.load(std::memory_order_relaxed);
+        if (pending == 0 || site->owner_.load(std::memory_order_relaxed) != &logger) {
+            continue;
+        }
+        if (quietOnly && site->flushSeen_.exchange(pending, std::memory_order_relaxed) != pending) {
+            continue;
+        }
+        const uint64_t count = site->suppressed_.exchange(0, std::memory_order_relaxed);
+        site->flushSeen_.store(0, std::memory_order_relaxed);
+        if (count == 0) {
+            continue;
+        }
+        const std::string message = "LogLimiter: " + std::string(site->key_) + " suppressed " + std::to_string(count) + " messages.";
+        // Only debug, info and warn sites are limited, see VBUS_LOG_*_LIMITED
+        switch (static_cast<LogLevel>(site->level_.load(std::memory_order_relaxed))) {
+            case LogLevel::Debug: logger.debug(message); break;
+            case LogLevel::Warn: logger.warn(message); break;
+            default: logger.info(message); break;
+        }
+    }
+}
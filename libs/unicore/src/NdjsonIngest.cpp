@@ -0,0 +1,166 @@
+#include "NdjsonIngest.h"
+#include "ErrorHandler.h"
+
+#include <cstring>
+#include <deque>
+#include <future>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Struct representing the parsed commands of one chunk.
+ */
+struct ChunkResult {
+    std::vector<std::shared_ptr<VirtualBusCmd>> commands;  ///< Accepted commands in file order
+    uint64_t lines = 0;                                    ///< Non-empty lines in the chunk
+    uint64_t rejected = 0;                                 ///< Lines the factory rejected
+};
+
+/**
+ * @brief Parses every line of a chunk.
+ *
+ * @param[in] begin First byte of the chunk.
+ * @param[in] end One past the last byte of the chunk.
+ * @param[in] factory Line parser producing the commands.
+ * @return Parsed commands and line counters.
+ */
+ChunkResult parseChunk(const char* begin, const char* end, const NdjsonIngest::CommandFactory& factory) {
+    ChunkResult chunk;
+    std::string line;
+    while (begin < end) {
+        const char* newline = static_cast<const char*>(std::memchr(begin, '\n', static_cast<size_t>(end - begin)));
+        const char* lineEnd = newline ? newline : end;
+        const char* trimmed = (lineEnd > begin && lineEnd[-1] == '\r') ? lineEnd - 1 : lineEnd;
+        if (trimmed > begin) {
+            line.assign(begin, trimmed);
+            ++chunk.lines;
+            if (auto command = factory(line)) {
+                chunk.commands.push_back(std::move(command));
+            } else {
+                ++chunk.rejected;
+            }
+        }
+        begin = lineEnd + 1;
+    }
+    return chunk;
+}
+
+} // namespace
+
+/**
+ * @brief Constructor for NdjsonIngest.
+ *
+ * @param[in] bus The bus the commands are published on.
+ * @param[in] pool Thread pool the chunks are parsed on.
+ * @param[in] workers Number of pool threads available to the ingest.
+ * @param[in] factory Line parser producing the commands.
+ * @param[in] chunkSize Approximate number of bytes per chunk.
+ * @param[in] logger A shared pointer to a logger instance for logging messages.
+ */
+NdjsonIngest::NdjsonIngest(VirtualBus& bus, ThreadPool& pool, size_t workers, CommandFactory factory,
+                           size_t chunkSize, std::shared_ptr<ILogger> logger)
+    : bus_(bus), pool_(pool), workers_(workers > 0 ? workers : 1), factory_(std::move(factory)),
+      chunkSize_(chunkSize > 0 ? chunkSize : 1), logger_(logger) {}
+
+/**
+ * @brief Ingests one NDJSON file.
+ *
+ * @param[in] path File to read.
+ * @param[in] senderId Sender identifier to publish with.
+ * @param[out] result Ingest statistics.
+ * @return OK, NOT_FOUND, ERROR or INVALID_ARGUMENT.
+ */
+ReturnType NdjsonIngest::ingest(const std::string& path, int senderId, Result& result) {
+    result = Result{};
+    if (!factory_) {
+        return ReturnType::INVALID_ARGUMENT;
+    }
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        ErrorHandler::handleError("NdjsonIngest", "Cannot open " + path, ErrorHandler::ErrorSeverity::ERROR, logger_);
+        return ReturnType::NOT_FOUND;
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        ErrorHandler::handleError("NdjsonIngest", "Cannot stat " + path, ErrorHandler::ErrorSeverity::ERROR, logger_);
+        return ReturnType::ERROR;
+    }
+    const size_t fileSize = static_cast<size_t>(info.st_size);
+    if (fileSize == 0) {
+        ::close(fd);
+        return ReturnType::OK;
+    }
+    void* mapping = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        ErrorHandler::handleError("NdjsonIngest", "Cannot map " + path, ErrorHandler::ErrorSeverity::ERROR, logger_);
+        return ReturnType::ERROR;
+    }
+    ::madvise(mapping, fileSize, MADV_SEQUENTIAL);
+
+    const char* data = static_cast<const char*>(mapping);
+    const char* const fileEnd = data + fileSize;
+    const auto start = std::chrono::steady_clock::now();
+    std::deque<std::future<ChunkResult>> inFlight;
+    ReturnType status = ReturnType::OK;
+
+    // Batches are published strictly in submission order, which is file order
+    auto publishOldest = [&]() {
+        ChunkResult chunk = inFlight.front().get();
+        inFlight.pop_front();
+        result.lines += chunk.lines;
+        result.rejected += chunk.rejected;
+        if (status != ReturnType::OK) {
+            return;
+        }
+        const size_t count = chunk.commands.size();
+        if (bus_.sendMessages(senderId, std::move(chunk.commands)) != ReturnType::OK) {
+            status = ReturnType::ERROR;
+            return;
+        }
+        result.published += count;
+    };
+
+    const char* chunkBegin = data;
+    while (chunkBegin < fileEnd && status == ReturnType::OK) {
+        const char* chunkEnd = fileEnd;
+        if (static_cast<size_t>(fileEnd - chunkBegin) > chunkSize_) {
+            const char* cut = chunkBegin + chunkSize_;
+            const char* newline = static_cast<const char*>(std::memchr(cut, '\n', static_cast<size_t>(fileEnd - cut)));
+            chunkEnd = newline ? newline + 1 : fileEnd;
+        }
+        inFlight.push_back(pool_.enqueue(parseChunk, chunkBegin, chunkEnd, std::cref(factory_)));
+        chunkBegin = chunkEnd;
+
+        if (inFlight.size() >= 2 * workers_) {
+            publishOldest();
+        }
+    }
+    // Workers still read the mapping, drain them before unmapping
+    while (!inFlight.empty()) {
+        publishOldest();
+    }
+    ::munmap(mapping, fileSize);
+
+    result.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    const double seconds = std::chrono::duration<double>(result.elapsed).count();
+    result.commandsPerSecond = seconds > 0.0 ? static_cast<double>(result.published) / seconds : 0.0;
+
+    if (status != ReturnType::OK) {
+        ErrorHandler::handleError("NdjsonIngest", "Bus rejected a batch from " + path, ErrorHandler::ErrorSeverity::ERROR, logger_);
+        return status;
+    }
+    if (logger_) {
+        logger_->info("NdjsonIngest: Published " + std::to_string(result.published) + " of " + std::to_string(result.lines) +
+                      " lines from " + path + ".");
+    }
+    return ReturnType::OK;
+}
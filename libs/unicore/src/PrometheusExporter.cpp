@@ -0,0 +1,185 @@
+#include "PrometheusExporter.h"
+#include "ThreadName.h"
+#include "ErrorHandler.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * @brief Constructor for PrometheusExporter.
+ *
+ * @param[in] metrics Counters to export, must outlive the exporter.
+ * @param[in] logger A shared pointer to a logger instance for logging messages.
+ */
+PrometheusExporter::PrometheusExporter(const BusMetrics& metrics, std::shared_ptr<ILogger> logger)
+    : metrics_(metrics), logger_(logger) {}
+
+/**
+ * @brief Destructor stopping all outputs.
+ */
+PrometheusExporter::~PrometheusExporter() {
+    stop();
+}
+
+/**
+ * @brief Starts rewriting a file with the current metrics.
+ *
+ * @param[in] path Target file, written as path + ".tmp" and renamed.
+ * @param[in] interval Time between two writes.
+ * @return OK, BUSY if the file output already runs, ERROR if the file cannot be written.
+ */
+ReturnType PrometheusExporter::startFile(const std::string& path, std::chrono::milliseconds interval) {
+    if (fileThread_.joinable()) {
+        return ReturnType::BUSY;
+    }
+    filePath_ = path;
+    fileInterval_ = interval;
+    if (!writeFile()) {
+        ErrorHandler::handleError("PrometheusExporter", "Cannot write metrics file " + path + ".", ErrorHandler::ErrorSeverity::WARNING, logger_);
+        return ReturnType::ERROR;
+    }
+    stopping_.store(false);
+    fileThread_ = std::thread(&PrometheusExporter::runFile, this);
+    if (logger_) {
+        logger_->info("PrometheusExporter: Writing metrics to " + path + ".");
+    }
+    return ReturnType::OK;
+}
+
+/**
+ * @brief Starts serving the metrics over HTTP on the loopback interface.
+ *
+ * @param[in] port TCP port, 0 picks a free one.
+ * @return OK, BUSY if the endpoint already runs, ERROR if the socket cannot be bound.
+ */
+ReturnType PrometheusExporter::startHttp(uint16_t port) {
+    if (httpThread_.joinable()) {
+        return ReturnType::BUSY;
+    }
+    listenFd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd_ < 0) {
+        ErrorHandler::handleError("PrometheusExporter", "Cannot create the metrics socket.", ErrorHandler::ErrorSeverity::WARNING, logger_);
+        return ReturnType::ERROR;
+    }
+    const int reuse = 1;
+    ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    socklen_t length = sizeof(address);
+    if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listenFd_, 8) != 0 ||
+        ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        ::close(listenFd_);
+        listenFd_ = -1;
+        ErrorHandler::handleError("PrometheusExporter", "Cannot listen on 127.0.0.1:" + std::to_string(port) + ".",
+                                  ErrorHandler::ErrorSeverity::WARNING, logger_);
+        return ReturnType::ERROR;
+    }
+    httpPort_ = ntohs(address.sin_port);
+    stopping_.store(false);
+    httpThread_ = std::thread(&PrometheusExporter::runHttp, this);
+    if (logger_) {
+        logger_->info("PrometheusExporter: Serving metrics on http://127.0.0.1:" + std::to_string(httpPort_) + "/metrics.");
+    }
+    return ReturnType::OK;
+}
+
+/**
+ * @brief Stops all outputs and writes the file a last time.
+ */
+void PrometheusExporter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_.store(true);
+    }
+    wake_.notify_all();
+    if (fileThread_.joinable()) {
+        fileThread_.join();
+        writeFile();
+    }
+    if (httpThread_.joinable()) {
+        httpThread_.join();
+    }
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        listenFd_ = -1;
+        httpPort_ = 0;
+    }
+}
+
+/**
+ * @brief Writes the current metrics to the file output.
+ * @return True on success.
+ */
+bool PrometheusExporter::writeFile() {
+    // Scrapers must never see a half-written file, hence the rename
+    const std::string temporary = filePath_ + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        file << metrics_.toPrometheus();
+        if (!file) {
+            return false;
+        }
+    }
+    return std::rename(temporary.c_str(), filePath_.c_str()) == 0;
+}
+
+/**
+ * @brief File output loop.
+ */
+void PrometheusExporter::runFile() {
+    ThreadName::set("vbus-prom-file");
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!wake_.wait_for(lock, fileInterval_, [this] { return stopping_.load(); })) {
+        lock.unlock();
+        writeFile();
+        lock.lock();
+    }
+}
+
+/**
+ * @brief HTTP accept loop.
+ */
+void PrometheusExporter::runHttp() {
+    ThreadName::set("vbus-prom-http");
+    pollfd listener{listenFd_, POLLIN, 0};
+    while (!stopping_.load()) {
+        // The timeout bounds how long stop() waits for this thread
+        if (::poll(&listener, 1, 200) <= 0) {
+            continue;
+        }
+        const int client = ::accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) {
+            continue;
+        }
+        // Read the request head; the path is ignored, every request gets the metrics
+        char request[1024];
+        pollfd readable{client, POLLIN, 0};
+        if (::poll(&readable, 1, 1000) > 0) {
+            (void)::recv(client, request, sizeof(request), 0);
+        }
+        const std::string body = metrics_.toPrometheus();
+        std::string response = "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+                               std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+        size_t sent = 0;
+        while (sent < response.size()) {
+            const ssize_t written = ::send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                break;
+            }
+            sent += static_cast<size_t>(written);
+        }
+        ::close(client);
+    }
+}
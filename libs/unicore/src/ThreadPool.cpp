@@ -1,5 +1,8 @@
 /* Updated to match AUTOSAR Adaptive Naming and Commenting Conventions */
 #include "ThreadPool.h"
+#include "Tracer.h"
+#include "ThreadName.h"
+#include "BusProbes.h"
 
 /**
  * @brief Constructor for ThreadPool that initializes worker threads.
@@ -11,11 +14,12 @@ ThreadPool::ThreadPool(size_t numThreads, std::shared_ptr<ILogger> logger)
     : stop_(false), logger_(logger) {
     for (size_t i = 0; i < numThreads; ++i) {
         workers_.emplace_back(
-            [this] {
+            [this, i] {
+                ThreadName::set("vbus-pool-" + std::to_string(i));
                 while (true) {
                     std::function<void()> task;
                     {
-                        std::unique_lock<std::mutex> lock(this->queueMutex_);
+                        ProfiledUniqueLock lock(this->queueMutex_);
                         this->condition_.wait(lock,
                             [this] { return this->stop_ || !this->tasks_.empty(); });
                         if (this->stop_ && this->tasks_.empty())
@@ -23,16 +27,17 @@ ThreadPool::ThreadPool(size_t numThreads, std::shared_ptr<ILogger> logger)
                         task = std::move(this->tasks_.front());
                         this->tasks_.pop();
                     }
-                    if (logger_) {
-                        logger_->info("ThreadPool: Executing task.");
+                    VBUS_LOG_INFO_LIMITED(logger_, "pool.execute", "ThreadPool: Executing task.");
+                    VBUS_PROBE1(pool_task_start, i);
+                    {
+                        TraceScope trace("ThreadPool::task");
+                        task();
                     }
-                    task();
+                    VBUS_PROBE1(pool_task_end, i);
                 }
             }
         );
-        if (logger_) {
-            logger_->info("ThreadPool: Created worker thread " + std::to_string(i));
-        }
+        VBUS_LOG_INFO(logger_, "ThreadPool: Created worker thread {}", i);
     }
 }
 
@@ -41,16 +46,14 @@ ThreadPool::ThreadPool(size_t numThreads, std::shared_ptr<ILogger> logger)
  */
 ThreadPool::~ThreadPool() {
     {
-        std::unique_lock<std::mutex> lock(queueMutex_);
+        ProfiledUniqueLock lock(queueMutex_);
         stop_ = true;
     }
     condition_.notify_all();
     for (std::thread& worker : workers_) {
         if (worker.joinable()) {
             worker.join();
-            if (logger_) {
-                logger_->info("ThreadPool: Worker thread joined.");
-            }
+            VBUS_LOG_INFO(logger_, "ThreadPool: Worker thread joined.");
         }
     }
 }
@@ -0,0 +1,375 @@
+#include "Tracer.h"
+#include "ErrorHandler.h"
+#include "JsonFormat.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+#include <pthread.h>
+#include <unistd.h>
+
+std::atomic<bool> Tracer::active_{false};
+std::atomic<uint64_t> Tracer::nextMessageId_{1};
+
+namespace {
+
+/**
+ * @brief Struct representing one recorded event.
+ */
+struct TraceEvent {
+    const char* name;   ///< Event name, a string literal
+    uint64_t startNs;   ///< Start time
+    uint64_t endNs;     ///< End time, equal to startNs for instantaneous events
+    uint64_t message;   ///< Message id or kNoMessage
+    int task;           ///< Task id or kNoTask
+    char phase;         ///< 'X' slice, 'q' enqueued, 'd' dequeued
+};
+
+/**
+ * @brief Struct representing the events of one thread.
+ *
+ * Only the owning thread appends; the mutex is uncontended except while start() or
+ * writeChromeJson() walk the buffers.
+ */
+struct ThreadBuffer {
+    std::mutex mutex;                ///< Guards the fields below
+    std::vector<TraceEvent> events;  ///< Recorded events
+    std::string name;                ///< Thread name
+    uint64_t dropped = 0;            ///< Events beyond the capacity
+    int tid = 0;                     ///< Thread id in the trace
+};
+
+/**
+ * @brief Buffers of all threads that recorded, kept after the threads exit.
+ */
+struct Registry {
+    std::mutex mutex;                                   ///< Guards buffers
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers; ///< Registered buffers
+    std::atomic<size_t> capacity{1u << 20};             ///< Events kept per thread
+    uint64_t epochNs = 0;                               ///< Time of the last start()
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+thread_local uint64_t currentMessageId = Tracer::kNoMessage;
+thread_local std::string threadName;
+thread_local std::shared_ptr<ThreadBuffer> threadBuffer;
+
+ThreadBuffer& buffer() {
+    if (!threadBuffer) {
+        auto created = std::make_shared<ThreadBuffer>();
+        if (threadName.empty()) {
+            char name[16] = {};
+            pthread_getname_np(pthread_self(), name, sizeof(name));
+            threadName = name;
+        }
+        created->name = threadName;
+        Registry& instance = registry();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        created->tid = static_cast<int>(instance.buffers.size()) + 1;
+        instance.buffers.push_back(created);
+        threadBuffer = std::move(created);
+    }
+    return *threadBuffer;
+}
+
+void record(const TraceEvent& event) {
+    ThreadBuffer& own = buffer();
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (own.events.size() < registry().capacity.load(std::memory_order_relaxed)) {
+        own.events.push_back(event);
+    } else {
+        ++own.dropped;
+    }
+}
+
+/**
+ * @brief Appends a JSON string, escaping quotes, backslashes and control characters.
+ */
+void appendEscaped(std::string& out, const std::string& value) {
+    out += '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+/**
+ * @brief Appends a nanosecond time as trace microseconds.
+ */
+void appendMicros(std::string& out, uint64_t ns) {
+    JsonFormat::appendNumber(out, ns / 1000);
+    char fraction[8];
+    std::snprintf(fraction, sizeof(fraction), ".%03u", static_cast<unsigned>(ns % 1000));
+    out += fraction;
+}
+
+/**
+ * @brief Appends the fields shared by all events of a thread.
+ */
+void appendHead(std::string& out, const char* name, const char* phase, uint64_t timeNs, int pid, int tid) {
+    out += "{\"name\":";
+    JsonFormat::appendString(out, name);
+    out += ",\"cat\":\"vbus\",\"ph\":";
+    JsonFormat::appendString(out, phase);
+    out += ",\"ts\":";
+    appendMicros(out, timeNs);
+    out += ",\"pid\":";
+    JsonFormat::appendNumber(out, pid);
+    out += ",\"tid\":";
+    JsonFormat::appendNumber(out, tid);
+}
+
+/**
+ * @brief Appends the id linking the queued span and flow arrow of a message to one subscriber.
+ */
+void appendDeliveryId(std::string& out, const TraceEvent& event) {
+    char id[40];
+    std::snprintf(id, sizeof(id), ",\"id\":\"0x%llx\"",
+                  static_cast<unsigned long long>((event.message << 16) | (static_cast<unsigned>(event.task) & 0xFFFFu)));
+    out += id;
+}
+
+void appendArgs(std::string& out, const TraceEvent& event) {
+    out += ",\"args\":{";
+    bool first = true;
+    if (event.message != Tracer::kNoMessage) {
+        out += "\"message\":";
+        JsonFormat::appendNumber(out, event.message);
+        first = false;
+    }
+    if (event.task != Tracer::kNoTask) {
+        out += first ? "\"task\":" : ",\"task\":";
+        JsonFormat::appendNumber(out, event.task);
+    }
+    out += "}}";
+}
+
+/**
+ * @brief Appends the Chrome trace events of one recorded event.
+ */
+void appendEvent(std::string& out, const TraceEvent& event, uint64_t epochNs, int pid, int tid) {
+    const uint64_t start = event.startNs > epochNs ? event.startNs - epochNs : 0;
+    switch (event.phase) {
+    case 'X':
+        appendHead(out, event.name, "X", start, pid, tid);
+        out += ",\"dur\":";
+        appendMicros(out, event.endNs > event.startNs ? event.endNs - event.startNs : 0);
+        appendArgs(out, event);
+        break;
+    case 'q':
+        appendHead(out, "queued", "b", start, pid, tid);
+        appendDeliveryId(out, event);
+        appendArgs(out, event);
+        out += ",\n";
+        appendHead(out, "delivery", "s", start, pid, tid);
+        appendDeliveryId(out, event);
+        out += '}';
+        break;
+    default:
+        appendHead(out, "queued", "e", start, pid, tid);
+        appendDeliveryId(out, event);
+        appendArgs(out, event);
+        out += ",\n";
+        // Bind to the enclosing slice, the one that picked the message up
+        appendHead(out, "delivery", "f", start, pid, tid);
+        appendDeliveryId(out, event);
+        out += ",\"bp\":\"e\"}";
+        break;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Clears all buffers and starts recording.
+ *
+ * @param[in] maxEventsPerThread Events kept per thread, later events are counted as dropped.
+ */
+void Tracer::start(size_t maxEventsPerThread) {
+    Registry& instance = registry();
+    std::lock_guard<std::mutex> lock(instance.mutex);
+    for (const auto& threadEvents : instance.buffers) {
+        std::lock_guard<std::mutex> bufferLock(threadEvents->mutex);
+        threadEvents->events.clear();
+        threadEvents->dropped = 0;
+    }
+    instance.capacity.store(maxEventsPerThread, std::memory_order_relaxed);
+    instance.epochNs = nowNs();
+    active_.store(true, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Stops recording, the buffers are kept until the next start().
+ */
+void Tracer::stop() {
+    active_.store(false, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Writes the recorded events in the Chrome trace event format.
+ *
+ * @param[in] path Target file.
+ * @param[in] logger A shared pointer to a logger instance for logging messages.
+ * @return OK, or ERROR if the file cannot be written.
+ */
+ReturnType Tracer::writeChromeJson(const std::string& path, std::shared_ptr<ILogger> logger) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        ErrorHandler::handleError("Tracer", "Cannot open trace file " + path + ".", ErrorHandler::ErrorSeverity::WARNING, logger);
+        return ReturnType::ERROR;
+    }
+
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    uint64_t epochNs = 0;
+    {
+        Registry& instance = registry();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        buffers = instance.buffers;
+        epochNs = instance.epochNs;
+    }
+
+    const int pid = static_cast<int>(::getpid());
+    size_t eventCount = 0;
+    uint64_t dropped = 0;
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":";
+    JsonFormat::appendNumber(out, pid);
+    out += ",\"tid\":0,\"args\":{\"name\":\"vbus\"}}";
+    for (const auto& threadEvents : buffers) {
+        std::vector<TraceEvent> events;
+        std::string name;
+        {
+            // Copy so the owning thread is blocked only briefly
+            std::lock_guard<std::mutex> lock(threadEvents->mutex);
+            events = threadEvents->events;
+            name = threadEvents->name;
+            dropped += threadEvents->dropped;
+        }
+        out += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":";
+        JsonFormat::appendNumber(out, pid);
+        out += ",\"tid\":";
+        JsonFormat::appendNumber(out, threadEvents->tid);
+        out += ",\"args\":{\"name\":";
+        appendEscaped(out, name.empty() ? "thread " + std::to_string(threadEvents->tid) : name);
+        out += "}}";
+        for (const auto& event : events) {
+            out += ",\n";
+            appendEvent(out, event, epochNs, pid, threadEvents->tid);
+        }
+        eventCount += events.size();
+        file << out;
+        out.clear();
+    }
+    out += "\n],\"otherData\":{\"dropped_events\":";
+    JsonFormat::appendNumber(out, dropped);
+    out += "}}\n";
+    file << out;
+    file.close();
+    if (!file) {
+        ErrorHandler::handleError("Tracer", "Cannot write trace file " + path + ".", ErrorHandler::ErrorSeverity::WARNING, logger);
+        return ReturnType::ERROR;
+    }
+    if (logger) {
+        logger->info("Tracer: Wrote " + std::to_string(eventCount) + " events to " + path + ".");
+    }
+    return ReturnType::OK;
+}
+
+/**
+ * @brief Names the calling thread in the trace.
+ *
+ * @param[in] name Thread name shown on the timeline.
+ */
+void Tracer::setThreadName(const std::string& name) {
+    threadName = name;
+    if (threadBuffer) {
+        std::lock_guard<std::mutex> lock(threadBuffer->mutex);
+        threadBuffer->name = name;
+    }
+}
+
+/**
+ * @brief Getter for the message the calling thread is handling.
+ * @return The id set by the innermost TraceScope with a message, or kNoMessage.
+ */
+uint64_t Tracer::currentMessage() {
+    return currentMessageId;
+}
+
+/**
+ * @brief Replaces the message of the calling thread.
+ *
+ * @param[in] messageId New message id.
+ * @return The previous message id.
+ */
+uint64_t Tracer::exchangeCurrentMessage(uint64_t messageId) {
+    const uint64_t previous = currentMessageId;
+    currentMessageId = messageId;
+    return previous;
+}
+
+/**
+ * @brief Monotonic clock used for the timestamps.
+ * @return Nanoseconds since an arbitrary epoch.
+ */
+uint64_t Tracer::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief Records a slice on the calling thread.
+ *
+ * @param[in] name Event name.
+ * @param[in] startNs Start time from nowNs().
+ * @param[in] endNs End time from nowNs().
+ * @param[in] messageId Message the slice handled, or kNoMessage.
+ * @param[in] taskId Task the slice ran for, or kNoTask.
+ */
+void Tracer::complete(const char* name, uint64_t startNs, uint64_t endNs, uint64_t messageId, int taskId) {
+    if (active()) {
+        record(TraceEvent{name, startNs, endNs, messageId, taskId, 'X'});
+    }
+}
+
+/**
+ * @brief Starts the "queued" span and the flow arrow of a message towards a subscriber.
+ *
+ * @param[in] messageId The published message.
+ * @param[in] taskId The subscriber.
+ */
+void Tracer::enqueued(uint64_t messageId, int taskId) {
+    if (active()) {
+        const uint64_t now = nowNs();
+        record(TraceEvent{"queued", now, now, messageId, taskId, 'q'});
+    }
+}
+
+/**
+ * @brief Ends the "queued" span and the flow arrow of a message at its subscriber.
+ *
+ * @param[in] messageId The delivered message.
+ * @param[in] taskId The subscriber.
+ */
+void Tracer::dequeued(uint64_t messageId, int taskId) {
+    if (active()) {
+        const uint64_t now = nowNs();
+        record(TraceEvent{"queued", now, now, messageId, taskId, 'd'});
+    }
+}
@@ -1,6 +1,8 @@
 /* Updated to match AUTOSAR Adaptive Naming and Commenting Conventions */
 #include "VirtualBus.h"
 #include "ErrorHandler.h"
+#include "BusProbes.h"
+#include <algorithm>
 
 /**
  * @brief Constructor for VirtualBus that initializes the bus as running and creates a thread pool.
@@ -9,9 +11,7 @@
  */
 VirtualBus::VirtualBus(std::shared_ptr<ILogger> logger)
     : running_(true), threadPool_(std::thread::hardware_concurrency()), logger_(logger) {
-    if (logger_) {
-        logger_->info("VirtualBus: Initialized with " + std::to_string(std::thread::hardware_concurrency()) + " worker threads.");
-    }
+    VBUS_LOG_INFO(logger_, "VirtualBus: Initialized with {} worker threads.", std::thread::hardware_concurrency());
 }
 
 /**
@@ -19,9 +19,7 @@ VirtualBus::VirtualBus(std::shared_ptr<ILogger> logger)
  */
 VirtualBus::~VirtualBus() {
     shutdown();
-    if (logger_) {
-        logger_->info("VirtualBus: Shut down.");
-    }
+    VBUS_LOG_INFO(logger_, "VirtualBus: Shut down.");
 }
 
 /**
@@ -31,18 +29,16 @@ VirtualBus::~VirtualBus() {
  * @param[in] taskName The name of the task.
  */
 ReturnType VirtualBus::attach(int taskId, const std::string& taskName) {
-    std::lock_guard<std::mutex> lock(busMutex_);
+    ProfiledLockGuard lock(busMutex_);
     if (tasks_.find(taskId) != tasks_.end()) {
-        if (logger_) {
-            logger_->warn("VirtualBus: Task ID " + std::to_string(taskId) + " already exists.");
-        }
+        VBUS_LOG_WARN(logger_, "VirtualBus: Task ID {} already exists.", taskId);
         ErrorHandler::handleError("VirtualBus", "Task ID already exists.", ErrorHandler::ErrorSeverity::WARNING, logger_);
         return ReturnType::INVALID_ARGUMENT;
     }
-    tasks_[taskId] = TaskInfo{taskName, std::queue<std::shared_ptr<VirtualBusCmd>>(), nullptr};
-    if (logger_) {
-        logger_->info("VirtualBus: Task " + taskName + " (ID: " + std::to_string(taskId) + ") attached to the bus.");
-    }
+    tasks_[taskId] = TaskInfo{taskName, std::queue<QueuedMessage>(), nullptr, std::make_shared<TaskLatency>(),
+                              metrics_.addTask(taskId, taskName)};
+    VBUS_PROBE2(attach, taskId, taskName.c_str());
+    VBUS_LOG_INFO(logger_, "VirtualBus: Task {} (ID: {}) attached to the bus.", taskName, taskId);
     return ReturnType::OK;
 }
 
@@ -52,18 +48,20 @@ ReturnType VirtualBus::attach(int taskId, const std::string& taskName) {
  * @param[in] taskId The identifier of the task to be detached.
  */
 void VirtualBus::detach(int taskId) {
-    std::lock_guard<std::mutex> lock(busMutex_);
+    ProfiledLockGuard lock(busMutex_);
     auto it = tasks_.find(taskId);
     if (it != tasks_.end()) {
         std::string taskName = it->second.name;
-        tasks_.erase(it);
-        if (logger_) {
-            logger_->info("VirtualBus: Task " + taskName + " (ID: " + std::to_string(taskId) + ") detached from the bus.");
+        auto& queue = it->second.messageQueue;
+        VBUS_PROBE2(detach, taskId, queue.size());
+        for (; !queue.empty(); queue.pop()) {
+            metrics_.recordDrop(it->second.metrics.get(), *queue.front().message);
         }
+        metrics_.removeTask(taskId);
+        tasks_.erase(it);
+        VBUS_LOG_INFO(logger_, "VirtualBus: Task {} (ID: {}) detached from the bus.", taskName, taskId);
     } else {
-        if (logger_) {
-            logger_->warn("VirtualBus: Attempted to detach non-existent task ID " + std::to_string(taskId));
-        }
+        VBUS_LOG_WARN(logger_, "VirtualBus: Attempted to detach non-existent task ID {}", taskId);
     }
 }
 
@@ -74,17 +72,13 @@ void VirtualBus::detach(int taskId) {
  * @param[in] callback The callback function to be registered.
  */
 void VirtualBus::registerCallback(int taskId, CallbackFunction callback) {
-    std::lock_guard<std::mutex> lock(busMutex_);
+    ProfiledLockGuard lock(busMutex_);
     auto it = tasks_.find(taskId);
     if (it != tasks_.end()) {
         it->second.callback = callback;
-        if (logger_) {
-            logger_->info("VirtualBus: Callback registered for task ID " + std::to_string(taskId));
-        }
+        VBUS_LOG_INFO(logger_, "VirtualBus: Callback registered for task ID {}", taskId);
     } else {
-        if (logger_) {
-            logger_->warn("VirtualBus: Attempted to register callback for non-existent task ID " + std::to_string(taskId));
-        }
+        VBUS_LOG_WARN(logger_, "VirtualBus: Attempted to register callback for non-existent task ID {}", taskId);
     }
 }
 
@@ -95,32 +89,50 @@ void VirtualBus::registerCallback(int taskId, CallbackFunction callback) {
  * @param[in] message The message to be sent.
  */
 void VirtualBus::sendMessage(int senderId, const std::shared_ptr<VirtualBusCmd>& message) {
+    if (!message) {
+        ErrorHandler::handleError("VirtualBus", "Task ID " + std::to_string(senderId) + " sent an empty message.", ErrorHandler::ErrorSeverity::WARNING, logger_);
+        return;
+    }
+    const uint64_t publishedNs = LatencyHistogram::nowNs();
+    const uint64_t traceId = Tracer::active() ? Tracer::nextMessageId() : Tracer::kNoMessage;
     std::vector<std::function<void()>> callbacksToInvoke;
 
     {
-        std::lock_guard<std::mutex> lock(busMutex_);
+        ProfiledLockGuard lock(busMutex_);
         auto senderIt = tasks_.find(senderId);
-        std::string senderName = (senderIt != tasks_.end()) ? senderIt->second.name : "Unknown";
 
-        if (logger_) {
-            logger_->info("VirtualBus: Task " + senderName + " (ID: " + std::to_string(senderId) + ") is sending a message.");
-        }
+        VBUS_LOG_INFO_LIMITED(logger_, "bus.send", "VirtualBus: Task {} (ID: {}) is sending a message.",
+                              senderIt != tasks_.end() ? senderIt->second.name.c_str() : "Unknown", senderId);
 
         if (senderIt == tasks_.end()) {
+            metrics_.recordDrop(nullptr, *message);
             ErrorHandler::handleError("VirtualBus", "Sender task ID " + std::to_string(senderId) + " not found.", ErrorHandler::ErrorSeverity::WARNING, logger_);
             return;
         }
+        metrics_.recordPublish(*senderIt->second.metrics, *message);
+        VBUS_PROBE3(publish, senderId, static_cast<int>(message->getType()), message.get());
+
+        for (const auto& observer : observers_) {
+            observer->onPublish(senderId, message);
+        }
 
         for (auto& [taskId, taskInfo] : tasks_) {
             if (taskId != senderId) {
-                taskInfo.messageQueue.push(message);
+                taskInfo.messageQueue.push(QueuedMessage{message, publishedNs, traceId});
+                taskInfo.metrics->setQueueDepth(taskInfo.messageQueue.size());
+                VBUS_PROBE3(enqueue, taskId, message.get(), taskInfo.messageQueue.size());
+                if (traceId != Tracer::kNoMessage) {
+                    Tracer::enqueued(traceId, taskId);
+                }
 
                 // Collect callbacks to invoke
                 if (taskInfo.callback) {
                     auto callback = taskInfo.callback;
                     auto msg = message;
-                    callbacksToInvoke.push_back([callback, msg]() {
-                        callback(msg);
+                    auto latency = taskInfo.latency;
+                    auto counters = taskInfo.metrics;
+                    callbacksToInvoke.push_back([this, callback, msg, latency, counters, publishedNs, traceId]() {
+                        invokeTimed(callback, *latency, *counters, publishedNs, traceId, msg);
                     });
                 }
             }
@@ -133,6 +145,92 @@ void VirtualBus::sendMessage(int senderId, const std::shared_ptr<VirtualBusCmd>&
     for (auto& func : callbacksToInvoke) {
         threadPool_.enqueue(func);
     }
+    if (traceId != Tracer::kNoMessage) {
+        Tracer::complete("VirtualBus::sendMessage", publishedNs, Tracer::nowNs(), traceId, senderId);
+    }
+}
+
+/**
+ * @brief Sends a batch of messages from a sender in order.
+ *
+ * @param[in] senderId The identifier of the sender.
+ * @param[in] messages The messages to be sent, null entries are skipped.
+ * @return OK, or NOT_FOUND if the sender is not attached.
+ */
+ReturnType VirtualBus::sendMessages(int senderId, std::vector<std::shared_ptr<VirtualBusCmd>> messages) {
+    if (messages.empty()) {
+        return ReturnType::OK;
+    }
+    const uint64_t publishedNs = LatencyHistogram::nowNs();
+    const size_t count = messages.size();
+    // Message i of the batch is traced as firstTraceId + i
+    const uint64_t firstTraceId = Tracer::active() ? Tracer::nextMessageId(count) : Tracer::kNoMessage;
+    auto batch = std::make_shared<const std::vector<std::shared_ptr<VirtualBusCmd>>>(std::move(messages));
+    std::vector<std::function<void()>> callbacks;
+
+    {
+        ProfiledLockGuard lock(busMutex_);
+        auto senderIt = tasks_.find(senderId);
+        if (senderIt == tasks_.end()) {
+            for (const auto& message : *batch) {
+                if (message) {
+                    metrics_.recordDrop(nullptr, *message);
+                }
+            }
+            ErrorHandler::handleError("VirtualBus", "Sender task ID " + std::to_string(senderId) + " not found.", ErrorHandler::ErrorSeverity::WARNING, logger_);
+            return ReturnType::NOT_FOUND;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            const auto& message = (*batch)[i];
+            if (!message) {
+                continue;
+            }
+            const uint64_t traceId = firstTraceId == Tracer::kNoMessage ? Tracer::kNoMessage : firstTraceId + i;
+            metrics_.recordPublish(*senderIt->second.metrics, *message);
+            VBUS_PROBE3(publish, senderId, static_cast<int>(message->getType()), message.get());
+            for (const auto& observer : observers_) {
+                observer->onPublish(senderId, message);
+            }
+            for (auto& [taskId, taskInfo] : tasks_) {
+                if (taskId != senderId) {
+                    taskInfo.messageQueue.push(QueuedMessage{message, publishedNs, traceId});
+                    VBUS_PROBE3(enqueue, taskId, message.get(), taskInfo.messageQueue.size());
+                    if (traceId != Tracer::kNoMessage) {
+                        Tracer::enqueued(traceId, taskId);
+                    }
+                }
+            }
+        }
+        for (auto& [taskId, taskInfo] : tasks_) {
+            if (taskId == senderId) {
+                continue;
+            }
+            taskInfo.metrics->setQueueDepth(taskInfo.messageQueue.size());
+            if (taskInfo.callback) {
+                callbacks.push_back([this, callback = taskInfo.callback, latency = taskInfo.latency,
+                                     counters = taskInfo.metrics, batch, publishedNs, firstTraceId]() {
+                    for (size_t i = 0; i < batch->size(); ++i) {
+                        if ((*batch)[i]) {
+                            const uint64_t traceId = firstTraceId == Tracer::kNoMessage ? Tracer::kNoMessage : firstTraceId + i;
+                            invokeTimed(callback, *latency, *counters, publishedNs, traceId, (*batch)[i]);
+                        }
+                    }
+                });
+            }
+        }
+    }
+
+    busConditionVariable_.notify_all();
+
+    for (auto& callback : callbacks) {
+        threadPool_.enqueue(std::move(callback));
+    }
+    if (firstTraceId != Tracer::kNoMessage) {
+        Tracer::complete("VirtualBus::sendMessages", publishedNs, Tracer::nowNs(), firstTraceId, senderId);
+    }
+    VBUS_LOG_INFO_LIMITED(logger_, "bus.send_batch", "VirtualBus: Task ID {} sent a batch of {} messages.", senderId, count);
+    return ReturnType::OK;
 }
 
 /**
@@ -143,12 +241,11 @@ void VirtualBus::sendMessage(int senderId, const std::shared_ptr<VirtualBusCmd>&
  * @return True if a message is received, otherwise false.
  */
 bool VirtualBus::receiveMessage(int taskId, std::shared_ptr<VirtualBusCmd>& message) {
-    std::unique_lock<std::mutex> lock(busMutex_);
+    const uint64_t enteredNs = Tracer::active() ? Tracer::nowNs() : 0;
+    ProfiledUniqueLock lock(busMutex_);
     auto it = tasks_.find(taskId);
     if (it == tasks_.end()) {
-        if (logger_) {
-            logger_->warn("VirtualBus: Task ID " + std::to_string(taskId) + " not found.");
-        }
+        VBUS_LOG_WARN(logger_, "VirtualBus: Task ID {} not found.", taskId);
         return false; // Task not found
     }
 
@@ -158,34 +255,194 @@ bool VirtualBus::receiveMessage(int taskId, std::shared_ptr<VirtualBusCmd>& mess
     busConditionVariable_.wait(lock, [&queue, this] { return !queue.empty() || !running_; });
 
     if (!running_) {
-        if (logger_) {
-            logger_->info("VirtualBus: Bus is no longer running.");
-        }
+        VBUS_LOG_INFO(logger_, "VirtualBus: Bus is no longer running.");
         return false;
     }
 
     if (!queue.empty()) {
-        message = queue.front();
-        queue.pop();
-        if (logger_) {
-            logger_->info("VirtualBus: Message received for task ID " + std::to_string(taskId));
-        }
+        popMessage(taskId, taskInfo, message, enteredNs);
         return true;
     }
     return false;
 }
 
 /**
- * @brief Shuts down the virtual bus.
+ * @brief Receives a message for a specific task, waiting at most the given time.
+ *
+ * @param[in] taskId The identifier of the task.
+ * @param[out] message The message received by the task.
+ * @param[in] timeout Maximum time to wait for a message.
+ * @return True if a message is received, otherwise false.
+ */
+bool VirtualBus::receiveMessage(int taskId, std::shared_ptr<VirtualBusCmd>& message, std::chrono::milliseconds timeout) {
+    const uint64_t enteredNs = Tracer::active() ? Tracer::nowNs() : 0;
+    ProfiledUniqueLock lock(busMutex_);
+    // The task is looked up on every wakeup, it may be attached or detached while waiting
+    auto it = tasks_.end();
+    busConditionVariable_.wait_for(lock, timeout, [&it, taskId, this] {
+        it = tasks_.find(taskId);
+        return !running_ || (it != tasks_.end() && !it->second.messageQueue.empty());
+    });
+
+    if (!running_ || it == tasks_.end() || it->second.messageQueue.empty()) {
+        return false;
+    }
+    popMessage(taskId, it->second, message, enteredNs);
+    return true;
+}
+
+/**
+ * @brief Takes the oldest message from the queue of a task.
+ *
+ * @param[in] taskId The identifier of the task.
+ * @param[in] taskInfo The task, its queue must not be empty.
+ * @param[out] message The message received by the task.
+ * @param[in] enteredNs Tracer time the receive call started, 0 if not tracing.
+ */
+void VirtualBus::popMessage(int taskId, TaskInfo& taskInfo, std::shared_ptr<VirtualBusCmd>& message, uint64_t enteredNs) {
+    auto& queue = taskInfo.messageQueue;
+    message = std::move(queue.front().message);
+    taskInfo.latency->queueDelay.recordSince(queue.front().publishedNs);
+    VBUS_PROBE3(dequeue, taskId, message.get(), queue.front().publishedNs);
+    const uint64_t traceId = queue.front().traceId;
+    queue.pop();
+    if (traceId != Tracer::kNoMessage) {
+        // The slice spans the wait, so a late pickup shows which side was slow
+        const uint64_t dequeuedNs = Tracer::nowNs();
+        Tracer::dequeued(traceId, taskId);
+        Tracer::complete("VirtualBus::receiveMessage", enteredNs != 0 ? enteredNs : dequeuedNs, Tracer::nowNs(), traceId, taskId);
+    }
+    metrics_.recordDelivery(*taskInfo.metrics, *message);
+    taskInfo.metrics->setQueueDepth(queue.size());
+    VBUS_LOG_INFO_LIMITED(logger_, "bus.receive", "VirtualBus: Message received for task ID {}", taskId);
+}
+
+/**
+ * @brief Shuts down the virtual bus, later calls do nothing.
  */
 void VirtualBus::shutdown() {
     {
-        std::lock_guard<std::mutex> lock(busMutex_);
-        running_ = false;
+        ProfiledLockGuard lock(busMutex_);
+        if (!running_.exchange(false)) {
+            return;
+        }
     }
     busConditionVariable_.notify_all();
-    if (logger_) {
-        logger_->info("VirtualBus: Shutting down.");
-    }
+    VBUS_LOG_INFO(logger_, "VirtualBus: Shutting down.");
     ErrorHandler::handleError("VirtualBus", "Bus is shutting down.", ErrorHandler::ErrorSeverity::INFO, logger_);
 }
+
+/**
+ * @brief Adds an observer that sees every published message.
+ *
+ * @param[in] observer The observer to add.
+ */
+void VirtualBus::addObserver(std::shared_ptr<IBusObserver> observer) {
+    if (!observer) {
+        return;
+    }
+    ProfiledLockGuard lock(busMutex_);
+    observers_.push_back(std::move(observer));
+}
+
+/**
+ * @brief Removes a previously added observer.
+ *
+ * @param[in] observer The observer to remove.
+ */
+void VirtualBus::removeObserver(const std::shared_ptr<IBusObserver>& observer) {
+    ProfiledLockGuard lock(busMutex_);
+    observers_.erase(std::remove(observers_.begin(), observers_.end(), observer), observers_.end());
+}
+
+/**
+ * @brief Copies the delivery latency histograms of one task.
+ *
+ * @param[in] taskId The identifier of the task.
+ * @param[out] report Latency of the task.
+ * @return OK, or NOT_FOUND if the task is not attached.
+ */
+ReturnType VirtualBus::getLatency(int taskId, LatencyReport& report) {
+    std::shared_ptr<TaskLatency> latency;
+    {
+        ProfiledLockGuard lock(busMutex_);
+        auto it = tasks_.find(taskId);
+        if (it == tasks_.end()) {
+            return ReturnType::NOT_FOUND;
+        }
+        report.name = it->second.name;
+        latency = it->second.latency;
+    }
+    report.taskId = taskId;
+    latency->queueDelay.snapshot(report.queueDelay);
+    latency->callbackDelay.snapshot(report.callbackDelay);
+    latency->callbackDuration.snapshot(report.callbackDuration);
+    return ReturnType::OK;
+}
+
+/**
+ * @brief Copies the delivery latency histograms of all attached tasks.
+ *
+ * @return One report per task, ordered by task identifier.
+ */
+std::vector<VirtualBus::LatencyReport> VirtualBus::getLatencyReports() {
+    std::vector<std::pair<int, std::shared_ptr<TaskLatency>>> latencies;
+    std::vector<LatencyReport> reports;
+    {
+        ProfiledLockGuard lock(busMutex_);
+        for (const auto& [taskId, taskInfo] : tasks_) {
+            latencies.emplace_back(taskId, taskInfo.latency);
+            reports.emplace_back();
+            reports.back().taskId = taskId;
+            reports.back().name = taskInfo.name;
+        }
+    }
+    // Copy the counters outside the bus lock, publishers keep recording meanwhile
+    for (size_t i = 0; i < reports.size(); ++i) {
+        latencies[i].second->queueDelay.snapshot(reports[i].queueDelay);
+        latencies[i].second->callbackDelay.snapshot(reports[i].callbackDelay);
+        latencies[i].second->callbackDuration.snapshot(reports[i].callbackDuration);
+    }
+    std::sort(reports.begin(), reports.end(), [](const LatencyReport& a, const LatencyReport& b) { return a.taskId < b.taskId; });
+    return reports;
+}
+
+/**
+ * @brief Clears the latency histograms of all attached tasks.
+ */
+void VirtualBus::resetLatency() {
+    ProfiledLockGuard lock(busMutex_);
+    for (auto& [taskId, taskInfo] : tasks_) {
+        taskInfo.latency->queueDelay.reset();
+        taskInfo.latency->callbackDelay.reset();
+        taskInfo.latency->callbackDuration.reset();
+    }
+}
+
+/**
+ * @brief Runs a subscriber callback and records its start delay, duration and the delivery.
+ *
+ * @param[in] callback The callback function of the subscriber.
+ * @param[in] latency Histograms of the subscriber.
+ * @param[in] counters Message counters of the subscriber.
+ * @param[in] publishedNs Monotonic publish time in nanoseconds.
+ * @param[in] traceId Tracer message id of the message.
+ * @param[in] message The message to deliver.
+ */
+void VirtualBus::invokeTimed(const CallbackFunction& callback, TaskLatency& latency, BusMetrics::TaskCounters& counters,
+                             uint64_t publishedNs, uint64_t traceId, const std::shared_ptr<VirtualBusCmd>& message) {
+    TraceScope trace("VirtualBus::callback", counters.taskId, traceId);
+    if (traceId != Tracer::kNoMessage) {
+        Tracer::dequeued(traceId, counters.taskId);
+    }
+    metrics_.recordDelivery(counters, *message);
+    const uint64_t startNs = LatencyHistogram::nowNs();
+    const uint64_t delayNs = startNs > publishedNs ? startNs - publishedNs : 0;
+    latency.callbackDelay.record(delayNs);
+    VBUS_PROBE3(callback_begin, counters.taskId, message.get(), delayNs);
+    callback(message);
+    const uint64_t endNs = LatencyHistogram::nowNs();
+    const uint64_t durationNs = endNs > startNs ? endNs - startNs : 0;
+    latency.callbackDuration.record(durationNs);
+    VBUS_PROBE3(callback_end, counters.taskId, message.get(), durationNs);
+}
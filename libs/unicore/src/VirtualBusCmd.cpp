@@ -1,27 +1,47 @@
 
 #include "JsonCmdParser.h"
+#include "CommandParserRegistry.h"
+#include "ErrorHandler.h"
+#include "LogFormat.h"
 
+#include <algorithm>
+
+namespace {
+
+constexpr size_t kExcerptBefore = 16;   ///< Bytes of the payload quoted before a syntax error
+constexpr size_t kExcerptSize = 64;     ///< Longest payload excerpt quoted in a syntax error
+
+} // namespace
 
 bool VirtualBusCmd::parse(const std::string& parameters) {
-        //return parser_ ? parser_->parseParameters(*this, parameters) : false;
+        ParseError error;
+        ReturnType result = tryParse(parameters, error);
+        if (result == ReturnType::OK) {
+            VBUS_LOG_INFO_LIMITED(logger_, "cmd.parse", "VirtualBusCmd: Parsing completed.");
+            return true;
+        }
 
-        if (!parser_) {
-            if (logger_) {
-                logger_->error("VirtualBusCmd: No parser set.");
-            }
-            return false;
+        std::string reason;
+        if (result == ReturnType::NOT_FOUND) {
+            reason = "No parser registered for command type " + std::to_string(static_cast<int>(type_)) + ".";
+        } else if (result == ReturnType::ERROR) {
+            // Payloads can be large, only the bytes around the error are quoted
+            const size_t at = std::min(error.position, parameters.size());
+            const size_t start = at - std::min(at, kExcerptBefore);
+            const size_t size = std::min(kExcerptSize, parameters.size() - start);
+            reason = "JSON syntax error at byte " + std::to_string(error.position) + " near: " +
+                     (start > 0 ? "..." : "") + parameters.substr(start, size) + (start + size < parameters.size() ? "..." : "");
+        } else {
+            reason = std::string("Invalid value for '") + error.field + "'.";
         }
-        try {
-            // Assuming parser has a parse method that returns a bool
-            bool result = parser_->parseParameters(*this,parameters);
-            if (logger_) {
-                logger_->info("VirtualBusCmd: Parsing completed with result: " + std::to_string(result));
-            }
-            return result;
-        } catch (const std::exception& e) {
-            if (logger_) {
-                logger_->error("VirtualBusCmd: Parsing error: " + std::string(e.what()));
-            }
-            return false;
+        ErrorHandler::handleError("VirtualBusCmd", reason, ErrorHandler::ErrorSeverity::WARNING, logger_);
+        return false;
+    }
+
+ReturnType VirtualBusCmd::tryParse(const std::string& parameters, ParseError& error) {
+        JsonCmdParser* parser = CommandParserRegistry::find(type_);
+        if (!parser) {
+            return ReturnType::NOT_FOUND;
         }
+        return parser->parseParameters(*this, parameters, error);
     }
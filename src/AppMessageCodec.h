@@ -0,0 +1,65 @@
+#ifndef APP_MESSAGE_CODEC_H
+#define APP_MESSAGE_CODEC_H
+
+#include <memory>
+
+#include "IBusMessageCodec.h"
+#include "CommandWireFormat.h"
+#include "LazyCommand.h"
+
+/**
+ * @brief Class adapting the application wire format to the core codec interface.
+ *
+ * Journals and recorders store the command type themselves, so only the bare payload
+ * from CommandWire is written. Command types without a binary encoding are recorded
+ * without payload and cannot be decoded.
+ *
+ * In lazy mode decode() only checks the payload size and returns LazyCommand instances,
+ * so replayed traffic that nobody inspects is never decoded.
+ */
+class AppMessageCodec : public IBusMessageCodec {
+public:
+    /**
+     * @brief Constructor for AppMessageCodec.
+     *
+     * @param[in] lazy True to decode payloads on first field access instead of eagerly.
+     */
+    explicit AppMessageCodec(bool lazy = false) : lazy_(lazy) {}
+
+    /**
+     * @brief Encodes the payload of a command.
+     *
+     * @param[in] command The command to encode.
+     * @param[out] buffer Destination buffer.
+     * @param[in] capacity Size of the destination buffer.
+     * @return Number of bytes written, 0 for unsupported types.
+     */
+    size_t encode(const VirtualBusCmd& command, uint8_t* buffer, size_t capacity) const override {
+        return CommandWire::encodePayload(command, buffer, capacity);
+    }
+
+    /**
+     * @brief Decodes a payload produced by encode().
+     *
+     * @param[in] type Command type of the payload.
+     * @param[in] buffer Encoded payload.
+     * @param[in] size Size of the payload.
+     * @return The decoded command, or nullptr for unsupported types and short payloads.
+     */
+    std::shared_ptr<VirtualBusCmd> decode(CommandType type, const uint8_t* buffer, size_t size) const override {
+        if (lazy_) {
+            if (type == CommandType::Inverter) {
+                return LazyCommand<InverterCommand>::fromBinary(buffer, size);
+            }
+            if (type == CommandType::Battery) {
+                return LazyCommand<BatteryStateCmd>::fromBinary(buffer, size);
+            }
+        }
+        return CommandWire::decodePayload(type, buffer, size);
+    }
+
+private:
+    bool lazy_;  ///< Decode on first field access
+};
+
+#endif // APP_MESSAGE_CODEC_H
@@ -0,0 +1,13 @@
+#include "BatteryCommand.h"
+#include "CommandParserRegistry.h"
+#include "CommandWireFormat.h"
+#include <memory>
+
+ReturnType BatteryStateCmd::registerParser(std::shared_ptr<ILogger> logger) {
+    // The parser is generated together with BatteryStateCmdBase
+    return CommandParserRegistry::registerParser(CommandType::Battery, std::make_unique<BatteryCommandParser>(logger), logger);
+}
+
+size_t BatteryStateCmd::payloadSize() const {
+    return CommandWire::payloadSize(getType());
+}
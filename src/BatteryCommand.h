@@ -2,166 +2,144 @@
 #ifndef BATTERY_COMMAND_H
 #define BATTERY_COMMAND_H
 
-#include "VirtualBusCmd.h"
+#include "BatteryStateCmdBase.h"
 #include "nlohmann/json.hpp"
-#include "BatteryCommandParser.h"
 #include "ILogger.h"
-#include <limits>
+#include "ReturnType.h"
 #include <memory>
 #include <string>
 
 /**
  * @brief Class representing a battery state command.
+ *
+ * Fields, range validation, the JSON parser and serializer are generated from
+ * schema/commands.json into BatteryStateCmdBase; the getters here add the plausibility
+ * limits, which serializeJson() applies like toJson().
  */
-class BatteryStateCmd : public VirtualBusCmd {
-private:
-    uint8_t numberOfCubes = 0;
-    uint8_t numberOfReadyCubes = 0;
-    uint16_t voltageMinimum = std::numeric_limits<uint16_t>::max();
-    uint16_t voltageMaximum = std::numeric_limits<uint16_t>::min();
-    int16_t voltageMean = 0;
-    uint16_t socMaximum = std::numeric_limits<uint16_t>::min();
-    uint16_t socMinimum = std::numeric_limits<uint16_t>::max();
-    uint32_t socMean = 0;
-    int32_t currentSum = 0;
-    int32_t currentMean = 0;
-    int32_t currentMinimum = std::numeric_limits<int32_t>::max();
-    int32_t currentMaximum = std::numeric_limits<int32_t>::min();
-    int16_t temperatureMinimum = std::numeric_limits<int16_t>::max();
-    int16_t temperatureMaximum = std::numeric_limits<int16_t>::min();
-    std::shared_ptr<ILogger> logger_; ///< Logger instance for logging messages
-
+class BatteryStateCmd : public BatteryStateCmdBase {
 public:
     /**
-     * @brief Constructor initializing command type as Server.
+     * @brief Constructor initializing command type as Battery.
      *
      * @param[in] logger A shared pointer to a logger instance for logging messages.
      */
-    BatteryStateCmd(std::shared_ptr<ILogger> logger = nullptr) : VirtualBusCmd(), logger_(logger) {
-        type = CommandType::Server;
-    }
+    BatteryStateCmd(std::shared_ptr<ILogger> logger = nullptr) : BatteryStateCmdBase(logger) {}
+
+    /**
+     * @brief Registers the shared parser for the battery state command, called once at startup.
+     *
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     * @return Result of CommandParserRegistry::registerParser().
+     */
+    static ReturnType registerParser(std::shared_ptr<ILogger> logger = nullptr);
 
     /**
-     * @brief Initializes the parser for the battery state command.
+     * @brief Getter for the payload size, counted by the bus metrics.
+     * @return Size of the binary wire payload in bytes.
      */
-    void initializeParser() {
-        setParser(std::make_shared<BatteryCommandParser>());
-        if (logger_) logger_->info("BatteryStateCmd: Parser initialized.");
-    }
+    size_t payloadSize() const override;
 
     /**
      * @brief Getter for the number of battery cubes.
      * @return Number of battery cubes.
      */
-    uint8_t getNumberOfCubes() const { return numberOfCubes; }
+    uint8_t getNumberOfCubes() const { return numberOfCubes(); }
 
     /**
      * @brief Getter for the number of ready battery cubes.
      * @return Number of ready battery cubes.
      */
-    uint8_t getNumberOfReadyCubes() const { return (numberOfReadyCubes == 0) ? 0 : numberOfReadyCubes; }
+    uint8_t getNumberOfReadyCubes() const { return (numberOfReadyCubes() == 0) ? 0 : numberOfReadyCubes(); }
 
     /**
      * @brief Getter for the minimum voltage.
      * @return Minimum voltage.
      */
-    uint16_t getVoltageMinimum() const { return (voltageMinimum < 48000) ? 48000 : voltageMinimum; }
+    uint16_t getVoltageMinimum() const override { return (voltageMinimum() < 48000) ? 48000 : voltageMinimum(); }
 
     /**
      * @brief Getter for the maximum voltage.
      * @return Maximum voltage.
      */
-    uint16_t getVoltageMaximum() const { return (voltageMaximum > 57000) ? 57000 : voltageMaximum; }
+    uint16_t getVoltageMaximum() const override { return (voltageMaximum() > 57000) ? 57000 : voltageMaximum(); }
 
     /**
      * @brief Getter for the mean voltage.
      * @return Mean voltage.
      */
-    uint16_t getVoltageMean() const { return voltageMaximum + voltageMinimum / 2; }
+    uint16_t getVoltageMean() const { return voltageMaximum() + voltageMinimum() / 2; }
 
     /**
      * @brief Getter for the minimum state of charge (SOC).
      * @return Minimum SOC.
      */
-    uint16_t getSOCMinimum() const {
-        if (socMinimum > 10000) return 10000;
-        if (socMinimum < 50) return 300;
-        return socMinimum;
+    uint16_t getSOCMinimum() const override {
+        if (socMinimum() > 10000) return 10000;
+        if (socMinimum() < 50) return 300;
+        return socMinimum();
     }
 
     /**
      * @brief Getter for the maximum state of charge (SOC).
      * @return Maximum SOC.
      */
-    uint16_t getSOCMaximum() const {
-        if (socMaximum > 10000) return 10000;
-        if (socMaximum < 50) return 300;
-        return socMaximum;
+    uint16_t getSOCMaximum() const override {
+        if (socMaximum() > 10000) return 10000;
+        if (socMaximum() < 50) return 300;
+        return socMaximum();
     }
 
     /**
      * @brief Getter for the mean state of charge (SOC).
      * @return Mean SOC.
      */
-    uint16_t getSOCMean() const {
-        if (socMean > 10000) return 10000;
-        if (socMean < 50) return 300;
-        return socMean;
+    uint32_t getSOCMean() const override {
+        if (socMean() > 10000) return 10000;
+        if (socMean() < 50) return 300;
+        return socMean();
     }
 
     /**
      * @brief Getter for the minimum current.
      * @return Minimum current.
      */
-    int32_t getCurrentMinimum() const { return currentMinimum; }
+    int32_t getCurrentMinimum() const { return currentMinimum(); }
 
     /**
      * @brief Getter for the maximum current.
      * @return Maximum current.
      */
-    int32_t getCurrentMaximum() const { return currentMaximum; }
+    int32_t getCurrentMaximum() const { return currentMaximum(); }
 
     /**
      * @brief Getter for the mean current.
      * @return Mean current.
      */
-    int32_t getCurrentMean() const { return currentMean; }
+    int32_t getCurrentMean() const { return currentMean(); }
 
     /**
      * @brief Getter for the current sum.
      * @return Sum of current.
      */
-    int32_t getCurrentSum() const { return currentSum; }
+    int32_t getCurrentSum() const { return currentSum(); }
 
     /**
      * @brief Getter for the maximum temperature.
      * @return Maximum temperature.
      */
-    uint16_t getTemperatureMaximum() const { return temperatureMaximum; }
+    uint16_t getTemperatureMaximum() const { return temperatureMaximum(); }
 
     /**
      * @brief Getter for the minimum temperature.
      * @return Minimum temperature.
      */
-    uint16_t getTemperatureMinimum() const { return temperatureMinimum; }
+    uint16_t getTemperatureMinimum() const { return temperatureMinimum(); }
 
     /**
      * @brief Resets all statistics to initial values.
      */
     void resetStatistics() {
-        numberOfCubes = 0;
-        numberOfReadyCubes = 0;
-        voltageMinimum = std::numeric_limits<uint16_t>::max();
-        voltageMaximum = std::numeric_limits<uint16_t>::min();
-        socMaximum = std::numeric_limits<uint16_t>::min();
-        socMinimum = std::numeric_limits<uint16_t>::max();
-        socMean = 0;
-        currentSum = 0;
-        currentMean = 0;
-        currentMinimum = std::numeric_limits<int32_t>::max();
-        currentMaximum = std::numeric_limits<int32_t>::min();
-        temperatureMinimum = std::numeric_limits<int16_t>::max();
-        temperatureMaximum = std::numeric_limits<int16_t>::min();
+        resetFields();
         if (logger_) logger_->info("BatteryStateCmd: Statistics reset to initial values.");
     }
 
@@ -172,12 +150,12 @@ public:
     nlohmann::json toJson() const {
         nlohmann::json jsonRepresentation;
 
-        jsonRepresentation["Cube_Num"] = numberOfCubes;
-        jsonRepresentation["Cube_OP"] = numberOfReadyCubes;
+        jsonRepresentation["Cube_Num"] = numberOfCubes();
+        jsonRepresentation["Cube_OP"] = numberOfReadyCubes();
         jsonRepresentation["Current"] = {
-            {"AVG", currentMean},
-            {"MAX", currentMaximum},
-            {"MIN", currentMinimum}
+            {"AVG", currentMean()},
+            {"MAX", currentMaximum()},
+            {"MIN", currentMinimum()}
         };
         jsonRepresentation["DATE"] = "22222";
         jsonRepresentation["Device_id"] = "82475923";
@@ -187,7 +165,7 @@ public:
             {"MIN", getSOCMinimum()}
         };
         jsonRepresentation["Voltage"] = {
-            {"AVG", voltageMean},
+            {"AVG", voltageMean()},
             {"MAX", getVoltageMaximum()},
             {"MIN", getVoltageMinimum()}
         };
@@ -199,7 +177,7 @@ public:
      * @brief Prints the battery state in JSON format.
      */
     void print() const override {
-        print_base();
+        printBase();
         if (logger_) logger_->info("BatteryStateCmd: Printing battery state as JSON.");
         std::cout << toJson().dump(4) << std::endl; // Pretty print with 4 spaces indentation
     }
@@ -0,0 +1,91 @@
+#ifndef CAN_TRANSMIT_TASK_H
+#define CAN_TRANSMIT_TASK_H
+
+#include "Task.h"
+#include "CanTxQueue.h"
+#include "InverterCommand.h"
+#include "InverterCanEncoder.h"
+#include "ILogger.h"
+#include "ErrorHandler.h"
+#include <chrono>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Class representing a task that forwards inverter setpoints from the virtual bus to CAN.
+ *
+ * Every InverterCommand seen on the bus is encoded and submitted to a CanTxQueue, which
+ * orders outgoing frames by priority and keeps only the newest unsent setpoint. The task
+ * thread takes the messages from its bus queue, so the queue does not grow while it runs.
+ */
+class CanTransmitTask : public Task {
+private:
+    std::shared_ptr<ILogger> logger_; ///< Logger instance for logging messages
+
+public:
+    /**
+     * @brief Constructor for CanTransmitTask.
+     *
+     * @param[in] name The name of the task.
+     * @param[in] bus The virtual bus reference.
+     * @param[in] txQueue Transmit queue receiving the encoded frames.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     */
+    CanTransmitTask(const std::string& name, VirtualBus& bus, CanTxQueue& txQueue, std::shared_ptr<ILogger> logger = nullptr)
+        : Task(name, bus, logger), logger_(logger), txQueue_(txQueue) {}
+
+    /**
+     * @brief Starts the transmit queue and the task.
+     */
+    void start() override {
+        txQueue_.start();
+        if (logger_) {
+            logger_->info("CanTransmitTask: Task started.");
+        }
+        Task::start();
+    }
+
+    /**
+     * @brief Stops the task and flushes pending frames.
+     */
+    void stop() override {
+        Task::stop();
+        txQueue_.flush(std::chrono::milliseconds(100));
+    }
+
+protected:
+    /**
+     * @brief Main logic of the CanTransmitTask that forwards every message of its bus queue.
+     */
+    void run() override {
+        std::shared_ptr<VirtualBusCmd> cmd;
+        while (running_) {
+            // The timeout bounds how long stop() waits for the thread
+            if (bus_.receiveMessage(id_, cmd, std::chrono::milliseconds(100))) {
+                onMessageReceived(cmd);
+            }
+        }
+    }
+
+    /**
+     * @brief Encodes an inverter command and submits it for transmission.
+     *
+     * @param[in] cmd Shared pointer to the received command.
+     */
+    void onMessageReceived(const std::shared_ptr<VirtualBusCmd>& cmd) {
+        if (!running_) return;
+
+        auto inverterCmd = std::dynamic_pointer_cast<InverterCommand>(cmd);
+        if (!inverterCmd) {
+            return;
+        }
+        if (txQueue_.submit(InverterCanEncoder::encode(*inverterCmd)) != ReturnType::OK) {
+            ErrorHandler::handleError("CanTransmitTask", "Transmit queue full, setpoint dropped.", ErrorHandler::ErrorSeverity::WARNING, logger_);
+        }
+    }
+
+private:
+    CanTxQueue& txQueue_; ///< Transmit queue for encoded frames
+};
+
+#endif // CAN_TRANSMIT_TASK_H
@@ -0,0 +1,275 @@
+#ifndef COMMAND_WIRE_FORMAT_H
+#define COMMAND_WIRE_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "WireFormat.h"
+#include "InverterCommand.h"
+#include "BatteryCommand.h"
+
+/**
+ * @brief Zero-copy view of an encoded InverterCommand payload.
+ *
+ * Layout (17 bytes): mode u8, voltage f64, current f64.
+ */
+class InverterCommandView {
+public:
+    static constexpr size_t kSize = 17;
+
+    InverterCommandView() = default;
+
+    /**
+     * @brief Creates a view after checking the payload size and mode.
+     *
+     * @param[in] payload Encoded payload, must outlive the view.
+     * @param[in] size Payload size.
+     * @param[out] view The view.
+     * @return OK, or INVALID_ARGUMENT for a short payload or an unknown mode.
+     */
+    static ReturnType from(const uint8_t* payload, size_t size, InverterCommandView& view) {
+        if (size < kSize || payload[0] > static_cast<uint8_t>(InverterCommand::Mode::Discharging)) {
+            return ReturnType::INVALID_ARGUMENT;
+        }
+        view.data_ = payload;
+        return ReturnType::OK;
+    }
+
+    InverterCommand::Mode mode() const { return static_cast<InverterCommand::Mode>(data_[0]); }
+    double voltage() const { return WireFormat::load<double>(data_ + 1); }
+    double current() const { return WireFormat::load<double>(data_ + 9); }
+
+private:
+    const uint8_t* data_ = nullptr;  ///< Start of the payload
+};
+
+/**
+ * @brief Zero-copy view of an encoded BatteryStateCmd payload.
+ *
+ * Accessors return the raw statistics as sent, without the clamping applied by the
+ * BatteryStateCmd getters. Layout (36 bytes): cubes u8, ready cubes u8, voltage min/max
+ * u16, voltage mean i16, SOC min/max u16, SOC mean u32, current sum/mean/min/max i32,
+ * temperature min/max i16.
+ */
+class BatteryStateView {
+public:
+    static constexpr size_t kSize = 36;
+
+    BatteryStateView() = default;
+
+    /**
+     * @brief Creates a view after checking the payload size.
+     *
+     * @param[in] payload Encoded payload, must outlive the view.
+     * @param[in] size Payload size.
+     * @param[out] view The view.
+     * @return OK, or INVALID_ARGUMENT for a short payload.
+     */
+    static ReturnType from(const uint8_t* payload, size_t size, BatteryStateView& view) {
+        if (size < kSize) {
+            return ReturnType::INVALID_ARGUMENT;
+        }
+        view.data_ = payload;
+        return ReturnType::OK;
+    }
+
+    uint8_t numberOfCubes() const { return data_[0]; }
+    uint8_t numberOfReadyCubes() const { return data_[1]; }
+    uint16_t voltageMinimum() const { return WireFormat::load<uint16_t>(data_ + 2); }
+    uint16_t voltageMaximum() const { return WireFormat::load<uint16_t>(data_ + 4); }
+    int16_t voltageMean() const { return WireFormat::load<int16_t>(data_ + 6); }
+    uint16_t socMinimum() const { return WireFormat::load<uint16_t>(data_ + 8); }
+    uint16_t socMaximum() const { return WireFormat::load<uint16_t>(data_ + 10); }
+    uint32_t socMean() const { return WireFormat::load<uint32_t>(data_ + 12); }
+    int32_t currentSum() const { return WireFormat::load<int32_t>(data_ + 16); }
+    int32_t currentMean() const { return WireFormat::load<int32_t>(data_ + 20); }
+    int32_t currentMinimum() const { return WireFormat::load<int32_t>(data_ + 24); }
+    int32_t currentMaximum() const { return WireFormat::load<int32_t>(data_ + 28); }
+    int16_t temperatureMinimum() const { return WireFormat::load<int16_t>(data_ + 32); }
+    int16_t temperatureMaximum() const { return WireFormat::load<int16_t>(data_ + 34); }
+
+private:
+    const uint8_t* data_ = nullptr;  ///< Start of the payload
+};
+
+/**
+ * @brief Binary encoding of the application commands.
+ *
+ * Payload functions produce the bare fixed-layout payload used where the command type is
+ * stored elsewhere (journal records, flight recorder slots). Frame functions prepend the
+ * WireFormat header for self-describing transports such as bridges and IPC.
+ */
+struct CommandWire {
+    /**
+     * @brief Returns the encoded payload size of a command type.
+     *
+     * @param[in] type Command type.
+     * @return Payload size, 0 if the type has no binary encoding.
+     */
+    static size_t payloadSize(CommandType type) {
+        switch (type) {
+            case CommandType::Inverter: return InverterCommandView::kSize;
+            case CommandType::Battery: return BatteryStateView::kSize;
+            default: return 0;
+        }
+    }
+
+    /**
+     * @brief Encodes the payload of a command.
+     *
+     * @param[in] command The command to encode.
+     * @param[out] buffer Destination buffer.
+     * @param[in] capacity Size of the destination buffer.
+     * @return Bytes written, 0 for unsupported types or a too small buffer.
+     */
+    static size_t encodePayload(const VirtualBusCmd& command, uint8_t* buffer, size_t capacity) {
+        const size_t size = payloadSize(command.getType());
+        if (size == 0 || capacity < size) {
+            return 0;
+        }
+        if (command.getType() == CommandType::Inverter) {
+            const auto& inverter = static_cast<const InverterCommandBase&>(command);
+            if (inverter.copyRawPayload(buffer, capacity) == size) {
+                return size;
+            }
+            buffer[0] = static_cast<uint8_t>(inverter.mode());
+            WireFormat::store<double>(buffer + 1, inverter.voltage());
+            WireFormat::store<double>(buffer + 9, inverter.current());
+        } else {
+            const auto& battery = static_cast<const BatteryStateCmdBase&>(command);
+            if (battery.copyRawPayload(buffer, capacity) == size) {
+                return size;
+            }
+            buffer[0] = battery.numberOfCubes();
+            buffer[1] = battery.numberOfReadyCubes();
+            WireFormat::store<uint16_t>(buffer + 2, battery.voltageMinimum());
+            WireFormat::store<uint16_t>(buffer + 4, battery.voltageMaximum());
+            WireFormat::store<int16_t>(buffer + 6, battery.voltageMean());
+            WireFormat::store<uint16_t>(buffer + 8, battery.socMinimum());
+            WireFormat::store<uint16_t>(buffer + 10, battery.socMaximum());
+            WireFormat::store<uint32_t>(buffer + 12, battery.socMean());
+            WireFormat::store<int32_t>(buffer + 16, battery.currentSum());
+            WireFormat::store<int32_t>(buffer + 20, battery.currentMean());
+            WireFormat::store<int32_t>(buffer + 24, battery.currentMinimum());
+            WireFormat::store<int32_t>(buffer + 28, battery.currentMaximum());
+            WireFormat::store<int16_t>(buffer + 32, battery.temperatureMinimum());
+            WireFormat::store<int16_t>(buffer + 34, battery.temperatureMaximum());
+        }
+        return size;
+    }
+
+    /**
+     * @brief Decodes an inverter payload into an existing command.
+     *
+     * @param[in] buffer Encoded payload.
+     * @param[in] size Payload size.
+     * @param[out] command Command receiving the fields, unchanged on failure.
+     * @return True if the payload is valid and every value is in range.
+     */
+    static bool decodeFields(const uint8_t* buffer, size_t size, InverterCommand& command) {
+        InverterCommandView view;
+        if (InverterCommandView::from(buffer, size, view) != ReturnType::OK) {
+            return false;
+        }
+        // Range checks first, so a rejected payload leaves every field untouched
+        const double voltage = view.voltage();
+        const double current = view.current();
+        if (!(voltage >= InverterCommand::kVoltageMin && voltage <= InverterCommand::kVoltageMax) ||
+            !(current >= InverterCommand::kCurrentMin && current <= InverterCommand::kCurrentMax)) {
+            return false;
+        }
+        command.setMode(view.mode());
+        command.setVoltage(voltage);
+        command.setCurrent(current);
+        return true;
+    }
+
+    /**
+     * @brief Decodes a battery payload into an existing command.
+     *
+     * @param[in] buffer Encoded payload.
+     * @param[in] size Payload size.
+     * @param[out] command Command receiving the fields, unchanged on failure.
+     * @return True if the payload is valid.
+     */
+    static bool decodeFields(const uint8_t* buffer, size_t size, BatteryStateCmd& command) {
+        BatteryStateView view;
+        if (BatteryStateView::from(buffer, size, view) != ReturnType::OK) {
+            return false;
+        }
+        // Every value of the battery field types is in range, so the setters cannot fail
+        command.setNumberOfCubes(view.numberOfCubes());
+        command.setNumberOfReadyCubes(view.numberOfReadyCubes());
+        command.setVoltageMinimum(view.voltageMinimum());
+        command.setVoltageMaximum(view.voltageMaximum());
+        command.setVoltageMean(view.voltageMean());
+        command.setSocMinimum(view.socMinimum());
+        command.setSocMaximum(view.socMaximum());
+        command.setSocMean(view.socMean());
+        command.setCurrentSum(view.currentSum());
+        command.setCurrentMean(view.currentMean());
+        command.setCurrentMinimum(view.currentMinimum());
+        command.setCurrentMaximum(view.currentMaximum());
+        command.setTemperatureMinimum(view.temperatureMinimum());
+        command.setTemperatureMaximum(view.temperatureMaximum());
+        return true;
+    }
+
+    /**
+     * @brief Decodes a payload into a new command object.
+     *
+     * @param[in] type Command type of the payload.
+     * @param[in] buffer Encoded payload.
+     * @param[in] size Payload size.
+     * @return The decoded command, or nullptr for unsupported types and invalid payloads.
+     */
+    static std::shared_ptr<VirtualBusCmd> decodePayload(CommandType type, const uint8_t* buffer, size_t size) {
+        if (type == CommandType::Inverter) {
+            auto command = std::make_shared<InverterCommand>();
+            return decodeFields(buffer, size, *command) ? command : nullptr;
+        }
+        if (type == CommandType::Battery) {
+            auto command = std::make_shared<BatteryStateCmd>();
+            return decodeFields(buffer, size, *command) ? command : nullptr;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Encodes a command as a self-describing frame.
+     *
+     * @param[in] command The command to encode.
+     * @param[out] buffer Destination buffer.
+     * @param[in] capacity Size of the destination buffer.
+     * @return Bytes written including the header, 0 for unsupported types or a too small buffer.
+     */
+    static size_t encode(const VirtualBusCmd& command, uint8_t* buffer, size_t capacity) {
+        if (capacity < WireFormat::kHeaderSize) {
+            return 0;
+        }
+        const size_t size = encodePayload(command, buffer + WireFormat::kHeaderSize, capacity - WireFormat::kHeaderSize);
+        if (size == 0) {
+            return 0;
+        }
+        WireFormat::writeHeader(buffer, static_cast<uint8_t>(command.getType()), static_cast<uint16_t>(size));
+        return WireFormat::kHeaderSize + size;
+    }
+
+    /**
+     * @brief Decodes a frame produced by encode().
+     *
+     * @param[in] buffer Frame start.
+     * @param[in] size Bytes available.
+     * @return The decoded command, or nullptr for invalid frames.
+     */
+    static std::shared_ptr<VirtualBusCmd> decode(const uint8_t* buffer, size_t size) {
+        WireFormat::WireHeader header;
+        if (WireFormat::readHeader(buffer, size, header) != ReturnType::OK) {
+            return nullptr;
+        }
+        return decodePayload(static_cast<CommandType>(header.type), buffer + WireFormat::kHeaderSize, header.payloadSize);
+    }
+};
+
+#endif // COMMAND_WIRE_FORMAT_H
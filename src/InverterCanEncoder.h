@@ -0,0 +1,63 @@
+#ifndef INVERTER_CAN_ENCODER_H
+#define INVERTER_CAN_ENCODER_H
+
+#include "InverterCommand.h"
+#include "candefenation.h"
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief Class encoding inverter setpoints into CAN frames.
+ *
+ * Frame layout (little endian, DLC 5):
+ * - byte 0: mode, 0 = Charging, 1 = Discharging
+ * - bytes 1-2: voltage setpoint in 0.01 V, unsigned
+ * - bytes 3-4: current setpoint in 0.1 A, signed
+ */
+class InverterCanEncoder {
+public:
+    static constexpr uint32_t kSetpointCanId = 0x210;  ///< Default identifier of the setpoint frame
+
+    /**
+     * @brief Encodes an inverter command into a setpoint frame.
+     *
+     * Values outside the representable range are saturated.
+     *
+     * @param[in] command The command to encode.
+     * @param[in] canId Identifier of the frame.
+     * @return The encoded frame.
+     */
+    static can_frame encode(const InverterCommand& command, uint32_t canId = kSetpointCanId) {
+        can_frame frame{};
+        frame.can_id = canId;
+        frame.can_dlc = 5;
+        frame.data[0] = (command.getMode() == InverterCommand::Mode::Charging) ? 0 : 1;
+
+        uint16_t voltage = static_cast<uint16_t>(saturate(command.getVoltage() * 100.0, 0.0, std::numeric_limits<uint16_t>::max()));
+        int16_t current = static_cast<int16_t>(saturate(command.getCurrent() * 10.0, std::numeric_limits<int16_t>::min(), std::numeric_limits<int16_t>::max()));
+        uint16_t currentBits = static_cast<uint16_t>(current);
+
+        frame.data[1] = static_cast<uint8_t>(voltage & 0xFF);
+        frame.data[2] = static_cast<uint8_t>(voltage >> 8);
+        frame.data[3] = static_cast<uint8_t>(currentBits & 0xFF);
+        frame.data[4] = static_cast<uint8_t>(currentBits >> 8);
+        return frame;
+    }
+
+private:
+    /**
+     * @brief Rounds a value and clamps it to a range.
+     */
+    static double saturate(double value, double minimum, double maximum) {
+        if (std::isnan(value)) {
+            return 0.0;
+        }
+        value = std::round(value);
+        if (value < minimum) return minimum;
+        if (value > maximum) return maximum;
+        return value;
+    }
+};
+
+#endif // INVERTER_CAN_ENCODER_H
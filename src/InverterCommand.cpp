@@ -1,13 +1,13 @@
 #include "InverterCommand.h"
-#include "InverterCommandParser.h"
+#include "CommandParserRegistry.h"
+#include "CommandWireFormat.h"
 #include <memory>
 
-void InverterCommand::initializeParser() {
-    // Creating a shared pointer to InverterCommandParser and assigning it to JsonCmdParser pointer
-    std::shared_ptr<JsonCmdParser> parser = std::make_shared<InverterCommandParser>();
-    setParser(parser);
+ReturnType InverterCommand::registerParser(std::shared_ptr<ILogger> logger) {
+    // The parser is generated together with InverterCommandBase
+    return CommandParserRegistry::registerParser(CommandType::Inverter, std::make_unique<InverterCommandParser>(logger), logger);
+}
 
-    if (logger_) {
-        logger_->info("InverterCommand: Parser initialized.");
-    }
+size_t InverterCommand::payloadSize() const {
+    return CommandWire::payloadSize(getType());
 }
@@ -0,0 +1,89 @@
+#ifndef INVERTER_PDO_PROFILE_H
+#define INVERTER_PDO_PROFILE_H
+
+#include "CanOpenPdoMapper.h"
+#include "InverterCommand.h"
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Class describing the CANopen object dictionary and default PDOs of the inverter.
+ *
+ * Manufacturer specific objects:
+ * - 0x2100:01 Mode, UNSIGNED8 (0 = Charging, 1 = Discharging)
+ * - 0x2100:02 Voltage setpoint, UNSIGNED16, 0.01 V
+ * - 0x2100:03 Current setpoint, INTEGER16, 0.1 A
+ *
+ * RPDO1 (0x200 + node ID) and TPDO1 (0x180 + node ID) both map all three objects.
+ */
+class InverterPdoProfile {
+public:
+    static constexpr uint16_t kSetpointIndex = 0x2100;  ///< Object dictionary index of the setpoint record
+
+    /**
+     * @brief Returns the object dictionary bindings of the inverter setpoint.
+     * @return Object dictionary bindings.
+     */
+    static std::vector<CanOpenObjectBinding> objectDictionary() {
+        return {
+            {kSetpointIndex, 0x01, CanOpenDataType::Unsigned, 1.0, &setMode, &getMode},
+            {kSetpointIndex, 0x02, CanOpenDataType::Unsigned, 0.01, &setVoltage, &getVoltage},
+            {kSetpointIndex, 0x03, CanOpenDataType::Signed, 0.1, &setCurrent, &getCurrent},
+        };
+    }
+
+    /**
+     * @brief Returns the default mapping of the setpoint PDOs in CiA 301 format.
+     * @return Mapping entries.
+     */
+    static std::vector<uint32_t> setpointMapping() {
+        return {0x21000108, 0x21000210, 0x21000310};
+    }
+
+    /**
+     * @brief Configures the object dictionary and the default PDOs of an inverter node.
+     *
+     * @param[in] mapper Mapper to configure.
+     * @param[in] nodeId CANopen node ID of the inverter (1 - 127).
+     * @return OK if all PDOs were added.
+     */
+    static ReturnType configure(CanOpenPdoMapper& mapper, uint8_t nodeId) {
+        mapper.setObjectDictionary(objectDictionary());
+        ReturnType result = mapper.addRpdo(0x200 + nodeId, setpointMapping(), &createCommand);
+        if (result != ReturnType::OK) {
+            return result;
+        }
+        return mapper.addTpdo(0x180 + nodeId, setpointMapping(), CommandType::Inverter);
+    }
+
+private:
+    static std::shared_ptr<VirtualBusCmd> createCommand() {
+        return std::make_shared<InverterCommand>();
+    }
+
+    static void setMode(VirtualBusCmd& command, double value) {
+        static_cast<InverterCommand&>(command).setMode(value != 0.0 ? InverterCommand::Mode::Discharging : InverterCommand::Mode::Charging);
+    }
+
+    static double getMode(const VirtualBusCmd& command) {
+        return static_cast<const InverterCommand&>(command).getMode() == InverterCommand::Mode::Charging ? 0.0 : 1.0;
+    }
+
+    static void setVoltage(VirtualBusCmd& command, double value) {
+        static_cast<InverterCommand&>(command).setVoltage(value);
+    }
+
+    static double getVoltage(const VirtualBusCmd& command) {
+        return static_cast<const InverterCommand&>(command).getVoltage();
+    }
+
+    static void setCurrent(VirtualBusCmd& command, double value) {
+        static_cast<InverterCommand&>(command).setCurrent(value);
+    }
+
+    static double getCurrent(const VirtualBusCmd& command) {
+        return static_cast<const InverterCommand&>(command).getCurrent();
+    }
+};
+
+#endif // INVERTER_PDO_PROFILE_H
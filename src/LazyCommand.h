@@ -0,0 +1,166 @@
+#ifndef LAZY_COMMAND_H
+#define LAZY_COMMAND_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "CommandWireFormat.h"
+#include "ErrorHandler.h"
+#include "ReturnType.h"
+#include "ILogger.h"
+
+/**
+ * @brief Command that keeps its raw payload and decodes it on first field access.
+ *
+ * A LazyCommand<InverterCommand> is an InverterCommand, so subscribers read it through the
+ * usual getters and casts. The JSON text or binary payload it was created from is decoded
+ * the first time any field is read or written and the values are cached in the regular
+ * fields. A mutex makes concurrent subscribers decode only once. Messages that are only
+ * routed, journaled or forwarded are never decoded, and CommandWire::encodePayload()
+ * copies a binary payload verbatim.
+ *
+ * Validation is deferred together with decoding. An invalid payload leaves the schema
+ * defaults in place and is reported once through ErrorHandler and decodeStatus().
+ *
+ * @tparam Command InverterCommand or BatteryStateCmd.
+ */
+template <typename Command>
+class LazyCommand : public Command {
+public:
+    /**
+     * @brief Encoding of the raw payload.
+     */
+    enum class Encoding {
+        Binary,  ///< CommandWire payload without frame header
+        Json     ///< JSON parameters as accepted by parseJson()
+    };
+
+    /**
+     * @brief Constructor adopting a raw payload.
+     *
+     * @param[in] encoding Encoding of the payload.
+     * @param[in] payload Raw payload bytes.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     */
+    LazyCommand(Encoding encoding, std::string payload, std::shared_ptr<ILogger> logger = nullptr)
+        : Command(logger), encoding_(encoding), raw_(std::move(payload)) {
+        this->pending_.store(true, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Creates a lazy command from JSON parameters without parsing them.
+     *
+     * @param[in] text JSON text.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     * @return The command.
+     */
+    static std::shared_ptr<LazyCommand> fromJson(std::string text, std::shared_ptr<ILogger> logger = nullptr) {
+        return std::make_shared<LazyCommand>(Encoding::Json, std::move(text), logger);
+    }
+
+    /**
+     * @brief Creates a lazy command from a binary payload, only its size is checked.
+     *
+     * @param[in] payload Encoded payload, copied into the command.
+     * @param[in] size Payload size.
+     * @param[in] logger A shared pointer to a logger instance for logging messages.
+     * @return The command, or nullptr if the size does not match the command type.
+     */
+    static std::shared_ptr<LazyCommand> fromBinary(const uint8_t* payload, size_t size, std::shared_ptr<ILogger> logger = nullptr) {
+        auto command = std::make_shared<LazyCommand>(Encoding::Binary, std::string(reinterpret_cast<const char*>(payload), size), logger);
+        return size == CommandWire::payloadSize(command->getType()) ? command : nullptr;
+    }
+
+    /**
+     * @brief Getter for the decoding state.
+     * @return True once the payload has been decoded into the fields.
+     */
+    bool isDecoded() const { return !this->pending_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Getter for the payload encoding.
+     * @return Encoding of the raw payload.
+     */
+    Encoding encoding() const { return encoding_; }
+
+    /**
+     * @brief Getter for the raw payload, kept after decoding.
+     * @return Raw payload bytes.
+     */
+    const std::string& rawPayload() const { return raw_; }
+
+    /**
+     * @brief Decodes the payload if necessary and returns the outcome.
+     * @return OK, ERROR for malformed JSON, INVALID_ARGUMENT for rejected values.
+     */
+    ReturnType decodeStatus() const {
+        this->ensureDecoded();
+        return status_;
+    }
+
+    /**
+     * @brief Copies the binary payload as long as it has not been decoded.
+     *
+     * @param[out] buffer Destination buffer.
+     * @param[in] capacity Size of the destination buffer.
+     * @return Bytes copied, 0 for JSON payloads, decoded commands or a too small buffer.
+     */
+    size_t copyRawPayload(uint8_t* buffer, size_t capacity) const override {
+        if (encoding_ != Encoding::Binary || isDecoded() || capacity < raw_.size()) {
+            return 0;
+        }
+        std::memcpy(buffer, raw_.data(), raw_.size());
+        return raw_.size();
+    }
+
+protected:
+    /**
+     * @brief Decodes the raw payload once and publishes the fields with release order.
+     */
+    void decodePending() const override {
+        ReturnType status;
+        {
+            std::lock_guard<std::mutex> lock(decodeMutex_);
+            if (!this->pending_.load(std::memory_order_relaxed)) {
+                return;  // Decoded by a concurrent reader
+            }
+
+            // Decode into a plain command, whose accessors do not recurse into this one
+            Command decoded;
+            if (encoding_ == Encoding::Json) {
+                ParseError error;
+                status = decoded.parseJson(raw_, error);
+            } else {
+                status = CommandWire::decodeFields(reinterpret_cast<const uint8_t*>(raw_.data()), raw_.size(), decoded)
+                             ? ReturnType::OK : ReturnType::INVALID_ARGUMENT;
+            }
+
+            // The factories create non-const objects, the const_cast only caches the decoded state
+            auto* self = const_cast<LazyCommand*>(this);
+            if (status == ReturnType::OK) {
+                self->copyFields(decoded);
+            }
+            self->status_ = status;
+            this->pending_.store(false, std::memory_order_release);
+        }
+
+        // Reported after the lock is released, so a slow logger does not hold up other readers
+        if (status != ReturnType::OK) {
+            ErrorHandler::handleError("LazyCommand", "Cannot decode payload of command type " +
+                                      std::to_string(static_cast<int>(this->getType())) + ".",
+                                      ErrorHandler::ErrorSeverity::WARNING, this->logger_);
+        }
+    }
+
+private:
+    Encoding encoding_;                    ///< Encoding of raw_
+    std::string raw_;                      ///< Raw payload as received
+    ReturnType status_ = ReturnType::OK;   ///< Outcome of the decoding, valid once pending_ is cleared
+    mutable std::mutex decodeMutex_;       ///< Serialises the one-time decoding
+};
+
+#endif // LAZY_COMMAND_H
@@ -6,6 +6,7 @@
 #include "InverterCommand.h"
 #include "ILogger.h"
 #include "ErrorHandler.h"
+#include "Tracer.h"
 #include <iostream>
 #include <memory>
 #include <string>
@@ -38,9 +39,7 @@ public:
         bus_.registerCallback(id_, [this](std::shared_ptr<VirtualBusCmd> cmd) {
             this->onMessageReceived(cmd);
         });
-        if (logger_) {
-            logger_->info("ReceiveTask: Callback registered and task started.");
-        }
+        VBUS_LOG_INFO(logger_, "ReceiveTask: Callback registered and task started.");
         Task::start();
     }
 
@@ -51,14 +50,10 @@ protected:
     void run() override {
         while (running_) {
             // Perform other tasks if needed
-            if (logger_) {
-                logger_->info("ReceiveTask: Running...");
-            }
+            VBUS_LOG_INFO(logger_, "ReceiveTask: Running...");
             std::this_thread::sleep_for(std::chrono::seconds(1));
         }
-        if (logger_) {
-            logger_->info("ReceiveTask: Stopped running.");
-        }
+        VBUS_LOG_INFO(logger_, "ReceiveTask: Stopped running.");
     }
 
     /**
@@ -68,11 +63,10 @@ protected:
      */
     void onMessageReceived(std::shared_ptr<VirtualBusCmd> cmd) {
         if (!running_) return; // Check if the task is still running
+        TraceScope trace("ReceiveTask::onMessageReceived", id_);
 
         // Process the received command
-        if (logger_) {
-            logger_->info("ReceiveTask: Message received.");
-        }
+        VBUS_LOG_INFO_LIMITED(logger_, "receive.message", "ReceiveTask: Message received.");
         cmd->print();
         if (cmd->getType() == CommandType::Inverter) {
             if (auto inverterCmd = std::dynamic_pointer_cast<InverterCommand>(cmd)) {
@@ -80,9 +74,9 @@ protected:
                 double voltage = inverterCmd->getVoltage();
                 double current = inverterCmd->getCurrent();
                 auto mode = inverterCmd->getMode();
-                std::string modeString = (mode == InverterCommand::Mode::Charging) ? "Charging" : "Discharging";
+                const char* modeString = (mode == InverterCommand::Mode::Charging) ? "Charging" : "Discharging";
                 if (logger_) {
-                    logger_->info("ReceiveTask: Received InverterCommand (" + modeString + "): Voltage = " + std::to_string(voltage) + ", Current = " + std::to_string(current));
+                    VBUS_LOG_INFO_LIMITED(logger_, "receive.command", "ReceiveTask: Received InverterCommand ({}): Voltage = {}, Current = {}", modeString, voltage, current);
                 } else {
                     std::cout << "Received InverterCommand (" << modeString << "): Voltage = " << voltage << ", Current = " << current << std::endl;
                 }
@@ -45,13 +45,9 @@ protected:
             command->setMode(InverterCommand::Mode::Charging);
 
             bus_.sendMessage(id_, command);
-            if (logger_) {
-                logger_->info("SendTask: Sent InverterCommand (Charging): Voltage = " + std::to_string(command->getVoltage()) + ", Current = " + std::to_string(command->getCurrent()));
-            }
-        }
-        if (logger_) {
-            logger_->info("SendTask: Stopped sending commands.");
+            VBUS_LOG_INFO_LIMITED(logger_, "send.command", "SendTask: Sent InverterCommand (Charging): Voltage = {}, Current = {}", command->getVoltage(), command->getCurrent());
         }
+        VBUS_LOG_INFO(logger_, "SendTask: Stopped sending commands.");
     }
 };
 
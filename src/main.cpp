@@ -1,6 +1,7 @@
 /* Updated to match AUTOSAR Adaptive Naming and Commenting Conventions */
 #include <iostream>
 #include <chrono>
+#include <cstdlib>
 #include <thread>
 
 #include "VirtualBus.h"
@@ -10,6 +11,18 @@
 #include "Configuration.h"
 #include "JsonStorage.h"
 #include "ErrorHandler.h"
+#include "BusJournal.h"
+#include "FlightRecorder.h"
+#include "LatencySignalDump.h"
+#include "PrometheusExporter.h"
+#include "LockProfiler.h"
+#include "LogLimiter.h"
+#include "Tracer.h"
+#include "AsyncLogger.h"
+#include "BinaryLogger.h"
+#include "AppMessageCodec.h"
+#include "InverterCommand.h"
+#include "BatteryCommand.h"
 
 //#include "OD.h"
 // Conditionally include SpdLogWrapper or StdCoutLogger
@@ -29,15 +42,23 @@ int main() {
     std::cout<<"Project Version:"<<PROJECT_VERSION<<std::endl;
     std::cout<<"###############################################"<<std::endl;
     // Set the logger
-#ifdef USE_SPDLOG
-    auto logger = std::make_shared<SpdLogWrapper>();
+    // Formatting and output run on a background thread, off the bus hot paths
+#if defined(USE_BINARY_LOG)
+    // Raw arguments only, the text is rebuilt on the host with blog_decode
+    auto logger = std::make_shared<BinaryLogger>("application.vblog");
+    std::cout<<"binary log written to application.vblog"<<std::endl;
+#elif defined(USE_SPDLOG)
+    auto logger = std::make_shared<AsyncLogger>(std::make_shared<SpdLogWrapper>());
     std::cout<<"spdlog set for logging"<<std::endl;
 #else
-    auto logger = std::make_shared<StdCoutLogger>();
+    auto logger = std::make_shared<AsyncLogger>();
 #endif
 
     VirtualBus bus(logger);
 
+    // Print the per-task delivery latency on `kill -USR1 <pid>`
+    LatencySignalDump latencyDump(bus, SIGUSR1, logger);
+
     // Get the singleton instance of Configuration
     Configuration& config = Configuration::getInstance();
 
@@ -47,6 +68,28 @@ int main() {
     auto jsonStorage = std::make_unique<JsonStorage>(logger);
     config.setStorage(std::move(jsonStorage));
 
+    // Log level and per-site limits are applied on load and on every later setConfig()
+    std::weak_ptr<ILogger> weakLogger = logger;
+    config.addListener("log_level", [weakLogger](const std::string& value) {
+        auto target = weakLogger.lock();
+        if (!target) {
+            return;
+        }
+        LogLevel level = LogLevel::Info;
+        if (ILogger::parseLevel(value, level)) {
+            target->setLevel(level);
+        } else if (!value.empty()) {
+            target->warn("Unknown log level " + value + ", keeping the current level.");
+        }
+    });
+    config.addListener("log_limits", [weakLogger](const std::string& value) {
+        if (!LogLimiter::configure(value)) {
+            if (auto target = weakLogger.lock()) {
+                target->warn("Ignoring invalid entries in log_limits: " + value);
+            }
+        }
+    });
+
     // Load configuration from JSON file
     if (!config.load("config.json")) {
         ErrorHandler::handleError("Main", "Failed to load configuration file.", ErrorHandler::ErrorSeverity::ERROR, logger);
@@ -59,6 +102,48 @@ int main() {
     logger->info("Log Level: " + logLevel);
     logger->info("Max Threads: " + maxThreads);
 
+    // Keep the most recent traffic and events in a crash-safe ring
+    std::string recorderPath = config.getConfig("flight_recorder");
+    auto recorder = std::make_shared<FlightRecorder>(recorderPath.empty() ? "flight_recorder.vbfr" : recorderPath,
+                                                     16384, std::make_shared<AppMessageCodec>(), logger);
+    if (recorder->isOpen()) {
+        bus.addObserver(recorder);
+        ErrorHandler::setFlightRecorder(recorder);
+        recorder->recordState("Bus up");
+    }
+
+    // Optionally record all bus traffic, one subdirectory per run
+    std::string journalDir = config.getConfig("journal_dir");
+    if (!journalDir.empty()) {
+        auto runId = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        auto journal = std::make_shared<BusJournal>(journalDir + "/" + std::to_string(runId), std::make_shared<AppMessageCodec>(), 64 * 1024 * 1024, logger);
+        if (journal->isOpen()) {
+            bus.addObserver(journal);
+        }
+    }
+
+    // Optionally export the bus counters to a Prometheus textfile and/or a loopback HTTP endpoint
+    PrometheusExporter metricsExporter(bus.getMetrics(), logger);
+    std::string metricsFile = config.getConfig("metrics_file");
+    if (!metricsFile.empty()) {
+        metricsExporter.startFile(metricsFile);
+    }
+    std::string metricsPort = config.getConfig("metrics_port");
+    if (!metricsPort.empty()) {
+        metricsExporter.startHttp(static_cast<uint16_t>(std::strtoul(metricsPort.c_str(), nullptr, 10)));
+    }
+
+    // Optionally trace every message from publish to consumer, open the file in ui.perfetto.dev
+    std::string traceFile = config.getConfig("trace_file");
+    if (!traceFile.empty()) {
+        Tracer::setThreadName("main");
+        Tracer::start();
+    }
+
+    // Parsers are shared by all commands of a type
+    InverterCommand::registerParser(logger);
+    BatteryStateCmd::registerParser(logger);
+
     // Initialize sender and receiver tasks
     SendTask sender("Sender", bus, logger);
     ReceiveTask receiver("Receiver", bus, logger);
@@ -76,6 +161,7 @@ int main() {
     // Start the tasks
     sender.start();
     receiver.start();
+    recorder->recordState("Tasks started");
 
     // Let the tasks run for a defined duration
     std::this_thread::sleep_for(std::chrono::seconds(10));
@@ -85,12 +171,22 @@ int main() {
     receiver.stop();
 
     // Shutdown the bus to stop any waiting threads
+    recorder->recordState("Shutting down");
     bus.shutdown();
 
     // Join the tasks to ensure clean shutdown
     sender.join();
     receiver.join();
 
+    if (!traceFile.empty()) {
+        Tracer::stop();
+        Tracer::writeChromeJson(traceFile, logger);
+    }
+
+    if (LockProfiler::enabled()) {
+        std::cout << LockProfiler::report() << std::flush;
+    }
+
     // Update configuration value
     config.setConfig("log_level", "debug");
     if (!config.save("updated_config.json")) {
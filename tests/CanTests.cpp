@@ -0,0 +1,266 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "TestUtils.h"
+#include "CanBusEmulator.h"
+#include "CanTxQueue.h"
+#include "CanTransmitTask.h"
+
+namespace {
+
+can_frame makeFrame(uint32_t id, uint8_t dlc, uint8_t fill) {
+    can_frame frame{};
+    frame.can_id = id;
+    frame.can_dlc = dlc;
+    std::memset(frame.data, fill, dlc);
+    return frame;
+}
+
+/**
+ * @brief Records the frames a node receives.
+ */
+struct Received {
+    std::mutex mutex;
+    std::vector<can_frame> frames;
+
+    CanBusEmulator::FrameCallback callback() {
+        return [this](const can_frame& frame, CanBusEmulator::Clock::time_point) {
+            std::lock_guard<std::mutex> lock(mutex);
+            frames.push_back(frame);
+        };
+    }
+
+    size_t count(uint32_t id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t matches = 0;
+        for (const auto& frame : frames) {
+            matches += frame.can_id == id ? 1 : 0;
+        }
+        return matches;
+    }
+};
+
+/**
+ * @brief Sink recording the written frames; it can hold the transmit thread in writeFrames().
+ */
+struct RecordingSink : ICanSink {
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<can_frame> frames;
+    bool hold = false;       ///< Blocks writeFrames() until cleared
+    bool holding = false;    ///< True while a write is blocked
+    bool busy = false;       ///< The next write takes nothing and reports BUSY
+
+    ReturnType writeFrames(const can_frame* batch, size_t count, size_t& written) override {
+        std::unique_lock<std::mutex> lock(mutex);
+        holding = true;
+        condition.notify_all();
+        condition.wait(lock, [this] { return !hold; });
+        holding = false;
+        if (busy) {
+            busy = false;
+            written = 0;
+            return ReturnType::BUSY;
+        }
+        frames.insert(frames.end(), batch, batch + count);
+        written = count;
+        return ReturnType::OK;
+    }
+
+    void release() {
+        std::lock_guard<std::mutex> lock(mutex);
+        hold = false;
+        condition.notify_all();
+    }
+
+    bool waitHolding() {
+        std::unique_lock<std::mutex> lock(mutex);
+        return condition.wait_for(lock, std::chrono::seconds(5), [this] { return holding; });
+    }
+
+    std::vector<can_frame> written() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return frames;
+    }
+};
+
+} // namespace
+
+TEST_CASE(canBusEmulatorArbitratesAndWaitsForDelivery) {
+    CanBusEmulator bus(CAN_BAUD_500K, CanBusEmulator::TimeMode::Virtual);
+    std::vector<uint32_t> order;
+    std::atomic<int> delivered{0};
+    const int a = bus.attachNode("A", nullptr);
+    const int b = bus.attachNode("B", nullptr);
+    bus.attachNode("Receiver", [&order, &delivered](const can_frame& frame, CanBusEmulator::Clock::time_point) {
+        order.push_back(frame.can_id);
+        if (frame.can_id == 0x300) {
+            // A slow receiver: waitIdle() has to wait for it
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        delivered.fetch_add(1);
+    });
+
+    CHECK(bus.transmit(a, makeFrame(0x300, 8, 0x00)) == ReturnType::OK);
+    CHECK(bus.transmit(a, makeFrame(0x100, 2, 0xFF)) == ReturnType::OK);
+    // Extended identifiers arbitrate on their 11 base identifier bits first
+    const uint32_t extended = (0x200U << 18) | 0x1234U | CAN_EFF_FLAG;
+    CHECK(bus.transmit(b, makeFrame(extended, 4, 0x55)) == ReturnType::OK);
+    CHECK(bus.transmit(b, makeFrame(0x200, 9, 0x00)) == ReturnType::INVALID_ARGUMENT);
+    bus.start();
+    CHECK(bus.waitIdle(std::chrono::milliseconds(5000)));
+    CHECK(delivered.load() == 3);
+    CHECK(order.size() == 3);
+    if (order.size() == 3) {
+        CHECK(order[0] == 0x100);
+        CHECK(order[1] == extended);
+        CHECK(order[2] == 0x300);
+    }
+
+    const CanBusEmulator::Statistics stats = bus.getStatistics();
+    CHECK(stats.framesDelivered == 3);
+    CHECK(stats.errorFrames == 0);
+    CHECK(stats.busBits == CanBusEmulator::frameBitLength(makeFrame(0x300, 8, 0x00)) +
+                               CanBusEmulator::frameBitLength(makeFrame(0x100, 2, 0xFF)) +
+                               CanBusEmulator::frameBitLength(makeFrame(extended, 4, 0x55)));
+    bus.stop();
+}
+
+TEST_CASE(canBusEmulatorBusOffNodeIsDisconnected) {
+    CanBusEmulator bus(CAN_BAUD_1M, CanBusEmulator::TimeMode::Virtual);
+    Received faulty;
+    Received sender;
+    Received listener;
+    const int faultyId = bus.attachNode("Faulty", faulty.callback());
+    const int senderId = bus.attachNode("Sender", sender.callback());
+    bus.attachNode("Listener", listener.callback());
+    bus.start();
+
+    // Every transmission fails until the transmit error counter reaches the bus-off limit
+    bus.setErrorRate(1.0);
+    CHECK(bus.transmit(faultyId, makeFrame(0x10, 1, 0x01)) == ReturnType::OK);
+    CHECK(bus.waitIdle(std::chrono::milliseconds(5000)));
+    bus.setErrorRate(0.0);
+    CHECK(bus.getNodeState(faultyId) == CanBusEmulator::NodeState::BusOff);
+    CHECK(faulty.count(CAN_ERR_CRTL) == 1);
+    CHECK(listener.count(CAN_ERR_PROT) == 32);
+    CHECK(bus.transmit(faultyId, makeFrame(0x10, 1, 0x01)) == ReturnType::ERROR);
+
+    CHECK(bus.transmit(senderId, makeFrame(0x20, 1, 0x02)) == ReturnType::OK);
+    CHECK(bus.waitIdle(std::chrono::milliseconds(5000)));
+    CHECK(listener.count(0x20) == 1);
+    CHECK(faulty.count(0x20) == 0);
+
+    bus.recoverNode(faultyId);
+    CHECK(bus.getNodeState(faultyId) == CanBusEmulator::NodeState::ErrorActive);
+    CHECK(bus.transmit(senderId, makeFrame(0x20, 1, 0x03)) == ReturnType::OK);
+    CHECK(bus.transmit(faultyId, makeFrame(0x30, 1, 0x04)) == ReturnType::OK);
+    CHECK(bus.waitIdle(std::chrono::milliseconds(5000)));
+    CHECK(faulty.count(0x20) == 1);
+    CHECK(sender.count(0x30) == 1);
+    bus.stop();
+}
+
+TEST_CASE(canTxQueueOrdersAndReplacesFrames) {
+    auto sink = std::make_shared<RecordingSink>();
+    CanTxQueue queue(sink);
+    CHECK(queue.submit(makeFrame(0x300, 1, 0x01)) == ReturnType::OK);
+    CHECK(queue.submit(makeFrame(0x100, 1, 0x02)) == ReturnType::OK);
+    CHECK(queue.submit(makeFrame(0x300, 1, 0x03)) == ReturnType::OK);
+    CHECK(queue.submit(makeFrame(0x100, 9, 0x04)) == ReturnType::INVALID_ARGUMENT);
+    queue.start();
+    CHECK(queue.flush(std::chrono::milliseconds(5000)));
+
+    const auto frames = sink->written();
+    CHECK(frames.size() == 2);
+    if (frames.size() == 2) {
+        CHECK(frames[0].can_id == 0x100);
+        CHECK(frames[1].can_id == 0x300 && frames[1].data[0] == 0x03);
+    }
+    const auto stats = queue.getStatistics();
+    CHECK(stats.submitted == 3);
+    CHECK(stats.replaced == 1);
+    CHECK(stats.written == 2);
+    queue.stop();
+}
+
+TEST_CASE(canTxQueueCountsFramesInFlightAgainstCapacity) {
+    auto sink = std::make_shared<RecordingSink>();
+    sink->hold = true;
+    sink->busy = true;
+    CanTxQueue queue(sink, 4, 5);
+    queue.setRetryInterval(std::chrono::microseconds(100));
+    for (uint32_t id = 0x100; id < 0x104; ++id) {
+        CHECK(queue.submit(makeFrame(id, 1, 0x01)) == ReturnType::OK);
+    }
+    queue.start();
+    CHECK(sink->waitHolding());
+
+    // The whole batch is in the sink, which will hand it back with BUSY, so one slot is left
+    CHECK(queue.submit(makeFrame(0x100, 1, 0x03)) == ReturnType::OK);
+    CHECK(queue.submit(makeFrame(0x200, 1, 0x02)) == ReturnType::BUSY);
+    sink->release();
+    CHECK(queue.flush(std::chrono::milliseconds(5000)));
+
+    const auto frames = sink->written();
+    CHECK(frames.size() == 4);
+    if (!frames.empty()) {
+        // The newer frame for 0x100 won over the requeued one
+        CHECK(frames[0].can_id == 0x100 && frames[0].data[0] == 0x03);
+    }
+    const auto stats = queue.getStatistics();
+    CHECK(stats.rejected == 1);
+    CHECK(stats.sinkBusy == 1);
+    CHECK(stats.pending == 0);
+    queue.stop();
+}
+
+TEST_CASE(canTransmitTaskDrainsItsBusQueue) {
+    constexpr int kCommands = 20;
+    VirtualBus bus;
+    auto sink = std::make_shared<RecordingSink>();
+    CanTxQueue queue(sink);
+    const int senderId = 1000;
+    CHECK(bus.attach(senderId, "Sender") == ReturnType::OK);
+    {
+        CanTransmitTask task("CanTx", bus, queue);
+        CHECK(bus.attach(task.getID(), task.getName()) == ReturnType::OK);
+        task.start();
+
+        for (int i = 0; i < kCommands; ++i) {
+            auto command = std::make_shared<InverterCommand>();
+            command->setMode(InverterCommand::Mode::Discharging);
+            command->setVoltage(400.0 + i);
+            bus.sendMessage(senderId, command);
+        }
+
+        VirtualBus::LatencyReport report;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (bus.getLatency(task.getID(), report) == ReturnType::OK && report.queueDelay.count < kCommands &&
+               std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        CHECK(report.queueDelay.count == kCommands);
+        CHECK(queue.flush(std::chrono::milliseconds(5000)));
+        task.stop();
+    }
+
+    // Older setpoints may be replaced before they are sent, the newest one always goes out
+    const auto frames = sink->written();
+    CHECK(!frames.empty());
+    if (!frames.empty()) {
+        InverterCommand last;
+        last.setMode(InverterCommand::Mode::Discharging);
+        last.setVoltage(400.0 + kCommands - 1);
+        const can_frame expected = InverterCanEncoder::encode(last);
+        CHECK(frames.back().can_id == expected.can_id);
+        CHECK(std::memcmp(frames.back().data, expected.data, expected.can_dlc) == 0);
+    }
+    bus.shutdown();
+}
@@ -0,0 +1,138 @@
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TestUtils.h"
+#include "IsoTpReassembler.h"
+
+namespace {
+
+can_frame makeFrame(uint32_t id, std::vector<uint8_t> bytes) {
+    can_frame frame{};
+    frame.can_id = id;
+    frame.can_dlc = static_cast<uint8_t>(bytes.size());
+    std::memcpy(frame.data, bytes.data(), bytes.size());
+    return frame;
+}
+
+/**
+ * @brief Collects the flow control frames and the payloads of a reassembler.
+ */
+struct Collector {
+    std::vector<can_frame> flowControl;
+    std::vector<std::shared_ptr<IsoTpPayloadCmd>> payloads;
+
+    IsoTpReassembler::FrameSender sender() {
+        return [this](const can_frame& frame) { flowControl.push_back(frame); };
+    }
+
+    IsoTpReassembler::MessageHandler handler() {
+        return [this](const std::shared_ptr<IsoTpPayloadCmd>& payload) { payloads.push_back(payload); };
+    }
+};
+
+/**
+ * @brief Logger keeping the warnings in memory.
+ */
+class WarningCollector : public ILogger {
+public:
+    void info(const std::string&) override {}
+    void warn(const std::string& message) override { warnings.push_back(message); }
+    void error(const std::string&) override {}
+    void critical(const std::string&) override {}
+
+    std::vector<std::string> warnings;
+};
+
+} // namespace
+
+TEST_CASE(isoTpReassemblesSingleAndMultiFrames) {
+    Collector collector;
+    IsoTpReassembler::Config config;
+    config.blockSize = 2;
+    IsoTpReassembler reassembler(config, collector.sender(), collector.handler());
+
+    CHECK(reassembler.onFrame(makeFrame(0x7E8, {0x03, 0xA1, 0xA2, 0xA3})) == ReturnType::OK);
+    CHECK(collector.payloads.size() == 1);
+    if (collector.payloads.size() == 1) {
+        const auto& payload = collector.payloads[0];
+        CHECK(payload->getCanId() == 0x7E8);
+        CHECK(payload->getType() == CommandType::Diagnostic);
+        CHECK(payload->size() == 3 && payload->data()[0] == 0xA1 && payload->data()[2] == 0xA3);
+    }
+
+    // 27 bytes: 6 in the first frame and 7 in each of three consecutive frames
+    CHECK(reassembler.onFrame(makeFrame(0x7E9, {0x10, 27, 0, 1, 2, 3, 4, 5})) == ReturnType::OK);
+    CHECK(collector.flowControl.size() == 1);
+    if (!collector.flowControl.empty()) {
+        CHECK(collector.flowControl[0].can_id == 0x7E1);
+        CHECK(collector.flowControl[0].data[0] == 0x30 && collector.flowControl[0].data[1] == 2);
+    }
+    CHECK(reassembler.onFrame(makeFrame(0x7E9, {0x21, 6, 7, 8, 9, 10, 11, 12})) == ReturnType::OK);
+    CHECK(reassembler.onFrame(makeFrame(0x7E9, {0x22, 13, 14, 15, 16, 17, 18, 19})) == ReturnType::OK);
+    CHECK(collector.flowControl.size() == 2);
+    CHECK(reassembler.onFrame(makeFrame(0x7E9, {0x23, 20, 21, 22, 23, 24, 25, 26})) == ReturnType::OK);
+    CHECK(collector.payloads.size() == 2);
+    if (collector.payloads.size() == 2) {
+        const auto& payload = collector.payloads[1];
+        CHECK(payload->size() == 27);
+        bool sequential = true;
+        for (size_t i = 0; i < payload->size(); ++i) {
+            sequential = sequential && payload->data()[i] == i;
+        }
+        CHECK(sequential);
+    }
+
+    CHECK(reassembler.onFrame(makeFrame(0x7E9, {0x21, 0, 0, 0, 0, 0, 0, 0})) == ReturnType::NOT_FOUND);
+    const auto stats = reassembler.getStatistics();
+    CHECK(stats.completed == 2);
+    CHECK(stats.flowControlSent == 2);
+    CHECK(stats.unexpected == 1);
+    CHECK(stats.activeSessions == 0);
+}
+
+TEST_CASE(isoTpPayloadHoldsItsPoolBuffer) {
+    Collector collector;
+    IsoTpReassembler::Config config;
+    config.maxSessions = 1;
+    config.poolBuffers = 1;
+    IsoTpReassembler reassembler(config, collector.sender(), collector.handler());
+
+    CHECK(reassembler.onFrame(makeFrame(0x7E8, {0x01, 0x11})) == ReturnType::OK);
+    CHECK(reassembler.onFrame(makeFrame(0x7E8, {0x01, 0x22})) == ReturnType::BUSY);
+
+    // The command lives in the buffer, so even a weak reference keeps it
+    std::weak_ptr<IsoTpPayloadCmd> weak = collector.payloads.at(0);
+    collector.payloads.clear();
+    CHECK(weak.expired());
+    CHECK(reassembler.onFrame(makeFrame(0x7E8, {0x01, 0x33})) == ReturnType::BUSY);
+    weak.reset();
+
+    CHECK(reassembler.onFrame(makeFrame(0x7E8, {0x01, 0x44})) == ReturnType::OK);
+    CHECK(collector.payloads.size() == 1 && collector.payloads[0]->data()[0] == 0x44);
+    CHECK(reassembler.getStatistics().overflows == 2);
+}
+
+TEST_CASE(isoTpExpiresStalledSessions) {
+    Collector collector;
+    IsoTpReassembler::Config config;
+    config.timeout = std::chrono::milliseconds(100);
+    auto logger = std::make_shared<WarningCollector>();
+    IsoTpReassembler reassembler(config, collector.sender(), collector.handler(), logger);
+    const auto start = IsoTpReassembler::Clock::now();
+
+    CHECK(reassembler.onFrame(makeFrame(0x7E8, {0x10, 20, 0, 1, 2, 3, 4, 5}), start) == ReturnType::OK);
+    CHECK(reassembler.onFrame(makeFrame(0x7E8, {0x22, 0, 0, 0, 0, 0, 0, 0}), start) == ReturnType::INVALID_ARGUMENT);
+    CHECK(reassembler.getStatistics().sequenceErrors == 1);
+
+    CHECK(reassembler.onFrame(makeFrame(0x7E8, {0x10, 20, 0, 1, 2, 3, 4, 5}), start) == ReturnType::OK);
+    reassembler.poll(start + std::chrono::milliseconds(500));
+    CHECK(reassembler.onFrame(makeFrame(0x7E8, {0x21, 0, 0, 0, 0, 0, 0, 0}), start + std::chrono::milliseconds(500)) == ReturnType::NOT_FOUND);
+    const auto stats = reassembler.getStatistics();
+    CHECK(stats.timeouts == 1);
+    CHECK(stats.activeSessions == 0);
+    CHECK(collector.payloads.empty());
+    CHECK(!logger->warnings.empty() && logger->warnings.back() == "IsoTpReassembler: Session for CAN ID 0x7E8 timed out.");
+}
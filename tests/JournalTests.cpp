@@ -0,0 +1,47 @@
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "TestUtils.h"
+#include "BusJournal.h"
+#include "AppMessageCodec.h"
+#include "InverterCommand.h"
+
+TEST_CASE(busJournalRollsOverToPreparedSegments) {
+    constexpr uint64_t kRecords = 5000;
+    const std::string directory = TestUtils::scratchPath("journal");
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+
+    InverterCommand command;
+    command.setVoltage(400.0);
+    {
+        // The smallest segment holds a single maximum payload plus room for about 1300 records
+        BusJournal journal(directory, std::make_shared<AppMessageCodec>(), 128 * 1024);
+        CHECK(journal.isOpen());
+        for (uint64_t i = 0; i < kRecords; ++i) {
+            CHECK(journal.append(7, command, i) == ReturnType::OK);
+        }
+        CHECK(journal.getRecordCount() == kRecords);
+    }
+
+    // The segment prepared last was never written and is removed
+    const auto segments = BusJournalReader::listSegments(directory);
+    CHECK(segments.size() >= 3);
+    const std::string last = segments.empty() ? "" : segments.back();
+    const auto lastSize = std::filesystem::file_size(last, error);
+    CHECK(lastSize > sizeof(BusJournalFormat::SegmentHeader) && lastSize < 128 * 1024);
+
+    uint64_t records = 0;
+    bool ordered = true;
+    BusJournalReader reader(directory);
+    CHECK(reader.forEach([&](const BusJournalFormat::RecordHeader& header, const uint8_t*) {
+        ordered = ordered && header.timestampNs == records && header.senderId == 7 &&
+                  header.type == static_cast<uint16_t>(CommandType::Inverter) && header.payloadSize > 0;
+        ++records;
+        return true;
+    }) == ReturnType::OK);
+    CHECK(records == kRecords);
+    CHECK(ordered);
+    std::filesystem::remove_all(directory, error);
+}
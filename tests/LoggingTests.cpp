@@ -0,0 +1,263 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TestUtils.h"
+#include "AsyncLogger.h"
+#include "BinaryLogger.h"
+#include "Configuration.h"
+#include "JsonStorage.h"
+#include "LogFormat.h"
+#include "LogLimiter.h"
+
+namespace {
+
+/**
+ * @brief Counts how many of `calls` messages a limiter admits.
+ */
+int admitted(LogLimiter& limiter, int calls) {
+    int count = 0;
+    uint64_t suppressed = 0;
+    for (int i = 0; i < calls; ++i) {
+        count += limiter.admit(suppressed) ? 1 : 0;
+    }
+    return count;
+}
+
+enum class Color : uint8_t { Red = 3 };
+
+/**
+ * @brief Logger keeping the formatted messages in memory.
+ */
+class CapturingLogger : public ILogger {
+public:
+    void info(const std::string& message) override { messages.push_back("info: " + message); }
+    void warn(const std::string& message) override { messages.push_back("warn: " + message); }
+    void error(const std::string& message) override { messages.push_back("error: " + message); }
+    void critical(const std::string& message) override { messages.push_back("critical: " + message); }
+
+    std::vector<std::string> messages;
+};
+
+void logQuietSite(const std::shared_ptr<ILogger>& logger) {
+    VBUS_LOG_WARN_LIMITED(logger, "test.quiet", "Quiet site {}", 1);
+}
+
+} // namespace
+
+TEST_CASE(binaryLogRoundTrip) {
+    const std::string path = TestUtils::scratchPath("roundtrip.vblog");
+    int line = 0;
+    {
+        auto logger = std::make_shared<BinaryLogger>(path);
+        CHECK(logger->isOpen());
+        const std::string name = "pump";
+        line = __LINE__ + 1;
+        VBUS_LOG_WARN(logger, "Node {} at {} V, id {} enabled {} color {} tag {}", name, 48.25, -17, true, Color::Red, 'x');
+        logger->warn("Plain text {} is not a placeholder");
+        VBUS_LOG_ERROR(logger, "Unsigned {} and {{literal}} braces, surplus {}", 4000000000u);
+        // Call sites below warn compile out in Release builds, see VBUS_LOG_MIN_LEVEL
+        const char* missing = nullptr;
+        VBUS_LOG_WARN(logger, "Null string {}", missing);
+        logger->flush();
+        CHECK(logger->dropped() == 0);
+    }
+
+    std::vector<BinaryLogReader::Entry> entries;
+    CHECK(BinaryLogReader::load(path, entries) == ReturnType::OK);
+    CHECK(entries.size() == 4);
+    if (entries.size() == 4) {
+        CHECK(entries[0].text == "Node pump at 48.25 V, id -17 enabled true color 3 tag x");
+        CHECK(entries[0].level == LogLevel::Warn);
+        CHECK(entries[0].line == line);
+        CHECK(entries[0].file.find("LoggingTests.cpp") != std::string::npos);
+        CHECK(entries[1].text == "Plain text {} is not a placeholder");
+        CHECK(entries[2].text == "Unsigned 4000000000 and {literal} braces, surplus {}");
+        CHECK(entries[2].level == LogLevel::Error);
+        CHECK(entries[0].wallClockNs != 0 && entries[0].wallClockNs <= entries[2].wallClockNs);
+        // Same text as the formatting loggers write
+        CHECK(entries[3].text == "Null string (null)");
+    }
+    std::remove(path.c_str());
+
+    CHECK(BinaryLogReader::load(TestUtils::scratchPath("missing.vblog"), entries) == ReturnType::NOT_FOUND);
+}
+
+TEST_CASE(binaryLogMergesThreadBlocks) {
+    const std::string path = TestUtils::scratchPath("threads.vblog");
+    constexpr int kThreads = 4;
+    constexpr int kRecords = 200;
+    {
+        auto logger = std::make_shared<BinaryLogger>(path, 4096, 2 * kThreads + 2);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&logger, t] {
+                for (int i = 0; i < kRecords; ++i) {
+                    VBUS_LOG_WARN(logger, "Thread {} record {}", t, i);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        logger->flush();
+        CHECK(logger->dropped() == 0);
+    }
+
+    std::vector<BinaryLogReader::Entry> entries;
+    CHECK(BinaryLogReader::load(path, entries) == ReturnType::OK);
+    CHECK(entries.size() == kThreads * kRecords);
+    std::vector<int> next(kThreads, 0);
+    bool ordered = true;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        ordered = ordered && (i == 0 || entries[i - 1].wallClockNs <= entries[i].wallClockNs);
+        int t = 0;
+        int record = 0;
+        if (std::sscanf(entries[i].text.c_str(), "Thread %d record %d", &t, &record) == 2 && t >= 0 && t < kThreads) {
+            ordered = ordered && record == next[t]++;
+        }
+    }
+    CHECK(ordered);
+    std::remove(path.c_str());
+}
+
+TEST_CASE(logLimiterConfigure) {
+    CHECK(LogLimiter::configure("test.every=every 3; test.rate = 2/s , test.both=every 2 3/s, test.off=off, *=every 4"));
+    LogLimiter every("test.every");
+    LogLimiter rate("test.rate");
+    LogLimiter both("test.both");
+    LogLimiter off("test.off");
+    LogLimiter fallback("test.unlisted");
+    CHECK(admitted(every, 9) == 3);
+    // One more window when the test crosses a second boundary
+    const int rated = admitted(rate, 10);
+    CHECK(rated >= 2 && rated <= 4);
+    const int sampledAndRated = admitted(both, 10);
+    CHECK(sampledAndRated >= 3 && sampledAndRated <= 5);
+    CHECK(admitted(off, 10) == 10);
+    CHECK(admitted(fallback, 8) == 2);
+
+    // The first admitted message after suppressed ones carries their count
+    uint64_t suppressed = 0;
+    CHECK(every.admit(suppressed) && suppressed == 2);
+
+    // Invalid entries are reported, the valid ones still apply
+    CHECK(!LogLimiter::configure("test.every=every 5; broken; test.rate=every; test.both=3/m; test.off=every 0"));
+    CHECK(admitted(every, 10) == 2);
+    CHECK(admitted(fallback, 10) == 10);
+
+    CHECK(LogLimiter::configure(""));
+    CHECK(admitted(every, 10) == 10);
+}
+
+TEST_CASE(asyncLoggerRegistersRingsDuringDrain) {
+    // Threads register their rings while the background thread is busy draining a ring full
+    // of long messages. Each thread first logs a huge message, so its ring stays empty for a
+    // while after registration. No message of a thread that is still running may be lost
+    std::FILE* file = std::tmpfile();
+    CHECK(file != nullptr);
+    if (!file) {
+        return;
+    }
+    constexpr int kThreads = 64;
+    constexpr int kMessages = 50;
+    {
+        AsyncLogger logger(file, file, 4096, std::chrono::milliseconds(0));
+        // Direct calls are gated by the runtime level only, so the count holds in every build type
+        logger.setLevel(LogLevel::Info);
+        std::atomic<bool> done{false};
+        const std::string huge(1 << 20, 'h');
+        std::thread bulk([&logger, &done] {
+            const std::string text(AsyncLogger::kInlineText + 1, 'b');
+            while (!done.load()) {
+                logger.warn(text);
+            }
+        });
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&logger, &huge] {
+                logger.info(huge);
+                for (int i = 0; i < kMessages; ++i) {
+                    logger.info("message");
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                }
+            });
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        done.store(true);
+        bulk.join();
+    }
+
+    std::rewind(file);
+    char line[512];
+    int messages = 0;
+    while (std::fgets(line, sizeof(line), file)) {
+        messages += std::strcmp(line, "[INFO]: message\n") == 0 ? 1 : 0;
+    }
+    std::fclose(file);
+    // Only the bulk thread can fill its ring, the other threads never drop
+    CHECK(messages == kThreads * kMessages);
+}
+
+TEST_CASE(logLimiterFlushesQuietSites) {
+    CHECK(LogLimiter::configure("test.quiet=every 10"));
+    auto logger = std::make_shared<CapturingLogger>();
+    CapturingLogger other;
+    for (int i = 0; i < 5; ++i) {
+        logQuietSite(logger);
+    }
+    CHECK(logger->messages.size() == 1);
+
+    // The first pass only notes the count, a site that is still active reports it itself
+    LogLimiter::flushSuppressed(*logger);
+    CHECK(logger->messages.size() == 1);
+    LogLimiter::flushSuppressed(other);
+    LogLimiter::flushSuppressed(*logger);
+    CHECK(logger->messages.size() == 2);
+    if (logger->messages.size() == 2) {
+        CHECK(logger->messages[1] == "warn: LogLimiter: test.quiet suppressed 4 messages.");
+    }
+    CHECK(other.messages.empty());
+    LogLimiter::flushSuppressed(*logger);
+    CHECK(logger->messages.size() == 2);
+
+    logQuietSite(logger);
+    LogLimiter::flushSuppressed(*logger, false);
+    CHECK(logger->messages.size() == 3);
+    CHECK(LogLimiter::configure(""));
+}
+
+TEST_CASE(configurationLoadNotifiesPresentKeysOnly) {
+    const std::string path = TestUtils::scratchPath("config.json");
+    {
+        std::ofstream file(path);
+        file << R"({"test_present": "yes"})";
+    }
+    auto logger = std::make_shared<CapturingLogger>();
+    Configuration& config = Configuration::getInstance();
+    config.setStorage(std::make_unique<JsonStorage>(logger));
+    // Listeners stay registered with the singleton, so they own what they capture
+    auto values = std::make_shared<std::vector<std::string>>();
+    config.addListener("test_present", [values](const std::string& value) { values->push_back(value); });
+    config.addListener("test_missing", [values](const std::string& value) { values->push_back("missing:" + value); });
+
+    CHECK(config.load(path));
+    CHECK(values->size() == 1 && (*values)[0] == "yes");
+    bool warned = false;
+    for (const auto& message : logger->messages) {
+        warned = warned || message.rfind("warn:", 0) == 0;
+    }
+    CHECK(!warned);
+
+    config.setStorage(nullptr);
+    std::remove(path.c_str());
+}
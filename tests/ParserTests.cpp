@@ -0,0 +1,49 @@
+#include <string>
+
+#include "TestUtils.h"
+#include "InverterCommand.h"
+
+TEST_CASE(jsonReaderParsesAndSkipsUnknownValues) {
+    InverterCommand command;
+    ParseError error;
+    const std::string text =
+        " {\"note\":\"tab\\t \\u00e9\\ud83d\\ude00\",\"extra\":[1,{\"a\":null},true,-2.5e3],"
+        "\"command\":\"StartDischarging\",\"voltage\":400,\"current\":-41.75} ";
+    CHECK(command.parseJson(text, error) == ReturnType::OK);
+    CHECK(command.getMode() == InverterCommand::Mode::Discharging);
+    CHECK(command.getVoltage() == 400.0);
+    CHECK(command.getCurrent() == -41.75);
+
+    // Keys with escapes are decoded before the lookup
+    CHECK(command.parseJson("{\"volt\\u0061ge\":12.5}", error) == ReturnType::OK);
+    CHECK(command.getVoltage() == 12.5);
+}
+
+TEST_CASE(jsonReaderReportsErrors) {
+    InverterCommand command;
+    ParseError error;
+    CHECK(command.parseJson("{\"voltage\":300}", error) == ReturnType::OK);
+
+    // Same 1-based positions as nlohmann::json
+    CHECK(command.parseJson("{\"voltage\":1", error) == ReturnType::ERROR);
+    CHECK(error.position == 13);
+    CHECK(command.parseJson("{\"voltage\":1x}", error) == ReturnType::ERROR);
+    CHECK(error.position == 13);
+    CHECK(command.parseJson("{\"voltage\":1,}", error) == ReturnType::ERROR);
+    CHECK(command.parseJson("{\"note\":\"\xC0\xAF\"}", error) == ReturnType::ERROR);
+    CHECK(command.parseJson("{\"note\":1e400}", error) == ReturnType::ERROR);
+    // Input that is not an object points at its first byte
+    CHECK(command.parseJson("[1]", error) == ReturnType::ERROR);
+    CHECK(error.position == 1);
+    CHECK(command.parseJson("  \"text\"", error) == ReturnType::ERROR);
+    CHECK(error.position == 3);
+
+    // A rejected value names its key and leaves the command unchanged
+    error = ParseError{};
+    CHECK(command.parseJson("{\"current\":5,\"voltage\":700}", error) == ReturnType::INVALID_ARGUMENT);
+    CHECK(std::string(error.field) == "voltage");
+    CHECK(command.parseJson("{\"command\":\"Stop\"}", error) == ReturnType::INVALID_ARGUMENT);
+    CHECK(std::string(error.field) == "command");
+    CHECK(command.getVoltage() == 300.0);
+    CHECK(command.getCurrent() == 0.0);
+}
@@ -0,0 +1,70 @@
+#ifndef TEST_UTILS_H
+#define TEST_UTILS_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Minimal test registry used by the unit tests, run by tests/test_main.cpp.
+ *
+ * A TEST_CASE registers itself at static initialization; CHECK records a failure and lets
+ * the test continue, so one run reports every broken expectation.
+ */
+namespace TestUtils {
+
+/**
+ * @brief Struct representing a registered test.
+ */
+struct TestCase {
+    const char* name;   ///< Name of the test function
+    void (*body)();     ///< Test function
+};
+
+inline std::vector<TestCase>& registry() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline void fail(const char* file, int line, const char* expression) {
+    std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expression);
+    ++failures();
+}
+
+/**
+ * @brief Adds a test to the registry at static initialization.
+ */
+struct Registrar {
+    Registrar(const char* name, void (*body)()) { registry().push_back(TestCase{name, body}); }
+};
+
+/**
+ * @brief Returns a path for a scratch file in the build directory.
+ *
+ * @param[in] name File name.
+ * @return Path of the file.
+ */
+inline std::string scratchPath(const std::string& name) {
+    return "test-" + name;
+}
+
+} // namespace TestUtils
+
+#define TEST_CASE(name)                                                                           \
+    static void name();                                                                           \
+    static TestUtils::Registrar name##Registrar(#name, name);                                     \
+    static void name()
+
+#define CHECK(condition)                                                                          \
+    do {                                                                                          \
+        if (!(condition)) {                                                                       \
+            TestUtils::fail(__FILE__, __LINE__, #condition);                                      \
+        }                                                                                         \
+    } while (0)
+
+#endif // TEST_UTILS_H
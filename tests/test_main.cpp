@@ -1,8 +1,14 @@
-
 #include <iostream>
 
+#include "TestUtils.h"
+
 int main() {
     std::cout << "Running tests..." << std::endl;
-    // Add your tests here
-    return 0;
+    for (const auto& test : TestUtils::registry()) {
+        const int before = TestUtils::failures();
+        test.body();
+        std::cout << (TestUtils::failures() == before ? "[  OK  ] " : "[ FAIL ] ") << test.name << std::endl;
+    }
+    std::cout << TestUtils::registry().size() << " tests, " << TestUtils::failures() << " failed checks" << std::endl;
+    return TestUtils::failures() == 0 ? 0 : 1;
 }
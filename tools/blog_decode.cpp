@@ -0,0 +1,73 @@
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BinaryLogger.h"
+
+namespace {
+
+const char* levelName(LogLevel level) {
+    static const char* names[] = {"DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL"};
+    const int index = static_cast<int>(level);
+    return index >= 0 && index < 5 ? names[index] : "UNKNOWN";
+}
+
+std::string formatTime(uint64_t wallClockNs) {
+    std::time_t seconds = static_cast<std::time_t>(wallClockNs / 1000000000ULL);
+    std::tm local{};
+    localtime_r(&seconds, &local);
+    char buffer[48];
+    size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local);
+    std::snprintf(buffer + length, sizeof(buffer) - length, ".%06llu",
+                  static_cast<unsigned long long>((wallClockNs % 1000000000ULL) / 1000));
+    return buffer;
+}
+
+} // namespace
+
+/**
+ * @brief Prints a binary log as text, oldest record first.
+ *
+ * Usage: blog_decode <log-file> [--sites]
+ *
+ * With --sites every line ends with the source location of its call site.
+ *
+ * @return Exit code.
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <log-file> [--sites]" << std::endl;
+        return 1;
+    }
+    const bool sites = argc >= 3 && std::string(argv[2]) == "--sites";
+
+    std::vector<BinaryLogReader::Entry> entries;
+    if (BinaryLogReader::load(argv[1], entries) != ReturnType::OK) {
+        std::cerr << "Cannot read " << argv[1] << std::endl;
+        return 1;
+    }
+
+    size_t textBytes = 0;
+    for (const auto& entry : entries) {
+        std::string line = formatTime(entry.wallClockNs) + " [" + levelName(entry.level) + "]: " + entry.text;
+        textBytes += line.size() + 1;
+        if (sites && !entry.file.empty()) {
+            line += "  (" + entry.file + ":" + std::to_string(entry.line) + ")";
+        }
+        std::cout << line << '\n';
+    }
+    std::cout.flush();
+
+    std::FILE* file = std::fopen(argv[1], "rb");
+    long binaryBytes = 0;
+    if (file && std::fseek(file, 0, SEEK_END) == 0) {
+        binaryBytes = std::ftell(file);
+    }
+    if (file) {
+        std::fclose(file);
+    }
+    std::cerr << entries.size() << " records, " << binaryBytes << " bytes binary, " << textBytes << " bytes as text" << std::endl;
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "FlightRecorder.h"
+#include "AppMessageCodec.h"
+
+namespace {
+
+const char* severityName(uint16_t severity) {
+    static const char* names[] = {"INFO", "WARNING", "ERROR", "CRITICAL"};
+    return severity < 4 ? names[severity] : "UNKNOWN";
+}
+
+std::string formatTime(uint64_t wallClockNs) {
+    std::time_t seconds = static_cast<std::time_t>(wallClockNs / 1000000000ULL);
+    std::tm local{};
+    localtime_r(&seconds, &local);
+    char buffer[48];
+    size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local);
+    std::snprintf(buffer + length, sizeof(buffer) - length, ".%06llu",
+                  static_cast<unsigned long long>((wallClockNs % 1000000000ULL) / 1000));
+    return buffer;
+}
+
+std::string describeMessage(const AppMessageCodec& codec, const FlightRecorderReader::Entry& entry) {
+    auto command = codec.decode(static_cast<CommandType>(entry.type), entry.payload.data(), entry.payload.size());
+    if (auto* inverter = dynamic_cast<InverterCommand*>(command.get())) {
+        return std::string("Inverter ") + (inverter->getMode() == InverterCommand::Mode::Charging ? "Charging" : "Discharging") +
+               " " + std::to_string(inverter->getVoltage()) + " V " + std::to_string(inverter->getCurrent()) + " A";
+    }
+    std::string text = "type " + std::to_string(entry.type) + " [";
+    char hex[4];
+    for (uint8_t byte : entry.payload) {
+        std::snprintf(hex, sizeof(hex), "%02x", byte);
+        text += hex;
+    }
+    return text + "]";
+}
+
+} // namespace
+
+/**
+ * @brief Prints the contents of a flight recorder file, oldest entry first.
+ *
+ * Usage: flight_dump <recorder-file> [--last N]
+ *
+ * @return Exit code.
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <recorder-file> [--last N]" << std::endl;
+        return 1;
+    }
+    size_t last = 0;
+    if (argc >= 4 && std::string(argv[2]) == "--last") {
+        last = std::stoul(argv[3]);
+    }
+
+    std::vector<FlightRecorderReader::Entry> entries;
+    if (FlightRecorderReader::load(argv[1], entries) != ReturnType::OK) {
+        std::cerr << "Cannot read " << argv[1] << std::endl;
+        return 1;
+    }
+
+    AppMessageCodec codec;
+    size_t first = (last > 0 && entries.size() > last) ? entries.size() - last : 0;
+    for (size_t i = first; i < entries.size(); ++i) {
+        const auto& entry = entries[i];
+        std::cout << formatTime(entry.wallClockNs) << " #" << entry.sequence << " ";
+        switch (entry.kind) {
+            case FlightRecorderFormat::EntryKind::Message:
+                std::cout << "MSG   sender " << entry.senderId << " " << describeMessage(codec, entry);
+                break;
+            case FlightRecorderFormat::EntryKind::State:
+                std::cout << "STATE " << std::string(entry.payload.begin(), entry.payload.end());
+                break;
+            case FlightRecorderFormat::EntryKind::Error:
+                std::cout << "ERROR " << severityName(entry.type) << " " << std::string(entry.payload.begin(), entry.payload.end());
+                break;
+            default:
+                std::cout << "?     kind " << static_cast<unsigned>(entry.kind);
+                break;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << entries.size() << " entries" << std::endl;
+    return 0;
+}
@@ -0,0 +1,572 @@
+#!/usr/bin/python3
+"""Generates bus command base classes and their JSON parsers from schema/commands.json.
+
+For every command in the schema one header <class>.h is written. It contains
+
+- a class deriving from VirtualBusCmd with the fields laid out by decreasing size,
+  accessors, and setters that reject values outside the schema range,
+- parseJson()/serializeJson() members specialised to the field list; parsing is a single
+  SAX pass (JsonSaxReader) that builds no DOM and reports failures as ReturnType, and
+  serializing writes the same text as nlohmann::json::dump() of the equivalent document,
+- a JsonCmdParser implementation that checks the command type instead of using dynamic_cast,
+- the ensureDecoded()/decodePending() hooks behind LazyCommand.
+
+Hand-written classes derive from the generated ones and add behaviour.
+
+Usage:
+    generate_commands.py <schema.json> <output-dir>     write the headers
+    generate_commands.py <schema.json> --list           print the header names
+"""
+import json
+import re
+import sys
+from pathlib import Path
+
+SCALARS = {
+    # schema type: (C++ type, size, minimum, maximum)
+    "uint8": ("uint8_t", 1, 0, 255),
+    "uint16": ("uint16_t", 2, 0, 65535),
+    "uint32": ("uint32_t", 4, 0, 4294967295),
+    "int16": ("int16_t", 2, -32768, 32767),
+    "int32": ("int32_t", 4, -2147483648, 2147483647),
+    "double": ("double", 8, None, None),
+}
+
+
+def upper_first(name):
+    return name[0].upper() + name[1:]
+
+
+def guard_name(class_name):
+    return re.sub(r"(?<!^)(?=[A-Z])", "_", class_name).upper() + "_H"
+
+
+def cpp_literal(field, value):
+    if field["kind"] == "enum":
+        return "{}::{}".format(field["type"], value)
+    if field["cpp"] == "double":
+        return repr(float(value))
+    if value == -2147483648:
+        return "INT32_MIN"
+    return str(int(value)) + ("U" if field["cpp"] == "uint32_t" else "")
+
+
+def load_command(command):
+    enums = {e["name"]: e for e in command.get("enums", [])}
+    fields = []
+    for spec in command["fields"]:
+        field = dict(spec)
+        field["Name"] = upper_first(spec["name"])
+        if spec["type"] in enums:
+            field["kind"] = "enum"
+            field["cpp"] = spec["type"]
+            field["size"] = 1
+            field["values"] = enums[spec["type"]]["values"]
+            field.setdefault("default", field["values"][0])
+            field["jsonValues"] = spec.get("jsonValues", {v: v for v in field["values"]})
+        elif spec["type"] in SCALARS:
+            cpp, size, low, high = SCALARS[spec["type"]]
+            field["kind"] = "real" if cpp == "double" else "integer"
+            field["cpp"] = cpp
+            field["size"] = size
+            field["typeMin"], field["typeMax"] = low, high
+            field.setdefault("min", low)
+            field.setdefault("max", high)
+            field.setdefault("default", 0)
+            if field["kind"] == "real" and (field["min"] is None or field["max"] is None):
+                sys.exit("{}: double fields need min and max".format(spec["name"]))
+        else:
+            sys.exit("{}: unknown type {}".format(spec["name"], spec["type"]))
+        fields.append(field)
+    return enums, fields
+
+
+def has_range_check(field):
+    if field["kind"] == "real":
+        return True
+    if field["kind"] == "integer":
+        return field["min"] != field["typeMin"] or field["max"] != field["typeMax"]
+    return True
+
+
+def json_groups(fields):
+    """Groups JSON-mapped fields by top-level key, keeping schema order."""
+    groups = []
+    index = {}
+    for field in fields:
+        if "json" not in field:
+            continue
+        parts = field["json"].split(".")
+        if len(parts) > 2:
+            sys.exit("{}: JSON paths are limited to two levels".format(field["name"]))
+        if len(parts) == 1:
+            groups.append((parts[0], [(None, field)]))
+            continue
+        if parts[0] not in index:
+            index[parts[0]] = len(groups)
+            groups.append((parts[0], []))
+        groups[index[parts[0]]][1].append((parts[1], field))
+    return groups
+
+
+def emit_accessors(out, field):
+    name, Name, cpp = field["name"], field["Name"], field["cpp"]
+    out.append("    /**")
+    out.append("     * @brief Getter for {}.".format(name))
+    out.append("     * @return {}.".format(field["brief"]))
+    out.append("     */")
+    out.append("    {} {}() const {{".format(cpp, name))
+    out.append("        ensureDecoded();")
+    out.append("        return {}_;".format(name))
+    out.append("    }")
+    out.append("")
+    out.append("    /**")
+    out.append("     * @brief Setter for {}.".format(name))
+    out.append("     * @param[in] value {}.".format(field["brief"]))
+    if has_range_check(field):
+        out.append("     * @return True if the value is in range and was stored.")
+    else:
+        out.append("     * @return Always true, every value of the type is valid.")
+    out.append("     */")
+    out.append("    bool set{}({} value) {{".format(Name, cpp))
+    out.append("        ensureDecoded();")
+    if field["kind"] == "enum":
+        out.append("        if (static_cast<uint8_t>(value) >= {}) {{".format(len(field["values"])))
+    elif field["kind"] == "real":
+        # Written as a negated conjunction so NaN is rejected as well
+        out.append("        if (!(value >= k{0}Min && value <= k{0}Max)) {{".format(Name))
+    elif has_range_check(field):
+        checks = []
+        if field["min"] != field["typeMin"]:
+            checks.append("value < k{}Min".format(Name))
+        if field["max"] != field["typeMax"]:
+            checks.append("value > k{}Max".format(Name))
+        out.append("        if ({}) {{".format(" || ".join(checks)))
+    if has_range_check(field):
+        out.append("            rejectValue(\"{}\");".format(name))
+        out.append("            return false;")
+        out.append("        }")
+    out.append("        {}_ = value;".format(name))
+    out.append("        return true;")
+    out.append("    }")
+    out.append("")
+
+
+def emit_float_cases(out, fields, ids):
+    out.append("    bool onFloat(int field, double value) {")
+    out.append("        switch (field) {")
+    for f in fields:
+        out.append("            case {}:".format(ids[f["name"]]))
+        out.append("                if (!(value >= k{0}Min && value <= k{0}Max)) return false;".format(f["Name"]))
+        out.append("                {}Value = value;".format(f["name"]))
+        out.append("                return true;")
+    out.append("            default:")
+    out.append("                return false;")
+    out.append("        }")
+    out.append("    }")
+
+
+def emit_string_cases(out, fields, ids):
+    out.append("    bool onString(int field, std::string_view value) {")
+    out.append("        switch (field) {")
+    for f in fields:
+        out.append("            case {}:".format(ids[f["name"]]))
+        for value in f["values"]:
+            out.append("                if (value == \"{}\") {{ {}Value = {}::{}; return true; }}".format(
+                f["jsonValues"][value], f["name"], f["cpp"], value))
+        out.append("                return false;")
+    out.append("            default:")
+    out.append("                return false;")
+    out.append("        }")
+    out.append("    }")
+
+
+def emit_reader(out, cls, parser, fields, groups):
+    """Emits the SAX handler staging the JSON-mapped fields of one command."""
+    json_fields = [f for f in fields if "json" in f]
+    ids = {f["name"]: i for i, f in enumerate(json_fields)}
+    group_names = [key for key, members in groups if members[0][0] is not None]
+
+    def value_cases(kinds):
+        return [f for f in json_fields if f["kind"] in kinds]
+
+    out.append("/**")
+    out.append(" * @brief Single-pass SAX handler staging the JSON values of {}.".format(cls))
+    out.append(" */")
+    out.append("class {0}::JsonReader : public JsonSaxReader<{0}::JsonReader> {{".format(cls))
+    out.append("public:")
+    out.append("    explicit JsonReader(const {}& command)".format(cls))
+    initializers = ["{0}Value(command.{0}_)".format(f["name"]) for f in json_fields]
+    out.append("        : " + ",\n          ".join(initializers) + " {}")
+    out.append("")
+    out.append("    int lookup(int group, std::string_view key) const {")
+    out.append("        if (group < 0) {")
+    for key, members in groups:
+        if members[0][0] is None:
+            out.append("            if (key == \"{}\") return {};".format(key, ids[members[0][1]["name"]]))
+        else:
+            out.append("            if (key == \"{}\") return groupMarker({});".format(key, group_names.index(key)))
+    out.append("            return kUnknown;")
+    out.append("        }")
+    for key, members in groups:
+        if members[0][0] is None:
+            continue
+        out.append("        if (group == {}) {{".format(group_names.index(key)))
+        for sub, field in members:
+            out.append("            if (key == \"{}\") return {};".format(sub, ids[field["name"]]))
+        out.append("        }")
+    out.append("        return kUnknown;")
+    out.append("    }")
+    out.append("")
+    out.append("    bool onInteger(int field, int64_t value) {")
+    out.append("        switch (field) {")
+    for f in value_cases(["integer"]):
+        out.append("            case {}:".format(ids[f["name"]]))
+        out.append("                if (value < static_cast<int64_t>(k{0}Min) || value > static_cast<int64_t>(k{0}Max)) return false;".format(f["Name"]))
+        out.append("                {}Value = static_cast<{}>(value);".format(f["name"], f["cpp"]))
+        out.append("                return true;")
+    out.append("            default:")
+    out.append("                return onFloat(field, static_cast<double>(value));")
+    out.append("        }")
+    out.append("    }")
+    out.append("")
+    out.append("    bool onUnsigned(int field, uint64_t value) {")
+    out.append("        return value <= static_cast<uint64_t>(INT64_MAX) && onInteger(field, static_cast<int64_t>(value));")
+    out.append("    }")
+    out.append("")
+    if not value_cases(["real"]):
+        out.append("    bool onFloat(int, double) { return false; }")
+    else:
+        emit_float_cases(out, value_cases(["real"]), ids)
+    out.append("")
+    if not value_cases(["enum"]):
+        out.append("    bool onString(int, std::string_view) { return false; }")
+    else:
+        emit_string_cases(out, value_cases(["enum"]), ids)
+    out.append("")
+    out.append("    static const char* keyName(int field) {")
+    out.append("        switch (field) {")
+    for f in json_fields:
+        out.append("            case {}: return \"{}\";".format(ids[f["name"]], f["json"]))
+    for index, key in enumerate(group_names):
+        out.append("            case groupMarker({}): return \"{}\";".format(index, key))
+    out.append("            default: return \"\";")
+    out.append("        }")
+    out.append("    }")
+    out.append("")
+    out.append("    void commit({}& command) const {{".format(cls))
+    for f in json_fields:
+        out.append("        command.{0}_ = {0}Value;".format(f["name"]))
+    out.append("    }")
+    out.append("")
+    out.append("private:")
+    for f in json_fields:
+        out.append("    {} {}Value;".format(f["cpp"], f["name"]))
+    out.append("};")
+    out.append("")
+
+
+def serialize_tree(command, groups):
+    """Maps each top-level JSON key to a field, a string constant or an object of fields."""
+    tree = {}
+    for key, members in groups:
+        if members[0][0] is None:
+            tree[key] = ("field", members[0][1])
+        else:
+            tree[key] = ("object", {sub: field for sub, field in members})
+    for key, value in command.get("jsonConstants", {}).items():
+        if key in tree:
+            sys.exit("{}: constant {} is also a field".format(command["class"], key))
+        tree[key] = ("constant", value)
+    return tree
+
+
+def serialize_pieces(tree):
+    """Flattens the tree into literal text and fields, keys sorted as nlohmann::json stores them."""
+    pieces = []
+
+    def literal(text):
+        if pieces and isinstance(pieces[-1], str):
+            pieces[-1] += text
+        else:
+            pieces.append(text)
+
+    literal("{")
+    for index, key in enumerate(sorted(tree)):
+        kind, node = tree[key]
+        literal("{}\"{}\":".format("," if index > 0 else "", key))
+        if kind == "constant":
+            literal("\"{}\"".format(node))
+        elif kind == "object":
+            literal("{")
+            for subIndex, sub in enumerate(sorted(node)):
+                literal("{}\"{}\":".format("," if subIndex > 0 else "", sub))
+                pieces.append(node[sub])
+            literal("}")
+        else:
+            pieces.append(node)
+    literal("}")
+    return pieces
+
+
+def c_string(text):
+    return "\"" + text.replace("\\", "\\\\").replace("\"", "\\\"") + "\""
+
+
+def emit_serialize_value(out, field, indent):
+    if field["kind"] == "enum":
+        out.append("{}switch ({}_) {{".format(indent, field["name"]))
+        for value in field["values"]:
+            text = "\"{}\"".format(field["jsonValues"][value])
+            out.append("{}    case {}::{}: out.append({}, {}); break;".format(
+                indent, field["cpp"], value, c_string(text), len(text)))
+        out.append("{}}}".format(indent))
+    elif "jsonGetter" in field:
+        out.append("{}JsonFormat::appendNumber(out, {}());".format(indent, field["jsonGetter"]))
+    else:
+        out.append("{}JsonFormat::appendNumber(out, {}_);".format(indent, field["name"]))
+
+
+def emit_json_getter(out, field):
+    out.append("    /**")
+    out.append("     * @brief Getter for the {} written by serializeJson(), overridden to apply limits.".format(field["name"]))
+    out.append("     * @return {}.".format(field["brief"]))
+    out.append("     */")
+    out.append("    virtual {} {}() const {{ return {}(); }}".format(field["cpp"], field["jsonGetter"], field["name"]))
+    out.append("")
+
+
+def generate(command, schema_name):
+    cls = command["class"]
+    parser = command["parser"]
+    enums, fields = load_command(command)
+    layout = sorted(fields, key=lambda f: -f["size"])  # stable: schema order within a size
+    groups = json_groups(fields)
+    json_fields = [f for f in fields if "json" in f]
+
+    out = []
+    out.append("// Generated by tools/generate_commands.py from {}. Do not edit.".format(schema_name))
+    out.append("#ifndef {}".format(guard_name(cls)))
+    out.append("#define {}".format(guard_name(cls)))
+    out.append("")
+    out.append("#include <atomic>")
+    out.append("#include <cstddef>")
+    out.append("#include <cstdint>")
+    out.append("#include <memory>")
+    out.append("#include <string>")
+    out.append("")
+    out.append("#include \"nlohmann/json.hpp\"")
+    out.append("#include \"VirtualBusCmd.h\"")
+    out.append("#include \"JsonCmdParser.h\"")
+    out.append("#include \"JsonFormat.h\"")
+    out.append("#include \"JsonSaxReader.h\"")
+    out.append("#include \"ErrorHandler.h\"")
+    out.append("#include \"ReturnType.h\"")
+    out.append("#include \"ILogger.h\"")
+    out.append("")
+    out.append("/**")
+    out.append(" * @brief Generated base class of the {} command.".format(command["type"]))
+    out.append(" *")
+    out.append(" * {}".format(command["brief"]))
+    out.append(" * Fields are laid out by decreasing size; setters and parseJson() reject values outside")
+    out.append(" * the schema range and leave the command unchanged. Every accessor first calls")
+    out.append(" * ensureDecoded(), which lets a lazy subclass decode its raw payload on first access.")
+    out.append(" */")
+    out.append("class {} : public VirtualBusCmd {{".format(cls))
+    out.append("public:")
+    for enum in enums.values():
+        out.append("    /**")
+        out.append("     * @brief {}".format(enum["brief"]))
+        out.append("     */")
+        out.append("    enum class {} : uint8_t {{ {} }};".format(
+            enum["name"], ", ".join("{} = {}".format(v, i) for i, v in enumerate(enum["values"]))))
+        out.append("")
+    for field in fields:
+        if field["kind"] == "enum":
+            continue
+        out.append("    static constexpr {} k{}Min = {};  ///< Lowest accepted {}".format(
+            field["cpp"], field["Name"], cpp_literal(field, field["min"]), field["name"]))
+        out.append("    static constexpr {} k{}Max = {};  ///< Highest accepted {}".format(
+            field["cpp"], field["Name"], cpp_literal(field, field["max"]), field["name"]))
+    out.append("")
+    out.append("    /**")
+    out.append("     * @brief Constructor initializing the command type and the schema defaults.")
+    out.append("     *")
+    out.append("     * @param[in] logger A shared pointer to a logger instance for logging messages.")
+    out.append("     */")
+    out.append("    explicit {}(std::shared_ptr<ILogger> logger = nullptr) : VirtualBusCmd(), logger_(logger) {{".format(cls))
+    out.append("        type_ = CommandType::{};".format(command["type"]))
+    out.append("    }")
+    out.append("")
+    for field in fields:
+        emit_accessors(out, field)
+    for field in fields:
+        if "jsonGetter" in field:
+            emit_json_getter(out, field)
+    out.append("    /**")
+    out.append("     * @brief Restores the schema defaults of all fields.")
+    out.append("     */")
+    out.append("    void resetFields() {")
+    out.append("        ensureDecoded();")
+    for field in fields:
+        out.append("        {}_ = {};".format(field["name"], cpp_literal(field, field["default"])))
+    out.append("    }")
+    out.append("")
+    out.append("    /**")
+    out.append("     * @brief Parses a JSON object into the fields in a single SAX pass without building a DOM.")
+    out.append("     *")
+    out.append("     * Keys that are absent keep their value, unknown keys are ignored. Failures are returned,")
+    out.append("     * never thrown or logged, and leave the command unchanged.")
+    out.append("     *")
+    out.append("     * @param[in] text JSON text of the command parameters.")
+    out.append("     * @param[out] error Position of a syntax error or key of the rejected value.")
+    out.append("     * @return OK, ERROR for malformed JSON, INVALID_ARGUMENT for a value of the wrong type or range.")
+    out.append("     */")
+    out.append("    ReturnType parseJson(const std::string& text, ParseError& error);")
+    out.append("")
+    out.append("    /**")
+    out.append("     * @brief Appends the fields as a JSON object without building a DOM.")
+    out.append("     *")
+    out.append("     * The text is the one nlohmann::json::dump() writes for the same document: keys sorted,")
+    out.append("     * no whitespace. With a reused output string nothing is allocated once its capacity has")
+    out.append("     * grown to the message size.")
+    out.append("     *")
+    out.append("     * @param[out] out String the JSON text is appended to.")
+    out.append("     */")
+    out.append("    void serializeJson(std::string& out) const;")
+    out.append("")
+    out.append("    /**")
+    out.append("     * @brief Copies the binary payload a lazy command still holds undecoded.")
+    out.append("     *")
+    out.append("     * Lets codecs forward such commands without decoding and re-encoding them.")
+    out.append("     *")
+    out.append("     * @param[out] buffer Destination buffer.")
+    out.append("     * @param[in] capacity Size of the destination buffer.")
+    out.append("     * @return Bytes copied, 0 if the fields are decoded or the buffer is too small.")
+    out.append("     */")
+    out.append("    virtual size_t copyRawPayload(uint8_t* buffer, size_t capacity) const {")
+    out.append("        (void)buffer;")
+    out.append("        (void)capacity;")
+    out.append("        return 0;")
+    out.append("    }")
+    out.append("")
+    out.append("protected:")
+    out.append("    class JsonReader;")
+    out.append("")
+    out.append("    /**")
+    out.append("     * @brief Decodes the fields a lazy subclass holds back; must clear pending_ with release order.")
+    out.append("     */")
+    out.append("    virtual void decodePending() const {}")
+    out.append("")
+    out.append("    void ensureDecoded() const {")
+    out.append("        if (pending_.load(std::memory_order_acquire)) {")
+    out.append("            decodePending();")
+    out.append("        }")
+    out.append("    }")
+    out.append("")
+    out.append("    /**")
+    out.append("     * @brief Copies every field of a decoded command without triggering decoding.")
+    out.append("     *")
+    out.append("     * @param[in] other Source command.")
+    out.append("     */")
+    out.append("    void copyFields(const {}& other) {{".format(cls))
+    for field in fields:
+        out.append("        {0}_ = other.{0}_;".format(field["name"]))
+    out.append("    }")
+    out.append("")
+    out.append("    void rejectValue(const char* field) const {")
+    out.append("        ErrorHandler::handleError(\"{}\", std::string(\"Value out of range for \") + field + \".\", ErrorHandler::ErrorSeverity::WARNING, logger_);".format(cls))
+    out.append("    }")
+    out.append("")
+    out.append("    std::shared_ptr<ILogger> logger_;  ///< Logger instance for logging messages")
+    for field in layout:
+        out.append("    {} {}_ = {};  ///< {}".format(field["cpp"], field["name"], cpp_literal(field, field["default"]), field["brief"]))
+    out.append("    mutable std::atomic<bool> pending_{false};  ///< True while a lazy subclass holds the fields encoded")
+    out.append("};")
+    out.append("")
+
+    # parseJson
+    emit_reader(out, cls, parser, fields, groups)
+    out.append("inline ReturnType {}::parseJson(const std::string& text, ParseError& error) {{".format(cls))
+    out.append("    // Values are staged in the reader and only stored once the whole object validated")
+    out.append("    ensureDecoded();")
+    out.append("    JsonReader reader(*this);")
+    out.append("    if (!reader.parse(text)) {")
+    out.append("        if (reader.syntaxError() || reader.errorField() == JsonReader::kUnknown) {")
+    out.append("            error.position = reader.errorPosition();")
+    out.append("            return ReturnType::ERROR;")
+    out.append("        }")
+    out.append("        error.field = JsonReader::keyName(reader.errorField());")
+    out.append("        return ReturnType::INVALID_ARGUMENT;")
+    out.append("    }")
+    out.append("    reader.commit(*this);")
+    out.append("    return ReturnType::OK;")
+    out.append("}")
+    out.append("")
+
+    # serializeJson
+    out.append("inline void {}::serializeJson(std::string& out) const {{".format(cls))
+    out.append("    ensureDecoded();")
+    for piece in serialize_pieces(serialize_tree(command, groups)):
+        if isinstance(piece, str):
+            out.append("    out.append({}, {});".format(c_string(piece), len(piece)))
+        else:
+            emit_serialize_value(out, piece, "    ")
+    out.append("}")
+    out.append("")
+
+    # Parser
+    out.append("/**")
+    out.append(" * @brief Generated JSON parser of the {} command.".format(command["type"]))
+    out.append(" *")
+    out.append(" * The command type is checked instead of using dynamic_cast.")
+    out.append(" */")
+    out.append("class {} : public JsonCmdParser {{".format(parser))
+    out.append("private:")
+    out.append("    std::shared_ptr<ILogger> logger_; ///< Logger instance for logging messages")
+    out.append("")
+    out.append("public:")
+    out.append("    /**")
+    out.append("     * @brief Constructor for {}.".format(parser))
+    out.append("     *")
+    out.append("     * @param[in] logger A shared pointer to a logger instance for logging messages.")
+    out.append("     */")
+    out.append("    {}(std::shared_ptr<ILogger> logger = nullptr) : logger_(logger) {{}}".format(parser))
+    out.append("")
+    out.append("    /**")
+    out.append("     * @brief Parses the given parameters and sets them in the command.")
+    out.append("     *")
+    out.append("     * @param[in] command Reference to a command object that parameters will be set to.")
+    out.append("     * @param[in] parameters JSON string representing command parameters.")
+    out.append("     * @param[out] error Position or field of the failure.")
+    out.append("     * @return OK, ERROR or INVALID_ARGUMENT, see {}::parseJson().".format(cls))
+    out.append("     */")
+    out.append("    ReturnType parseParameters(VirtualBusCmd& command, const std::string& parameters, ParseError& error) override {")
+    out.append("        if (command.getType() != CommandType::{}) {{".format(command["type"]))
+    out.append("            return ReturnType::INVALID_ARGUMENT;")
+    out.append("        }")
+    out.append("        return static_cast<{}&>(command).parseJson(parameters, error);".format(cls))
+    out.append("    }")
+    out.append("};")
+    out.append("")
+    out.append("#endif // {}".format(guard_name(cls)))
+    return "\n".join(out) + "\n"
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    schema_path = Path(sys.argv[1])
+    schema = json.loads(schema_path.read_text())
+    headers = [command["class"] + ".h" for command in schema["commands"]]
+    if sys.argv[2] == "--list":
+        print(";".join(headers))
+        return
+    output = Path(sys.argv[2])
+    output.mkdir(parents=True, exist_ok=True)
+    for command, header in zip(schema["commands"], headers):
+        (output / header).write_text(generate(command, schema_path.name))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,157 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "VirtualBus.h"
+#include "ThreadPool.h"
+#include "NdjsonIngest.h"
+#include "InverterCommand.h"
+#include "BatteryCommand.h"
+#include "LazyCommand.h"
+
+namespace {
+
+/**
+ * @brief Writes COUNT synthetic commands of the given type as NDJSON.
+ */
+bool generateFile(const std::string& path, const std::string& type, uint64_t count) {
+    std::ofstream file(path, std::ios::trunc);
+    for (uint64_t i = 0; i < count && file; ++i) {
+        if (type == "battery") {
+            file << "{\"Cube_Num\":12,\"Cube_OP\":" << (11 + i % 2) << ",\"Voltage\":{\"MIN\":" << (25000 + i % 500)
+                 << ",\"MAX\":" << (25600 + i % 500) << ",\"AVG\":" << (25300 + i % 500) << "},\"SOC\":{\"MIN\":"
+                 << (4000 + i % 100) << ",\"MAX\":" << (4200 + i % 100) << ",\"AVG\":" << (4100 + i % 100)
+                 << "},\"Current\":{\"MIN\":-" << (i % 80) << ",\"MAX\":" << (i % 80) << ",\"AVG\":0}}\n";
+        } else {
+            file << "{\"command\":\"" << ((i & 1) ? "StartDischarging" : "StartCharging") << "\",\"voltage\":"
+                 << (400.0 + static_cast<double>(i % 100) * 0.1) << ",\"current\":" << static_cast<double>(i % 50) << "}\n";
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+} // namespace
+
+/**
+ * @brief Bulk-loads an NDJSON command file onto a fresh VirtualBus and reports the throughput.
+ *
+ * Usage: ndjson_ingest <file> [--type inverter|battery] [--threads N] [--chunk BYTES] [--generate COUNT] [--lazy 1]
+ *
+ * Every line is parsed as a command of the given type (default inverter) on N pool threads
+ * (default: all cores). `--generate` first writes COUNT synthetic commands to the file.
+ * `--lazy 1` publishes LazyCommand instances holding the JSON text, validation and decoding
+ * then happen on first field access, so rejected lines are not counted.
+ *
+ * @return Exit code.
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <file> [--type inverter|battery] [--threads N] [--chunk BYTES] [--generate COUNT] [--lazy 1]" << std::endl;
+        return 1;
+    }
+    const std::string path = argv[1];
+    std::string type = "inverter";
+    size_t threads = std::thread::hardware_concurrency();
+    size_t chunkSize = 1024 * 1024;
+    uint64_t generate = 0;
+    bool lazy = false;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        std::string argument = argv[i];
+        if (argument == "--type") {
+            type = argv[i + 1];
+        } else if (argument == "--threads") {
+            threads = std::strtoul(argv[i + 1], nullptr, 0);
+        } else if (argument == "--chunk") {
+            chunkSize = std::strtoul(argv[i + 1], nullptr, 0);
+        } else if (argument == "--generate") {
+            generate = std::strtoull(argv[i + 1], nullptr, 0);
+        } else if (argument == "--lazy") {
+            lazy = std::strtol(argv[i + 1], nullptr, 0) != 0;
+        } else {
+            std::cerr << "Unknown option " << argument << std::endl;
+            return 1;
+        }
+    }
+    if (type != "inverter" && type != "battery") {
+        std::cerr << "Unknown command type " << type << std::endl;
+        return 1;
+    }
+    if (threads == 0) {
+        threads = 1;
+    }
+    if (generate > 0 && !generateFile(path, type, generate)) {
+        std::cerr << "Cannot write " << path << std::endl;
+        return 1;
+    }
+
+    InverterCommand::registerParser();
+    BatteryStateCmd::registerParser();
+    NdjsonIngest::CommandFactory factory;
+    if (lazy && type == "battery") {
+        factory = [](const std::string& line) -> std::shared_ptr<VirtualBusCmd> {
+            return LazyCommand<BatteryStateCmd>::fromJson(line);
+        };
+    } else if (lazy) {
+        factory = [](const std::string& line) -> std::shared_ptr<VirtualBusCmd> {
+            return LazyCommand<InverterCommand>::fromJson(line);
+        };
+    } else if (type == "battery") {
+        factory = [](const std::string& line) -> std::shared_ptr<VirtualBusCmd> {
+            auto command = std::make_shared<BatteryStateCmd>();
+            ParseError error;
+            return command->tryParse(line, error) == ReturnType::OK ? command : nullptr;
+        };
+    } else {
+        factory = [](const std::string& line) -> std::shared_ptr<VirtualBusCmd> {
+            auto command = std::make_shared<InverterCommand>();
+            ParseError error;
+            return command->tryParse(line, error) == ReturnType::OK ? command : nullptr;
+        };
+    }
+
+    VirtualBus bus;
+    const int sourceId = 1;
+    const int subscriberId = 2;
+    bus.attach(sourceId, "Ingest");
+    bus.attach(subscriberId, "Subscriber");
+    std::atomic<uint64_t> received{0};
+    // Drains the subscriber queue while the file is ingested, so the commands are released
+    std::thread subscriber([&bus, &received] {
+        std::shared_ptr<VirtualBusCmd> message;
+        while (bus.receiveMessage(subscriberId, message)) {
+            message.reset();
+            received.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    NdjsonIngest::Result result;
+    ReturnType status;
+    {
+        ThreadPool pool(threads);
+        NdjsonIngest ingest(bus, pool, threads, factory, chunkSize);
+        status = ingest.ingest(path, sourceId, result);
+    }
+    while (received.load(std::memory_order_relaxed) < result.published) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    bus.shutdown();
+    subscriber.join();
+    if (status != ReturnType::OK) {
+        std::cerr << "Cannot ingest " << path << std::endl;
+        return 1;
+    }
+
+    std::cout << "Threads:    " << threads << std::endl;
+    std::cout << "Lines:      " << result.lines << std::endl;
+    std::cout << "Published:  " << result.published << std::endl;
+    std::cout << "Rejected:   " << result.rejected << std::endl;
+    std::cout << "Delivered:  " << received.load() << std::endl;
+    std::cout << "Elapsed:    " << std::chrono::duration<double, std::milli>(result.elapsed).count() << " ms" << std::endl;
+    std::cout << "Throughput: " << static_cast<uint64_t>(result.commandsPerSecond) << " cmd/s" << std::endl;
+    return 0;
+}
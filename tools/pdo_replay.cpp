@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "VirtualBus.h"
+#include "CanDumpReader.h"
+#include "CanOpenPdoMapper.h"
+#include "InverterPdoProfile.h"
+
+/**
+ * @brief Replays a candump log through the inverter PDO mapping and reports the time
+ *        from frame arrival to bus publish.
+ *
+ * Usage: pdo_replay <candump.log> [node-id] [--realtime]
+ *
+ * @return Exit code.
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <candump.log> [node-id] [--realtime]" << std::endl;
+        return 1;
+    }
+    const std::string path = argv[1];
+    uint8_t nodeId = 1;
+    bool realtime = false;
+    for (int i = 2; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--realtime") {
+            realtime = true;
+        } else {
+            nodeId = static_cast<uint8_t>(std::strtoul(argument.c_str(), nullptr, 0));
+        }
+    }
+
+    std::vector<CanDumpRecord> records;
+    CanDumpReader reader;
+    if (reader.load(path, records) != ReturnType::OK) {
+        std::cerr << "Cannot open " << path << std::endl;
+        return 1;
+    }
+
+    VirtualBus bus;
+    const int gatewayId = 1;
+    const int subscriberId = 2;
+    bus.attach(gatewayId, "CANopen");
+    bus.attach(subscriberId, "Subscriber");
+    std::atomic<uint64_t> received{0};
+    bus.registerCallback(subscriberId, [&received](std::shared_ptr<VirtualBusCmd>) {
+        received.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    CanOpenPdoMapper mapper(bus, gatewayId);
+    if (InverterPdoProfile::configure(mapper, nodeId) != ReturnType::OK) {
+        std::cerr << "Invalid PDO configuration" << std::endl;
+        return 1;
+    }
+
+    std::vector<double> latenciesUs;
+    latenciesUs.reserve(records.size());
+    uint64_t ignored = 0;
+    const auto replayStart = std::chrono::steady_clock::now();
+    const double firstTimestamp = records.empty() ? 0.0 : records.front().timestamp;
+
+    for (const auto& record : records) {
+        if (realtime) {
+            std::this_thread::sleep_until(replayStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(record.timestamp - firstTimestamp)));
+        }
+        const auto arrival = std::chrono::steady_clock::now();
+        ReturnType result = mapper.onFrame(record.frame);
+        const auto published = std::chrono::steady_clock::now();
+        if (result == ReturnType::OK) {
+            latenciesUs.push_back(std::chrono::duration<double, std::micro>(published - arrival).count());
+        } else {
+            ++ignored;
+        }
+    }
+
+    // Give the callback workers a moment to drain before reading the delivery count
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    bus.shutdown();
+
+    std::cout << "Frames: " << records.size() << ", PDOs published: " << latenciesUs.size()
+              << ", other frames: " << ignored << ", delivered: " << received.load() << std::endl;
+    if (!latenciesUs.empty()) {
+        std::sort(latenciesUs.begin(), latenciesUs.end());
+        auto percentile = [&latenciesUs](double p) {
+            size_t index = static_cast<size_t>(p * static_cast<double>(latenciesUs.size() - 1));
+            return latenciesUs[index];
+        };
+        std::cout << "Arrival to publish (us): p50 " << percentile(0.50) << ", p99 " << percentile(0.99)
+                  << ", max " << latenciesUs.back() << std::endl;
+    }
+    return 0;
+}